@@ -3,23 +3,35 @@
  */
 
 #include <ctype.h>         /* isdigit */
-#include <errno.h>         /* errno */
-#include <limits.h>        /* CHAR_BIT */
+#include <errno.h>         /* errno, ERANGE, EINTR */
+#include <limits.h>        /* CHAR_BIT, INT_MAX */
 #include <signal.h>        /* SIG*, SIG_*, signal */
 #include <stdarg.h>        /* va_list, va_start, va_end */
 #include <stddef.h>        /* NULL */
-#include <stdio.h>         /* fprintf, vfprintf, putc, stderr, remove, FILE, fopen, fclose */
+#include <stdio.h>         /* fprintf, vfprintf, putc, getc, stderr, remove, FILE, fopen, fclose,
+                              fflush, fileno, tmpfile, rewind, fseek, SEEK_END, EOF, fgets,
+                              fscanf, fread, fwrite, ferror, rename, sprintf, fdopen */
 #include <stdlib.h>        /* strtol, exit, EXIT_FAILURE */
-#include <string.h>        /* strtok, strchr, strcmp, strcpy, strcat, strrchr, strlen */
-#include <cbl/arena.h>     /* arena_t, ARENA_NEW, ARENA_ALLOC, ARENA_DISPOSE */
+#include <string.h>        /* strtok, strchr, strcmp, strcpy, strcat, strrchr, strlen, memset,
+                              memcpy, strncmp, strspn */
+#include <cbl/arena.h>     /* arena_t, ARENA_NEW, ARENA_ALLOC, ARENA_CALLOC, ARENA_DISPOSE */
 #include <cbl/assert.h>    /* assert */
 #include <cdsl/dlist.h>    /* dlist_t, dlist_new, dlist_length, dlist_get, dlist_addtail,
                               dlist_free */
 #include <cdsl/hash.h>     /* hash_string, hash_new, hash_reset */
 #include <cdsl/table.h>    /* table_t, table_new, table_put, table_get, table_free */
-#include <sys/types.h>     /* pid_t */
-#include <unistd.h>        /* fork, execv, getpid */
-#include <sys/wait.h>      /* wait, W* */
+#include <sys/types.h>     /* pid_t, ssize_t */
+#include <sys/stat.h>      /* mkdir */
+#include <fcntl.h>         /* fcntl, open, struct flock, F_SETFD, F_SETLKW, F_WRLCK, FD_CLOEXEC,
+                              O_RDWR, O_CREAT */
+#include <unistd.h>        /* fork, execv, getpid, dup2, pipe, close, read, write, getcwd, _exit,
+                              sysconf, _SC_NPROCESSORS_ONLN */
+#include <sys/wait.h>      /* waitpid, W* */
+#ifdef HAVE_SOCKET
+#include <sys/socket.h>    /* socket, connect, sendmsg, struct msghdr, CMSG_*, SCM_RIGHTS */
+#include <sys/uio.h>       /* struct iovec */
+#include <sys/un.h>        /* struct sockaddr_un */
+#endif    /* HAVE_SOCKET */
 
 #include "ec.h"
 #include "util.h"
@@ -72,6 +84,25 @@ enum {
     TO     /* .o, .obj */
 };
 
+/* file being processed */
+struct job {
+    const char *f;       /* input to next command */
+    const char *bn;      /* base name of file */
+    const char *id;      /* suffix for temporary files */
+    const char *outn;    /* output of commands */
+    const char *cmd[2];  /* commands running */
+    pid_t pid[2];        /* processes running commands; 0 if none */
+    int t;               /* file type; determines next command */
+    int piped;           /* true if compiler output piped to assembler */
+    int direct;          /* true if compiler writes object file */
+    int keyed;           /* 1 while computing cache key, 2 after computed */
+    const char *key;     /* cache entry for output; NULL if not cached */
+    int ok;              /* false if command failed */
+    FILE *log;           /* diagnostics kept from commands; NULL if not kept */
+    FILE *diag;          /* diagnostics kept from compiler for cache; NULL if not kept */
+    int done;            /* true if no command left */
+};
+
 
 static const char *prgname;    /* program name */
 
@@ -125,8 +156,18 @@ static arena_t *strg;                     /* arena */
 static table_t *otab;                     /* option conversion table */
 static dlist_t *ls[LMAX];                 /* option lists */
 static int flagE, flagc, flagS, flagv;    /* driver flags */
+static int flagt;                         /* true if intermediate files kept */
+static int flagi;                         /* true if compiler writes object files */
+#ifdef HAVE_SOCKET
+static int flagw;                         /* true if compile server used */
+#endif    /* HAVE_SOCKET */
 static const char *outfile;               /* output file */
 static int ecnt;                          /* # of errors occurred */
+static int killed;                        /* true if command terminated by signal */
+static int njob;                          /* max # of commands running concurrently */
+static const char *cachedir;              /* cache directory; NULL if not cached */
+static const char *bdir;                  /* directory for beluga; NULL if predefined */
+static int nhit, nmiss;                   /* # of cache hits and misses */
 static char buf[64];                      /* common buffer to handle options */
 
 /* predefined command for beluga */
@@ -147,6 +188,16 @@ static const char *ld[] = {
     NULL
 };
 
+#ifdef HAVE_SOCKET
+/* compile server */
+static struct {
+    const char *sock;    /* socket; NULL if server not running */
+    const char *cwd;     /* working directory sent with requests */
+    pid_t pid;           /* process running server */
+    int fd;              /* write end of pipe to standard input of server */
+} srv = { NULL, NULL, 0, -1 };
+#endif    /* HAVE_SOCKET */
+
 
 /*
  *  removes temporary files
@@ -246,6 +297,24 @@ static void initlist(void)
 }
 
 
+#ifdef HAVE_SOCKET
+/*
+ *  stops the compile server
+ */
+static void stopsrv(void)
+{
+    if (srv.fd < 0)
+        return;
+
+    close(srv.fd);    /* lets server see EOF */
+    srv.fd = -1;
+    srv.sock = NULL;
+    if (srv.pid > 0)
+        waitpid(srv.pid, NULL, 0);
+}
+#endif    /* HAVE_SOCKET */
+
+
 /*
  *  cleans up
  */
@@ -253,6 +322,9 @@ static void clean(void)
 {
     int i;
 
+#ifdef HAVE_SOCKET
+    stopsrv();
+#endif    /* HAVE_SOCKET */
     rm();
     for (i = 0; i < LMAX; i++)
         if (ls[i])
@@ -447,6 +519,11 @@ static int dopt(char *argv[])
             if (arg[1] == '\0')
                 flagE = 1;
             return 0;    /* passes -E to beluga */
+        case 'B':    /* -B<dir> */
+            if (arg[1] == '\0')
+                error(1, "directory must be given to `-B'");
+            bdir = arg + 1;
+            break;
         case 'c':    /* -c */
             if (arg[1] == '\0')
                 flagc = 1;
@@ -461,6 +538,47 @@ static int dopt(char *argv[])
                 dlist_addtail(ls[LI], arg-1);
             }
             break;
+        case 'O':    /* -O[<n>] */
+            if (arg[1] != '\0' && (!isdigit((unsigned char)arg[1]) || arg[2] != '\0'))
+                return 0;
+            dlist_addtail(ls[LC], arg-1);
+            break;
+        case 's':    /* -save-temps */
+            if (strcmp(arg, "save-temps") != 0)
+                return 0;
+            flagt = 1;
+            break;
+        case 'f':    /* -fintegrated-as, -fcompile-server, -fcache-dir=<dir> */
+            if (strcmp(arg, "fintegrated-as") == 0)
+                flagi = 1;
+            else if (strncmp(arg, "fcache-dir=", 11) == 0) {
+                if (arg[11] == '\0')
+                    error(1, "directory must be given to `-fcache-dir='");
+                cachedir = arg + 11;
+            }
+            else if (strcmp(arg, "fcompile-server") == 0)
+#ifdef HAVE_SOCKET
+                flagw = 1;
+#else    /* !HAVE_SOCKET */
+                error(0, "built without HAVE_SOCKET; -fcompile-server ignored");
+#endif    /* HAVE_SOCKET */
+            else
+                return 0;
+            break;
+        case 'j':    /* -j <n>, -j<n> */
+            {
+                long n;
+                char *p, *v = (arg[1] != '\0')? arg+1: argv[1];
+
+                if (!v)
+                    error(1, "number of jobs must be given to `-j'");
+                errno = 0;
+                if (!isdigit((unsigned char)*v) ||
+                    (n = strtol(v, &p, 10), *p != '\0' || errno || n <= 0 || n > INT_MAX))
+                    error(1, "argument to `-j' must be a positive integer in proper range");
+                njob = n;
+                return (v == argv[1])? 2: 1;
+            }
         case 'o':    /* -o */
             if (argv[1]) {
                 outfile = argv[1];
@@ -890,50 +1008,117 @@ static char **compose(const char *a[], dlist_t *opt, dlist_t *in, dlist_t *out)
 /*
  *  prints a command to run
  */
-static void vout(char *arg[])
+static void vout(FILE *fp, char *arg[])
 {
-    fputs(*arg, stderr);
+    fputs(*arg, fp);
     while (*++arg)
-        fprintf(stderr, " %s", *arg);
-    putc('\n', stderr);
+        fprintf(fp, " %s", *arg);
+    putc('\n', fp);
 }
 
 
 /*
- *  run a command
+ *  returns the # of processors online
  */
-static int run(char *arg[])
+static int ncpu(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (n > 0)
+        return (n > INT_MAX)? INT_MAX: n;
+#endif    /* _SC_NPROCESSORS_ONLN */
+
+    return 1;
+}
+
+
+/*
+ *  starts a command without echoing it;
+ *  redirects its stdin or stdout if in or out is not negative;
+ *  returns 0 if the command not actually run
+ */
+static pid_t execute(char *arg[], int in, int out, FILE *log)
 {
-    int st;
     pid_t pid;
 
     assert(arg);
 
-    if (flagv)
-        vout(arg);
     if (flagv > 1)
-        return 1;
+        return 0;
+    fflush(NULL);
     if ((pid = fork()) < 0)
         error(1, "failed to create process");
-    else if (pid > 0) {    /* parent */
-        if (wait(&st) < 0)
-            error(1, "failed to manage process while running %s", arg[0]);
-        if (!WIFEXITED(st) || WEXITSTATUS(st) != 0) {
-            if (WIFSIGNALED(st))
-                error(1, "error occurred while running %s", arg[0]);
-            ecnt++;
-            return 0;
-        }
-        return 1;
-    } else {    /* child */
+    else if (pid == 0) {    /* child */
+        if (in >= 0)
+            dup2(in, 0);
+        if (out >= 0)
+            dup2(out, 1);
+        if (log)
+            dup2(fileno(log), 2);
         execv(arg[0], arg);
-        error(1, "failed to execute %s", arg[0]);
+        error(0, "failed to execute %s", arg[0]);
+        _exit(EXIT_FAILURE);
+    }
+
+    return pid;
+}
+
+
+/*
+ *  starts a command with its stdin or stdout redirected if in or out is not negative;
+ *  returns 0 if the command not actually run
+ */
+static pid_t spawn(char *arg[], int in, int out, FILE *log)
+{
+    assert(arg);
+
+    if (flagv)
+        vout((log)? log: stderr, arg);
+
+    return execute(arg, in, out, log);
+}
+
+
+/*
+ *  checks the exit status of a command
+ */
+static int status(int st, const char *cmd)
+{
+    assert(cmd);
+
+    if (!WIFEXITED(st) || WEXITSTATUS(st) != 0) {
+        if (WIFSIGNALED(st)) {
+            error(0, "error occurred while running %s", cmd);
+            killed = 1;    /* stops after running commands reaped */
+        }
+        ecnt++;
+        return 0;
     }
 
     return 1;
 }
 
 
+/*
+ *  run a command
+ */
+static int run(char *arg[])
+{
+    int st;
+    pid_t pid;
+
+    assert(arg);
+
+    if ((pid = spawn(arg, -1, -1, NULL)) == 0)
+        return 1;
+    if (waitpid(pid, &st, 0) < 0)
+        error(1, "failed to manage process while running %s", arg[0]);
+
+    return status(st, arg[0]);
+}
+
+
 /*
  *  finds a file from the linker's input list
  */
@@ -966,78 +1151,626 @@ static const char *pid(void)
 
 
 /*
- *  process a file
+ *  composes a name for an intermediate file
+ */
+static const char *tmpname(const struct job *j, const char *ext)
+{
+    assert(j);
+    assert(ext);
+
+    return (flagt)? ncat("", j->bn, "", ext): ncat(TMP_DIR, j->bn, j->id, ext);
+}
+
+
+/*
+ *  composes a name for an object file
+ */
+static const char *objname(const struct job *j)
+{
+    assert(j);
+
+    return (!flagc)? tmpname(j, ".o"): (outfile)? outfile: ncat("", j->bn, "", ".o");
+}
+
+
+/*
+ *  copies a file;
+ *  returns false on failure
+ */
+static int copy(const char *from, const char *to)
+{
+    size_t n;
+    int e = 0;
+    FILE *in, *out;
+    char b[BUFSIZ];
+
+    assert(from);
+    assert(to);
+
+    if ((in = fopen(from, "rb")) == NULL)
+        return 0;
+    if ((out = fopen(to, "wb")) == NULL) {
+        fclose(in);
+        return 0;
+    }
+    while ((n = fread(b, 1, sizeof(b), in)) > 0)
+        if (fwrite(b, 1, n, out) != n)
+            e = 1;
+    e |= ferror(in);
+    fclose(in);
+    e |= (fclose(out) != 0);
+
+    return !e;
+}
+
+
+/*
+ *  looks up the cache for a file with the key from the compiler;
+ *  returns true if output is taken from the cache
+ */
+static int cached(struct job *j)
+{
+    int i, n;
+    FILE *fp;
+    char k[64 + 2], h[1 + 8 + 1];
+    unsigned long v = 2166136261UL;
+    const char *p, *out;
+
+    assert(j);
+    assert(j->outn);
+
+    if ((fp = fopen(j->outn, "r")) == NULL)
+        return 0;
+    p = fgets(k, sizeof(k), fp);
+    fclose(fp);
+    if (!p || strspn(k, "0123456789abcdef") != 64 || k[64] != '\n')
+        return 0;
+    k[64] = '\0';
+
+    /* output of the assembler also depends on how it runs */
+    if (!flagS) {
+        v = (v ^ (flagi+1)) * 16777619UL & 0xffffffffUL;
+        n = dlist_length(ls[LS]);
+        for (i = 0; i < n; i++)
+            for (p = dlist_get(ls[LS], i); ; p++) {
+                v = (v ^ (unsigned char)*p) * 16777619UL & 0xffffffffUL;
+                if (*p == '\0')
+                    break;
+            }
+        sprintf(h, "-%08lx", v);
+    } else
+        h[0] = '\0';
+    j->key = ncat(cachedir, xstr(DIR_SEPARATOR), ncat("", k, h, ""), (flagS)? ".s": ".o");
+
+    if (!exist(j->key))
+        return 0;
+    out = (!flagS)? objname(j): (outfile)? outfile: ncat("", j->bn, "", ".s");
+    if (flagv)
+        fprintf((j->log)? j->log: stderr, "cp %s %s\n", j->key, out);
+    if (flagv > 1 || !copy(j->key, out))
+        return 0;
+    j->outn = out;
+
+    return 1;
+}
+
+
+/*
+ *  passes diagnostics kept from the compiler on;
+ *  output is not cached if any since they would be lost on a hit
+ */
+static void putdiag(struct job *j)
+{
+    int c;
+    long n;
+
+    assert(j);
+    assert(j->diag);
+
+    n = ftell(j->diag);
+    rewind(j->diag);
+    while ((c = getc(j->diag)) != EOF)
+        putc(c, (j->log)? j->log: stderr);
+    fclose(j->diag);
+    j->diag = NULL;
+    if (n != 0)
+        j->key = NULL;
+}
+
+
+/*
+ *  stores output of a file in the cache
+ */
+static void store(const struct job *j)
+{
+    const char *t;
+
+    assert(j);
+    assert(j->outn);
+
+    if (!j->key)
+        return;
+    t = ncat(j->key, pid(), "", ".tmp");
+    if (!copy(j->outn, t) || rename(t, j->key) != 0)
+        remove(t);
+}
+
+
+/*
+ *  updates statistics kept in the cache directory and prints them if requested;
+ *  the file is locked since concurrent runs may share the directory
  */
-static void process(const char *f)
+static void cachestat(void)
 {
-    int t, ok;
+    int fd;
+    FILE *fp;
+    const char *f;
+    struct flock lk;
+    unsigned long h, m, hit = nhit, miss = nmiss;
+
+    assert(cachedir);
+
+    f = ncat(cachedir, xstr(DIR_SEPARATOR), "stats", "");
+    if ((fd = open(f, O_RDWR | O_CREAT, 0666)) >= 0) {
+        memset(&lk, 0, sizeof(lk));
+        lk.l_type = F_WRLCK;    /* whole file */
+        lk.l_whence = SEEK_SET;
+        if (fcntl(fd, F_SETLKW, &lk) == 0 && (fp = fdopen(fd, "r+")) != NULL) {
+            if (fscanf(fp, "%lu %lu", &h, &m) == 2)
+                hit += h, miss += m;
+            rewind(fp);    /* never shorter than before */
+            fprintf(fp, "%lu %lu\n", hit, miss);
+            fclose(fp);    /* releases lock */
+        } else
+            close(fd);
+    }
+    if (flagv)
+        fprintf(stderr, "%s: cache: %d hit(s), %d miss(es); %lu hit(s), %lu miss(es) in total\n",
+                prgname, nhit, nmiss, hit, miss);
+}
+
+
+/*
+ *  composes a command for a file
+ */
+static char **command(const char *a[], dlist_t *opt, const char *in, const char *out)
+{
+    char **arg;
     dlist_t *d1, *d2;
-    const char *bn, *outn;
 
-    assert(f);
+    arg = compose(a, opt, (d1=dlist_list((void *)in, NULL)), (d2=dlist_list((void *)out, NULL)));
+    dlist_free(&d1);
+    dlist_free(&d2);
 
-    if (f[0] == '-') {
-        if (!exist(f))
-            error(1, "failed to read file: %s", f);
-        bn = "stdin";
-        t = TC;
-    } else {
-        bn = basename(f, DSEP);
-        t = type(extname(f, DSEP));
+    return arg;
+}
+
+
+#ifdef HAVE_SOCKET
+/*
+ *  starts the compile server;
+ *  files are compiled by separate processes if failed
+ */
+static void startsrv(void)
+{
+    char c, *p;
+    char **arg;
+    size_t n = 256;
+    int in[2], out[2];
+
+    if (flagv > 1)
+        return;
+    while (!getcwd(p = ARENA_ALLOC(strg, n), n))
+        if (errno == ERANGE)
+            n *= 2;
+        else
+            return;
+    srv.cwd = p;
+    srv.sock = ncat(TMP_DIR, "bcc", pid(), ".sock");
+
+    dlist_addtail(ls[LC], (void *)ncat("--server=", srv.sock, "", ""));
+    arg = command(beluga, ls[LC], "-", "-");
+    dlist_remtail(ls[LC]);
+    dlist_addtail(ls[LR], (void *)srv.sock);
+
+    if (pipe(in) < 0 || pipe(out) < 0)
+        error(1, "failed to create pipe");
+    fcntl(in[0], F_SETFD, FD_CLOEXEC);
+    fcntl(in[1], F_SETFD, FD_CLOEXEC);
+    fcntl(out[0], F_SETFD, FD_CLOEXEC);
+    fcntl(out[1], F_SETFD, FD_CLOEXEC);
+    srv.pid = spawn(arg, in[0], out[1], NULL);
+    srv.fd = in[1];
+    close(in[0]);
+    close(out[1]);
+    if (read(out[0], &c, 1) != 1) {    /* not ready */
+        stopsrv();
+        error(0, "failed to start compile server; compiling files separately");
+    }
+    close(out[0]);
+}
+
+
+/*
+ *  hands a file to the compile server with descriptors for the standard streams;
+ *  the process created exits with the exit code from the compiler
+ */
+static pid_t request(char *arg[], const char *in, const char *out, int ofd, FILE *log)
+{
+    int s, fd[3];
+    ssize_t r;
+    size_t len;
+    pid_t pid;
+    char *m;
+    unsigned char st;
+    struct iovec v;
+    struct msghdr h;
+    struct sockaddr_un a;
+    union {
+        struct cmsghdr h;
+        char b[CMSG_SPACE(sizeof(fd))];
+    } u;
+
+    assert(arg);
+    assert(in);
+    assert(out);
+    assert(srv.sock);
+
+    fflush(NULL);
+    if ((pid = fork()) < 0)
+        error(1, "failed to create process");
+    else if (pid == 0) {    /* child */
+        if (log)
+            dup2(fileno(log), 2);
+        if (strcmp(in, "-") == 0)
+            in = "";
+        if (strcmp(out, "-") == 0)
+            out = "";
+        len = strlen(srv.cwd)+1 + strlen(in)+1 + strlen(out)+1;
+        m = ARENA_ALLOC(strg, len);
+        sprintf(m, "%s%c%s%c%s", srv.cwd, '\0', in, '\0', out);
+        fd[0] = 0;
+        fd[1] = (ofd >= 0)? ofd: 1;
+        fd[2] = 2;
+
+        memset(&a, 0, sizeof(a));
+        a.sun_family = AF_UNIX;
+        strcpy(a.sun_path, srv.sock);
+        memset(&h, 0, sizeof(h));
+        v.iov_base = m;
+        v.iov_len = len;
+        h.msg_iov = &v;
+        h.msg_iovlen = 1;
+        h.msg_control = u.b;
+        h.msg_controllen = sizeof(u.b);
+        CMSG_FIRSTHDR(&h)->cmsg_level = SOL_SOCKET;
+        CMSG_FIRSTHDR(&h)->cmsg_type = SCM_RIGHTS;
+        CMSG_FIRSTHDR(&h)->cmsg_len = CMSG_LEN(sizeof(fd));
+        memcpy(CMSG_DATA(CMSG_FIRSTHDR(&h)), fd, sizeof(fd));
+
+        if ((s = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+            connect(s, (struct sockaddr *)&a, sizeof(a)) < 0 || (r = sendmsg(s, &h, 0)) < 0) {
+            error(0, "failed to connect to compile server");
+            _exit(EXIT_FAILURE);
+        }
+        for (len -= r, m += r; len > 0; len -= r, m += r)
+            if ((r = write(s, m, len)) <= 0)
+                _exit(EXIT_FAILURE);
+        while ((r = read(s, &st, 1)) < 0 && errno == EINTR)
+            continue;
+        _exit((r == 1)? st: EXIT_FAILURE);
     }
 
-    switch(t) {
+    return pid;
+}
+#endif    /* HAVE_SOCKET */
+
+
+/* where diagnostics from the compiler go */
+#define ERRF(j) (((j)->diag)? (j)->diag: (j)->log)
+
+/*
+ *  starts the compiler and the assembler connected by a pipe
+ */
+static void startpipe(struct job *j)
+{
+    int fd[2];
+    char **arg[2];
+
+    assert(j);
+
+    j->outn = objname(j);
+    arg[0] = command(beluga, ls[LC], j->f, "-");
+    arg[1] = command(as, ls[LS], "-", j->outn);
+    j->cmd[0] = arg[0][0];
+    j->cmd[1] = arg[1][0];
+
+    if (pipe(fd) < 0)
+        error(1, "failed to create pipe");
+    fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+    if (flagv) {    /* before the compiler writes to stderr */
+        vout((j->log)? j->log: stderr, arg[0]);
+        vout((j->log)? j->log: stderr, arg[1]);
+    }
+#ifdef HAVE_SOCKET
+    if (srv.sock)
+        j->pid[0] = request(arg[0], j->f, "-", fd[1], ERRF(j));
+    else
+#endif    /* HAVE_SOCKET */
+    j->pid[0] = execute(arg[0], -1, fd[1], ERRF(j));
+    close(fd[1]);    /* lets assembler see EOF */
+    j->pid[1] = execute(arg[1], fd[0], -1, j->log);
+    close(fd[0]);
+}
+
+
+/*
+ *  starts the next command for a file;
+ *  returns false if no command left
+ */
+static int start(struct job *j)
+{
+    char **arg;
+
+    assert(j);
+
+    j->ok = 1;
+    switch(j->t) {
         case TH:
         case TC:
-            outn = (!flagE && !flagS)? ncat(TMP_DIR, bn, pid(), ".s"):
-                   (outfile)? outfile:
-                   (flagE)? "-": ncat("", bn, "", ".s");
-            ok = run(compose(beluga, ls[LC], (d1=dlist_list((void *)f, NULL)),
-                             (d2=dlist_list((void *)outn, NULL))));
-            dlist_free(&d1);
-            dlist_free(&d2);
-            if ((flagE || flagS) && ok)
-                break;
-            if (!(outn[0] == '-' && outn[1] == '\0'))
-                dlist_addtail(ls[LR], (void *)outn);
-            if (!ok)
+            if (cachedir && !j->keyed && !(flagE || flagt)) {
+                j->keyed = 1;
+                j->outn = tmpname(j, ".key");
+                dlist_addtail(ls[LC], "--cache-key");
+                arg = command(beluga, ls[LC], j->f, j->outn);
+                dlist_remtail(ls[LC]);
                 break;
-            f = outn;
-            /* no break */
+            }
+            if (j->key && (j->diag = tmpfile()) == NULL)
+                error(1, "failed to create temporary file");
+            j->direct = (flagi && !(flagE || flagS));
+            if ((j->piped = !(flagE || flagS || flagt || flagi)) != 0) {
+                startpipe(j);
+                return 1;
+            }
+            j->outn = (j->direct)? objname(j):
+                      (!flagE && !flagS)? tmpname(j, ".s"):
+                      (outfile)? outfile:
+                      (flagE)? "-": ncat("", j->bn, "", ".s");
+            arg = command(beluga, ls[LC], j->f, j->outn);
+#ifdef HAVE_SOCKET
+            if (srv.sock) {
+                j->cmd[0] = arg[0];
+                if (flagv)
+                    vout((j->log)? j->log: stderr, arg);
+                j->pid[0] = request(arg, j->f, j->outn, -1, ERRF(j));
+                return 1;
+            }
+#endif    /* HAVE_SOCKET */
+            break;
         case TS:
             if (flagE || flagS)
-                break;
-            outn = (!flagc)? ncat(TMP_DIR, bn, pid(), ".o"):
-                   (outfile)? outfile: ncat("", bn, "", ".o");
-            ok = run(compose(as, ls[LS], (d1=dlist_list((void *)f, NULL)),
-                             (d2=dlist_list((void *)outn, NULL))));
-            dlist_free(&d1);
-            dlist_free(&d2);
+                return 0;
+            j->outn = objname(j);
+            arg = command(as, ls[LS], j->f, j->outn);
+            break;
+        default:
+            return 0;
+    }
+    j->cmd[0] = arg[0];
+    j->pid[0] = spawn(arg, -1, -1, ERRF(j));
+
+    return 1;
+}
+
+
+/*
+ *  handles the result of a command for a file;
+ *  returns false if no more command to run
+ */
+static int finish(struct job *j, int ok)
+{
+    assert(j);
+    assert(j->outn);
+
+    switch(j->t) {
+        case TH:
+        case TC:
+            if (j->keyed == 1) {    /* cache key computed */
+                j->keyed = 2;
+                dlist_addtail(ls[LR], (void *)j->outn);
+                if (!ok)
+                    return 0;
+                if (!cached(j)) {
+                    nmiss++;
+                    return 1;    /* runs compiler */
+                }
+                nhit++;
+                if (flagS || flagc)
+                    return 0;
+                dlist_addtail(ls[LR], (void *)j->outn);
+                j->t = TO;
+                j->f = j->outn;
+                return 1;
+            }
+            if (j->diag)
+                putdiag(j);
+            if (j->piped || j->direct) {    /* assembler run together or not needed */
+                j->t = TS;
+                return finish(j, ok);
+            }
+            if ((flagE || flagS) && ok) {
+                if (flagS)
+                    store(j);
+                return 0;
+            }
+            if (!(j->outn[0] == '-' && j->outn[1] == '\0') && !(flagt && ok))
+                dlist_addtail(ls[LR], (void *)j->outn);
+            if (!ok)
+                return 0;
+            j->t = TS;
+            break;
+        case TS:
+            if (ok)
+                store(j);
             if (flagc && ok)
-                break;
-            dlist_addtail(ls[LR], (void *)outn);
+                return 0;
+            if (!(flagt && ok))
+                dlist_addtail(ls[LR], (void *)j->outn);
             if (!ok)
-                break;
-            f = outn;
-            /* no break */
-        case TO:
-        case -1:
-            if (flagE || flagS || flagc) {
-                error(0, "ignored linker input file: %s", f);
-                break;
-            }
-            if (!findlli(f))
-                dlist_addtail(ls[LLI], (void *)f);
+                return 0;
+            j->t = TO;
             break;
         default:
             assert(!"invalid file type -- should never reach here");
             break;
     }
+    j->f = j->outn;
+
+    return 1;
+}
+
+
+/*
+ *  runs commands for a file until one is left running
+ */
+static void advance(struct job *j)
+{
+    assert(j);
+
+    while (start(j)) {
+        if (j->pid[0] > 0 || j->pid[1] > 0)
+            return;
+        if (!finish(j, 1))    /* not actually run */
+            break;
+    }
+    j->done = 1;
 }
 
 
 #define INPUT(p) ((p)[0] != '-' || (p)[1] == '\0')
 
+/*
+ *  prepares to process a file
+ */
+static void prepare(struct job *j, int i, int redir)
+{
+    char *p;
+
+    assert(j);
+    assert(j->f);
+
+    if (!INPUT(j->f)) {
+        assert(j->f[1] == 'l');
+        j->done = 1;
+        return;
+    }
+
+    if (j->f[0] == '-') {
+        if (!exist(j->f))
+            error(1, "failed to read file: %s", j->f);
+        j->bn = "stdin";
+        j->t = TC;
+    } else {
+        j->bn = basename(j->f, DSEP);
+        j->t = type(extname(j->f, DSEP));
+    }
+
+    p = ARENA_ALLOC(strg, strlen(pid()) + 1 + (sizeof(int)*CHAR_BIT+2)/3 + 1);
+    sprintf(p, "%s-%d", pid(), i);
+    j->id = p;
+    if (redir && (j->t == TH || j->t == TC || j->t == TS) && (j->log = tmpfile()) == NULL)
+        error(1, "failed to create temporary file");
+}
+
+
+/*
+ *  completes processing a file;
+ *  prints diagnostics kept and hands output over to the linker
+ */
+static void complete(struct job *j)
+{
+    int c;
+
+    assert(j);
+    assert(j->done);
+
+    if (j->log) {
+        rewind(j->log);
+        while ((c = getc(j->log)) != EOF)
+            putc(c, stderr);
+        fclose(j->log);
+        j->log = NULL;
+    }
+
+    if (!INPUT(j->f))
+        dlist_addtail(ls[LLI], (void *)j->f);
+    else if (j->t == TO || j->t == -1) {
+        if (flagE || flagS || flagc)
+            error(0, "ignored linker input file: %s", j->f);
+        else if (!findlli(j->f))
+            dlist_addtail(ls[LLI], (void *)j->f);
+    }
+}
+
+
+/*
+ *  processes files running up to njob commands concurrently;
+ *  diagnostics from commands are kept per file and printed in the order of files;
+ *  starts no more commands once one is terminated by a signal
+ */
+static void process(struct job job[], int n)
+{
+    int i, k, st;
+    int next = 0, done = 0, running = 0;
+    pid_t p;
+    struct job *j;
+
+    assert(job);
+    assert(njob > 0);
+
+    while (done < n) {
+        for (; !killed && running < njob && next < n; next++) {
+            j = &job[next];
+            prepare(j, next, (njob > 1 && n > 1));
+            if (!j->done) {
+                advance(j);
+                if (!j->done)
+                    running++;
+            }
+        }
+        for (; done < n && job[done].done; done++)
+            complete(&job[done]);
+        if (done == n || (killed && running == 0))
+            break;
+
+        assert(running > 0);
+        if ((p = waitpid(-1, &st, 0)) < 0)
+            error(1, "failed to manage processes");
+        for (i = 0; i < next && job[i].pid[0] != p && job[i].pid[1] != p; i++)
+            continue;
+        if (i == next)    /* not ours */
+            continue;
+        j = &job[i];
+        k = (j->pid[0] == p)? 0: 1;
+        j->pid[k] = 0;
+        if (!status(st, j->cmd[k]))
+            j->ok = 0;
+        if (j->pid[0] > 0 || j->pid[1] > 0)    /* other end of pipe running */
+            continue;
+        if (j->log)
+            fseek(j->log, 0, SEEK_END);
+        if (finish(j, j->ok) && !killed)
+            advance(j);
+        else
+            j->done = 1;
+        if (j->done)
+            running--;
+    }
+}
+
+
 /*
  *  main function
  */
@@ -1070,19 +1803,32 @@ int main(int argc, char **argv)
         outfile = NULL;
     }
 
+    if (bdir)
+        beluga[0] = ncat(bdir, xstr(DIR_SEPARATOR), "beluga", "");
+    if (flagi && !(flagE || flagS))
+        dlist_addtail(ls[LC], "--object");
+
+    if (njob == 0)
+        njob = ncpu();
+    if (flagE)    /* output to stdout */
+        njob = 1;
+#ifdef HAVE_SOCKET
+    if (flagw)
+        startsrv();
+#endif    /* HAVE_SOCKET */
+    if (cachedir)
+        mkdir(cachedir, 0777);    /* benign if exists */
+
     {    /* proceeds before linking */
+        struct job *job;
+
         n = dlist_length(ls[LI]);
         if (n == 0)
             error(1, "no input files");
-        for (i = 0; i < n; i++) {
-            p = dlist_get(ls[LI], i);
-            if (INPUT(p))
-                process(p);
-            else {
-                assert(p[1] == 'l');
-                dlist_addtail(ls[LLI], (void *)p);
-            }
-        }
+        job = ARENA_CALLOC(strg, n, sizeof(*job));
+        for (i = 0; i < n; i++)
+            job[i].f = dlist_get(ls[LI], i);
+        process(job, n);
     }
 
     if (!(ecnt > 0 || flagE || flagS || flagc)) {    /* invokes linker */
@@ -1095,6 +1841,8 @@ int main(int argc, char **argv)
         dlist_free(&l);
     }
 
+    if (cachedir)
+        cachestat();
     clean();
 
     return (ecnt == 0)? 0: EXIT_FAILURE;
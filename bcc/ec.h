@@ -0,0 +1,710 @@
+#define EP_INPUT_ERROR 0
+#define EP_INPUT_EMPTYFILE 1
+#define EP_INPUT_NOTENDNL 2
+#define EP_INPUT_BSNLEOF 3
+#define EP_INPUT_BSSPACENL 4
+#define EP_INPUT_LONGLINE 5
+#define EP_INPUT_LONGLINESTD 6
+#define EP_INPUT_EMBEDNUL 7
+#define EP_INPUT_CONVFAIL 8
+#define EP_INPUT_TRIGRAPH 9
+#define EP_INPUT_TRIGRAPHI 10
+#define EP_PP_UNKNOWNDIR 11
+#define EP_PP_SPHTDIREC 12
+#define EP_PP_EXTRATOKEN 13
+#define EP_PP_EXTRATOKENCL 14
+#define EP_PP_NOHEADER 15
+#define EP_PP_NOINCFILE 16
+#define EP_PP_MANYINC 17
+#define EP_PP_MANYINCW 18
+#define EP_PP_MANYINCSTD 19
+#define EP_PP_COMBINEHDR 20
+#define EP_PP_NOMCRID 21
+#define EP_PP_MCRREDEF 22
+#define EP_PP_PMCRREDEF 23
+#define EP_PP_PMCRUNDEF 24
+#define EP_PP_UNDEFMCR 25
+#define EP_PP_ELLSEEN 26
+#define EP_PP_VAARGS 27
+#define EP_PP_VARIADIC 28
+#define EP_PP_NOPNAME 29
+#define EP_PP_NOPRPAREN 30
+#define EP_PP_NOSPACE 31
+#define EP_PP_NOEQCL 32
+#define EP_PP_DUPNAME 33
+#define EP_PP_MANYPARAM 34
+#define EP_PP_MANYPSTD 35
+#define EP_PP_MANYPPID 36
+#define EP_PP_MANYPPIDSTD 37
+#define EP_PP_DSHARPPOS 38
+#define EP_PP_TWODSHARP 39
+#define EP_PP_NEEDPARAM 40
+#define EP_PP_EMPTYARG 41
+#define EP_PP_DIRECINARG 42
+#define EP_PP_UNTERMARG 43
+#define EP_PP_MANYARG 44
+#define EP_PP_MANYARGW 45
+#define EP_PP_MANYARGSTD 46
+#define EP_PP_INSUFFARG 47
+#define EP_PP_ARGTOVAARGS 48
+#define EP_PP_INVTOKMADE 49
+#define EP_PP_EMPTYTOKMADE 50
+#define EP_PP_INVSTRMADE 51
+#define EP_PP_ORDERSDS 52
+#define EP_PP_ORDERDS 53
+#define EP_PP_ORDERDSEX 54
+#define EP_PP_UNUSEDMCR 55
+#define EP_PP_MANYCOND 56
+#define EP_PP_MANYCONDSTD 57
+#define EP_PP_UNTERMCOND 58
+#define EP_PP_NOMATCHIF 59
+#define EP_PP_ELIFAFTRELSE 60
+#define EP_PP_DUPELSE 61
+#define EP_PP_ELSEHERE 62
+#define EP_PP_NOIFEXPR 63
+#define EP_PP_NOIFID 64
+#define EP_PP_ILLOP 65
+#define EP_PP_ILLOPW 66
+#define EP_PP_DEFFROMMCR 67
+#define EP_PP_MCRDEF 68
+#define EP_PP_NODEFID 69
+#define EP_PP_NODEFRPAREN 70
+#define EP_PP_ILLEXPR 71
+#define EP_PP_NOEXPRLPAREN 72
+#define EP_PP_EXPRERR 73
+#define EP_PP_OVFCONST 74
+#define EP_PP_NEGTOUNSIGN 75
+#define EP_PP_INVESC 76
+#define EP_PP_INVESCNP 77
+#define EP_PP_EXPRUNDEFID 78
+#define EP_PP_ERROR 79
+#define EP_PP_ERRORF 80
+#define EP_PP_WARNING 81
+#define EP_PP_NOSTDDIRECTIVE 82
+#define EP_PP_UNKNOWNPRAGMA 83
+#define EP_PP_LARGELINE 84
+#define EP_PP_ZEROLINE 85
+#define EP_PP_NOLINENO 86
+#define EP_PP_ILLLINENO 87
+#define EP_PP_ILLFNAME 88
+#define EP_PP_EMPTYHDR 89
+#define EP_PP_EXPFROM 90
+#define EP_CONST_LONGSTR 91
+#define EP_CONST_LONGSTRSTD 92
+#define EP_CONST_LARGECHAR 93
+#define EP_CONST_EMPTYCHAR 94
+#define EP_CONST_MBWIDE 95
+#define EP_CONST_MBWIDESTD 96
+#define EP_CONST_WIDENOTFIT 97
+#define EP_CONST_MBNOTFIT 98
+#define EP_CONST_LARGEOCT 99
+#define EP_CONST_LARGEHEX 100
+#define EP_CONST_PPNUMSFX 101
+#define EP_CONST_NOEXPDIG 102
+#define EP_CONST_LARGEFP 103
+#define EP_CONST_TRUNCFP 104
+#define EP_CONST_LARGEINT 105
+#define EP_CONST_LARGEUNSIGN 106
+#define EP_CONST_UNSIGNINC90 107
+#define EP_CONST_LLONGINC90 108
+#define EP_CONST_ILLOCTESC 109
+#define EP_CONST_ESCOCT89 110
+#define EP_CONST_ESCOCT3DIG 111
+#define EP_LEX_UNCLOSESTR 112
+#define EP_LEX_UNCLOSEHDR 113
+#define EP_LEX_UNCLOSECMT 114
+#define EP_LEX_BSNLINCMT 115
+#define EP_LEX_C99CMT 116
+#define EP_LEX_CMTINCMT 117
+#define EP_LEX_UNKNOWN 118
+#define EP_LEX_STRAYWS 119
+#define EP_LEX_STRAYBS 120
+#define EP_LEX_LONGID 121
+#define EP_LEX_LONGEID 122
+#define EP_LEX_SEEID 123
+#define EP_LEX_LONGIDSTD 124
+#define EP_LEX_EXTRACOMMA 125
+#define EP_PARSE_TOMATCH 126
+#define EP_PARSE_ERROR 127
+#define EP_PARSE_MANYBID 128
+#define EP_PARSE_MANYBIDSTD 129
+#define EP_PARSE_BLOCKSTART 130
+#define EP_PARSE_CLSFIRST 131
+#define EP_PARSE_CLS 132
+#define EP_PARSE_INVUSE 133
+#define EP_PARSE_DEFINT 134
+#define EP_PARSE_DEFINTSTD 135
+#define EP_PARSE_LLONGINC90 136
+#define EP_PARSE_INVCLS 137
+#define EP_PARSE_INVCLSID 138
+#define EP_PARSE_REDECL 139
+#define EP_PARSE_REDECLW 140
+#define EP_PARSE_REDECLTY 141
+#define EP_PARSE_REDECLTYW 142
+#define EP_PARSE_HIDEID 143
+#define EP_PARSE_PREVDECL 144
+#define EP_PARSE_PREVDEF 145
+#define EP_PARSE_DECLHERE 146
+#define EP_PARSE_DEFHERE 147
+#define EP_PARSE_NOINIT 148
+#define EP_PARSE_VOIDID 149
+#define EP_PARSE_VOIDALONE 150
+#define EP_PARSE_ELLSEEN 151
+#define EP_PARSE_ELLALONE 152
+#define EP_PARSE_QUALVOID 153
+#define EP_PARSE_NOPTYPE 154
+#define EP_PARSE_PARAMID 155
+#define EP_PARSE_EXTRAID 156
+#define EP_PARSE_INVARRSIZE 157
+#define EP_PARSE_REDEF 158
+#define EP_PARSE_INVLINK 159
+#define EP_PARSE_INVLINKW 160
+#define EP_PARSE_MANYEID 161
+#define EP_PARSE_MANYEIDSTD 162
+#define EP_PARSE_INCOMPTYPE 163
+#define EP_PARSE_NODECLSPEC 164
+#define EP_PARSE_EMPTYDECL 165
+#define EP_PARSE_DECLPARAM 166
+#define EP_PARSE_NOUSECLS 167
+#define EP_PARSE_INVDECL 168
+#define EP_PARSE_INVDCLSTMT 169
+#define EP_PARSE_INVTYPE 170
+#define EP_PARSE_TYPEDEFF 171
+#define EP_PARSE_EXTRAPARAM 172
+#define EP_PARSE_NOPROTO 173
+#define EP_PARSE_NOID 174
+#define EP_PARSE_MANYPARAM 175
+#define EP_PARSE_MANYPSTD 176
+#define EP_PARSE_INCOMPRET 177
+#define EP_PARSE_NOPARAM 178
+#define EP_PARSE_PARAMMATCH 179
+#define EP_PARSE_NOPARAMID 180
+#define EP_PARSE_INCOMPARAM 181
+#define EP_PARSE_ENUMID 182
+#define EP_PARSE_ENUMOVER 183
+#define EP_PARSE_MANYEC 184
+#define EP_PARSE_MANYECSTD 185
+#define EP_PARSE_ENUMCOMMA 186
+#define EP_PARSE_ENUMSEMIC 187
+#define EP_PARSE_INVBITTYPE 188
+#define EP_PARSE_INVBITSIZE 189
+#define EP_PARSE_NOFNAME 190
+#define EP_PARSE_INCOMPMEM 191
+#define EP_PARSE_INVFTYPE 192
+#define EP_PARSE_MANYMBR 193
+#define EP_PARSE_MANYMBRSTD 194
+#define EP_PARSE_ANONYTAG 195
+#define EP_PARSE_INVFIELD 196
+#define EP_PARSE_NOFIELD 197
+#define EP_PARSE_NOTAG 198
+#define EP_PARSE_REFSTATIC 199
+#define EP_PARSE_REFPARAM 200
+#define EP_PARSE_REFLOCAL 201
+#define EP_PARSE_SETNOREFS 202
+#define EP_PARSE_SETNOREFP 203
+#define EP_PARSE_SETNOREFL 204
+#define EP_PARSE_UNDSTATIC 205
+#define EP_PARSE_ENUMINT 206
+#define EP_PARSE_INITCONST 207
+#define EP_PARSE_INVINIT 208
+#define EP_PARSE_INVFLDINIT 209
+#define EP_PARSE_BIGFLDINIT 210
+#define EP_PARSE_INCOMINIT 211
+#define EP_PARSE_NOBRACE 212
+#define EP_PARSE_EXTRABRACE 213
+#define EP_PARSE_MANYINIT 214
+#define EP_PARSE_INVMBINIT 215
+#define EP_PARSE_INVWINIT 216
+#define EP_PARSE_MANYPD 217
+#define EP_PARSE_MANYPDSTD 218
+#define EP_PARSE_MANYPE 219
+#define EP_PARSE_MANYPESTD 220
+#define EP_PARSE_MANYSTR 221
+#define EP_PARSE_MANYSTRSTD 222
+#define EP_PARSE_MIXDCLSTMT 223
+#define EP_PARSE_UNUSEDINIT 224
+#define EP_PARSE_ATAGPARAM 225
+#define EP_PARSE_PINTFLD 226
+#define EP_PARSE_MIXPROTO 227
+#define EP_PARSE_QUALFRET 228
+#define EP_PARSE_VOIDOBJ 229
+#define EP_PARSE_MANYDECL 230
+#define EP_PARSE_MANYDECLSTD 231
+#define EP_PARSE_NODCLR 232
+#define EP_PARSE_UNKNOWNTY 233
+#define EP_EXPR_SKIPREF 234
+#define EP_EXPR_SKIPVOLREF 235
+#define EP_EXPR_SIZEOFFUNC 236
+#define EP_EXPR_SIZEOFINC 237
+#define EP_EXPR_SIZEOFBIT 238
+#define EP_EXPR_PTRINT 239
+#define EP_EXPR_FPTROPTR 240
+#define EP_EXPR_INVCASTSS 241
+#define EP_EXPR_INVCAST 242
+#define EP_EXPR_NOID 243
+#define EP_EXPR_IMPLDECL 244
+#define EP_EXPR_IMPLDECLSTD 245
+#define EP_EXPR_ILLTYPEDEF 246
+#define EP_EXPR_ILLEXPR 247
+#define EP_EXPR_NEEDLVALUE 248
+#define EP_EXPR_ADDRFLD 249
+#define EP_EXPR_ADDRREG 250
+#define EP_EXPR_ATOPREG 251
+#define EP_EXPR_NLVALARR 252
+#define EP_EXPR_NEGUNSIGNED 253
+#define EP_EXPR_ASGNCONST 254
+#define EP_EXPR_CONDTYPE 255
+#define EP_EXPR_NOFUNC 256
+#define EP_EXPR_NOMEMBER 257
+#define EP_EXPR_NOSTRUCT 258
+#define EP_EXPR_NOSTRUCTP 259
+#define EP_EXPR_NOSTRUCTPTY 260
+#define EP_EXPR_UNKNOWNMEM 261
+#define EP_EXPR_RETINCOMP 262
+#define EP_EXPR_ARGNOTMATCH 263
+#define EP_EXPR_INCOMPARG 264
+#define EP_EXPR_POINTER 265
+#define EP_EXPR_EXTRAARG 266
+#define EP_EXPR_MANYARG 267
+#define EP_EXPR_MANYARGSTD 268
+#define EP_EXPR_INSUFFARG 269
+#define EP_EXPR_UNKNOWNSIZE 270
+#define EP_EXPR_ASGNENUMPTR 271
+#define EP_EXPR_ASGNINCOMP 272
+#define EP_EXPR_BINOPERR 273
+#define EP_EXPR_UNIOPERR 274
+#define EP_EXPR_ILLTYPE 275
+#define EP_EXPR_OVFCONSTFP 276
+#define EP_EXPR_OVFCONST 277
+#define EP_EXPR_OVFCONV 278
+#define EP_EXPR_NOINTCONST 279
+#define EP_EXPR_NOINTCONSTW 280
+#define EP_EXPR_INVINITCE 281
+#define EP_EXPR_LARGEVAL 282
+#define EP_EXPR_OVERSHIFT 283
+#define EP_EXPR_OVERSHIFTS 284
+#define EP_EXPR_OVERSHIFTU 285
+#define EP_EXPR_LSHIFTNEG 286
+#define EP_EXPR_RSHIFTNEG 287
+#define EP_EXPR_DIVBYZERO 288
+#define EP_EXPR_UNSIGNEDCMP 289
+#define EP_EXPR_SYMBOLTRUE 290
+#define EP_EXPR_NOEFFECT 291
+#define EP_EXPR_VOIDLVALUES 292
+#define EP_EXPR_VOIDLVALUENS 293
+#define EP_EXPR_BIGFLD 294
+#define EP_EXPR_VALNOTUSED 295
+#define EP_EXPR_CHARSUBSCR 296
+#define EP_EXPR_DEREFINCOMP 297
+#define EP_EXPR_NEEDPAREN 298
+#define EP_EXPR_ASGNTRUTH 299
+#define EP_TYPE_ARRFUNC 300
+#define EP_TYPE_ARRINCOMP 301
+#define EP_TYPE_ARRVOID 302
+#define EP_TYPE_BIGARR 303
+#define EP_TYPE_BIGARRSTD 304
+#define EP_TYPE_QUALFUNC 305
+#define EP_TYPE_DUPQUAL 306
+#define EP_TYPE_DUPQUALDCLR 307
+#define EP_TYPE_FUNCARR 308
+#define EP_TYPE_FUNCFUNC 309
+#define EP_TYPE_STRREDEF 310
+#define EP_TYPE_DIFFTAG 311
+#define EP_TYPE_STRDUPMEM 312
+#define EP_TYPE_STRAMBMEM 313
+#define EP_TYPE_SEEMEMBER 314
+#define EP_TYPE_INVENUM 315
+#define EP_TYPE_ERRPROTO 316
+#define EP_TYPE_BIGOBJ 317
+#define EP_TYPE_BIGOBJADJ 318
+#define EP_STMT_INFLOOP 319
+#define EP_STMT_HUGETABLE 320
+#define EP_STMT_SWTCHNOINT 321
+#define EP_STMT_SWTCHNOCASE 322
+#define EP_STMT_DUPCASES 323
+#define EP_STMT_DUPCASEU 324
+#define EP_STMT_MANYCASE 325
+#define EP_STMT_MANYCASESTD 326
+#define EP_STMT_DUPLABEL 327
+#define EP_STMT_ILLRETTYPE 328
+#define EP_STMT_RETLOCAL 329
+#define EP_STMT_UNREACHABLE 330
+#define EP_STMT_MANYNEST 331
+#define EP_STMT_MANYNESTSTD 332
+#define EP_STMT_ILLBREAK 333
+#define EP_STMT_ILLCONTINUE 334
+#define EP_STMT_INVCASE 335
+#define EP_STMT_INVDEFAULT 336
+#define EP_STMT_DUPDEFAULT 337
+#define EP_STMT_EXTRARETURN 338
+#define EP_STMT_NORETURN 339
+#define EP_STMT_NORETURNSTD 340
+#define EP_STMT_GOTONOLAB 341
+#define EP_STMT_INVELSE 342
+#define EP_STMT_ILLSTMT 343
+#define EP_STMT_STMTREQ 344
+#define EP_STMT_UNDEFLAB 345
+#define EP_STMT_UNUSEDLAB 346
+#define EP_STMT_LABELSTMT 347
+#define EP_STMT_AMBELSE 348
+#define EP_STMT_AMBELSEIF 349
+#define EP_STMT_EMPTYBODY 350
+#define EP_X86_FPREGSPILL 351
+#define EP_XTRA_ERRLIMIT 352
+#define EP_XTRA_ONCEFILE 353
+#define EP_XTRA_INVMAIN 354
+#define EC_INPUT_ERROR 0
+#define EC_INPUT_EMPTYFILE 1
+#define EC_INPUT_NOTENDNL 2
+#define EC_INPUT_BSNLEOF 3
+#define EC_INPUT_BSSPACENL 4
+#define EC_INPUT_LONGLINE 5
+#define EC_INPUT_LONGLINESTD 6
+#define EC_INPUT_EMBEDNUL 7
+#define EC_INPUT_CONVFAIL 8
+#define EC_INPUT_TRIGRAPH 9
+#define EC_INPUT_TRIGRAPHI 10
+#define EC_PP_UNKNOWNDIR 11
+#define EC_PP_SPHTDIREC 12
+#define EC_PP_EXTRATOKEN 13
+#define EC_PP_EXTRATOKENCL 14
+#define EC_PP_NOHEADER 15
+#define EC_PP_NOINCFILE 16
+#define EC_PP_MANYINC 17
+#define EC_PP_MANYINCW 18
+#define EC_PP_MANYINCSTD 19
+#define EC_PP_COMBINEHDR 20
+#define EC_PP_NOMCRID 21
+#define EC_PP_MCRREDEF 22
+#define EC_PP_PMCRREDEF 23
+#define EC_PP_PMCRUNDEF 24
+#define EC_PP_UNDEFMCR 25
+#define EC_PP_ELLSEEN 26
+#define EC_PP_VAARGS 27
+#define EC_PP_VARIADIC 28
+#define EC_PP_NOPNAME 29
+#define EC_PP_NOPRPAREN 30
+#define EC_PP_NOSPACE 31
+#define EC_PP_NOEQCL 32
+#define EC_PP_DUPNAME 33
+#define EC_PP_MANYPARAM 34
+#define EC_PP_MANYPSTD 35
+#define EC_PP_MANYPPID 36
+#define EC_PP_MANYPPIDSTD 37
+#define EC_PP_DSHARPPOS 38
+#define EC_PP_TWODSHARP 39
+#define EC_PP_NEEDPARAM 40
+#define EC_PP_EMPTYARG 41
+#define EC_PP_DIRECINARG 42
+#define EC_PP_UNTERMARG 43
+#define EC_PP_MANYARG 44
+#define EC_PP_MANYARGW 45
+#define EC_PP_MANYARGSTD 46
+#define EC_PP_INSUFFARG 47
+#define EC_PP_ARGTOVAARGS 48
+#define EC_PP_INVTOKMADE 49
+#define EC_PP_EMPTYTOKMADE 50
+#define EC_PP_INVSTRMADE 51
+#define EC_PP_ORDERSDS 52
+#define EC_PP_ORDERDS 53
+#define EC_PP_ORDERDSEX 54
+#define EC_PP_UNUSEDMCR 55
+#define EC_PP_MANYCOND 56
+#define EC_PP_MANYCONDSTD 57
+#define EC_PP_UNTERMCOND 58
+#define EC_PP_NOMATCHIF 59
+#define EC_PP_ELIFAFTRELSE 60
+#define EC_PP_DUPELSE 61
+#define EC_PP_ELSEHERE 62
+#define EC_PP_NOIFEXPR 63
+#define EC_PP_NOIFID 64
+#define EC_PP_ILLOP 65
+#define EC_PP_ILLOPW 66
+#define EC_PP_DEFFROMMCR 67
+#define EC_PP_MCRDEF 68
+#define EC_PP_NODEFID 69
+#define EC_PP_NODEFRPAREN 70
+#define EC_PP_ILLEXPR 71
+#define EC_PP_NOEXPRLPAREN 72
+#define EC_PP_EXPRERR 73
+#define EC_PP_OVFCONST 74
+#define EC_PP_NEGTOUNSIGN 75
+#define EC_PP_INVESC 76
+#define EC_PP_INVESCNP 77
+#define EC_PP_EXPRUNDEFID 78
+#define EC_PP_ERROR 79
+#define EC_PP_ERRORF 80
+#define EC_PP_WARNING 81
+#define EC_PP_NOSTDDIRECTIVE 82
+#define EC_PP_UNKNOWNPRAGMA 83
+#define EC_PP_LARGELINE 84
+#define EC_PP_ZEROLINE 85
+#define EC_PP_NOLINENO 86
+#define EC_PP_ILLLINENO 87
+#define EC_PP_ILLFNAME 88
+#define EC_PP_EMPTYHDR 89
+#define EC_PP_EXPFROM 90
+#define EC_CONST_LONGSTR 91
+#define EC_CONST_LONGSTRSTD 92
+#define EC_CONST_LARGECHAR 93
+#define EC_CONST_EMPTYCHAR 94
+#define EC_CONST_MBWIDE 95
+#define EC_CONST_MBWIDESTD 96
+#define EC_CONST_WIDENOTFIT 97
+#define EC_CONST_MBNOTFIT 98
+#define EC_CONST_LARGEOCT 99
+#define EC_CONST_LARGEHEX 100
+#define EC_CONST_PPNUMSFX 101
+#define EC_CONST_NOEXPDIG 102
+#define EC_CONST_LARGEFP 103
+#define EC_CONST_TRUNCFP 104
+#define EC_CONST_LARGEINT 105
+#define EC_CONST_LARGEUNSIGN 106
+#define EC_CONST_UNSIGNINC90 107
+#define EC_CONST_LLONGINC90 108
+#define EC_CONST_ILLOCTESC 109
+#define EC_CONST_ESCOCT89 110
+#define EC_CONST_ESCOCT3DIG 111
+#define EC_LEX_UNCLOSESTR 112
+#define EC_LEX_UNCLOSEHDR 113
+#define EC_LEX_UNCLOSECMT 114
+#define EC_LEX_BSNLINCMT 115
+#define EC_LEX_C99CMT 116
+#define EC_LEX_CMTINCMT 117
+#define EC_LEX_UNKNOWN 118
+#define EC_LEX_STRAYWS 119
+#define EC_LEX_STRAYBS 120
+#define EC_LEX_LONGID 121
+#define EC_LEX_LONGEID 122
+#define EC_LEX_SEEID 123
+#define EC_LEX_LONGIDSTD 124
+#define EC_LEX_EXTRACOMMA 125
+#define EC_PARSE_TOMATCH 126
+#define EC_PARSE_ERROR 127
+#define EC_PARSE_MANYBID 128
+#define EC_PARSE_MANYBIDSTD 129
+#define EC_PARSE_BLOCKSTART 130
+#define EC_PARSE_CLSFIRST 131
+#define EC_PARSE_CLS 132
+#define EC_PARSE_INVUSE 133
+#define EC_PARSE_DEFINT 134
+#define EC_PARSE_DEFINTSTD 135
+#define EC_PARSE_LLONGINC90 136
+#define EC_PARSE_INVCLS 137
+#define EC_PARSE_INVCLSID 138
+#define EC_PARSE_REDECL 139
+#define EC_PARSE_REDECLW 140
+#define EC_PARSE_REDECLTY 141
+#define EC_PARSE_REDECLTYW 142
+#define EC_PARSE_HIDEID 143
+#define EC_PARSE_PREVDECL 144
+#define EC_PARSE_PREVDEF 145
+#define EC_PARSE_DECLHERE 146
+#define EC_PARSE_DEFHERE 147
+#define EC_PARSE_NOINIT 148
+#define EC_PARSE_VOIDID 149
+#define EC_PARSE_VOIDALONE 150
+#define EC_PARSE_ELLSEEN 151
+#define EC_PARSE_ELLALONE 152
+#define EC_PARSE_QUALVOID 153
+#define EC_PARSE_NOPTYPE 154
+#define EC_PARSE_PARAMID 155
+#define EC_PARSE_EXTRAID 156
+#define EC_PARSE_INVARRSIZE 157
+#define EC_PARSE_REDEF 158
+#define EC_PARSE_INVLINK 159
+#define EC_PARSE_INVLINKW 160
+#define EC_PARSE_MANYEID 161
+#define EC_PARSE_MANYEIDSTD 162
+#define EC_PARSE_INCOMPTYPE 163
+#define EC_PARSE_NODECLSPEC 164
+#define EC_PARSE_EMPTYDECL 165
+#define EC_PARSE_DECLPARAM 166
+#define EC_PARSE_NOUSECLS 167
+#define EC_PARSE_INVDECL 168
+#define EC_PARSE_INVDCLSTMT 169
+#define EC_PARSE_INVTYPE 170
+#define EC_PARSE_TYPEDEFF 171
+#define EC_PARSE_EXTRAPARAM 172
+#define EC_PARSE_NOPROTO 173
+#define EC_PARSE_NOID 174
+#define EC_PARSE_MANYPARAM 175
+#define EC_PARSE_MANYPSTD 176
+#define EC_PARSE_INCOMPRET 177
+#define EC_PARSE_NOPARAM 178
+#define EC_PARSE_PARAMMATCH 179
+#define EC_PARSE_NOPARAMID 180
+#define EC_PARSE_INCOMPARAM 181
+#define EC_PARSE_ENUMID 182
+#define EC_PARSE_ENUMOVER 183
+#define EC_PARSE_MANYEC 184
+#define EC_PARSE_MANYECSTD 185
+#define EC_PARSE_ENUMCOMMA 186
+#define EC_PARSE_ENUMSEMIC 187
+#define EC_PARSE_INVBITTYPE 188
+#define EC_PARSE_INVBITSIZE 189
+#define EC_PARSE_NOFNAME 190
+#define EC_PARSE_INCOMPMEM 191
+#define EC_PARSE_INVFTYPE 192
+#define EC_PARSE_MANYMBR 193
+#define EC_PARSE_MANYMBRSTD 194
+#define EC_PARSE_ANONYTAG 195
+#define EC_PARSE_INVFIELD 196
+#define EC_PARSE_NOFIELD 197
+#define EC_PARSE_NOTAG 198
+#define EC_PARSE_REFSTATIC 199
+#define EC_PARSE_REFPARAM 200
+#define EC_PARSE_REFLOCAL 201
+#define EC_PARSE_SETNOREFS 202
+#define EC_PARSE_SETNOREFP 203
+#define EC_PARSE_SETNOREFL 204
+#define EC_PARSE_UNDSTATIC 205
+#define EC_PARSE_ENUMINT 206
+#define EC_PARSE_INITCONST 207
+#define EC_PARSE_INVINIT 208
+#define EC_PARSE_INVFLDINIT 209
+#define EC_PARSE_BIGFLDINIT 210
+#define EC_PARSE_INCOMINIT 211
+#define EC_PARSE_NOBRACE 212
+#define EC_PARSE_EXTRABRACE 213
+#define EC_PARSE_MANYINIT 214
+#define EC_PARSE_INVMBINIT 215
+#define EC_PARSE_INVWINIT 216
+#define EC_PARSE_MANYPD 217
+#define EC_PARSE_MANYPDSTD 218
+#define EC_PARSE_MANYPE 219
+#define EC_PARSE_MANYPESTD 220
+#define EC_PARSE_MANYSTR 221
+#define EC_PARSE_MANYSTRSTD 222
+#define EC_PARSE_MIXDCLSTMT 223
+#define EC_PARSE_UNUSEDINIT 224
+#define EC_PARSE_ATAGPARAM 225
+#define EC_PARSE_PINTFLD 226
+#define EC_PARSE_MIXPROTO 227
+#define EC_PARSE_QUALFRET 228
+#define EC_PARSE_VOIDOBJ 229
+#define EC_PARSE_MANYDECL 230
+#define EC_PARSE_MANYDECLSTD 231
+#define EC_PARSE_NODCLR 232
+#define EC_PARSE_UNKNOWNTY 233
+#define EC_EXPR_SKIPREF 234
+#define EC_EXPR_SKIPVOLREF 235
+#define EC_EXPR_SIZEOFFUNC 236
+#define EC_EXPR_SIZEOFINC 237
+#define EC_EXPR_SIZEOFBIT 238
+#define EC_EXPR_PTRINT 239
+#define EC_EXPR_FPTROPTR 240
+#define EC_EXPR_INVCASTSS 241
+#define EC_EXPR_INVCAST 242
+#define EC_EXPR_NOID 243
+#define EC_EXPR_IMPLDECL 244
+#define EC_EXPR_IMPLDECLSTD 245
+#define EC_EXPR_ILLTYPEDEF 246
+#define EC_EXPR_ILLEXPR 247
+#define EC_EXPR_NEEDLVALUE 248
+#define EC_EXPR_ADDRFLD 249
+#define EC_EXPR_ADDRREG 250
+#define EC_EXPR_ATOPREG 251
+#define EC_EXPR_NLVALARR 252
+#define EC_EXPR_NEGUNSIGNED 253
+#define EC_EXPR_ASGNCONST 254
+#define EC_EXPR_CONDTYPE 255
+#define EC_EXPR_NOFUNC 256
+#define EC_EXPR_NOMEMBER 257
+#define EC_EXPR_NOSTRUCT 258
+#define EC_EXPR_NOSTRUCTP 259
+#define EC_EXPR_NOSTRUCTPTY 260
+#define EC_EXPR_UNKNOWNMEM 261
+#define EC_EXPR_RETINCOMP 262
+#define EC_EXPR_ARGNOTMATCH 263
+#define EC_EXPR_INCOMPARG 264
+#define EC_EXPR_POINTER 265
+#define EC_EXPR_EXTRAARG 266
+#define EC_EXPR_MANYARG 267
+#define EC_EXPR_MANYARGSTD 268
+#define EC_EXPR_INSUFFARG 269
+#define EC_EXPR_UNKNOWNSIZE 270
+#define EC_EXPR_ASGNENUMPTR 271
+#define EC_EXPR_ASGNINCOMP 272
+#define EC_EXPR_BINOPERR 273
+#define EC_EXPR_UNIOPERR 274
+#define EC_EXPR_ILLTYPE 275
+#define EC_EXPR_OVFCONSTFP 276
+#define EC_EXPR_OVFCONST 277
+#define EC_EXPR_OVFCONV 278
+#define EC_EXPR_NOINTCONST 279
+#define EC_EXPR_NOINTCONSTW 280
+#define EC_EXPR_INVINITCE 281
+#define EC_EXPR_LARGEVAL 282
+#define EC_EXPR_OVERSHIFT 283
+#define EC_EXPR_OVERSHIFTS 284
+#define EC_EXPR_OVERSHIFTU 285
+#define EC_EXPR_LSHIFTNEG 286
+#define EC_EXPR_RSHIFTNEG 287
+#define EC_EXPR_DIVBYZERO 288
+#define EC_EXPR_UNSIGNEDCMP 289
+#define EC_EXPR_SYMBOLTRUE 290
+#define EC_EXPR_NOEFFECT 291
+#define EC_EXPR_VOIDLVALUES 292
+#define EC_EXPR_VOIDLVALUENS 293
+#define EC_EXPR_BIGFLD 294
+#define EC_EXPR_VALNOTUSED 295
+#define EC_EXPR_CHARSUBSCR 296
+#define EC_EXPR_DEREFINCOMP 297
+#define EC_EXPR_NEEDPAREN 298
+#define EC_EXPR_ASGNTRUTH 299
+#define EC_TYPE_ARRFUNC 300
+#define EC_TYPE_ARRINCOMP 301
+#define EC_TYPE_ARRVOID 302
+#define EC_TYPE_BIGARR 303
+#define EC_TYPE_BIGARRSTD 304
+#define EC_TYPE_QUALFUNC 305
+#define EC_TYPE_DUPQUAL 306
+#define EC_TYPE_DUPQUALDCLR 307
+#define EC_TYPE_FUNCARR 308
+#define EC_TYPE_FUNCFUNC 309
+#define EC_TYPE_STRREDEF 310
+#define EC_TYPE_DIFFTAG 311
+#define EC_TYPE_STRDUPMEM 312
+#define EC_TYPE_STRAMBMEM 313
+#define EC_TYPE_SEEMEMBER 314
+#define EC_TYPE_INVENUM 315
+#define EC_TYPE_ERRPROTO 316
+#define EC_TYPE_BIGOBJ 317
+#define EC_TYPE_BIGOBJADJ 318
+#define EC_STMT_INFLOOP 319
+#define EC_STMT_HUGETABLE 320
+#define EC_STMT_SWTCHNOINT 321
+#define EC_STMT_SWTCHNOCASE 322
+#define EC_STMT_DUPCASES 323
+#define EC_STMT_DUPCASEU 324
+#define EC_STMT_MANYCASE 325
+#define EC_STMT_MANYCASESTD 326
+#define EC_STMT_DUPLABEL 327
+#define EC_STMT_ILLRETTYPE 328
+#define EC_STMT_RETLOCAL 329
+#define EC_STMT_UNREACHABLE 330
+#define EC_STMT_MANYNEST 331
+#define EC_STMT_MANYNESTSTD 332
+#define EC_STMT_ILLBREAK 333
+#define EC_STMT_ILLCONTINUE 334
+#define EC_STMT_INVCASE 335
+#define EC_STMT_INVDEFAULT 336
+#define EC_STMT_DUPDEFAULT 337
+#define EC_STMT_EXTRARETURN 338
+#define EC_STMT_NORETURN 339
+#define EC_STMT_NORETURNSTD 340
+#define EC_STMT_GOTONOLAB 341
+#define EC_STMT_INVELSE 342
+#define EC_STMT_ILLSTMT 343
+#define EC_STMT_STMTREQ 344
+#define EC_STMT_UNDEFLAB 345
+#define EC_STMT_UNUSEDLAB 346
+#define EC_STMT_LABELSTMT 347
+#define EC_STMT_AMBELSE 348
+#define EC_STMT_AMBELSEIF 349
+#define EC_STMT_EMPTYBODY 350
+#define EC_X86_FPREGSPILL 351
+#define EC_XTRA_ERRLIMIT 352
+#define EC_XTRA_ONCEFILE 353
+#define EC_XTRA_INVMAIN 354
@@ -9,9 +9,16 @@ xx("E", "-E", NULL, NULL, NULL, "preprocess only; do not compile, assemble or li
 
 dd("c",  NULL,         "compile and assemble; do not link")
 dd("S",  NULL,         "compile only; do not assemble or link")
+dd("O",  "[<n>]",      "optimize at level <n>; 1 if <n> is omitted")
 dd("l",  " <library>", "link <library>")
 dd("o",  " <file>",    "place the output into <file>")
+dd("j",  " <n>",       "run up to <n> commands at once; # of online processors by default")
 dd("v",  NULL,         "show the programs invoked by bcc")
+dd("save-temps", NULL, "keep intermediate files in the current directory")
+dd("fintegrated-as", NULL, "write object files without running the assembler")
+dd("fcompile-server", NULL, "compile files in a server that keeps headers in memory")
+dd("fcache-dir", "=<dir>", "reuse output cached in <dir> for identical preprocessed files")
+dd("B",  "<dir>",      "run beluga found in <dir>")
 dd("Wp", ",<options>", "pass comma-separated options to the preprocessor")
 dd("Wc", ",<options>", "pass comma-separated options to the compiler")
 dd("Wa", ",<options>", "pass comma-separated options to the assembler")
@@ -2,7 +2,8 @@
  *  preprocessor
  */
 
-#include <stdio.h>         /* FILE, fputs, putc, fprintf */
+#include <stdio.h>         /* FILE, fwrite, fprintf */
+#include <string.h>        /* strlen, memcpy */
 #include <cbl/arena.h>     /* arena_t */
 #include <cbl/assert.h>    /* assert */
 
@@ -10,10 +11,17 @@
 #include "lex.h"
 #include "lmap.h"
 #include "lst.h"
+#include "main.h"
 #include "proc.h"
 #include "strg.h"
+#include "util.h"
 #include "cpp.h"
 
+#define OBUFN 65536    /* size of output buffer */
+
+/* puts a character into the output buffer */
+#define OUTC(c) ((void)((op == obuf+OBUFN)? oflush(): (void)0), *op++ = (c))
+
 
 /* 0 if no spaces are necessary;
    1 if space is necessary after the token;
@@ -30,6 +38,39 @@ static FILE *outfile;    /* output file */
 static int sync;         /* true if line sync is necessary */
 static int ptid;         /* previous output token */
 
+static char obuf[OBUFN], *op = obuf;    /* output buffer */
+
+
+/*
+ *  writes out the output buffer
+ */
+static void oflush(void)
+{
+    if (op > obuf) {
+        fwrite(obuf, 1, op-obuf, outfile);
+        op = obuf;
+    }
+}
+
+
+/*
+ *  puts a string of known length into the output buffer
+ */
+static void outs(const char *s, sz_t n)
+{
+    assert(s);
+
+    if (n > (sz_t)(obuf+OBUFN - op)) {
+        oflush();
+        if (n >= OBUFN) {
+            fwrite(s, 1, n, outfile);
+            return;
+        }
+    }
+    memcpy(op, s, n);
+    op += n;
+}
+
 
 /*
  *  prints a string escaping special characters
@@ -41,10 +82,9 @@ static void printesc(const char *s)
     for (; *s; s++)
         switch(*s) {
             case '\\':
-                fputs("\\\\", outfile);
-                break;
             case '"':
-                fputs("\\\"", outfile);
+                OUTC('\\');
+                OUTC(*s);
                 break;
             /* others are printed without escaping */
             case '\a':
@@ -54,7 +94,7 @@ static void printesc(const char *s)
             case '\r':
             case '\t':
             default:
-                putc(*s, outfile);
+                OUTC(*s);
                 break;
         }
 }
@@ -65,18 +105,46 @@ static void printesc(const char *s)
  */
 static void outpos(const char *f, sz_t y, int n)
 {
-    static const char *ns[] = { "", " 1", " 2" };
+    static const char *ns[] = { "\"\n", "\" 1\n", "\" 2\n" };
+
+    char buf[2 + 3*sizeof(sz_t) + 2], *p = &buf[sizeof(buf)];    /* "# " digits " \"" */
 
     assert(f);
     assert(n >= 0 && n < NELEM(ns));
 
-    fprintf(outfile, "# %"FMTSZ"u \"", y);
+    *--p = '"', *--p = ' ';
+    do {
+        *--p = '0' + y % 10;
+    } while((y /= 10) != 0);
+    *--p = ' ', *--p = '#';
+    outs(p, &buf[sizeof(buf)] - p);
     printesc(f);
-    fprintf(outfile, "\"%s\n", ns[n]);
+    outs(ns[n], 2 + 2*(n > 0));
     sync = 0;
 }
 
 
+/*
+ *  puts the spelling of a token preceded by a space if necessary
+ */
+static void outtok(const lex_t *t, int *pneedsp)
+{
+    const char *s;
+
+    assert(t);
+    assert(pneedsp);
+
+    if (*pneedsp) {
+        if (toksp[t->id] & 2)
+            OUTC(' ');
+        *pneedsp = 0;
+    }
+    s = LEX_SPELL(t);
+    outs(s, strlen(s));
+    ptid = t->id;
+}
+
+
 /*
  *  drives preprocessing
  */
@@ -157,7 +225,7 @@ void (cpp_start)(FILE *fp)
                         break;
                     default:
                         if (!sync) {
-                            putc('\n', outfile);
+                            OUTC('\n');
                             ty++;
                         }
                         n = lst_peek();
@@ -170,24 +238,21 @@ void (cpp_start)(FILE *fp)
                         }
                         break;
                 }
+                if (main_opt()->pptool == 1)    /* keeps -H output in order */
+                    oflush();
                 ptid = LEX_NEWLINE;
                 needsp = 0;
                 break;
             default:
                 if (sync)
                     outpos(tf, ty, sync >> 1);
-                if (needsp) {
-                    if (toksp[t->id] & 2)
-                        putc(' ', outfile);
-                    needsp = 0;
-                }
-                fputs(LEX_SPELL(t), outfile);
-                ptid = t->id;
+                outtok(t, &needsp);
                 break;
         }
     }
     if (sync > 1)    /* cares #include sync only */
         outpos(tf, ty, sync >> 1);
+    oflush();
 }
 
 
@@ -221,23 +286,20 @@ void (cpp_nosync)(FILE *fp)
                     case 1:
                         break;
                     default:
-                        putc('\n', outfile);
+                        OUTC('\n');
                         break;
                 }
+                if (main_opt()->pptool == 1)    /* keeps -H output in order */
+                    oflush();
                 ptid = LEX_NEWLINE;
                 needsp = 0;
                 break;
             default:
-                if (needsp) {
-                    if (toksp[t->id] & 2)
-                        putc(' ', outfile);
-                    needsp = 0;
-                }
-                fputs(LEX_SPELL(t), outfile);
-                ptid = t->id;
+                outtok(t, &needsp);
                 break;
         }
     }
+    oflush();
 }
 
 
@@ -255,15 +317,77 @@ void (cpp_nout)(void)
 }
 
 
+/*
+ *  (cache key) hashes a string including its terminating null character
+ */
+static void keys(sha256_t *c, const char *s)
+{
+    assert(c);
+    assert(s);
+
+    sha256_add(c, s, strlen(s)+1);
+}
+
+
+/*
+ *  drives preprocessing without output and writes a key for a cache of compiler output;
+ *  the key covers tokens except spaces and line boundaries, and sig that describes options
+ */
+void (cpp_key)(FILE *fp, const char *sig)
+{
+    char id[2], buf[64+1];
+    lex_t *t;
+    sha256_t h;
+
+    assert(fp);
+    assert(sig);
+
+    id[1] = '\0';
+    sha256_init(&h);
+    ptid = LEX_NEWLINE;
+    proc_prep();
+    while ((t = lst_next())->id != LEX_EOI) {
+        switch(t->id) {
+            case -1:
+                strg_free((arena_t *)t->spell);
+                break;
+            case LEX_SPACE:
+            case LEX_MCR:
+                break;
+            case LEX_NEWLINE:
+                if (t->f.sync == 2) {
+                    t = lst_next();
+                    assert(t->id == 0);
+                }
+                if (ptid != LEX_NEWLINE)    /* blank lines ignored */
+                    keys(&h, "\n");
+                ptid = LEX_NEWLINE;
+                break;
+            default:
+                id[0] = t->id;
+                keys(&h, id);
+                keys(&h, LEX_SPELL(t));
+                ptid = t->id;
+                break;
+        }
+    }
+    ptid = 0;
+    keys(&h, sig);
+
+    fprintf(fp, "%s\n", sha256_hex(&h, buf));
+}
+
+
 /*
  *  finalizes preprocessing
  */
 void (cpp_close)(void)
 {
     if (ptid && ptid != LEX_NEWLINE) {    /* ptid implies pponly */
-        putc('\n', outfile);
+        OUTC('\n');
         ptid = 0;    /* makes idempotent */
     }
+    oflush();
 }
 
 /* end of cpp.c */
@@ -11,6 +11,7 @@
 void cpp_start(FILE *);
 void cpp_nosync(FILE *);
 void cpp_nout(void);
+void cpp_key(FILE *, const char *);
 void cpp_close(void);
 
 
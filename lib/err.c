@@ -86,7 +86,8 @@ int err_lim = 5;                                      /* # of allowed errors bef
 const except_t err_except = { "too many errors" };    /* exception for too many errors */
 
 
-static int cnt;    /* # of errors occurred */
+static int cnt;       /* # of errors occurred */
+static sz_t ndiag;    /* # of diagnostics issued */
 
 /* diagnostic messages */
 static const char *msg[] = {
@@ -181,6 +182,15 @@ int (err_count)(void)
 }
 
 
+/*
+ *  returns the number of diagnostics issued
+ */
+sz_t (err_ndiag)(void)
+{
+    return ndiag;
+}
+
+
 /*
  *  set behavior of warnings;
  *  no effect on errors
@@ -256,6 +266,22 @@ int (err_chkwarn)(int code)
 }
 
 
+/*
+ *  returns a hash of the current warning settings;
+ *  used to key cached output
+ */
+unsigned long (err_sig)(void)
+{
+    int i;
+    unsigned long h = err_level;
+
+    for (i = 0; i < NELEM(msg); i++)
+        h = h*31 + wlevm[i]*2 + (dtype(prop[i]) == M);
+
+    return h & 0xffffffffUL;
+}
+
+
 /*
  *  sets an error flag of a function
  */
@@ -747,6 +773,7 @@ static int issue(struct epos_t *ep, const lmap_t *from, int code, va_list ap)
             return 0;
     }
 
+    ndiag++;
     fprintf(stderr, "%s{", comma);
 
     /* #include chain */
@@ -892,6 +919,8 @@ static int issue(struct epos_t *ep, const lmap_t *from, int code, va_list ap)
             return 0;
     }
 
+    ndiag++;
+
     /* #include chain */
     if (pos->type == LMAP_INC && !pos->u.i.printed) {
 #ifdef HAVE_COLOR
@@ -29,8 +29,10 @@ extern const except_t err_except;    /* exception for too many errors */
 
 void err_init(void);
 int err_count(void);
+sz_t err_ndiag(void);
 void err_setwarn(int, int);
 int err_chkwarn(int);
+unsigned long err_sig(void);
 int err_experr(void);
 void err_cleareff(void);
 
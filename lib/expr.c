@@ -47,6 +47,10 @@ static const except_t invexpr =
                  { "invalid expression" };    /* exception for invalid expression */
 static int silent;                            /* positive in unevaluated (sub-)expressions */
 static int level;                             /* nesting level of parenthesized expressions */
+static int gform;                             /* progress in recognizing !defined(X) */
+static int nprim;                             /* # of primary expressions */
+static const char *gname;                     /* X in !defined(X) */
+static const char *mgname;                    /* X if #if has form of !defined(X) */
 
 
 /* internal functions referenced forwardly */
@@ -385,6 +389,7 @@ static expr_t *prim(lex_t **pt)
     assert(pt);
     assert(*pt);
 
+    nprim++;
     cs = LEX_SPELL(*pt);
     switch((*pt)->id) {
         case LEX_ID:
@@ -419,6 +424,8 @@ static expr_t *prim(lex_t **pt)
                         }
                     }
                     r = newrs(xis(mcr_redef(cs)), dpos, (*pt)->pos);
+                    if (gform == 2)
+                        gname = cs, gform = 3;
                 }
             } else {
                 err_dpos((*pt)->pos, ERR_PP_EXPRUNDEFID, cs);
@@ -536,6 +543,8 @@ static expr_t *unary(lex_t **pt)
         case '!':
             spos = (*pt)->pos;
             *pt = nextnsp();
+            if (gform == 1)
+                gform = ((*pt)->id == LEX_ID && strcmp(LEX_SPELL(*pt), "defined") == 0)? 2: 0;
             l = unary(pt);
             l->u.u = xiu(xe(l->u.u, xO));
             l->type = EXPR_TS;
@@ -1092,17 +1101,21 @@ expr_t *(expr_start)(lex_t **pt, const char *k)
     assert(*pt);
     assert(sizeof(sx_t)*CHAR_BIT >= PPINT_BYTE*TG_CHAR_BIT);
 
-    level = silent = 0;
+    level = silent = nprim = 0;
+    mgname = NULL;
     pushback = *pt;
     *pt = nextnsp();
+    gform = ((*pt)->id == '!');
     if ((*pt)->id == LEX_NEWLINE)
         err_dpos((*pt)->pos, ERR_PP_NOIFEXPR, k);
     else {
         EXCEPT_TRY
             r = expr(pt, 0, NULL);
-            if ((*pt)->id == LEX_NEWLINE)
+            if ((*pt)->id == LEX_NEWLINE) {
+                if (gform == 3 && nprim == 1)
+                    mgname = gname;
                 EXCEPT_RETURN r;
-            else {
+            } else {
                 switch((*pt)->id) {
                     case ')':    /* closing paren */
                         err_dpos((*pt)->pos, ERR_PP_NOEXPRLPAREN, NULL);
@@ -1130,4 +1143,13 @@ expr_t *(expr_start)(lex_t **pt, const char *k)
     return newrs(xO, (*pt)->pos, (*pt)->pos);
 }
 
+
+/*
+ *  returns X if the last controlling expression has the form of !defined(X)
+ */
+const char *(expr_mgname)(void)
+{
+    return mgname;
+}
+
 /* end of expr.c */
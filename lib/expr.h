@@ -40,6 +40,7 @@ typedef struct expr_t {
 
 
 expr_t *expr_start(lex_t **, const char *);
+const char *expr_mgname(void);
 
 
 #endif    /* EXPR_H */
@@ -3,7 +3,10 @@
  */
 
 #include <stddef.h>        /* NULL */
-#include <stdio.h>         /* FILE, getc, ungetc, EOF, ferror, feof, ftell */
+#include <stdio.h>         /* FILE, fopen, fclose, fread, ferror, fseek, ftell, SEEK_END,
+                              SEEK_SET */
+#include <string.h>        /* memchr, memcpy */
+#include <cbl/arena.h>     /* ARENA_ALLOC */
 #include <cbl/assert.h>    /* assert */
 #include <cbl/memory.h>    /* MEM_ALLOC, MEM_RESIZE, MEM_FREE */
 #include <cdsl/hash.h>     /* hash_string */
@@ -13,9 +16,12 @@
 #include "inc.h"
 #include "lmap.h"
 #include "main.h"
+#include "strg.h"
 #include "util.h"
 #include "in.h"
 
+#define INUNIT 8192    /* allocation unit for input buffer */
+
 
 sz_t in_py;                   /* physical line # of current file */
 const char *in_line;          /* beginning of current line */
@@ -24,15 +30,24 @@ const char *in_limit;         /* end of current line */
 void (*in_nextline)(void);    /* function to read next input line */
 
 
-static FILE *fptr;    /* file pointer for input */
-static char *buf;     /* input buffer */
-static sz_t bufn;     /* input buffer size */
-static int bs;        /* # of escaped newlines in in_line */
+static FILE *fptr;      /* file pointer for input */
+static in_buf_t ib;     /* whole input from fptr */
+static char *buf;       /* buffer for spliced lines */
+static sz_t bufn;       /* spliced line buffer size */
+static int bs;          /* # of escaped newlines in in_line */
 #ifdef HAVE_ICONV
 static char *ibuf;    /* UTF-8 input buffer */
 static sz_t ibufn;    /* UTF-8 input buffer size */
 #endif    /* HAVE_ICONV */
 
+/* file contents retained across translation units */
+static struct kept {
+    const char *fn;       /* file name; hash string */
+    const char *base;     /* contents */
+    sz_t n;               /* length of contents */
+    struct kept *link;    /* hash chain */
+} *kt[256];
+
 
 /*
  *  converts a trigraph warning its first use
@@ -151,86 +166,168 @@ static const char *rnsp(const char *s, const char *e)
 
 
 /*
- *  replaces fgets() to detect embedded null characters
+ *  reads a whole file into an input buffer;
+ *  ASSUMPTION: fseek()/ftell() give byte offsets for text streams if they work
  */
-static char *ngets(char *s, int n, FILE *fp, int *pnul)
+static void readall(FILE *fp, in_buf_t *pb)
 {
-    int c;
-    char *p = s;
+    long pos;
+    sz_t n, size = INUNIT;
 
-    assert(s);
     assert(fp);
-    assert(pnul);
+    assert(pb);
 
-    while (--n > 0) {
-        if ((c = getc(fp)) == EOF)
-            break;
-        *p++ = c;
-        if (c == '\n')
+    if (fseek(fp, 0, SEEK_END) == 0 && (pos = ftell(fp)) > 0 && fseek(fp, 0, SEEK_SET) == 0)
+        size = pos + 1+1;    /* +1 for NUL and +1 to detect EOF with no extra round */
+    pb->base = MEM_ALLOC(size);
+
+    n = 0;
+    while (1) {
+        n += fread(pb->base+n, 1, size-1-n, fp);    /* -1 for NUL */
+        if (n < size-1 || ferror(fp))
             break;
-        if (c == '\0')
-            *pnul = 1;
+        MEM_RESIZE(pb->base, size*=2);    /* doubles for unsized streams */
     }
-    *p = 0;
 
-    return p;
+    pb->err = ferror(fp);
+    pb->base[n] = '\0';
+    pb->cur = pb->base;
+    pb->limit = pb->base + n;
 }
 
 
 /*
- *  replaces null characters with spaces
+ *  finds retained contents of a file
+ */
+static struct kept *findkept(const char *fn)
+{
+    struct kept *p;
+
+    assert(fn);
+
+    for (p = kt[hashkey(fn, NELEM(kt))]; p; p = p->link)
+        if (p->fn == fn)
+            return p;
+
+    return NULL;
+}
+
+
+/*
+ *  loads an input file from fp or from retained contents
+ */
+static void load(FILE *fp, const char *fn, in_buf_t *pb)
+{
+    struct kept *p;
+
+    assert(pb);
+
+    if (fp)
+        readall(fp, pb);
+    else {
+        p = findkept(fn);
+        assert(p);
+        pb->base = MEM_ALLOC(p->n + 1);    /* +1 for NUL */
+        memcpy(pb->base, p->base, p->n + 1);
+        pb->err = 0;
+        pb->cur = pb->base;
+        pb->limit = pb->base + p->n;
+    }
+    pb->kept = lmap_flbuf(pb->base, pb->limit);
+}
+
+
+/*
+ *  finds the end of a physical line;
+ *  returns a pointer to its newline or to the end of input
+ */
+static char *eol(const char *p)
+{
+    char *q;
+
+    assert(p);
+    assert(p <= ib.limit);
+
+    q = memchr(p, '\n', ib.limit-p);
+    return (q)? q: ib.limit;
+}
+
+
+/*
+ *  checks if a physical line ending at e (newline) needs splicing;
+ *  lines ending with ??/ are also handled by splice() to warn of trigraphs
+ */
+static int spliced(const char *p, const char *e)
+{
+    assert(p);
+    assert(e);
+
+    if (e == ib.limit || e == p)
+        return 0;
+    return (e[-1] == '\\' ||
+            (main_opt()->trigraph && e-p > 2 && e[-1] == '/' && e[-2] == '?' && e[-3] == '?'));
+}
+
+
+/*
+ *  replaces null characters with spaces;
+ *  diagnosed after replacement since diagnostics read lines from the input buffer
  */
 static void repnul(char *s, const char *e)
 {
+    sz_t i, n;
+    char *p, **v;
+
     assert(s);
     assert(e);
 
-    for (; s < e; s++)
-        if (*s == '\0') {
-            err_dline(s, 1, ERR_INPUT_EMBEDNUL);
-            *s = ' ';
+    for (n = 0, p = s; p < e; p++)
+        n += (*p == '\0');
+    v = MEM_ALLOC(n * sizeof(*v));
+    for (n = 0, p = s; p < e; p++)
+        if (*p == '\0') {
+            *p = ' ';
+            v[n++] = p;
         }
+    for (i = 0; i < n; i++)
+        err_dline(v[i], 1, ERR_INPUT_EMBEDNUL);
+    MEM_FREE(v);
 }
 
 
 /*
- *  reads the next line;
- *  in_limit points to one past the terminating null unless EOF;
- *  ASSUMPTION: '\n' is no part of multibyte characters and has no effect on the shift state;
- *  ASSUMPTION: charset in which source is written is same as that in which beluga is running
+ *  builds a logical line from physical lines with line splicing in buf;
+ *  sets *pend if the line ends at EOF
  */
-static void nextline(void)
+static char *splice(sz_t *plen, int *pend)
 {
-    int nul;
-    char *p;
-    const char *q;
-    sz_t len;
+    char *p, *e, *q;
+    sz_t len, n;
 
-    assert(fptr);
+    assert(plen);
+    assert(pend);
 
-    if (bs > 0)
-        in_py += bs, bs = 0;
-    lmap_fline(++in_py, ftell(fptr));
-    p = (char *)(in_limit = in_line = in_cp = buf);
-    *p = '\0';
+    p = (char *)(in_line = in_cp = buf);
     len = 0;
 
     while (1) {
-        assert(bufn-len > 1);
-        nul = 0;
-        q = ngets(p+len, bufn-len, fptr, &nul);
-        if (ferror(fptr)) {
-            err_dline(NULL, 1, ERR_INPUT_ERROR);
-            in_nextline = eof;
-            break;
+        e = eol(ib.cur);
+        n = e - ib.cur + (e < ib.limit);    /* includes newline */
+        if (bufn-len <= n) {
+            MEM_RESIZE(p, bufn = ROUNDUP(len+n+1, BUFUNIT));
+            in_line = in_cp = buf = p;
         }
-        if (nul)
-            repnul(p+len, q);
-        len += (q - (p+len));
-        if (len == 0) {    /* real EOF */
-            in_nextline = eof;
-            break;
+        memcpy(p+len, ib.cur, n);
+        p[len+n] = '\0';
+        ib.cur += n;
+        *pend = (e == ib.limit);
+        if (memchr(p+len, '\0', n)) {
+            for (q = ib.cur-n; q < ib.cur; q++)    /* diagnostics read lines from ib */
+                if (*q == '\0')
+                    *q = ' ';
+            repnul(p+len, p+len+n);
         }
+        len += n;
         if (len > 1 && (p[len-2] == '\\' ||
                         (main_opt()->trigraph && len > 3 &&
                          p[len-4] == '?' && p[len-3] == '?' && p[len-2] == '/')) &&
@@ -238,61 +335,100 @@ static void nextline(void)
             if (p[len-2] == '/')
                 in_trigraph(&p[len-4]);    /* for warning */
             if (p[len-2] == '\\' || (main_opt()->trigraph & 1)) {    /* line splicing */
-                int n = 1+1;
-                int c;
-                lmap_fline(in_py + ++bs, ftell(fptr));
-                c = getc(fptr);
+                int m = 1+1;
+                bs++;
                 if (p[len-2] == '/')
-                    len -= 2, n = 3+1;
-                if (c == EOF) {
-                    err_dline(p+len-2, n, ERR_INPUT_BSNLEOF);
+                    len -= 2, m = 3+1;
+                if (ib.cur == ib.limit) {
+                    err_dline(p+len-2, m, ERR_INPUT_BSNLEOF);
                     p[len-2] = '\n';
                     p[--len] = '\0';
                     bs--;    /* for better tracking of locus */
+                    *pend = 1;
                 } else {
-                    ungetc(c, fptr);
                     p[--len-1] = '\n';
+                    p[len] = '\0';
                     continue;
                 }
             }
         }
-        if (p[len-1] == '\n' || feof(fptr)) {    /* line completed */
+        break;
+    }
+
+    *plen = len;
+    return p;
+}
+
+
+/*
+ *  reads the next line;
+ *  in_limit points to one past the terminating null unless EOF;
+ *  lines not spliced are used in place from the input buffer;
+ *  ASSUMPTION: '\n' is no part of multibyte characters and has no effect on the shift state;
+ *  ASSUMPTION: charset in which source is written is same as that in which beluga is running
+ */
+static void nextline(void)
+{
+    int end;
+    char *p, *e;
+    const char *q;
+    sz_t len;
+
+    assert(ib.base);
+
+    if (bs > 0)
+        in_py += bs, bs = 0;
+    in_py++;
+
+    if (ib.cur == ib.limit) {    /* real EOF */
+        if (ib.err)
+            err_dline(NULL, 1, ERR_INPUT_ERROR);
+        in_nextline = eof;
+        in_limit = in_cp = in_line = "";
+        return;
+    }
+
+    e = eol(ib.cur);
+    if (!spliced(ib.cur, e)) {
+        p = ib.cur;
+        in_line = in_cp = p;
+        end = (e == ib.limit);
+        ib.cur = e + !end;
+        if (memchr(p, '\0', e-p))
+            repnul(p, e);
+        *e = '\0';    /* newline */
+        len = e - p;
+    } else {
+        p = splice(&len, &end);
+        if (!end)    /* newline read from input */
+            p[--len] = '\0';
+    }
+
 #ifdef HAVE_ICONV
-            if (main_iton) {
-                ICONV_DECL(p, len + 1);    /* +1 to include NUL */
-                olenv = olen = ibufn;
-                obufv = obuf = ibuf;
-                ICONV_DO(main_iton, 0, { err_dline(p + (ibufv-p+1), 1, ERR_INPUT_CONVFAIL); });
-                ibuf = p = obuf;
-                len = olen - olenv - 1;
-            }
+    if (main_iton) {
+        ICONV_DECL(p, len + 1);    /* +1 to include NUL */
+        olenv = olen = ibufn;
+        obufv = obuf = ibuf;
+        ICONV_DO(main_iton, 0, { err_dline(p + (ibufv-p+1), 1, ERR_INPUT_CONVFAIL); });
+        ibuf = p = obuf;
+        len = olen - olenv - 1;
+    }
 #endif    /* HAVE_ICONV */
-            in_line = p;
-            if (!feof(fptr))    /* newline read from input */
-                p[--len] = '\0';
-            else if (p[len-1] != '\n')    /* EOF without newline */
-                err_dline(p+len, 1, ERR_INPUT_NOTENDNL);
-            if (len > 1 && ISCH_SP(p[len-1]) && (q = rnsp(p, p+len)) != NULL &&
-                (*q == '\\' || ((main_opt()->trigraph & 1) && q[0] == '/' && q > p+1 &&
-                                q[-1] == '?' && q[-2] == '?')))
-                err_dline(q+1, p+len-1-q, ERR_INPUT_BSSPACENL);
-            in_limit = &p[len+1];
-            in_cp = p;
-            if (main_opt()->std) {
-                sz_t c = in_cntchar(p, &p[len], TL_LINE_STD, &q);
-                if (c >= TL_LINE_STD)
-                    (void)(err_dline(q, 1, ERR_INPUT_LONGLINE) &&
-                           err_dline(NULL, 1, ERR_INPUT_LONGLINESTD, (unsigned long)TL_LINE_STD));
-            }
-            return;
-        } else {    /* expands buffer */
-            MEM_RESIZE(p, bufn+=BUFUNIT);
-            buf = p;
-        }
+    in_line = p;
+    if (end && p[len-1] != '\n')    /* EOF without newline */
+        err_dline(p+len, 1, ERR_INPUT_NOTENDNL);
+    if (len > 1 && ISCH_SP(p[len-1]) && (q = rnsp(p, p+len)) != NULL &&
+        (*q == '\\' || ((main_opt()->trigraph & 1) && q[0] == '/' && q > p+1 &&
+                        q[-1] == '?' && q[-2] == '?')))
+        err_dline(q+1, p+len-1-q, ERR_INPUT_BSSPACENL);
+    in_limit = &p[len+1];
+    in_cp = p;
+    if (main_opt()->std) {
+        sz_t c = in_cntchar(p, &p[len], TL_LINE_STD, &q);
+        if (c >= TL_LINE_STD)
+            (void)(err_dline(q, 1, ERR_INPUT_LONGLINE) &&
+                   err_dline(NULL, 1, ERR_INPUT_LONGLINESTD, (unsigned long)TL_LINE_STD));
     }
-    /* EOF */
-    p[0] = '\0';
-    in_limit = in_cp = in_line;
 }
 
 
@@ -314,6 +450,7 @@ void (in_init)(FILE *fp, const char *fn)
     } else    /* stdin */
         lmap_init(NULL, NULL);
 
+    load(fp, NULL, &ib);
     assert(BUFUNIT > 1);
     buf = MEM_ALLOC(bufn = BUFUNIT);
 #ifdef HAVE_ICONV
@@ -326,27 +463,78 @@ void (in_init)(FILE *fp, const char *fn)
 
 
 /*
- *  saves or restores input file context
+ *  saves or restores input file context;
+ *  pushes fp, or fn if its contents retained by in_keep()
  */
-void (in_switch)(FILE *fp, int d)
+void (in_switch)(FILE *fp, const char *fn, int d)
 {
     in_nextline = nextline;
-    if (fp) {    /* push */
+    if (fp || fn) {    /* push */
         assert(d == 0 || bs >= d);
-        inc_push(fptr, bs-d);
+        inc_push(fptr, &ib, bs-d);
         fptr = fp;
+        load(fp, fn, &ib);
         in_py = bs = 0;
-    } else    /* pop */
-        fptr = inc_pop(fptr, &in_py);
+    } else {    /* pop */
+        if (!ib.kept)
+            MEM_FREE(ib.base);
+        fptr = inc_pop(fptr, &ib, &in_py);
+    }
     in_nextline();
 }
 
 
+/*
+ *  retains the contents of a file for later translation units;
+ *  fn is a hash string
+ */
+void (in_keep)(const char *fn)
+{
+    unsigned h;
+    FILE *fp;
+    in_buf_t b;
+    struct kept *p;
+
+    assert(fn);
+
+    if (findkept(fn) || (fp = fopen(fn, "r")) == NULL)
+        return;
+    readall(fp, &b);
+    fclose(fp);
+    if (b.err) {
+        MEM_FREE(b.base);
+        return;
+    }
+
+    p = ARENA_ALLOC(strg_perm, sizeof(*p));
+    p->fn = fn;
+    p->base = b.base;
+    p->n = b.limit - b.base;
+    h = hashkey(fn, NELEM(kt));
+    p->link = kt[h];
+    kt[h] = p;
+}
+
+
+/*
+ *  checks if the contents of a file are retained;
+ *  fn is a hash string
+ */
+int (in_iskept)(const char *fn)
+{
+    assert(fn);
+
+    return (findkept(fn) != NULL);
+}
+
+
 /*
  *  finalizes input
  */
 void (in_close)(void)
 {
+    if (!ib.kept)
+        MEM_FREE(ib.base);
     MEM_FREE(buf);
 #ifdef HAVE_ICONV
     if (main_iton)
@@ -379,6 +567,11 @@ sz_t (in_getwx)(sz_t wx, const char *s, const char *p, int *pdy)
             wx = 1;
             continue;
         }
+        if (*(unsigned char *)s < 0x80 && *s != '\0') {    /* ASCII; no decoding */
+            s++;
+            wx++;
+            continue;
+        }
         wc = utf8to32(&s);
         wx += (wc == (unsigned long)-1)? 1: wcwidth(wc);
     }
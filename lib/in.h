@@ -10,6 +10,16 @@
 #include "common.h"
 
 
+/* input buffer holding whole file */
+typedef struct in_buf_t {
+    char *base;     /* beginning of buffer */
+    char *cur;      /* start of next physical line */
+    char *limit;    /* end of input; *limit is NUL */
+    int err;        /* true if read error occurred */
+    int kept;       /* true if retained by line mapper */
+} in_buf_t;
+
+
 extern sz_t in_py;                   /* physical line # of current file */
 extern const char *in_line;          /* beginning of current line */
 extern const char *in_cp;            /* current character */
@@ -20,7 +30,9 @@ extern void (*in_nextline)(void);    /* function to read next input line */
 int in_trigraph(const char *);
 sz_t in_cntchar(const char *, const char *, sz_t, const char **);
 void in_init(FILE *, const char *);
-void in_switch(FILE *, int);
+void in_switch(FILE *, const char *, int);
+void in_keep(const char *);
+int in_iskept(const char *);
 void in_close(void);
 sz_t in_getwx(sz_t, const char *, const char *, int *);
 
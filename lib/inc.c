@@ -4,11 +4,17 @@
 
 #include <stddef.h>        /* NULL, size_t */
 #include <stdio.h>         /* FILE, fopen, fclose, stderr, stdout, fputs, putc, fprintf */
+#include <stdlib.h>        /* strtol */
 #include <string.h>        /* strlen, strcpy, strrchr, strtok */
 #include <cbl/assert.h>    /* assert */
 #include <cbl/arena.h>     /* ARENA_ALLOC */
+#include <cbl/memory.h>    /* MEM_ALLOC, MEM_FREE */
 #include <cdsl/hash.h>     /* hash_new, hash_string */
 #include <cdsl/list.h>     /* list_t, list_push, list_reverse, list_free, LIST_FOREACH */
+#ifdef HAVE_DIRENT
+#include <errno.h>         /* errno, ENOENT */
+#include <dirent.h>        /* DIR, struct dirent, opendir, readdir, closedir */
+#endif    /* HAVE_DIRENT */
 
 #include "common.h"
 #include "cond.h"
@@ -16,6 +22,7 @@
 #include "in.h"
 #include "main.h"
 #include "mg.h"
+#include "pch.h"
 #include "strg.h"
 #include "util.h"
 #include "inc.h"
@@ -65,6 +72,40 @@ static int syslev = -1;             /* nesting level of system header */
 static inc_t *incinfo[TL_INC+1];    /* #include chain */
 static list_t *mkdep;               /* Makefile dependency list */
 
+/* header resolution cache */
+static struct rct {
+    const char *name;    /* header name with closing character; hash string */
+    int i;               /* index to rpl[] or -1 if not found */
+    list_t *p;           /* entry in rpl[i] */
+    int learned;         /* true if from previous translation units */
+    struct rct *link;    /* hash chain */
+} *rct[256];
+
+/* paths tried */
+static struct path {
+    const char *path;     /* full path; hash string */
+    int found;            /* true if exists */
+    const char *rp;       /* canonical path; hash string */
+    int learned;          /* true if from previous translation units */
+    struct path *link;    /* hash chain */
+} *pt[256];
+
+#ifdef HAVE_DIRENT
+/* search directories read */
+static struct ldir {
+    const char *dir;      /* directory */
+    int read;             /* true if entries known */
+    struct ldir *link;    /* hash chain */
+} *ldt[64];
+
+/* entries of search directories */
+static struct lent {
+    const char *dir;      /* directory */
+    const char *name;     /* entry name; hash string */
+    struct lent *link;    /* hash chain */
+} *let[1024];
+#endif    /* HAVE_DIRENT */
+
 
 /*
  *  adds raw #include paths to parse later
@@ -177,6 +218,43 @@ void (inc_free)(void)
 }
 
 
+/*
+ *  builds a key to identify #include search paths
+ */
+const char *(inc_pathkey)(void)
+{
+    int i;
+    list_t *p;
+    size_t n = 0;
+    char *buf, *pbuf;
+    const char *key;
+
+    for (i = 0; i < NELEM(rpl); i++) {
+        LIST_FOREACH(p, rpl[i]) {
+            if (p->data)
+                n += strlen(p->data) + 1;    /* +1 for PSEP */
+        }
+        n++;    /* for | */
+    }
+
+    pbuf = buf = MEM_ALLOC(n + 1);
+    for (i = 0; i < NELEM(rpl); i++) {
+        LIST_FOREACH(p, rpl[i]) {
+            if (!p->data)
+                continue;
+            strcpy(pbuf, p->data);
+            pbuf += strlen(pbuf);
+            *pbuf++ = PSEP[0];
+        }
+        *pbuf++ = '|';
+    }
+    key = hash_new(buf, n);
+    MEM_FREE(buf);
+
+    return key;
+}
+
+
 /*
  *  builds full paths for header names
  */
@@ -213,6 +291,166 @@ static const char *build(const char *p, const char *h, size_t *pn)
 }
 
 
+#ifdef HAVE_DIRENT
+/*
+ *  reads a search directory once and checks if it has an entry;
+ *  only the first component of a header name is inspected
+ */
+static int listed(const char *d, const char *h)
+{
+    unsigned k;
+    const char *e;
+    struct ldir *p;
+    struct lent *q;
+
+    assert(d);
+    assert(h);
+    assert(DSEP != '\0');
+
+    k = hashkey(d, NELEM(ldt));
+    for (p = ldt[k]; p; p = p->link)
+        if (p->dir == d)
+            break;
+    if (!p) {
+        DIR *dp;
+        struct dirent *de;
+
+        p = ARENA_ALLOC(strg_perm, sizeof(*p));
+        p->dir = d;
+        p->read = 0;
+        p->link = ldt[k];
+        ldt[k] = p;
+        if ((dp = opendir((*d)? d: ".")) != NULL) {
+            while ((de = readdir(dp)) != NULL) {
+                q = ARENA_ALLOC(strg_perm, sizeof(*q));
+                q->dir = d;
+                q->name = hash_string(de->d_name);
+                k = hashkey(q->name, NELEM(let));
+                q->link = let[k];
+                let[k] = q;
+            }
+            closedir(dp);
+            p->read = 1;
+        } else if (errno == ENOENT)
+            p->read = 1;    /* no entries */
+    }
+    if (!p->read)
+        return 1;
+
+    for (e = h; *e != DSEP && e[1] != '\0'; e++)
+        continue;
+    e = hash_new(h, e - h);
+    for (q = let[hashkey(e, NELEM(let))]; q; q = q->link)
+        if (q->name == e && q->dir == d)
+            return 1;
+
+    return 0;
+}
+#endif    /* HAVE_DIRENT */
+
+
+/*
+ *  finds a path tried before
+ */
+static struct path *tried(const char *ffn)
+{
+    struct path *p;
+
+    assert(ffn);
+
+    for (p = pt[hashkey(ffn, NELEM(pt))]; p; p = p->link)
+        if (p->path == ffn)
+            return p;
+
+    return NULL;
+}
+
+
+/*
+ *  remembers a path tried
+ */
+static struct path *addpath(const char *ffn, int found)
+{
+    unsigned k;
+    struct path *p;
+
+    assert(ffn);
+
+    k = hashkey(ffn, NELEM(pt));
+    p = ARENA_ALLOC(strg_perm, sizeof(*p));
+    p->path = ffn;
+    p->found = found;
+    p->rp = NULL;
+    p->learned = 0;
+    p->link = pt[k];
+    pt[k] = p;
+
+    return p;
+}
+
+
+/*
+ *  locates a header in a search directory;
+ *  opens it only when not tried before
+ */
+static struct path *probe(const char *d, const char *h, const char **pffn, size_t *pn,
+                          FILE **pfp)
+{
+    FILE *fp;
+    struct path *p;
+    const char *ffn;
+
+    assert(d);
+    assert(h);
+    assert(pffn);
+    assert(pfp);
+
+    ffn = *pffn = build(d, h, pn);
+#ifdef HAVE_DIRENT
+    if (h[0] != DSEP && !listed(d, h))
+        return NULL;
+#endif    /* HAVE_DIRENT */
+    ffn = *pffn = hash_string(ffn);
+    if ((p = tried(ffn)) != NULL)
+        return (p->found)? p: NULL;
+
+    fp = fopen(ffn, "r");
+    p = addpath(ffn, (fp != NULL));
+    *pfp = fp;
+
+    return (fp)? p: NULL;
+}
+
+
+/*
+ *  finds where a header was found in search paths;
+ *  i set to -2 for headers not searched yet
+ */
+static struct rct *resolve(const char *h)
+{
+    unsigned k;
+    struct rct *p;
+
+    assert(h);
+
+    h = hash_string(h);
+    k = hashkey(h, NELEM(rct));
+    for (p = rct[k]; p; p = p->link)
+        if (p->name == h)
+            return p;
+
+    p = ARENA_ALLOC(strg_perm, sizeof(*p));
+    p->name = h;
+    p->i = -2;
+    p->p = NULL;
+    p->learned = 0;
+    p->link = rct[k];
+    rct[k] = p;
+
+    return p;
+}
+
+
 /*
  *  prints #include hierarchy
  */
@@ -287,7 +525,8 @@ void (inc_mkdep)(FILE *fp)
 
 
 /*
- *  recognizes header names
+ *  recognizes header names;
+ *  returns 2 if replayed from the header cache
  */
 int (inc_start)(const char *fn, const lmap_t *hpos)
 {
@@ -295,7 +534,10 @@ int (inc_start)(const char *fn, const lmap_t *hpos)
     FILE *fp;
     list_t *p;
     size_t n;
-    const char *ffn = NULL, *c;
+    struct rct *r;
+    struct path *e;
+    const char *ffn = NULL, *c, *kfn;
+    const lmap_t *pos;
 
     assert(fn);
     assert(*fn == '<' || *fn == '"');
@@ -311,24 +553,34 @@ int (inc_start)(const char *fn, const lmap_t *hpos)
     }
 
     assert(rpl[0]->data && rpl[2]->data);
-    for (i = 0; i < NELEM(rpl); i++) {
-        LIST_FOREACH(p, rpl[i]) {
-            if (!p->data)
-                continue;
-            if (((char *)p->data)[0] == '\0') {
-                if (!q)
+    i = 0;
+    fp = NULL;
+    if (q && (e = probe(c, fn, &ffn, &n, &fp)) != NULL)
+        goto found;
+    r = resolve(fn);
+    if (r->i >= 0 && (e = probe(r->p->data, fn, &ffn, &n, &fp)) != NULL) {
+        i = r->i;
+        goto found;
+    }
+    if (r->i == -1)
+        ffn = build("", fn, &n);
+    else {
+        for (; i < NELEM(rpl); i++) {
+            LIST_FOREACH(p, rpl[i]) {
+                if (!p->data || ((char *)p->data)[0] == '\0')
                     continue;
-                ffn = build(c, fn, &n);
-            } else
-                ffn = build(p->data, fn, &n);
-            if ((fp = fopen(ffn, "r")) != NULL)
-                goto found;
-        }
-        if (main_opt()->nostdinc && i == 1) {
-            if (!ffn)
-                ffn = build("", fn, &n);
-            i++;
+                if ((e = probe(p->data, fn, &ffn, &n, &fp)) != NULL) {
+                    r->i = i, r->p = p;
+                    goto found;
+                }
+            }
+            if (main_opt()->nostdinc && i == 1) {
+                if (!ffn)
+                    ffn = build("", fn, &n);
+                i++;
+            }
         }
+        r->i = -1;
     }
     err_dpos(hpos, ERR_PP_NOINCFILE, ffn + n);
     return 0;
@@ -338,15 +590,26 @@ int (inc_start)(const char *fn, const lmap_t *hpos)
             (void)(err_dpos(hpos, ERR_PP_MANYINCW) &&
                    err_dpos(hpos, ERR_PP_MANYINCSTD, (long)TL_INC_STD));
         if (inc_level == TL_INC) {
-            fclose(fp);
+            if (fp)
+                fclose(fp);
             err_dpos(hpos, ERR_PP_MANYINC);
             return 0;
         }
-        c = rpath(ffn);
+        if (!e->rp)
+            e->rp = rpath(ffn);
+        c = e->rp;
+        pch_guard(c);
         if (mg_isguarded(c)) {
-            fclose(fp);
+            if (fp)
+                fclose(fp);
             return 0;
         }
+        if (!fp && !in_iskept(ffn) &&
+            (fp = fopen(ffn, "r")) == NULL) {    /* opened only when not guarded */
+            err_dpos(hpos, ERR_PP_NOINCFILE, ffn + n);
+            return 0;
+        }
+        kfn = (fp)? NULL: ffn;
         if (i > 0 && syslev < 0)
             syslev = inc_level;
         ffn = (main_opt()->path == 0 && strlen(c) <= strlen(ffn))?
@@ -363,9 +626,19 @@ int (inc_start)(const char *fn, const lmap_t *hpos)
                 break;
         }
         hpos = lmap_mstrip(hpos);
-        lmap_from = lmap_include(c, ffn, hpos, (syslev >= 0));
+        pos = lmap_include(c, ffn, hpos, (syslev >= 0));
+        if (syslev >= 0 && pch_replay(pos)) {
+            if (fp)
+                fclose(fp);
+            if (syslev == inc_level)
+                syslev = -1;
+            return 2;
+        }
+        lmap_from = pos;
         lmap_flset(c);
-        in_switch(fp, hpos->u.n.py-in_py);
+        in_switch(fp, kfn, hpos->u.n.py-in_py);
+        if (syslev >= 0)
+            pch_start(c);
 
         return 1;
 }
@@ -374,10 +647,11 @@ int (inc_start)(const char *fn, const lmap_t *hpos)
 /*
  *  pushes the current context into the #include chain
  */
-void (inc_push)(FILE *fp, int bs)
+void (inc_push)(FILE *fp, const in_buf_t *ib, int bs)
 {
     inc_t *p;
 
+    assert(ib);
     assert(inc_chain > &incinfo[0]);
 
     inc_level++;
@@ -386,6 +660,7 @@ void (inc_push)(FILE *fp, int bs)
     p = *inc_chain;
 
     p->fptr = fp;
+    p->ib = *ib;
     p->bs = bs;
     p->cond = cond_list;
     p->mgstate = mg_state;
@@ -398,20 +673,22 @@ void (inc_push)(FILE *fp, int bs)
 /*
  *  pops a context from the #include chain
  */
-FILE *(inc_pop)(FILE *fp, sz_t *ppy)
+FILE *(inc_pop)(FILE *fp, in_buf_t *ib, sz_t *ppy)
 {
     inc_t *p;
     const lmap_t *pos;
 
-    assert(fp);
+    assert(ib);
     assert(inc_level > 0);
     assert(inc_chain < &incinfo[NELEM(incinfo)-1]);
 
     inc_level--;
-    fclose(fp);
+    if (fp)
+        fclose(fp);
 
     p = *inc_chain++;
 
+    *ib = p->ib;
     cond_list = p->cond;
     mg_state = p->mgstate;
     mg_name = p->mgname;
@@ -430,6 +707,90 @@ FILE *(inc_pop)(FILE *fp, sz_t *ppy)
 }
 
 
+/*
+ *  writes #include lookups made by the current translation unit;
+ *  read by inc_learn() in a compile server
+ */
+void (inc_report)(FILE *fp)
+{
+    int i, k;
+    list_t *q;
+    struct rct *r;
+    struct path *p;
+
+    assert(fp);
+
+    for (i = 0; i < NELEM(pt); i++)
+        for (p = pt[i]; p; p = p->link)
+            if (!p->learned) {
+                fprintf(fp, "p%d %s", p->found, p->path);
+                putc('\0', fp);
+                fputs((p->rp)? p->rp: "", fp);
+                putc('\0', fp);
+            }
+    for (i = 0; i < NELEM(rct); i++)
+        for (r = rct[i]; r; r = r->link)
+            if (!r->learned && r->i > -2) {
+                k = 0;
+                if (r->i >= 0)
+                    for (q = rpl[r->i]; q != r->p; q = q->next)
+                        k++;
+                fprintf(fp, "r%d %d %s", r->i, k, r->name);
+                putc('\0', fp);
+            }
+}
+
+
+/*
+ *  retains #include lookups written by inc_report() for later translation units;
+ *  s to e must end with a null character
+ */
+void (inc_learn)(const char *s, const char *e)
+{
+    int i, k;
+    char *t;
+    list_t *q;
+    struct rct *r;
+    struct path *p;
+
+    assert(s);
+    assert(e);
+    assert(s < e && e[-1] == '\0');
+
+    for (; s < e; s += strlen(s) + 1)
+        switch(*s) {
+            case 'p':
+                if ((p = tried(hash_string(s+3))) == NULL)
+                    p = addpath(hash_string(s+3), s[1] == '1');
+                p->learned = 1;
+                s += strlen(s) + 1;
+                if (s >= e)
+                    return;
+                if (*s)
+                    p->rp = hash_string(s);
+                if (p->found)
+                    in_keep(p->path);
+                break;
+            case 'r':
+                i = strtol(s+1, &t, 10);
+                k = strtol(t, &t, 10);
+                if (i < -1 || i >= NELEM(rpl) || *t++ != ' ')
+                    break;
+                r = resolve(t);
+                if (i >= 0) {
+                    for (q = rpl[i]; q && k > 0; q = q->next)
+                        k--;
+                    if (!q)
+                        break;
+                    r->p = q;
+                }
+                r->i = i;
+                r->learned = 1;
+                break;
+        }
+}
+
+
 /*
  *  checks if the first file is being processed
  */
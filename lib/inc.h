@@ -9,12 +9,14 @@
 
 #include "common.h"
 #include "cond.h"
+#include "in.h"
 #include "lmap.h"
 
 
 /* #include chain element */
 typedef struct inc_t {
     FILE *fptr;             /* file pointer */
+    in_buf_t ib;            /* input buffer */
     int bs;                 /* # of escaped newlines */
     cond_t *cond;           /* context for conditional inclusion */
     int mgstate;            /* mg_state */
@@ -29,10 +31,13 @@ extern int inc_level;        /* nesting level of #include's */
 void inc_add(const char *, const char *, int);
 void inc_init(void);
 void inc_free(void);
+const char *inc_pathkey(void);
 void inc_mkdep(FILE *);
 int inc_start(const char *, const lmap_t *);
-void inc_push(FILE *, int);
-FILE *inc_pop(FILE *, sz_t *);
+void inc_push(FILE *, const in_buf_t *, int);
+FILE *inc_pop(FILE *, in_buf_t *, sz_t *);
+void inc_report(FILE *);
+void inc_learn(const char *, const char *);
 int inc_isffile(void);
 
 
@@ -7,6 +7,10 @@
 #include <string.h>        /* memcpy, memset, strchr, strlen */
 #include <cbl/arena.h>     /* ARENA_CALLOC, ARENA_ALLOC */
 #include <cbl/assert.h>    /* assert */
+#include <cdsl/hash.h>     /* hash_string */
+#ifdef HAVE_SSE2
+#include <emmintrin.h>     /* __m128i, _mm_* */
+#endif    /* HAVE_SSE2 */
 
 #include "common.h"
 #include "err.h"
@@ -66,6 +70,37 @@
 #define RETDRT(i, s) if (unclean(t, (i), (s))) return t
 #define RETFNL(i)    do { unclean(t, (i), "\0"); return t; } while(0)
 
+/* characters to stop skipping block comments, line comments, identifiers and spaces */
+#define STOPCMT(c) ((c) == '*' || (c) == '/' || (c) == '\n' || (c) == '\0')
+#define STOPNL(c)  ((c) == '\n' || (c) == '\0')
+#define STOPID(c)  (!ISCH_I(c))
+#define STOPSP(c)  ((c) != ' ' && (c) != '\t')
+
+/* characters to stop copying string literals and character constants; q is the quote */
+#define STOPSTR(c) ((c) == q || (c) == '\\' || (c) == '?' || (c) == '\n' || (c) == '\0')
+#define BLKSTR(p)  (blkstr((p), q))
+
+/* skips characters until stop() holds;
+   with SSE2, aligned blocks with no stopping characters are skipped at once;
+   aligned loads never cross a page boundary, so reading past NUL is safe */
+#ifdef HAVE_SSE2
+#define SKIP(p, stop, blk)                         \
+    do {                                           \
+        while (((sz_t)(p) & 15) && !stop(*(p)))    \
+            (p)++;                                 \
+        while (!((sz_t)(p) & 15) && !blk(p))       \
+            (p) += 16;                             \
+        while (!stop(*(p)))                        \
+            (p)++;                                 \
+    } while(0)
+#else    /* !HAVE_SSE2 */
+#define SKIP(p, stop, blk)       \
+    do {                         \
+        while (!stop(*(p)))      \
+            (p)++;               \
+    } while(0)
+#endif    /* HAVE_SSE2 */
+
 
 int lex_inc;      /* true while parsing #include */
 int lex_direc;    /* true while parsing directives */
@@ -94,6 +129,104 @@ static void resize(void)
 }
 
 
+/*
+ *  puts characters into token buffer
+ */
+static void putrun(const char *s, sz_t n)
+{
+    sz_t m;
+
+    assert(s);
+
+    while (n > (m = buf+bsize-1 - pbuf)) {
+        memcpy(pbuf, s, m);
+        pbuf += m, s += m, n -= m;
+        resize();
+    }
+    memcpy(pbuf, s, n);
+    pbuf += n;
+}
+
+
+#ifdef HAVE_SSE2
+/*
+ *  (SSE2) checks if an aligned block has characters to stop skipping block comments
+ */
+static int blkcmt(const char *p)
+{
+    __m128i x = _mm_load_si128((const __m128i *)p);
+    __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('*')),
+                                          _mm_cmpeq_epi8(x, _mm_set1_epi8('/'))),
+                             _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')),
+                                          _mm_cmpeq_epi8(x, _mm_setzero_si128())));
+
+    return _mm_movemask_epi8(m);
+}
+
+
+/*
+ *  (SSE2) checks if an aligned block has characters to stop skipping line comments
+ */
+static int blknl(const char *p)
+{
+    __m128i x = _mm_load_si128((const __m128i *)p);
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')),
+                             _mm_cmpeq_epi8(x, _mm_setzero_si128()));
+
+    return _mm_movemask_epi8(m);
+}
+
+
+/*
+ *  (SSE2) checks if an aligned block has characters other than [_0-9A-Za-z];
+ *  bytes above 0x7f are negative and thus never taken as identifier characters
+ */
+static int blkid(const char *p)
+{
+    __m128i x = _mm_load_si128((const __m128i *)p);
+    __m128i l = _mm_or_si128(x, _mm_set1_epi8(0x20));    /* to lower case */
+    __m128i m = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a'-1)),
+                              _mm_cmplt_epi8(l, _mm_set1_epi8('z'+1)));
+
+    m = _mm_or_si128(m, _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0'-1)),
+                                      _mm_cmplt_epi8(x, _mm_set1_epi8('9'+1))));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+
+    return (_mm_movemask_epi8(m) != 0xffff);
+}
+
+
+/*
+ *  (SSE2) checks if an aligned block has characters other than spaces and tabs
+ */
+static int blksp(const char *p)
+{
+    __m128i x = _mm_load_si128((const __m128i *)p);
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                             _mm_cmpeq_epi8(x, _mm_set1_epi8('\t')));
+
+    return (_mm_movemask_epi8(m) != 0xffff);
+}
+
+
+/*
+ *  (SSE2) checks if an aligned block has characters to stop copying string literals
+ */
+static int blkstr(const char *p, int q)
+{
+    __m128i x = _mm_load_si128((const __m128i *)p);
+    __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8((char)q)),
+                                          _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))),
+                             _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('?')),
+                                          _mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))));
+
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_setzero_si128()));
+
+    return _mm_movemask_epi8(m);
+}
+#endif    /* HAVE_SSE2 */
+
+
 /*
  *  recognizes "unclean" tokens;
  *  ASSUMPTION: warning for trigraphs issued once per file
@@ -143,6 +276,7 @@ static int scon(lex_t *t)
     int q, c;
     int y = 0;
     int w = (buf[0] == 'L');
+    const char *s;
     register const char *rcp = in_cp;
 
     assert(t);
@@ -156,7 +290,12 @@ static int scon(lex_t *t)
         q = buf[0];
     assert(q == '\'' || q == '"');
 
-    while (*rcp != q && *rcp != '\0') {
+    while (1) {
+        s = rcp;
+        SKIP(rcp, STOPSTR, BLKSTR);
+        putrun(s, rcp-s);
+        if (*rcp == q || *rcp == '\0')
+            break;
         if (*rcp == '\n') {
             t->f.clean = 0;
             BSNL(wx);
@@ -246,6 +385,11 @@ static int comment(lex_t *t)
                 wx = 1;
                 continue;
             }
+            if (!STOPCMT(*rcp)) {
+                SKIP(rcp, STOPCMT, blkcmt);
+                c = rcp[-1];
+                continue;
+            }
             if (*rcp == '/')
                 slash = rcp;
             else if (c == '/' && *rcp == '*')
@@ -267,13 +411,14 @@ static int comment(lex_t *t)
     if (*rcp == '/' && !fromstr) {
         if (main_opt()->std != 1) {    /* line comments supported */
             dy += y, wx = x;
-            while (*++rcp != '\0') {
-                if (*rcp == '\n') {
-                    err_dline(rcp, 1, ERR_LEX_BSNLINCMT);
-                    do { dy++, y++; } while(*++rcp == '\n');
-                    wx = 1;
-                    rcp--;
-                }
+            rcp++;
+            while (1) {
+                SKIP(rcp, STOPNL, blknl);
+                if (*rcp == '\0')
+                    break;
+                err_dline(rcp, 1, ERR_LEX_BSNLINCMT);
+                do { dy++, y++; } while(*++rcp == '\n');
+                wx = 1;
             }
             ((lmap_t *)t->pos)->u.n.dy = y;
             ((lmap_t *)t->pos)->u.n.dx = wx = in_getwx(wx, in_cp, rcp, NULL);
@@ -293,13 +438,22 @@ static void ppnum(lex_t *t)
 {
     int c;
     int y;
+    const char *s;
     register const char *rcp = in_cp;
 
     assert(t);
 
     c = y = 0;
     while (1) {
-        while(ISCH_IP(*rcp) || ((*rcp == '-' || *rcp == '+') && tolower(c) == 'e')) {
+        while (1) {
+            for (s = rcp; ISCH_IP(*rcp); rcp++)
+                continue;
+            if (rcp > s) {
+                putrun(s, rcp-s);
+                c = rcp[-1];
+            }
+            if ((*rcp != '-' && *rcp != '+') || tolower(c) != 'e')
+                break;
             c = *rcp++;
             putbuf(c);
         }
@@ -335,8 +489,8 @@ static void id(lex_t *t)
     assert(t);
 
     while (1) {
-        while(ISCH_I(*rcp))
-            putbuf(*rcp++);
+        SKIP(rcp, STOPID, blkid);
+        putrun(in_cp, rcp-in_cp);
         ((lmap_t *)t->pos)->u.n.dx += rcp-in_cp;
         in_cp = rcp;
         if (*rcp != '\n') {
@@ -473,6 +627,11 @@ lex_t *(lex_next)(void)
                         if (rcp[-1] != ' ' && rcp[-1] != '\t' && !fromstr)
                             err_dline(rcp-1, 1, (lex_direc)? ERR_PP_SPHTDIREC: ERR_LEX_STRAYWS,
                                       (rcp[-1] == '\v')? "\\v": (rcp[-1] == '\f')? "\\f": "\\r");
+                        if (!STOPSP(*rcp)) {
+                            const char *p = rcp;
+                            SKIP(rcp, STOPSP, blksp);
+                            putrun(p, rcp-p);
+                        }
                         if (!ISCH_SP(*rcp))
                             break;
                         putbuf(*rcp++);
@@ -972,6 +1131,27 @@ const char *(lex_spell)(const lex_t *t)
 }
 
 
+/*
+ *  gets a clean and hashed spelling of a token;
+ *  remembers it in a clean token to avoid hashing again
+ */
+const char *(lex_chn)(lex_t *t)
+{
+    assert(t);
+
+    if (t->f.chn)
+        return t->spell;
+    if (!t->f.clean)
+        return hash_string(lex_spell(t));
+
+    t->spell = hash_string(t->spell);
+    t->f.alloc = 0;
+    t->f.chn = 1;
+
+    return t->spell;
+}
+
+
 /*
  *  backs up or restores side effects from token recognization;
  *  cannot be nested
@@ -30,6 +30,7 @@ struct lex_t {
         unsigned noarg: 1;    /* true if token came from ## */
         unsigned sync:  2;    /* 1: #include start, 2: end */
         unsigned vaarg: 2;    /* 1: __VA_ARGS__ diagnosed, 2: used for extension */
+        unsigned chn:   1;    /* true if spelling is clean and hashed */
     } f;
     struct lex_t *next;    /* link for token list */
 };
@@ -52,6 +53,7 @@ lex_t *lex_next(void);
 ux_t lex_bs(lex_t *, const char *, const char **, ux_t, const char *);
 lex_t *lex_make(int, const char *, int);
 const char *lex_spell(const lex_t *);
+const char *lex_chn(lex_t *);
 void lex_backup(int, const lmap_t *);
 
 
@@ -3,9 +3,8 @@
  */
 
 #include <stddef.h>        /* NULL */
-#include <stdio.h>         /* FILE, FOPEN_MAX, getc, EOF, ferror, feof, fopen, fclose, fseek,
-                              rewind, sprintf */
-#include <string.h>        /* strlen, strcpy, memcpy */
+#include <stdio.h>         /* FILE, sprintf */
+#include <string.h>        /* strlen, strcspn, memcpy */
 #include <cbl/memory.h>    /* MEM_ALLOC, MEM_RESIZE, MEM_FREE */
 #include <cbl/arena.h>     /* arena_t, ARENA_ALLOC */
 #include <cbl/assert.h>    /* assert */
@@ -19,8 +18,9 @@
 #include "strg.h"
 #include "lmap.h"
 
-#define LPUNIT 1024    /* allocation unit for line positions */
-#define LBUNIT 256     /* allocation unit for line buffer */
+#define LSTEP  64     /* # of lines per line index entry */
+#define LIUNIT 64     /* allocation unit for line index */
+#define LBUNIT 256    /* allocation unit for line buffer */
 
 
 /* internal functions referenced forwardly */
@@ -29,18 +29,15 @@ static const lmap_t *generate(int, sz_t);
 
 /* line location table */
 static struct flb {
-    const char *rf;      /* resolved file name */
-    sz_t posn;           /* size of pos */
-    long *pos;           /* line positions */
-    struct flb *link;    /* hash chain */
+    const char *rf;       /* resolved file name */
+    char *base;           /* retained input; NULL if none */
+    const char *limit;    /* end of retained input */
+    sz_t n;               /* # of line index entries */
+    sz_t size;            /* size of line index */
+    const char **idx;     /* start of every LSTEP-th line; built on demand */
+    struct flb *link;     /* hash chain */
 } *flb[128], *pflb;
 
-/* open file cache */
-static struct fpb {
-    const char *rf;    /* resolved file name */
-    FILE *fp;          /* file pointer */
-} fpb[FOPEN_MAX/2];
-
 static char buf[LBUNIT], *pbuf = buf;     /* line buffer */
 static sz_t bufn = NELEM(buf);            /* size of line buffer */
 static const char *nstdin = "<stdin>";    /* name for stdin */
@@ -63,8 +60,10 @@ void (lmap_flset)(const char *rf)
 
     assert(rf);
 
-    if (!*rf)
+    if (!*rf) {
+        pflb = NULL;
         return;
+    }
 
     h = hashkey(rf, NELEM(flb));
     for (p = flb[h]; p; p = p->link)
@@ -74,8 +73,10 @@ void (lmap_flset)(const char *rf)
     if (!p) {
         p = ARENA_ALLOC(strg_perm, sizeof(*p));
         p->rf = rf;
-        p->posn = LPUNIT;
-        p->pos = MEM_ALLOC(LPUNIT * sizeof(*p->pos));
+        p->base = NULL;
+        p->limit = NULL;
+        p->n = p->size = 0;
+        p->idx = NULL;
         p->link = flb[h];
         flb[h] = p;
     }
@@ -85,91 +86,57 @@ void (lmap_flset)(const char *rf)
 
 
 /*
- *  (line location) remembers a line location
+ *  (line location) retains the input of the current file for diagnostics;
+ *  returns true if the buffer is taken over
  */
-void (lmap_fline)(sz_t py, long pos)
+int (lmap_flbuf)(char *base, const char *limit)
 {
-    assert(py > 0);
-
-    if (!pflb || pos < 0)
-        return;
+    assert(base);
+    assert(limit);
+    assert(*limit == '\0');
 
-    if (py > pflb->posn) {
-        pflb->posn += LPUNIT;
-        MEM_RESIZE(pflb->pos, pflb->posn*sizeof(*pflb->pos));
-    }
-    pflb->pos[py-1] = pos;
-}
+    if (!pflb || pflb->base)
+        return 0;
 
+    pflb->base = base;
+    pflb->limit = limit;
 
-/*
- *  replaces fgets() to handle embedded null characters
- */
-static char *ngets(char *s, int n, FILE *fp)
-{
-    int c;
-    char *p = s;
-
-    assert(s);
-    assert(fp);
-
-    while (--n > 0) {
-        if ((c = getc(fp)) == EOF)
-            break;
-        if (c == '\0')
-            c = ' ';
-        *p++ = c;
-        if (c == '\n')
-            break;
-    }
-    *p = 0;
-
-    return p;
+    return 1;
 }
 
 
 /*
- *  (line location) reads a line from a file
+ *  (line location) skips lines;
+ *  lines already read end with a null character, others with a newline;
+ *  the line after the last one starts at the end of input
  */
-static const char *line(FILE *fp)
+static const char *skip(const char *s, const char *limit, sz_t n)
 {
-    sz_t len = 0;
-    const char *q;
-
-    pbuf[0] = '\n', pbuf[1] = '\0';    /* for one past last line */
+    assert(s);
+    assert(limit);
 
-    while (1) {
-        q = ngets(pbuf+len, bufn-len, fp);
-        if (ferror(fp)) {
-            rewind(fp);
+    while (n-- > 0) {
+        if (s == limit)
             return NULL;
-        }
-        len += (q - (pbuf+len));
-        if (pbuf[len-1] == '\n' || feof(fp)) {
-            if (pbuf[len-1] == '\n')
-                pbuf[len-1] = '\0';
-            return pbuf;
-        }
-        bufn += LBUNIT;
-        if (pbuf == buf) {
-            pbuf = MEM_ALLOC(bufn);
-            strcpy(pbuf, buf);
-        } else
-            MEM_RESIZE(pbuf, bufn);
+        s += strcspn(s, "\n");
+        if (s < limit)
+            s++;
     }
+
+    return s;
 }
 
 
 /*
  *  (line location) gets a source line;
- *  ASSUMPTION: ftell()/fseek() works for different stream of the same file
+ *  the line index grows as lines are asked for
  */
 const char *(lmap_flget)(const char *rf, sz_t py)
 {
     unsigned h;
+    sz_t k, len;
     struct flb *p;
-    long pos;
-    FILE *fp;
+    const char *s;
 
     assert(rf);
     assert(py > 0);
@@ -181,25 +148,36 @@ const char *(lmap_flget)(const char *rf, sz_t py)
     for (p = flb[h]; p; p = p->link)
         if (p->rf == rf)
             break;
-    if (!p || p->posn < py)
+    if (!p || !p->base)
         return NULL;
-    pos = p->pos[py-1];
 
-    h = hashkey(rf, NELEM(fpb));
-    if (fpb[h].rf == rf)
-        fp = fpb[h].fp;
-    else {
-        if ((fp = fopen(rf, "r")) == NULL)
+    k = (py-1) / LSTEP;
+    if (p->n == 0) {
+        p->idx = MEM_ALLOC((p->size = LIUNIT) * sizeof(*p->idx));
+        p->idx[p->n++] = p->base;
+    }
+    while (p->n <= k) {
+        if ((s = skip(p->idx[p->n-1], p->limit, LSTEP)) == NULL)
             return NULL;
-        if (fpb[h].fp)
-           fclose(fpb[h].fp);
-        fpb[h].rf = rf;
-        fpb[h].fp = fp;
+        if (p->n == p->size)
+            MEM_RESIZE(p->idx, (p->size+=LIUNIT) * sizeof(*p->idx));
+        p->idx[p->n++] = s;
     }
-
-    if (fseek(fp, pos, 0) != 0)
+    if ((s = skip(p->idx[k], p->limit, (py-1) % LSTEP)) == NULL)
         return NULL;
-    return line(fp);
+
+    len = strcspn(s, "\n");
+    if (len >= bufn) {
+        bufn = ROUNDUP(len+1, LBUNIT);
+        if (pbuf == buf)
+            pbuf = MEM_ALLOC(bufn);
+        else
+            MEM_RESIZE(pbuf, bufn);
+    }
+    memcpy(pbuf, s, len);
+    pbuf[len] = '\0';
+
+    return pbuf;
 }
 
 
@@ -423,7 +401,7 @@ const lmap_t *(lmap_macro)(const lmap_t *o, const lmap_t *f, arena_t *a)
         o = o->u.m;
     assert(o->type == LMAP_NORMAL);
 
-    p = ARENA_ALLOC(a, sizeof(*p));
+    p = ARENA_ALLOC(a, LMAP_MSIZE);    /* u.m only */
     p->type = LMAP_MACRO;
     p->u.m = o;
     p->from = f;
@@ -530,10 +508,10 @@ const char *(lmap_out)(const lmap_t *p)
 void (lmap_init)(const char *rf, const char *f)
 {
     static lmap_t root;
-    static lmap_t cmdh = { -1, { "<command-line>", 0, "<command-line>", 0, 0 }, NULL },
-                  blth = { -1, { "<built-in>",     0, "<built-in>",     0, 0 }, NULL },
-                  cmdn = { LMAP_NORMAL, { NULL, }, &cmdh },
-                  bltn = { LMAP_NORMAL, { NULL, }, &blth };
+    static lmap_t cmdh = { -1, NULL, { { "<command-line>", 0, "<command-line>", 0, 0 } } },
+                  blth = { -1, NULL, { { "<built-in>",     0, "<built-in>",     0, 0 } } },
+                  cmdn = { LMAP_NORMAL, &cmdh, { { NULL, 0, NULL, 0, 0 } } },    /* u.n set below */
+                  bltn = { LMAP_NORMAL, &blth, { { NULL, 0, NULL, 0, 0 } } };
 
     root.type = -1;
     root.u.i.f = (f)? f: nstdin;
@@ -558,12 +536,13 @@ void (lmap_close)(void)
     struct flb *p;
 
     for (i = 0; i < NELEM(flb); i++)
-        for (p = flb[i]; p; p = p->link)
-            if (p->pos)
-                MEM_FREE(p->pos);
-    for (i = 0; i < NELEM(fpb); i++)
-        if (fpb[i].fp)
-            fclose(fpb[i].fp);
+        for (p = flb[i]; p; p = p->link) {
+            if (p->base)
+                MEM_FREE(p->base);
+            if (p->idx)
+                MEM_FREE(p->idx);
+            p->n = 0;
+        }
     if (pbuf != buf)
         MEM_FREE(pbuf);
 }
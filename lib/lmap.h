@@ -5,6 +5,7 @@
 #ifndef LMAP_H
 #define LMAP_H
 
+#include <stddef.h>       /* offsetof */
 #include <cbl/arena.h>    /* arena_t */
 #ifndef NDEBUG
 #include <stdio.h>        /* FILE */
@@ -31,9 +32,11 @@ enum {
     LMAP_PIN        /* start of token for diagnostics */
 };
 
-/* line mapper node */
+/* line mapper node;
+   from precedes u so that LMAP_MACRO nodes can be allocated short */
 struct lmap_t {
-    int type;    /* type */
+    int type;                     /* type */
+    const struct lmap_t *from;    /* head or originating node */
     union {
         struct {
             const char *f;          /* nominal file name; cis */
@@ -54,7 +57,6 @@ struct lmap_t {
             sz_t dx;    /* x at which token ends; counted by wcwidth() */
         } n;            /* LMAP_NORMAL */
     } u;
-    const struct lmap_t *from;    /* head or originating node */
 };
 
 
@@ -65,7 +67,7 @@ extern const lmap_t *(*lmap_add)(int, sz_t);    /* function to get source locus
 
 
 void lmap_flset(const char *);
-void lmap_fline(sz_t, long);
+int lmap_flbuf(char *, const char *);
 const char *lmap_flget(const char *, sz_t);
 
 void lmap_setadd(int);
@@ -98,6 +100,10 @@ void lmap_print(const lmap_t *, FILE *);
 #define lmap_nfrom(p) (lmap_npfrom(1, (p)))
 #define lmap_pfrom(p) (lmap_npfrom(0, (p)))
 
+/* gets size of node */
+#define LMAP_MSIZE   (offsetof(lmap_t, u) + sizeof(((lmap_t *)0)->u.m))
+#define LMAP_SIZE(p) (((p)->type == LMAP_MACRO)? LMAP_MSIZE: sizeof(lmap_t))
+
 
 #endif    /* LMAP_H */
 
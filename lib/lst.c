@@ -371,6 +371,15 @@ void (lst_output)(lex_t *l)
 }
 
 
+/*
+ *  returns the last token of the base output list
+ */
+lex_t *(lst_tail)(void)
+{
+    return base.out;
+}
+
+
 /*
  *  copies a token
  */
@@ -381,7 +390,10 @@ lex_t *(lst_copy)(const lex_t *t, int npos, arena_t *a)
     assert(t);
 
     memcpy(p, t, sizeof(*p));
-    p->spell = (t->f.alloc)? hash_string(p->spell): p->spell;
+    if (t->f.alloc) {
+        p->spell = hash_string(p->spell);
+        p->f.chn = p->f.clean;
+    }
     if (npos && t->pos)
         p->pos = lmap_macro(t->pos, lmap_from, strg_perm);
     p->f.alloc = 0;
@@ -391,6 +403,38 @@ lex_t *(lst_copy)(const lex_t *t, int npos, arena_t *a)
 }
 
 
+/*
+ *  copies tokens from an array into a contiguous buffer linked as a list
+ */
+lex_t *(lst_copyv)(lex_t *const v[], int n, int npos, arena_t *a)
+{
+    int i;
+    lex_t *p;
+
+    assert(v);
+    assert(n >= 0);
+
+    if (n == 0)
+        return NULL;
+
+    p = ARENA_ALLOC(a, n * sizeof(*p));
+    for (i = 0; i < n; i++) {
+        memcpy(&p[i], v[i], sizeof(*p));
+        if (v[i]->f.alloc) {
+            p[i].spell = hash_string(p[i].spell);
+            p[i].f.chn = p[i].f.clean;
+        }
+        if (npos && v[i]->pos)
+            p[i].pos = lmap_macro(v[i]->pos, lmap_from, strg_perm);
+        p[i].f.alloc = 0;
+        p[i].next = &p[i+1];
+    }
+    p[n-1].next = p;
+
+    return &p[n-1];
+}
+
+
 /*
  *  copies a token list
  */
@@ -449,6 +493,86 @@ lex_t **(lst_toarray)(lex_t *l, arena_t *a)
 }
 
 
+/*
+ *  (token vector) prepares an empty vector
+ */
+void (lst_vinit)(lst_vec_t *pv)
+{
+    assert(pv);
+
+    pv->v = NULL;
+    pv->n = pv->size = 0;
+}
+
+
+/*
+ *  (token vector) appends a copy of a token;
+ *  tokens move when the vector grows
+ */
+void (lst_vadd)(lst_vec_t *pv, const lex_t *t, arena_t *a)
+{
+    lex_t *p;
+
+    assert(pv);
+    assert(t);
+
+    if (pv->n == pv->size) {
+        pv->size = (pv->size > 0)? pv->size*2: 16;
+        p = ARENA_ALLOC(a, pv->size * sizeof(*p));
+        if (pv->n > 0)
+            memcpy(p, pv->v, pv->n * sizeof(*p));
+        pv->v = p;
+    }
+
+    p = &pv->v[pv->n++];
+    memcpy(p, t, sizeof(*p));
+    if (t->f.alloc) {
+        p->spell = hash_string(p->spell);
+        p->f.chn = p->f.clean;
+    }
+    p->f.alloc = 0;
+}
+
+
+/*
+ *  (token vector) converts a vector to a null-terminated array
+ */
+lex_t **(lst_varray)(const lst_vec_t *pv, arena_t *a)
+{
+    int i;
+    lex_t **p;
+
+    assert(pv);
+
+    p = ARENA_ALLOC(a, (pv->n+1)*sizeof(*p));
+    for (i = 0; i < pv->n; i++)
+        p[i] = &pv->v[i];
+    p[i] = NULL;
+
+    return p;
+}
+
+
+/*
+ *  (token vector) links tokens in a vector as a list
+ */
+lex_t *(lst_vlist)(lst_vec_t *pv)
+{
+    int i;
+
+    assert(pv);
+
+    if (pv->n == 0)
+        return NULL;
+
+    for (i = 0; i < pv->n-1; i++)
+        pv->v[i].next = &pv->v[i+1];
+    pv->v[i].next = pv->v;
+
+    return &pv->v[i];
+}
+
+
 /*
  *  constructs a token list from a string
  */
@@ -13,6 +13,13 @@
 #include "lex.h"
 
 
+/* token vector */
+typedef struct lst_vec_t {
+    lex_t *v;    /* tokens */
+    int n;       /* # of tokens */
+    int size;    /* # of tokens allocated */
+} lst_vec_t;
+
 extern lex_t *(*lst_nexti)(void);    /* retrieves token from input list */
 extern lex_t *(*lst_peeki)(void);    /* looks ahead next token */
 
@@ -27,10 +34,16 @@ lex_t *lst_next(void);
 lex_t *lst_peek(void);
 lex_t *lst_peekns(void);
 void lst_output(lex_t *);
+lex_t *lst_tail(void);
 lex_t *lst_copy(const lex_t *, int, arena_t *);
+lex_t *lst_copyv(lex_t *const [], int, int, arena_t *);
 lex_t *lst_copyl(const lex_t *, int, arena_t *);
 int lst_length(const lex_t *);
 lex_t **lst_toarray(lex_t *, arena_t *);
+void lst_vinit(lst_vec_t *);
+void lst_vadd(lst_vec_t *, const lex_t *, arena_t *);
+lex_t **lst_varray(const lst_vec_t *, arena_t *);
+lex_t *lst_vlist(lst_vec_t *);
 lex_t *lst_run(const char *, const lmap_t *);
 void lst_free(void);
 #ifdef NDEBUG
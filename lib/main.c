@@ -8,9 +8,10 @@
 #include <stdarg.h>        /* va_list, va_start, va_end */
 #include <stddef.h>        /* NULL */
 #include <stdio.h>         /* FILE, fopen, stdin, stdout, stderr, fprintf, vfprintf, printf, puts,
-                              fclose */
+                              fclose, sprintf */
 #include <stdlib.h>        /* exit, getenv, EXIT_FAILURE */
-#include <string.h>        /* strcmp, strerror, strchr */
+#include <string.h>        /* strcmp, strerror, strchr, strlen */
+#include <cbl/arena.h>     /* ARENA_ALLOC */
 #include <cbl/assert.h>    /* assert */
 #include <cbl/except.h>    /* EXCEPT_TRY, EXCEPT_EXCEPT, EXCEPT_ELSE, EXCEPT_RERAISE, EXCEPT_END */
 #include <cdsl/hash.h>     /* hash_reset */
@@ -29,11 +30,17 @@
 #include "cpp.h"
 #include "decl.h"
 #include "err.h"
+#include "flow.h"
 #include "in.h"
 #include "inc.h"
+#include "inl.h"
 #include "ir.h"
+#include "lmap.h"
 #include "lst.h"
 #include "mcr.h"
+#include "pch.h"
+#include "peep.h"
+#include "srv.h"
 #include "strg.h"
 #include "ty.h"
 #include "util.h"
@@ -82,8 +89,12 @@ struct main_opt main_opt = {    /* default values */
     0,       /* pfldunsign */
     0,       /* xref */
     0,       /* glevel */
+    0,       /* olevel */
     0,       /* proto */
     0,       /* unwind */
+    0,       /* _ilabel */
+    0,       /* _stat */
+    0,       /* _swplan */
 #ifndef NDEBUG
     0,       /* _debug */
 #endif    /* !NDEBUG */
@@ -97,6 +108,7 @@ struct main_opt main_opt = {    /* default values */
     0,       /* onlystdmcr */
     0,       /* output */
     0,       /* pptool */
+    NULL,    /* pchdir */
 };
 
 struct main_tl main_tl;              /* translation limits */
@@ -116,6 +128,8 @@ static FILE *infile;            /* input file */
 static FILE *outfile;           /* output file */
 static const char *infname;     /* name of input file */
 static const char *outfname;    /* name of output file */
+static const char *srvname;     /* name of socket for compile server */
+static const char *target = DEFTARGET;    /* name of target */
 static int optfree;             /* true while necessary to call opt_free() */
 
 #ifdef HAVE_ICONV
@@ -326,6 +340,9 @@ static void quit(int code)
         fclose(outfile);
     if (optfree)
         opt_free();
+#ifdef HAVE_SOCKET
+    srv_done(code);
+#endif    /* HAVE_SOCKET */
 
     exit(code);
 }
@@ -417,6 +434,10 @@ static void help(void)
         /* for preprocessor */
         "  -3, --trigraph         supports trigraphs",
 
+        /* for preprocessor */
+        "      --cache-key        print a key for caching the output instead of",
+        "                           compiling",
+
         /* common */
         "      --colorize=<never|always|auto>",
         "                         use color in diagnostics",
@@ -478,6 +499,13 @@ static void help(void)
         /* common */
         "      --no-warning-code",
         "                         do not display warning codes in diagnostics",
+
+        /* for compiler proper */
+        "      --object           write an ELF object file instead of assembly",
+        "                         (x86-linux only)",
+        "  -O, --olevel[=<n>]     optimize at level <n>; 1 if <n> is omitted",
+
+        /* common */
         "  -o, --output=<file>    set output file",
 
         /* for preprocessor */
@@ -487,6 +515,11 @@ static void help(void)
         /* common */
         "      --path=<canonical|long|short>",
         "                         control how include paths are displayed",
+
+        /* for preprocessor */
+        "      --pch-dir=<dir>    cache preprocessed system headers in <dir>",
+
+        /* common */
         "      --plain-char=<signed|unsigned>",
         "                         set plain char type as signed or unsigned char",
 
@@ -497,6 +530,14 @@ static void help(void)
         "                         set pointers to be compatible with int or long int",
         "      --ptrdifft=<int|long>",
         "                         set ptrdiff_t type as int or long int",
+        "      --regparm[=<n>]    pass <n> arguments to static functions in registers;",
+        "                         3 if <n> is omitted (x86-linux only)",
+
+        /* common */
+        "      --server=<socket>  compile translation units sent to <socket> until the",
+        "                           standard input is closed",
+
+        /* for compiler proper */
         "      --show-prototype   output prototype information",
         "      --sizet=<uint|ulong>",
         "                         set size_t type as unsigned int or unsigned long",
@@ -555,6 +596,23 @@ static void help(void)
 }
 
 
+/*
+ *  opens input and output files
+ */
+static void openio(void)
+{
+    infile = stdin;
+    if (infname) {
+        errno = 0;
+        if ((infile = fopen(infname, "r")) == NULL)
+            ioerr(infname);
+    }
+    outfile = stdout;
+    if (outfname && (outfile = fopen(outfname, "w")) == NULL)
+        ioerr(outfname);
+}
+
+
 /*
  *  parses options
  */
@@ -593,10 +651,14 @@ static void parseopt(int argc, char **argv)
         "plain-int-field",      UCHAR_MAX+18, OPT_ARG_REQ,            OPT_TYPE_STR,
         "xref",                 'x',          &(main_opt.xref),       1,
         "glevel",               'g',          OPT_ARG_OPT,            OPT_TYPE_INT,
+        "olevel",               'O',          OPT_ARG_OPT,            OPT_TYPE_INT,
         "show-prototype",       0,            &(main_opt.proto),      1,
         "unwind-typedef",       0,            &(main_opt.unwind),     1,
         "exec-charset",         UCHAR_MAX+19, OPT_ARG_REQ,            OPT_TYPE_STR,
         "target",               UCHAR_MAX+20, OPT_ARG_REQ,            OPT_TYPE_STR,
+        "_interp-label",        0,            &(main_opt._ilabel),    1,
+        "_stat",                0,            &(main_opt._stat),      1,
+        "_switch-plan",         0,            &(main_opt._swplan),    1,
 #ifndef NDEBUG
         "_debug",               0,            &(main_opt._debug),     1,
 #endif    /* !NDEBUG */
@@ -622,6 +684,9 @@ static void parseopt(int argc, char **argv)
         "list-macro-defs",      UCHAR_MAX+28, OPT_ARG_NO,             OPT_TYPE_NO,
         "make-deps",            UCHAR_MAX+29, OPT_ARG_NO,             OPT_TYPE_NO,
         "make-deps-sys",        UCHAR_MAX+30, OPT_ARG_NO,             OPT_TYPE_NO,
+        "pch-dir",              UCHAR_MAX+31, OPT_ARG_REQ,            OPT_TYPE_STR,
+        "server",               UCHAR_MAX+32, OPT_ARG_REQ,            OPT_TYPE_STR,
+        "cache-key",            UCHAR_MAX+33, OPT_ARG_NO,             OPT_TYPE_NO,
         NULL,
     };
 
@@ -820,6 +885,14 @@ static void parseopt(int argc, char **argv)
                 } else
                     main_opt.glevel = 1;
                 break;
+            case 'O':    /* --olevel */
+                if (argptr) {
+                    main_opt.olevel = *(const long *)argptr;
+                    if (main_opt.olevel < 0)
+                        oerr("optimization level must be non-negative\n");
+                } else
+                    main_opt.olevel = 1;
+                break;
             case UCHAR_MAX+19:    /* --exec-charset */
 #ifdef HAVE_ICONV
                 main_opt.ecset = (const char *)argptr;
@@ -831,6 +904,7 @@ static void parseopt(int argc, char **argv)
                 ir_cur = ir_bind((const char *)argptr);
                 if (!ir_cur)
                     oerr("`%s' is not supported target\n", (const char *)argptr);
+                target = argptr;
                 break;
 
             /* for preprocessor */
@@ -897,6 +971,21 @@ static void parseopt(int argc, char **argv)
                 main_opt.pptool = 4;
                 main_opt.output = 2;
                 break;
+            case UCHAR_MAX+31:    /* --pch-dir */
+                main_opt.pchdir = argptr;
+                break;
+            case UCHAR_MAX+32:    /* --server */
+#ifdef HAVE_SOCKET
+                srvname = argptr;
+#else    /* !HAVE_SOCKET */
+                oerr("built without HAVE_SOCKET; --server not supported\n");
+#endif    /* HAVE_SOCKET */
+                break;
+            case UCHAR_MAX+33:    /* --cache-key */
+                main_opt.pponly = 1;
+                main_opt.pptool = 5;
+                main_opt.output = 2;
+                break;
 
             /* common case labels follow */
             case 0:    /* flag variable set; do nothing else now */
@@ -929,16 +1018,15 @@ static void parseopt(int argc, char **argv)
     if (main_opt.little_endian == 2)
         main_opt.little_endian = LITTLE;
 
-    infile = stdin;
     if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        if (srvname)
+            oerr("no input file allowed with --server\n");
         infname = argv[1];
-        errno = 0;
-        if ((infile = fopen(infname, "r")) == NULL)
-            ioerr(infname);
     }
-    outfile = stdout;
-    if (outfname && (outfile = fopen(outfname, "w")) == NULL)
-        ioerr(outfname);
+    if (srvname && outfname)
+        oerr("--output not allowed with --server\n");
+    if (!srvname)
+        openio();
 
     opt_free();
     optfree = 0;
@@ -1096,6 +1184,60 @@ static void postenv(void)
 }
 
 
+/*
+ *  composes a signature of options that affect the compiler proper or its diagnostics
+ *  for --cache-key
+ */
+static const char *keysig(void)
+{
+    char buf[128], *p;
+    const char *ec = "", *wc = "";
+
+#ifdef HAVE_ICONV
+    if (main_opt.ecset)
+        ec = main_opt.ecset;
+    if (main_opt.wcset)
+        wc = main_opt.wcset;
+#endif    /* HAVE_ICONV */
+    sprintf(buf, "%s %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %lx|", VERSION,
+            main_opt.std, main_opt.extension, main_opt.wchart, main_opt.logicshift,
+            main_opt.uchar, main_opt.sizet, main_opt.ptrdifft, main_opt.ptrlong,
+            main_opt.pfldunsign, main_opt.glevel, main_opt.olevel, main_opt.little_endian,
+            main_opt._ilabel, ir_cur->regparm, main_opt.nowarn, main_opt.stricterr,
+            main_opt.xref, err_sig());
+    p = ARENA_ALLOC(strg_perm, strlen(buf) + strlen(target)+1 + strlen(ec)+1 + strlen(wc)+1);
+    sprintf(p, "%s%s|%s|%s", buf, target, ec, wc);
+
+    return p;
+}
+
+
+#ifdef HAVE_SOCKET
+/*
+ *  runs a compile server;
+ *  returns only in a child process that compiles a translation unit
+ */
+static void serve(void)
+{
+    int r;
+
+    lmap_init(NULL, NULL);
+    mcr_init();
+    inc_init();
+    pch_init();
+
+    if ((r = srv_serve(srvname, &infname, &outfname)) < 0)
+        ioerr(srvname);
+    if (r == 0)
+        quit((err_count() == 0)? 0: EXIT_FAILURE);
+
+    openio();
+    in_init(infile, infname);
+    mcr_time();
+}
+#endif    /* HAVE_SOCKET */
+
+
 /*
  *  main function
  */
@@ -1119,9 +1261,17 @@ int main(int argc, char *argv[])
         strg_init();
         err_init();
         ty_init();
-        in_init(infile, infname);
-        mcr_init();
-        inc_init();
+#ifdef HAVE_SOCKET
+        if (srvname)
+            serve();
+        else
+#endif    /* HAVE_SOCKET */
+        {
+            in_init(infile, infname);
+            mcr_init();
+            inc_init();
+            pch_init();
+        }
         if (main_opt()->pponly) {
             switch(main_opt.output) {
                 case 0:    /* normal */
@@ -1131,7 +1281,12 @@ int main(int argc, char *argv[])
                     cpp_nosync(outfile);
                     break;
                 case 2:    /* no output */
-                    cpp_nout();
+                    if (main_opt.pptool == 5) {    /* --cache-key */
+                        const char *sig = keysig();
+                        main_opt.nowarn = 1;    /* issued when compiled */
+                        cpp_key(outfile, sig);
+                    } else
+                        cpp_nout();
                     break;
                 default:
                     assert(!"invalid output mode -- should never reach here");
@@ -1143,6 +1298,9 @@ int main(int argc, char *argv[])
             ir_cur->progbeg(outfile);
             decl_program();
             decl_finalize();
+            inl_close();
+            flow_close();
+            peep_close();
             ir_cur->progend();
         }
         if (err_chkwarn(ERR_PP_UNUSEDMCR))
@@ -1166,6 +1324,9 @@ int main(int argc, char *argv[])
         EXCEPT_RERAISE;
 #endif
     EXCEPT_END
+#ifdef HAVE_SOCKET
+    srv_report();
+#endif    /* HAVE_SOCKET */
 
     EXCEPT_TRY    /* tries to clean up */
         cpp_close();
@@ -1173,6 +1334,7 @@ int main(int argc, char *argv[])
         in_close();
         mcr_free();
         inc_free();
+        pch_free();
         err_close();
         strg_close();
         hash_reset();
@@ -45,8 +45,12 @@ struct main_opt {
     int pfldunsign;         /* 0: plain bit-field is signed, 1: unsigned */
     int xref;               /* cross-reference info generated if set */
     int glevel;             /* debugging level */
+    int olevel;             /* optimization level */
     int proto;              /* prints prototype declarations for globals */
     int unwind;             /* unwind typedef names */
+    int _ilabel;            /* (internal) labels dags without BURS tables */
+    int _stat;              /* (internal) prints statistics on instruction selection */
+    int _swplan;            /* (internal) prints plans for switch statements */
 #ifndef NDEBUG
     int _debug;             /* (internal) prints debugging info for back-end */
 #endif    /* !NDEBUG */
@@ -59,7 +63,8 @@ struct main_opt {
     int nostdinc;           /* do not follow system include paths if set */
     int onlystdmcr;         /* do not predefine non-standard macros if set */
     int output;             /* 0: normal, 1: no linemarkers, 2: no output */
-    int pptool;             /* 0: normal, 1: -H, 2: -dM, 3: -MM, 4: -M */
+    int pptool;             /* 0: normal, 1: -H, 2: -dM, 3: -MM, 4: -M, 5: cache key */
+    const char *pchdir;     /* directory for header cache */
 };
 
 /* translation limits */
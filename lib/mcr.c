@@ -25,19 +25,19 @@
 #include "lst.h"
 #include "lmap.h"
 #include "main.h"
+#include "pch.h"
 #include "strg.h"
 #include "ty.h"
 #include "util.h"
 #include "mcr.h"
 #include "../version.h"
 
-#define MTAB  128      /* initial size of macro table; must be power of 2 */
-#define MAXMT 32768    /* max size of macro table */
+#define MTAB 256    /* initial size of macro table; must be power of 2 */
 
 #define MAXDS 6        /* max number of successive #'s to fully diagnose */
 
 #define EXPANDING(p) ((p) && (p)->count > 0)                 /* checks if macro being expanded */
-#define SPELL(t, s)  ((t)->spell = (s), (t)->f.alloc = 0)    /* sets spelling of token */
+#define SPELL(t, s)  ((t)->spell = (s), (t)->f.alloc = (t)->f.chn = 0)    /* sets spelling of token */
 #define isempty(t)   (*(t)->spell == '\0')                   /* true if empty token */
 
 /* issues diagnostics for unused macros */
@@ -80,13 +80,15 @@ struct pel {
 };
 
 
-/* macro table */
+/* macro table;
+   open addressing with hashed names, removed macros left with null names */
 static struct {
-    size_t u, n;    /* # of used/total buckets */
+    size_t u, n;    /* # of used/total slots */
     struct mtab {
         const char *chn;      /* macro name (clean, hashed) */
         const lmap_t *pos;    /* definition locus */
         lex_t **rl;           /* replacement list */
+        int rn;               /* # of tokens in replacement list */
         struct {
             unsigned flike:   1;    /* function-like */
             unsigned vaarg:   1;    /* variadic */
@@ -98,9 +100,9 @@ static struct {
         struct {
             int argno;         /* # of arguments */
             lex_t **param;     /* parameters */
+            int *pidx;         /* parameter index + 1 for each replacement token */
             struct pel *pe;    /* parameter expansion list */
         } func;                /* function-like macro */
-        struct mtab *link;    /* hash chain */
     } **t;
 } mtab;
 
@@ -109,18 +111,21 @@ static struct eml {
     const char *chn;     /* macro name (clean, hashed) */
     int count;           /* nesting count */
     struct eml *next;    /* next entry */
-} *em;
+} *em, *efree;
 
 static int diagds;      /* true if issueing ERR_PP_ORDERDS is enabled */
 static list_t *cmdl;    /* (command list) macros from command line */
 static int nppname;     /* number of macros defined */
 static sz_t counter;    /* tracks __COUNTER__ */
 
+static char pdate[] = "\"May  4 1979\"",    /* spelling of __DATE__ */
+            ptime[] = "\"07:10:05\"";       /* spelling of __TIME__ */
+
 
 /*
  *  (parameter expansion list) adds a parameter
  */
-static struct pel *peadd(struct pel *l, const lex_t *t, const lmap_t **found)
+static struct pel *peadd(struct pel *l, lex_t *t, const lmap_t **found)
 {
     const char *chn;
     struct pel *p;
@@ -128,7 +133,7 @@ static struct pel *peadd(struct pel *l, const lex_t *t, const lmap_t **found)
     assert(t);
     assert(found);
 
-    chn = hash_string(LEX_SPELL(t));
+    chn = lex_chn(t);
     for (p = l; p; p = p->next)
         if (p->chn == chn) {
             *found = p->pos;
@@ -149,13 +154,13 @@ static struct pel *peadd(struct pel *l, const lex_t *t, const lmap_t **found)
 /*
  *  (parameter expansion list) looks up a parameter
  */
-static struct pel *pelookup(struct pel *p, const lex_t *t)
+static struct pel *pelookup(struct pel *p, lex_t *t)
 {
     const char *chn;
 
     assert(t);
 
-    chn = hash_string(LEX_SPELL(t));
+    chn = lex_chn(t);
     for (; p; p = p->next)
         if (p->chn == chn)
             break;
@@ -178,7 +183,10 @@ void (mcr_eadd)(const char *chn)
             break;
 
     if (!p) {
-        MEM_NEW(p);
+        if (efree)
+            p = efree, efree = efree->next;
+        else
+            MEM_NEW(p);
         p->chn = chn;
         p->count = 0;
         p->next = em;
@@ -191,14 +199,14 @@ void (mcr_eadd)(const char *chn)
 /*
  *  (expanding macro list) looks up an identifier
  */
-static struct eml *elookup(const lex_t *t)
+static struct eml *elookup(lex_t *t)
 {
     struct eml *p;
     const char *chn;
 
     assert(t);
 
-    chn = hash_string(LEX_SPELL(t));
+    chn = lex_chn(t);
     for (p = em; p; p = p->next)
         if (p->chn == chn)
             break;
@@ -220,43 +228,39 @@ void (mcr_edel)(const char *chn)
         if ((*p)->chn == chn && --(*p)->count == 0) {
             q = *p;
             *p = q->next;
-            MEM_FREE(q);
+            q->next = efree;
+            efree = q;
             break;
         }
 }
 
 
 /*
- *  (parameter list) adds a macro parameter
+ *  (parameter list) sets the n-th macro parameter;
+ *  parameters are kept in an array chained in order
  */
-static struct pl *padd(struct pl *pl, const lex_t *t, lex_t **rl, lex_t *el)
+static void padd(struct pl *pl, int n, lex_t *t, lex_t **rl, lex_t *el)
 {
-    const char *chn;
-    struct pl *p;
-
+    assert(pl);
+    assert(n >= 0);
     assert(t);
 
-    chn = hash_string(LEX_SPELL(t));
-    p = ARENA_ALLOC(strg_perm, sizeof(*p));
-    p->chn = chn;
-    p->rl = rl;
-    p->el = el;
-    p->next = pl;
-
-    return p;
+    pl[n].chn = lex_chn(t);
+    pl[n].rl = rl;
+    pl[n].el = el;
 }
 
 
 /*
  *  (parameter list) look up a parameter
  */
-static struct pl *plookup(struct pl *p, const lex_t *t)
+static struct pl *plookup(struct pl *p, lex_t *t)
 {
     const char *chn;
 
     assert(t);
 
-    chn = hash_string(LEX_SPELL(t));
+    chn = lex_chn(t);
     for (; p; p = p->next)
         if (p->chn == chn)
             break;
@@ -266,22 +270,41 @@ static struct pl *plookup(struct pl *p, const lex_t *t)
 
 
 /*
- *  (macro table) adjusts the size of a hash bucket
+ *  (parameter list) finds an argument for a replacement token by its index
+ */
+static struct pl *pget(const struct mtab *p, struct pl *pl, lex_t **q)
+{
+    int i;
+
+    assert(p);
+    assert(pl);
+    assert(q);
+
+    i = p->func.pidx[q - p->rl];
+
+    return (i > 0 && pl[i-1].chn)? &pl[i-1]: NULL;
+}
+
+
+/*
+ *  (macro table) doubles the number of slots;
+ *  drops removed macros and counts the entry being inserted
  */
 static void resize(void)
 {
     unsigned h;
-    struct mtab *p, *q, **nt;
+    struct mtab *p, **nt;
     size_t i, nn = mtab.n * 2;
 
     nt = MEM_CALLOC(nn, sizeof(*nt));
 
+    mtab.u = 1;    /* entry being inserted */
     for (i = 0; i < mtab.n; i++)
-        for (p = mtab.t[i]; p; p = q) {
-            q = p->link;
-            h = hashkey(p->chn, nn);
-            p->link = nt[h];
+        if ((p = mtab.t[i]) != NULL && p->chn) {
+            for (h = hashkey(p->chn, nn); nt[h]; h = (h+1) & (nn-1))
+                continue;
             nt[h] = p;
+            mtab.u++;
         }
 
     MEM_FREE(mtab.t);
@@ -306,21 +329,23 @@ static int eqtlist(lex_t *p[], lex_t *q[])
 
 
 /*
- *  (macro table) adds an identifier
+ *  (macro table) adds an identifier;
+ *  chn is assumed to be a hash string
  */
-static struct mtab *add(const char *cn, const lmap_t *pos, lex_t *l[], lex_t *param[], int vaarg)
+static struct mtab *add(const char *chn, const lmap_t *pos, lex_t *l[], lex_t *param[],
+                        int vaarg)
 {
     unsigned h;
-    const char *chn;
-    struct mtab *p;
+    struct mtab *p, **d = NULL;
 
-    assert(cn);
+    assert(chn);
     assert(pos);
 
-    chn = hash_string(cn);
-    h = hashkey(chn, mtab.n);
-    for (p = mtab.t[h]; p; p = p->link)
-        if (p->chn == chn) {
+    for (h = hashkey(chn, mtab.n); (p = mtab.t[h]) != NULL; h = (h+1) & (mtab.n-1)) {
+        if (!p->chn) {
+            if (!d)
+                d = &mtab.t[h];    /* reuses slot of removed macro */
+        } else if (p->chn == chn) {
             if ((p->f.flike ^ !!param) || p->f.vaarg != vaarg || !eqtlist(p->rl, l) ||
                 (param && !eqtlist(p->func.param, param)))
                 (void)(err_dpos(pos, ERR_PP_MCRREDEF, chn) &&
@@ -332,42 +357,47 @@ static struct mtab *add(const char *cn, const lmap_t *pos, lex_t *l[], lex_t *pa
             }
             return NULL;
         }
-    if (++mtab.u*3 > mtab.n*2 && mtab.n < MAXMT) {
-        resize();
-        h = hashkey(chn, mtab.n);
+    }
+    if (!d) {
+        if (++mtab.u*3 > mtab.n*2) {
+            resize();
+            for (h = hashkey(chn, mtab.n); mtab.t[h]; h = (h+1) & (mtab.n-1))
+                continue;
+        }
+        d = &mtab.t[h];
     }
 
     p = ARENA_CALLOC(strg_perm, 1, sizeof(*p));
     p->chn = chn;
     p->pos = pos;
     p->rl = l;
+    while (l[p->rn])
+        p->rn++;
     p->f.flike = !!param;
     p->f.vaarg = vaarg;
     p->func.argno = -1;
     p->func.param = param;
-    p->link = mtab.t[h];
-    mtab.t[h] = p;
+    *d = p;
 
     return p;
 }
 
 
 /*
- *  (macro table) looks up an identifier
+ *  (macro table) looks up an identifier;
+ *  chn is assumed to be a hash string
  */
-static struct mtab *lookup(const char *cn)
+static struct mtab *lookup(const char *chn)
 {
     unsigned h;
-    const char *chn;
     struct mtab *p;
 
-    assert(cn);
+    assert(chn);
 
-    chn = hash_string(cn);
-    h = hashkey(chn, mtab.n);
-    for (p = mtab.t[h]; p; p = p->link)
+    for (h = hashkey(chn, mtab.n); (p = mtab.t[h]) != NULL; h = (h+1) & (mtab.n-1))
         if (p->chn == chn)
             break;
+    pch_macro(chn);
 
     return p;
 }
@@ -379,9 +409,30 @@ static struct mtab *lookup(const char *cn)
  */
 int (mcr_redef)(const char *cn)
 {
-    struct mtab *p = lookup(cn);
+    struct mtab *p = lookup(hash_string(cn));
 
-    return (p)? (p->f.used = 1): 0;
+    if (!p)
+        return 0;
+    p->f.used = 1;
+    pch_use(p->chn);
+
+    return 1;
+}
+
+
+/*
+ *  (macro table) removes a macro
+ */
+static void del(struct mtab *p)
+{
+    assert(p);
+    assert(!p->f.predef);
+
+    if (err_chkwarn(ERR_PP_UNUSEDMCR))
+        UNUSEDMCR(p);
+    p->chn = NULL;
+    nppname--;
+    assert(nppname >= 0);
 }
 
 
@@ -395,23 +446,51 @@ void (mcr_del)(lex_t *t)
 
     assert(t);
 
-    p = lookup(cn = LEX_SPELL(t));
+    p = lookup(cn = lex_chn(t));
     MCR_IDVAARGS(cn, t);
     if (p) {
         if (p->f.predef)
             err_dpos(t->pos, ERR_PP_PMCRUNDEF, cn);
         else {
-            if (err_chkwarn(ERR_PP_UNUSEDMCR))
-                UNUSEDMCR(p);
-            p->chn = NULL;
-            nppname--;
-            assert(nppname >= 0);
+            del(p);
+            pch_undef(cn);
         }
     } else
         err_dpos(t->pos, ERR_PP_UNDEFMCR, cn);
 }
 
 
+/*
+ *  resolves parameters in a replacement list into their indices
+ */
+static int *pindex(lex_t *rl[], lex_t *param[], arena_t *strg)
+{
+    int i, *pidx;
+    lex_t **q;
+    const char *chn;
+
+    assert(rl);
+    assert(param);
+    assert(strg);
+
+    for (q = rl; *q; q++)
+        continue;
+    pidx = ARENA_CALLOC(strg, q-rl+1, sizeof(*pidx));
+
+    for (q = rl; *q; q++)
+        if ((*q)->id == LEX_ID) {
+            chn = lex_chn(*q);
+            for (i = 0; param[i]; i++)
+                if (lex_chn(param[i]) == chn) {
+                    pidx[q-rl] = i + 1;
+                    break;
+                }
+        }
+
+    return pidx;
+}
+
+
 /*
  *  checks if parameters need to be expanded
  */
@@ -523,7 +602,7 @@ lex_t *(mcr_define)(const lmap_t *pos, int cmd)
         err_dpos(lmap_after(pos), ERR_PP_NOMCRID);
         return t;
     }
-    cn = LEX_SPELL(t);
+    cn = lex_chn(t);
     idpos = t->pos;
     MCR_IDVAARGS(cn, t);
     strg = (lookup(cn))? strg_line: strg_perm;
@@ -668,6 +747,7 @@ lex_t *(mcr_define)(const lmap_t *pos, int cmd)
             err_dpos(idpos, ERR_PP_MCRDEF);
             return t;
         }
+        pch_macro(cn);    /* previous definition */
         p = add(cn, idpos, lst_toarray(l, strg), param, !!v);
         if (p) {
             if (nppname++ == TL_PPNAME_STD)
@@ -676,6 +756,8 @@ lex_t *(mcr_define)(const lmap_t *pos, int cmd)
             if (n >= 0) {
                 p->func.argno = n;
                 p->func.pe = pe;
+                if (n > 0)
+                    p->func.pidx = pindex(p->rl, param, strg);
                 if (sharp && n > 0)
                     chkexp(pe, p->rl);
             }
@@ -686,12 +768,106 @@ lex_t *(mcr_define)(const lmap_t *pos, int cmd)
                        err_dpos(idpos, ERR_LEX_LONGIDSTD, (long)TL_INAME_STD) &&
                        err_dpos(p->pos, ERR_LEX_SEEID, p->chn));
         }
+        pch_define(cn);
     }
 
     return t;
 }
 
 
+/*
+ *  (macro table) gets a macro definition for the header cache
+ */
+int (mcr_getdef)(const char *cn, mcr_def_t *d)
+{
+    struct mtab *p;
+
+    assert(cn);
+    assert(d);
+
+    if ((p = lookup(hash_string(cn))) == NULL)
+        return 0;
+
+    d->pos = p->pos;
+    d->rl = p->rl;
+    d->param = p->func.param;
+    d->argno = p->func.argno;
+    d->vaarg = p->f.vaarg;
+    d->sharp = p->f.sharp;
+    d->dynamic = p->f.dynamic;
+
+    return 1;
+}
+
+
+/*
+ *  (macro table) installs a macro definition from the header cache;
+ *  does what mcr_define() does without diagnostics
+ */
+void (mcr_setdef)(const char *cn, const mcr_def_t *d)
+{
+    lex_t **q;
+    struct mtab *p;
+    struct pel *pe = NULL, *r;
+    const lmap_t *dup;
+
+    assert(cn);
+    assert(d);
+    assert(d->pos);
+    assert(d->rl);
+
+    p = add(hash_string(cn), d->pos, d->rl, d->param, d->vaarg);
+    if (p) {
+        nppname++;
+        if (d->param) {
+            for (q = d->param; *q; q++)
+                pe = peadd(pe, *q, &dup);
+            if (d->argno > 0) {
+                for (q = d->rl; *q; q++)
+                    if ((*q)->id == LEX_ID && (r = pelookup(pe, *q)) != NULL)
+                        r->expand++;
+                p->func.pidx = pindex(d->rl, d->param, strg_perm);
+            }
+            p->func.argno = d->argno;
+            p->func.pe = pe;
+            if (d->sharp && d->argno > 0)
+                chkexp(pe, p->rl);
+        }
+        if (d->sharp)
+            p->f.sharp = 1;
+        (void)conflict(p->chn);
+    }
+}
+
+
+/*
+ *  (macro table) #undefines a macro from the header cache
+ */
+void (mcr_undef)(const char *cn)
+{
+    struct mtab *p;
+
+    assert(cn);
+
+    if ((p = lookup(hash_string(cn))) != NULL && !p->f.predef)
+        del(p);
+}
+
+
+/*
+ *  (macro table) marks a macro used from the header cache
+ */
+void (mcr_use)(const char *cn)
+{
+    struct mtab *p;
+
+    assert(cn);
+
+    if ((p = lookup(hash_string(cn))) != NULL)
+        p->f.used = 1;
+}
+
+
 /*
  *  concatenates tow tokens
  */
@@ -851,8 +1027,10 @@ static lex_t *paste(lex_t *t1, lex_t *t2, struct pl *pl, lex_t **ll, lex_t **pds
     if (pl) {
         if (t1->id == LEX_ID && !t1->f.noarg && (p = plookup(pl, t1)) != NULL) {
             if (*(q = p->rl) != NULL) {
-                for (; q[1]; q++)
-                    l = lst_append(l, lst_copy(*q, 1, strg_line));
+                while (q[1])
+                    q++;
+                if (q > p->rl)
+                    l = lst_append(l, lst_copyv(p->rl, q - p->rl, 1, strg_line));
                 t1 = *q;
             } else
                 t1 = &empty;
@@ -1114,16 +1292,25 @@ static lex_t *nextspnl(int nl, lex_t **pnl)
  */
 static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
 {
+    int arg = 0;
     int errarg = 0;
     int level = 1, n = 0;
     lex_t *t, *nl = NULL;
-    lex_t *tl = NULL, **rl;
+    lex_t **rl;
+    lst_vec_t tv;
     struct pl *pl = NULL;
     const lmap_t *pos, *prnpos, *tpos;
 
     assert(p);
     assert(ppos);
 
+    if (p->func.argno > 0)
+        pl = ARENA_CALLOC(strg_line, p->func.argno, sizeof(*pl));
+    for (n = 1; n < p->func.argno; n++)
+        pl[n-1].next = &pl[n];
+    n = 0;
+    lst_vinit(&tv);
+
     pos = *ppos;
     while ((t = lst_nexti())->id != '(')
         continue;
@@ -1137,7 +1324,7 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
                 (!lex_direc || u->id != LEX_NEWLINE)) {
                 t->id = LEX_SPACE;
                 SPELL(t, " ");
-                tl = lst_append(tl, lst_copy(t, 0, strg_line));
+                lst_vadd(&tv, t, strg_line);
             }
             t = u;
             continue;
@@ -1148,18 +1335,18 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
                 /* no break */
             case ',':
                 if (level > (t->id == ',')) {
-                    assert(tl);
-                    tl = lst_append(tl, lst_copy(t, 0, strg_line));
-                } else if (p->f.vaarg && level == 1 && n == p->func.argno - !tl) {
-                    if (!tl && ++n == TL_ARGP_STD+1 && !errarg) {
+                    assert(tv.n > 0);
+                    lst_vadd(&tv, t, strg_line);
+                } else if (p->f.vaarg && level == 1 && n == p->func.argno - (tv.n == 0)) {
+                    if (tv.n == 0 && ++n == TL_ARGP_STD+1 && !errarg) {
                         tpos = lmap_macro(t->pos, pos, strg_line);
                         (void)(err_dpos(tpos, ERR_PP_MANYARGW, p->chn) &&
                                err_dpos(tpos, ERR_PP_MANYARGSTD, (long)TL_ARGP_STD));
                     }
-                    tl = lst_append(tl, lst_copy(t, 0, strg_line));
+                    lst_vadd(&tv, t, strg_line);
                 } else {
                     if (t->id == ',' || p->func.argno > 0) {
-                        if (!tl) {
+                        if (tv.n == 0) {
                             if (n++ == p->func.argno) {
                                 ((void)(err_dpos(lmap_macro(t->pos, pos, strg_line),
                                                  ERR_PP_MANYARG, p->chn) &&
@@ -1183,11 +1370,12 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
                             assert(n > 0);
                             pe = pelookup(p->func.pe, p->func.param[n-1]);
                             assert(pe);
-                            rl = lst_toarray(tl, strg_line);    /* before exparg() */
-                            pl = padd(pl, p->func.param[n-1], rl, (pe->expand)?
-                                                                      exparg(tl, pos): NULL);
+                            rl = lst_varray(&tv, strg_line);    /* before exparg() */
+                            padd(pl, n-1, p->func.param[n-1], rl,
+                                 (pe->expand)? exparg(lst_vlist(&tv), pos): NULL);
+                            arg = 1;
                         }
-                        tl = NULL;
+                        lst_vinit(&tv);
                     }
                     if (t->id == ')')
                         goto ret;
@@ -1198,7 +1386,7 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
             case '(':
                 level++;
             default:
-                if (!tl) {
+                if (tv.n == 0) {
                     if (n++ == p->func.argno) {
                         ((void)(err_dpos(lmap_macro(t->pos, pos, strg_line), ERR_PP_MANYARG,
                                          p->chn) &&
@@ -1211,7 +1399,7 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
                                err_dpos(tpos, ERR_PP_MANYARGSTD, (long)TL_ARGP_STD));
                     }
                 }
-                tl = lst_append(tl, lst_copy(t, 0, strg_line));
+                lst_vadd(&tv, t, strg_line);
                 break;
         }
         t = lst_nexti();
@@ -1232,14 +1420,15 @@ static struct pl *recarg(struct mtab *p, const lmap_t **ppos, int *pnoarg)
                         err_dpos(p->pos, ERR_PARSE_DEFHERE)));
             *pnoarg = 1;
             while (n++ < p->func.argno)
-                pl = padd(pl, p->func.param[n-1], lst_toarray(tl, strg_line), NULL);
+                padd(pl, n-1, p->func.param[n-1], lst_varray(&tv, strg_line), NULL);
+            arg = 1;
         }
 
         if ((t->id == LEX_EOI || t->id == LEX_NEWLINE) && nl)
             lst_insert(lst_copy(nl, 0, strg_line));
         lst_discard(1);    /* removes from macro name to end of invocation */
 
-        return pl;
+        return (arg)? pl: NULL;
 }
 
 #undef ISNL
@@ -1287,7 +1476,7 @@ int (mcr_expand)(lex_t *t)
 
     assert(t);
 
-    p = lookup(s = LEX_SPELL(t));
+    p = lookup(s = lex_chn(t));
     MCR_IDVAARGS(s, t);
     if (!p || t->f.blue)
         return 0;
@@ -1297,6 +1486,8 @@ int (mcr_expand)(lex_t *t)
 
         if (p->f.predef) {
             assert(ISPREDMCR(s));
+            if (p->f.dynamic)
+                pch_taint();
             switch(s[2]) {
                 case 'F':
                     if (strcmp(s, "__FILE__") == 0) {
@@ -1351,33 +1542,41 @@ int (mcr_expand)(lex_t *t)
     }
 
     p->f.used = 1;
+    pch_use(p->chn);
     tpos = lmap_from, lmap_from = idpos;    /* set */
     mcr_eadd(p->chn);
     l = lst_append(l, lex_make(LEX_MCR, p->chn, 0));
-    if (pl)
-        for (q = p->func.param; *q; q++) {
-            r = plookup(pl, *q);
-            if (r && r->el)
-                paint(r->el);
+    for (r = pl; r; r = r->next)
+        if (r->el)
+            paint(r->el);
+    if (!pl && !p->f.sharp) {    /* copies replacement list at once */
+        lex_t *v = lst_copyv(p->rl, p->rn, 1, strg_line);
+        if (v) {
+            for (q = p->rl, t = v->next; *q; q++, t++)
+                if ((*q)->id == LEX_ID && EXPANDING(elookup(*q)))
+                    t->f.blue = 1;
+            l = lst_append(l, v);
         }
-    for (q = p->rl; *q; ) {
-        t = *q++;
-        if (p->f.sharp && sharp(&q, t, pl, &l, noarg))
-            continue;
-        else if (t->id == LEX_ID) {
-            if (pl && (r = plookup(pl, t)) != NULL) {
-                l = lst_append(l, lex_make(LEX_MCR, NULL, 0));
-                if (r->el)    /* el already has correct u.m chain */
-                    l = lst_append(l, lst_copyl(r->el, 0, strg_line));
-                l = lst_append(l, lex_make(LEX_MCR, NULL, 1));
-            } else {
+    } else {
+        for (q = p->rl; *q; ) {
+            t = *q++;
+            if (p->f.sharp && sharp(&q, t, pl, &l, noarg))
+                continue;
+            else if (t->id == LEX_ID) {
+                if (pl && (r = pget(p, pl, q-1)) != NULL) {
+                    l = lst_append(l, lex_make(LEX_MCR, NULL, 0));
+                    if (r->el)    /* el already has correct u.m chain */
+                        l = lst_append(l, lst_copyl(r->el, 0, strg_line));
+                    l = lst_append(l, lex_make(LEX_MCR, NULL, 1));
+                } else {
+                    l = lst_append(l, lst_copy(t, 1, strg_line));
+                    pe = elookup(t);
+                    if (EXPANDING(pe))
+                        l->f.blue = 1;
+                }
+            } else
                 l = lst_append(l, lst_copy(t, 1, strg_line));
-                pe = elookup(t);
-                if (EXPANDING(pe))
-                    l->f.blue = 1;
-            }
-        } else
-            l = lst_append(l, lst_copy(t, 1, strg_line));
+        }
     }
     l = lst_append(l, lex_make(LEX_MCR, p->chn, 1));
     mcr_edel(p->chn);
@@ -1400,7 +1599,7 @@ static struct mtab *addpr(const char *name, int tid, const char *val)
     assert(tid == LEX_SCON || tid == LEX_PPNUM || tid == LEX_ID);
     assert(val);
     assert(tid != LEX_PPNUM || isdigit(*(unsigned char *)val));
-    assert(!lookup(name));
+    assert(!lookup(hash_string(name)));
     assert(ISPREDMCR(name));
 
     if (*val) {
@@ -1410,7 +1609,7 @@ static struct mtab *addpr(const char *name, int tid, const char *val)
         t->pos = lmap_bltin;
     }
 
-    p = add(name, lmap_bltin, lst_toarray(t, strg_perm), NULL, 0);
+    p = add(hash_string(name), lmap_bltin, lst_toarray(t, strg_perm), NULL, 0);
     assert(p);
     p->f.predef = 1;
 
@@ -1622,6 +1821,21 @@ VERSION             __VERSION__
 }
 
 
+/*
+ *  (predefined) sets __DATE__ and __TIME__ to the current time;
+ *  also called when a compile server starts a translation unit
+ */
+void (mcr_time)(void)
+{
+    time_t tm = time(NULL);
+    char *p = ctime(&tm);    /* Fri May  4 07:10:05 1979\n */
+
+    strncpy(pdate+1, p+4, 7);
+    strncpy(pdate+8, p+20, 4);
+    strncpy(ptime+1, p+11, 8);
+}
+
+
 /*
  *  (predefined, command-line) initializes macros;
  *  ASSUMPTION: hosted implementation assumed;
@@ -1630,21 +1844,12 @@ VERSION             __VERSION__
  */
 void (mcr_init)(void)
 {
-    static char pdate[] = "\"May  4 1979\"",
-                ptime[] = "\"07:10:05\"";
-
-    time_t tm = time(NULL);
-    char *p = ctime(&tm);    /* Fri May  4 07:10:05 1979\n */
-
     mtab.t = MEM_CALLOC(MTAB, sizeof(*mtab.t));
     mtab.n = MTAB;
 
     /* standard */
-    strncpy(pdate+1, p+4, 7);
-    strncpy(pdate+8, p+20, 4);
+    mcr_time();
     addpr("__DATE__", LEX_SCON, pdate);
-
-    strncpy(ptime+1, p+11, 8);
     addpr("__TIME__", LEX_SCON, ptime);
 
     addpr("__FILE__", LEX_SCON, "\"\"")->f.dynamic = 1;
@@ -1702,7 +1907,7 @@ void (mcr_unused)(void)
     struct mtab *p;
 
     for (h = 0; h < mtab.n; h++)
-        for (p = mtab.t[h]; p; p = p->link)
+        if ((p = mtab.t[h]) != NULL)
             UNUSEDMCR(p);
 }
 
@@ -1716,33 +1921,32 @@ void (mcr_listdef)(FILE *fp)
     struct mtab *p;
     lex_t **pt;
 
-    for (h = 0; h < mtab.n; h++)
-        for (p = mtab.t[h]; p; p = p->link) {
-            if (p->f.dynamic)
-                continue;
-            fprintf(fp, "#define %s", p->chn);
-            if (p->f.flike) {
-                int n = p->func.argno - p->f.vaarg;
-                putc('(', fp);
-                if (n-- > 0) {
-                    fputs(LEX_SPELL(p->func.param[0]), fp);
-                    pt = &p->func.param[1];
-                    while (n-- > 0) {
-                        fprintf(fp, ", %s", LEX_SPELL(*pt));
-                        pt++;
-                    }
+    for (h = 0; h < mtab.n; h++) {
+        if ((p = mtab.t[h]) == NULL || !p->chn || p->f.dynamic)
+            continue;
+        fprintf(fp, "#define %s", p->chn);
+        if (p->f.flike) {
+            int n = p->func.argno - p->f.vaarg;
+            putc('(', fp);
+            if (n-- > 0) {
+                fputs(LEX_SPELL(p->func.param[0]), fp);
+                pt = &p->func.param[1];
+                while (n-- > 0) {
+                    fprintf(fp, ", %s", LEX_SPELL(*pt));
+                    pt++;
                 }
-                if (p->f.vaarg)
-                    fprintf(fp, "%s...", (p->func.argno > 1)? ", ": "");
-                putc(')', fp);
             }
-            if (p->rl[0]) {
-                putc(' ', fp);
-                for (pt = p->rl; *pt; pt++)
-                    fputs(LEX_SPELL(*pt), fp);
-            }
-            putc('\n', fp);
+            if (p->f.vaarg)
+                fprintf(fp, "%s...", (p->func.argno > 1)? ", ": "");
+            putc(')', fp);
+        }
+        if (p->rl[0]) {
+            putc(' ', fp);
+            for (pt = p->rl; *pt; pt++)
+                fputs(LEX_SPELL(*pt), fp);
         }
+        putc('\n', fp);
+    }
 }
 
 
@@ -1758,6 +1962,10 @@ void (mcr_free)(void)
         q = em->next;
         MEM_FREE(em);
     }
+    for (; efree; efree = q) {
+        q = efree->next;
+        MEM_FREE(efree);
+    }
 }
 
 
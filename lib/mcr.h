@@ -13,12 +13,29 @@
 #include "lmap.h"
 
 
+/* macro definition for the header cache */
+typedef struct mcr_def_t {
+    const lmap_t *pos;    /* definition locus */
+    lex_t **rl;           /* replacement list */
+    lex_t **param;        /* parameters; NULL if object-like */
+    int argno;            /* # of arguments */
+    int vaarg;            /* true if variadic */
+    int sharp;            /* true if has # or ## */
+    int dynamic;          /* true if generated dynamically */
+} mcr_def_t;
+
+
 void mcr_eadd(const char *);
 void mcr_edel(const char *);
 int mcr_redef(const char *);
 void mcr_del(lex_t *);
 lex_t *mcr_define(const lmap_t *, int);
+int mcr_getdef(const char *, mcr_def_t *);
+void mcr_setdef(const char *, const mcr_def_t *);
+void mcr_undef(const char *);
+void mcr_use(const char *);
 void mcr_cmd(int, const char *);
+void mcr_time(void);
 void mcr_init(void);
 int mcr_expand(lex_t *);
 void mcr_unused(void);
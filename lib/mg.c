@@ -8,6 +8,7 @@
 #include "common.h"
 #include "mcr.h"
 #include "lmap.h"
+#include "pch.h"
 #include "strg.h"
 #include "mg.h"
 
@@ -25,48 +26,78 @@ const char *mg_name;        /* macro for #include guard */
 
 
 /*
- *  remembers a macro guard
+ *  remembers a macro guard for a file;
+ *  path is assumed to be a hash string
  */
-void (mg_once)(void)
+void (mg_add)(const char *path, const char *name)
 {
     unsigned h;
     struct mgt *p;
-    const lmap_t *pos = lmap_pfrom(lmap_from);
 
-    assert(pos->type <= LMAP_INC);
-    h = hashkey(pos->u.i.rf, NELEM(mgt));
+    assert(path);
+
+    h = hashkey(path, NELEM(mgt));
     for (p = mgt[h]; p; p = p->link)
-        if (p->path == pos->u.i.rf) {
+        if (p->path == path) {
             if (p->name)    /* #pragma once always wins */
-                p->name = mg_name;
+                p->name = name;
             return;
         }
 
     p = ARENA_ALLOC(strg_perm, sizeof(*p));
-    p->path = pos->u.i.rf;
-    p->name = mg_name;
+    p->path = path;
+    p->name = name;
     p->link = mgt[h];
     mgt[h] = p;
 }
 
 
 /*
- *  checks if a file is macro-guarded;
+ *  remembers a macro guard
+ */
+void (mg_once)(void)
+{
+    const lmap_t *pos = lmap_pfrom(lmap_from);
+
+    assert(pos->type <= LMAP_INC);
+    mg_add(pos->u.i.rf, mg_name);
+    pch_once(pos->u.i.rf, mg_name);
+}
+
+
+/*
+ *  finds a macro guard for a file;
+ *  *pname set to NULL for #pragma once;
  *  path is assumed to be a hash string
  */
-int (mg_isguarded)(const char *path)
+int (mg_guard)(const char *path, const char **pname)
 {
     unsigned h;
     struct mgt *p;
 
     assert(path);
+    assert(pname);
 
     h = hashkey(path, NELEM(mgt));
     for (p = mgt[h]; p; p = p->link)
-        if (p->path == path && (!p->name || mcr_redef(p->name)))
+        if (p->path == path) {
+            *pname = p->name;
             return 1;
+        }
 
     return 0;
 }
 
+
+/*
+ *  checks if a file is macro-guarded;
+ *  path is assumed to be a hash string
+ */
+int (mg_isguarded)(const char *path)
+{
+    const char *name;
+
+    return (mg_guard(path, &name) && (!name || mcr_redef(name)));
+}
+
 /* end of mg.c */
@@ -20,7 +20,9 @@ extern int mg_state;           /* macro guard state */
 extern const char *mg_name;    /* macro for #include guard */
 
 
+void mg_add(const char *, const char *);
 void mg_once(void);
+int mg_guard(const char *, const char **);
 int mg_isguarded(const char *);
 
 
@@ -0,0 +1,1547 @@
+/*
+ *  header cache for preprocessing
+ */
+
+#include <stddef.h>        /* size_t, NULL */
+#include <stdio.h>         /* FILE, fopen, fread, fwrite, ferror, fclose, sprintf, rename, remove */
+#include <string.h>        /* strlen, strcmp, strcpy, memcmp, memcpy */
+#include <time.h>          /* time, clock */
+#ifdef HAVE_STAT
+#include <sys/types.h>     /* off_t, time_t */
+#include <sys/stat.h>      /* struct stat, stat */
+#endif    /* HAVE_STAT */
+#include <cbl/arena.h>     /* arena_t, ARENA_NEW, ARENA_ALLOC, ARENA_CALLOC, ARENA_FREE, ARENA_DISPOSE */
+#include <cbl/assert.h>    /* assert */
+#include <cbl/memory.h>    /* MEM_ALLOC, MEM_CALLOC, MEM_RESIZE, MEM_FREE */
+#include <cdsl/hash.h>     /* hash_string */
+
+#include "common.h"
+#include "err.h"
+#include "inc.h"
+#include "lex.h"
+#include "lmap.h"
+#include "lst.h"
+#include "main.h"
+#include "mcr.h"
+#include "mg.h"
+#include "strg.h"
+#include "util.h"
+#include "pch.h"
+#include "../version.h"
+
+#define MAGIC "beluga header cache 2\n"    /* magic string for cache files */
+
+#define NSLOT 4       /* # of cache files for each header */
+#define NENT  4096    /* initial size of entry table; power of 2 */
+
+/* locus ids */
+#define IDNULL  -1    /* null locus */
+#define IDNONE  -2    /* locus not representable */
+#define IDEXT   -3    /* (for fid) locus from macro defined outside header */
+#define IDHDR   0     /* cached header */
+#define IDBLTIN 1     /* built-in locus */
+#define IDCMD   2     /* command line locus */
+#define IDFIRST 3     /* first id assigned to recorded locus */
+
+/* computes FNV-1a hash */
+#define FNV(h, c) ((((h) ^ (unsigned char)(c)) * 16777619UL) & 0xffffffffUL)
+#define FNVINIT   2166136261UL
+
+/* hashes key with entry kind */
+#define HASH(k, i) ((hashkey((k), rec.nent) + (i)) & (rec.nent-1))
+
+/* packs and unpacks token flags */
+#define TOKFLAG(t) ((t)->f.alloc | ((t)->f.clean << 1) | ((t)->f.end << 2) | \
+                    ((t)->f.blue << 3) | ((t)->f.noarg << 4) | ((t)->f.sync << 5) | \
+                    ((unsigned long)(t)->f.vaarg << 7))
+
+
+/* entry kinds */
+enum {
+    EMACRO,    /* macro */
+    EFILE,     /* file read */
+    EGUARD,    /* macro guard checked */
+    ELOCUS     /* locus */
+};
+
+/* byte buffer */
+struct buf {
+    unsigned char *p;    /* buffer */
+    size_t n;            /* # of bytes used */
+    size_t size;         /* size of buffer */
+};
+
+/* entry for recording */
+struct ent {
+    int kind;           /* entry kind */
+    const void *key;    /* key; hash string or locus */
+    long id;            /* (ELOCUS) locus id */
+    lmap_t n;           /* (ELOCUS) copy of locus to detect reused memory */
+    long fid, mid;      /* (ELOCUS) ids for from and u.m */
+    struct {
+        unsigned dep:     1;    /* true if definition affects header */
+        unsigned touched: 1;    /* true if (un)defined in header */
+        unsigned used:    1;    /* true if used before touched */
+        unsigned defined: 1;    /* true if defined before header */
+    } f;                        /* (EMACRO) flags */
+    const unsigned char *sig;    /* (EMACRO) signature of definition */
+    size_t nsig;                 /* (EMACRO) length of signature */
+    struct ent *next;            /* (EMACRO) list of dependencies */
+    struct ent *link;            /* hash chain */
+};
+
+
+/* recording context */
+static struct {
+    int level;                 /* #include level of header; 0 if not recording */
+    int depth;                 /* deepest nesting level from header */
+    int slot;                  /* cache slot to write */
+    const char *rf;            /* resolved header name */
+    sz_t ndiag;                /* # of diagnostics at start */
+    int marked;                /* true if mark set */
+    lex_t *mark;               /* last output token captured */
+    long nid;                  /* next locus id */
+    struct ent **t;            /* entry table */
+    sz_t nent, nuse;           /* size and # of entries */
+    struct ent *macro,         /* list of macro dependencies */
+               **pmacro;       /* last next field of macro list */
+    struct buf file, guard,    /* file and guard records */
+               locus, tok,     /* locus records and tokens */
+               ev, eoi;        /* events and EOI token */
+    sz_t nfile, nguard,        /* # of records */
+         ntok, nev;
+} rec;
+
+/* replay context */
+static struct {
+    int on;                       /* true if replay pending */
+    unsigned char *data;          /* cache file */
+    const unsigned char *mdep;    /* start of macro dependencies */
+    sz_t nmdep;                   /* # of macro dependencies */
+    const unsigned char *cur;     /* start of tokens */
+    const lmap_t **locus;         /* locus table */
+    long nlocus, size;            /* # of loci and size of table */
+} rep;
+
+static const char *dir;          /* cache directory; NULL if disabled */
+static const char *key;          /* key for context */
+static char *pbuf;               /* buffer for cache file path */
+static const char *prf;          /* header to record next */
+static int pslot;                /* slot for header to record next */
+static arena_t *strg;            /* arena for recording */
+static struct buf sbuf, obuf;    /* buffers for signature and output */
+
+/* read cursor */
+static const unsigned char *rp, *rlim;
+static int rerr;
+
+
+/*
+ *  makes room in a byte buffer
+ */
+static void grow(struct buf *b, size_t n)
+{
+    assert(b);
+
+    if (b->size - b->n >= n)
+        return;
+    while (b->size - b->n < n)
+        b->size = (b->size)? b->size*2: 256;
+    if (b->p)
+        MEM_RESIZE(b->p, b->size);
+    else
+        b->p = MEM_ALLOC(b->size);
+}
+
+
+/*
+ *  appends bytes to a byte buffer
+ */
+static void putm(struct buf *b, const void *p, size_t n)
+{
+    if (n == 0)
+        return;
+    grow(b, n);
+    memcpy(b->p+b->n, p, n);
+    b->n += n;
+}
+
+
+/*
+ *  appends a byte
+ */
+static void putb(struct buf *b, int c)
+{
+    grow(b, 1);
+    b->p[b->n++] = c;
+}
+
+
+/*
+ *  appends an unsigned integer
+ */
+static void putn(struct buf *b, unsigned long n)
+{
+    while (n >= 0x80) {
+        putb(b, (n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+    putb(b, n);
+}
+
+
+/*
+ *  appends a signed integer
+ */
+static void puti(struct buf *b, long n)
+{
+    putn(b, (n < 0)? ((unsigned long)-(n+1) << 1) | 1: (unsigned long)n << 1);
+}
+
+
+/*
+ *  appends a string;
+ *  null pointer allowed
+ */
+static void putstr(struct buf *b, const char *s)
+{
+    size_t n;
+
+    if (!s) {
+        putn(b, 0);
+        return;
+    }
+    n = strlen(s) + 1;
+    putn(b, n);
+    putm(b, s, n);
+}
+
+
+/*
+ *  reads an unsigned integer
+ */
+static unsigned long getn(void)
+{
+    int s = 0;
+    unsigned long n = 0;
+
+    while (rp < rlim && s < 32) {
+        n |= (unsigned long)(*rp & 0x7f) << s;
+        if (!(*rp++ & 0x80))
+            return n;
+        s += 7;
+    }
+    rerr = 1;
+
+    return 0;
+}
+
+
+/*
+ *  reads a signed integer
+ */
+static long geti(void)
+{
+    unsigned long n = getn();
+
+    return (n & 1)? -(long)(n >> 1) - 1: (long)(n >> 1);
+}
+
+
+/*
+ *  reads a byte
+ */
+static int getb(void)
+{
+    if (rp < rlim)
+        return *rp++;
+    rerr = 1;
+
+    return 0;
+}
+
+
+/*
+ *  reads bytes
+ */
+static const unsigned char *getm(unsigned long n)
+{
+    const unsigned char *p = rp;
+
+    if (n > (unsigned long)(rlim - rp)) {
+        rerr = 1;
+        return NULL;
+    }
+    rp += n;
+
+    return p;
+}
+
+
+/*
+ *  reads a string;
+ *  returns a pointer into the cache file
+ */
+static const char *getstr(void)
+{
+    unsigned long n = getn();
+    const unsigned char *p;
+
+    if (n == 0 || (p = getm(n)) == NULL)
+        return NULL;
+    if (p[n-1] != '\0') {
+        rerr = 1;
+        return NULL;
+    }
+
+    return (const char *)p;
+}
+
+
+/*
+ *  computes a checksum
+ */
+static unsigned long fnv(unsigned long h, const unsigned char *p, size_t n)
+{
+    while (n-- > 0)
+        h = FNV(h, *p++);
+
+    return h;
+}
+
+
+/*
+ *  computes the size and digest of a file;
+ *  dig must point to 64+1 characters
+ */
+static int fsum(const char *path, unsigned long *psize, char *dig)
+{
+    FILE *fp;
+    size_t n;
+    sha256_t ctx;
+    unsigned char buf[4096];
+
+    assert(path);
+    assert(psize);
+    assert(dig);
+
+    if ((fp = fopen(path, "rb")) == NULL)
+        return 0;
+    *psize = 0;
+    sha256_init(&ctx);
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        *psize += n;
+        sha256_add(&ctx, buf, n);
+    }
+    n = ferror(fp);
+    fclose(fp);
+    sha256_hex(&ctx, dig);
+
+    return !n;
+}
+
+
+/*
+ *  gets the size and modification time of a file;
+ *  returns 0 if unknown or too recent to be trusted
+ */
+static unsigned long fstamp(const char *path, unsigned long *psize)
+{
+#ifdef HAVE_STAT
+    struct stat st;
+
+    assert(path);
+    assert(psize);
+
+    if (stat(path, &st) != 0 || st.st_mtime <= 0 || st.st_mtime >= time(NULL)-1)
+        return 0;
+    *psize = st.st_size;
+
+    return st.st_mtime;
+#else    /* !HAVE_STAT */
+    UNUSED(path);
+    UNUSED(psize);
+
+    return 0;
+#endif    /* HAVE_STAT */
+}
+
+
+/*
+ *  reads a whole file into memory
+ */
+static unsigned char *readfile(const char *path, size_t *pn)
+{
+    FILE *fp;
+    size_t n, size;
+    unsigned char *p;
+
+    assert(path);
+    assert(pn);
+
+    if ((fp = fopen(path, "rb")) == NULL)
+        return NULL;
+    p = MEM_ALLOC(size = 8192);
+    *pn = 0;
+    while ((n = fread(p + *pn, 1, size - *pn, fp)) > 0)
+        if ((*pn += n) == size)
+            MEM_RESIZE(p, size *= 2);
+    if (ferror(fp))
+        MEM_FREE(p);
+    fclose(fp);
+
+    return p;
+}
+
+
+/*
+ *  builds the path of a cache file
+ */
+static const char *path(const char *rf, int slot)
+{
+    unsigned long h;
+
+    assert(rf);
+
+    h = fnv(FNVINIT, (const unsigned char *)key, strlen(key)+1);
+    h = fnv(h, (const unsigned char *)rf, strlen(rf));
+    sprintf(pbuf, "%s/%08lx-%d.pch", dir, h, slot);
+
+    return pbuf;
+}
+
+
+/*
+ *  builds a signature of a macro definition
+ */
+static void sig(struct buf *b, const mcr_def_t *d)
+{
+    lex_t **p;
+
+    assert(b);
+    assert(d);
+
+    b->n = 0;
+    if (d->dynamic) {
+        putb(b, 'd');
+        return;
+    }
+    putn(b, (d->param != NULL) | (d->vaarg << 1) | (d->sharp << 2));
+    puti(b, d->argno);
+    if (d->param) {
+        for (p = d->param; *p; p++)
+            continue;
+        putn(b, p - d->param);
+        for (p = d->param; *p; p++)
+            putstr(b, LEX_SPELL(*p));
+    }
+    for (p = d->rl; *p; p++)
+        continue;
+    putn(b, p - d->rl);
+    for (p = d->rl; *p; p++) {
+        puti(b, (*p)->id);
+        putn(b, (*p)->f.vaarg);
+        putstr(b, LEX_SPELL(*p));
+    }
+}
+
+
+/*
+ *  (recording) finds an entry
+ */
+static struct ent *find(int kind, const void *k)
+{
+    struct ent *p;
+
+    for (p = rec.t[HASH(k, kind)]; p; p = p->link)
+        if (p->key == k && p->kind == kind)
+            return p;
+
+    return NULL;
+}
+
+
+/*
+ *  (recording) adds an entry
+ */
+static struct ent *add(int kind, const void *k)
+{
+    unsigned h;
+    struct ent *p;
+
+    if (++rec.nuse > rec.nent) {
+        sz_t i, n = rec.nent;
+        struct ent **t = rec.t, *q;
+
+        rec.t = MEM_CALLOC(rec.nent *= 2, sizeof(*rec.t));
+        for (i = 0; i < n; i++)
+            for (p = t[i]; p; p = q) {
+                q = p->link;
+                h = HASH(p->key, p->kind);
+                p->link = rec.t[h];
+                rec.t[h] = p;
+            }
+        MEM_FREE(t);
+    }
+
+    p = ARENA_CALLOC(strg, 1, sizeof(*p));
+    p->kind = kind;
+    p->key = k;
+    p->id = IDNONE;
+    h = HASH(k, kind);
+    p->link = rec.t[h];
+    rec.t[h] = p;
+
+    return p;
+}
+
+
+/*
+ *  (recording) stops recording
+ */
+static void abandon(void)
+{
+    MEM_FREE(rec.t);
+    ARENA_FREE(strg);
+    rec.level = 0;
+}
+
+
+/*
+ *  (recording) remembers a file read
+ */
+static int file(const char *rf)
+{
+    unsigned long size, ssize = 0, mtime;
+    char dig[64+1];
+
+    assert(rf);
+
+    if (find(EFILE, rf))
+        return 1;
+    if (!fsum(rf, &size, dig))
+        return 0;
+    mtime = fstamp(rf, &ssize);
+    (void)add(EFILE, rf);
+    putstr(&rec.file, rf);
+    putn(&rec.file, size);
+    putn(&rec.file, (ssize == size)? mtime: 0);    /* 0 makes replay hash */
+    putstr(&rec.file, dig);
+    rec.nfile++;
+
+    return 1;
+}
+
+
+/*
+ *  (recording) checks if two loci have the same contents
+ */
+static int same(const lmap_t *p, const lmap_t *q)
+{
+    if (p->type != q->type || p->from != q->from)
+        return 0;
+
+    switch(p->type) {
+        case LMAP_INC:
+            return (p->u.i.f == q->u.i.f && p->u.i.rf == q->u.i.rf &&
+                    p->u.i.system == q->u.i.system);
+        case LMAP_NORMAL:
+            return (p->u.n.py == q->u.n.py && p->u.n.wx == q->u.n.wx &&
+                    p->u.n.dy == q->u.n.dy && p->u.n.dx == q->u.n.dx);
+        case LMAP_MACRO:
+            return (p->u.m == q->u.m);
+    }
+
+    return 0;
+}
+
+
+/*
+ *  (recording) locates a locus in a macro definition
+ */
+static int locate(const mcr_def_t *d, const lmap_t *p, long *pk)
+{
+    long i;
+
+    if (d->pos == p) {
+        *pk = -1;
+        return 1;
+    }
+    if (d->param)
+        for (i = 0; d->param[i]; i++)
+            if (d->param[i]->pos == p) {
+                *pk = -2 - i;
+                return 1;
+            }
+    for (i = 0; d->rl[i]; i++)
+        if (d->rl[i]->pos == p) {
+            *pk = i;
+            return 1;
+        }
+
+    return 0;
+}
+
+
+/*
+ *  (recording) assigns an id to a locus from a macro defined outside the header;
+ *  a file locus is found through the locus of a definition
+ */
+static long extid(const lmap_t *p, struct ent *e)
+{
+    long k;
+    mcr_def_t d;
+    struct ent *q;
+    const lmap_t *pos;
+
+    for (q = rec.macro; q; q = q->next) {
+        if (!q->f.defined || !mcr_getdef(q->key, &d))
+            continue;
+        if (p->type == LMAP_INC) {
+            pos = lmap_mstrip(d.pos);
+            if (pos->type != LMAP_NORMAL || pos->from != p || !file(p->u.i.rf))
+                continue;
+            putb(&rec.locus, 'Y');
+            putstr(&rec.locus, q->key);
+        } else if (locate(&d, p, &k)) {
+            putb(&rec.locus, 'X');
+            putstr(&rec.locus, q->key);
+            puti(&rec.locus, k);
+        } else
+            continue;
+        memcpy(&e->n, p, LMAP_SIZE(p));
+        e->fid = IDEXT;
+        return (e->id = rec.nid++);
+    }
+
+    return IDNONE;
+}
+
+
+/*
+ *  (recording) assigns an id to a locus;
+ *  records nodes as necessary
+ */
+static long posid(const lmap_t *p)
+{
+    long f, m = IDNULL;
+    struct ent *e;
+
+    if (!p)
+        return IDNULL;
+    if (p == lmap_bltin)
+        return IDBLTIN;
+    if (p == lmap_cmd)
+        return IDCMD;
+
+    if ((e = find(ELOCUS, p)) != NULL) {
+        if (e->id >= 0 && e->id < IDFIRST)
+            return e->id;
+        if (e->id >= 0 && same(&e->n, p) &&
+            (e->fid == IDEXT ||
+             (posid(p->from) == e->fid && (p->type != LMAP_MACRO || posid(p->u.m) == e->mid))))
+            return e->id;
+    } else
+        e = add(ELOCUS, p);
+
+    switch(p->type) {
+        case LMAP_INC:
+            if ((f = posid(p->from)) < 0)
+                return extid(p, e);
+            putb(&rec.locus, 'I');
+            putstr(&rec.locus, p->u.i.f);
+            putstr(&rec.locus, p->u.i.rf);
+            putn(&rec.locus, p->u.i.system);
+            putn(&rec.locus, f+1);
+            break;
+        case LMAP_NORMAL:
+            if (p->from->type != LMAP_INC || (f = posid(p->from)) < 0)
+                return extid(p, e);
+            putb(&rec.locus, 'N');
+            putn(&rec.locus, p->u.n.py);
+            putn(&rec.locus, p->u.n.wx);
+            putn(&rec.locus, p->u.n.dy);
+            putn(&rec.locus, p->u.n.dx);
+            putn(&rec.locus, f+1);
+            break;
+        case LMAP_MACRO:
+            if ((m = posid(p->u.m)) < 0 || (f = posid(p->from)) < 0)
+                return IDNONE;
+            putb(&rec.locus, 'C');
+            putn(&rec.locus, m+1);
+            putn(&rec.locus, f+1);
+            break;
+        default:
+            return IDNONE;
+    }
+    memcpy(&e->n, p, LMAP_SIZE(p));
+    e->fid = f;
+    e->mid = m;
+
+    return (e->id = rec.nid++);
+}
+
+
+/*
+ *  (recording) appends a token
+ */
+static int puttok(struct buf *b, const lex_t *t)
+{
+    long id = posid(t->pos);
+
+    if (id == IDNONE)
+        return 0;
+    puti(b, t->id);
+    putn(b, TOKFLAG(t));
+    putstr(b, t->spell);
+    putn(b, id+1);
+
+    return 1;
+}
+
+
+/*
+ *  (recording) appends a token array
+ */
+static int puttoks(struct buf *b, lex_t **l)
+{
+    lex_t **p;
+
+    for (p = l; *p; p++)
+        continue;
+    putn(b, p - l);
+    for (p = l; *p; p++)
+        if (!puttok(b, *p))
+            return 0;
+
+    return 1;
+}
+
+
+/*
+ *  (recording) marks a macro (un)defined in the header
+ */
+static void touch(const char *chn)
+{
+    struct ent *e;
+
+    if ((e = find(EMACRO, chn)) == NULL)
+        e = add(EMACRO, chn);
+    e->f.touched = 1;
+}
+
+
+/*
+ *  (recording) writes a cache file
+ */
+static void save(int state)
+{
+    FILE *fp;
+    char *tmp;
+    struct ent *e;
+    struct buf *b = &obuf, h = { 0, };
+    sz_t n;
+
+    b->n = 0;
+    putstr(b, key);
+    putstr(b, rec.rf);
+    putn(b, rec.depth);
+    putn(b, rec.nfile);
+    putm(b, rec.file.p, rec.file.n);
+    putn(b, rec.nguard);
+    putm(b, rec.guard.p, rec.guard.n);
+    for (n = 0, e = rec.macro; e; e = e->next)
+        n++;
+    putn(b, n);
+    for (e = rec.macro; e; e = e->next) {
+        putstr(b, e->key);
+        putn(b, e->f.defined);
+        if (e->f.defined) {
+            putn(b, e->nsig);
+            putm(b, e->sig, e->nsig);
+        }
+        putn(b, e->f.used);
+    }
+    putn(b, rec.nid - IDFIRST);
+    putm(b, rec.locus.p, rec.locus.n);
+    putn(b, rec.ntok);
+    putm(b, rec.tok.p, rec.tok.n);
+    putn(b, rec.nev);
+    putm(b, rec.ev.p, rec.ev.n);
+    putn(b, state);
+    putm(b, rec.eoi.p, rec.eoi.n);
+
+    putm(&h, MAGIC, sizeof(MAGIC)-1);
+    putn(&h, b->n);
+    putn(&h, fnv(FNVINIT, b->p, b->n));
+
+    path(rec.rf, rec.slot);
+    tmp = MEM_ALLOC(strlen(pbuf) + 1 + 2*8 + 1);
+    sprintf(tmp, "%s.%08lx%08lx", pbuf, (unsigned long)time(NULL) & 0xffffffffUL,
+            (unsigned long)clock() & 0xffffffffUL);
+    if ((fp = fopen(tmp, "wb")) != NULL) {
+        n = (fwrite(h.p, 1, h.n, fp) == h.n && fwrite(b->p, 1, b->n, fp) == b->n);
+        if (fclose(fp) == 0 && n) {
+            if (rename(tmp, pbuf) != 0) {
+                remove(pbuf);
+                if (rename(tmp, pbuf) != 0)
+                    remove(tmp);
+            }
+        } else
+            remove(tmp);
+    }
+    MEM_FREE(tmp);
+    MEM_FREE(h.p);
+}
+
+
+/*
+ *  (replay) gets a locus from an id
+ */
+static const lmap_t *locus(unsigned long n)
+{
+    if (n == 0)
+        return NULL;
+    if (n > (unsigned long)rep.nlocus) {
+        rerr = 1;
+        return NULL;
+    }
+
+    return rep.locus[n-1];
+}
+
+
+/*
+ *  (replay) reads a token
+ */
+static lex_t *gettok(arena_t *a, int perm)
+{
+    char *p;
+    const char *s;
+    unsigned long f;
+    lex_t *t = ARENA_ALLOC(a, sizeof(*t));
+
+    t->id = geti();
+    f = getn();
+    s = getstr();
+    t->pos = locus(getn());
+    t->f.alloc = 0;
+    t->f.clean = f >> 1;
+    t->f.end = f >> 2;
+    t->f.blue = f >> 3;
+    t->f.noarg = f >> 4;
+    t->f.sync = f >> 5;
+    t->f.vaarg = f >> 7;
+    t->f.chn = 0;
+    if (!s)
+        t->spell = NULL;
+    else if (perm || t->id == LEX_MCR) {
+        t->spell = hash_string(s);
+        t->f.chn = t->f.clean;
+    } else {
+        p = ARENA_ALLOC(a, strlen(s)+1);
+        strcpy(p, s);
+        t->spell = p;
+        t->f.alloc = 1;
+    }
+    t->next = t;
+
+    return t;
+}
+
+
+/*
+ *  (replay) reads a token array
+ */
+static lex_t **gettoks(arena_t *a, int perm)
+{
+    unsigned long i, n = getn();
+    lex_t **l;
+
+    if (n > (unsigned long)(rlim - rp)) {
+        rerr = 1;
+        return NULL;
+    }
+    l = ARENA_ALLOC(a, (n+1) * sizeof(*l));
+    for (i = 0; i < n; i++)
+        l[i] = gettok(a, perm);
+    l[i] = NULL;
+
+    return l;
+}
+
+
+/*
+ *  (replay) installs a macro definition
+ */
+static void define(void)
+{
+    unsigned long f;
+    arena_t *a;
+    mcr_def_t d;
+    const char *chn = getstr();
+
+    if (!chn)
+        return;
+    a = (mcr_getdef(chn, &d))? strg_line: strg_perm;    /* discarded if defined */
+    d.pos = locus(getn());
+    d.argno = geti();
+    f = getn();
+    d.vaarg = f & 1;
+    d.sharp = (f >> 1) & 1;
+    d.dynamic = 0;
+    d.param = (f & 4)? gettoks(a, 1): NULL;
+    d.rl = gettoks(a, 1);
+    if (!rerr && d.pos && d.rl)
+        mcr_setdef(chn, &d);
+}
+
+
+/*
+ *  (replay) resolves a locus from a macro defined outside the header
+ */
+static const lmap_t *extlocus(const char *chn, long k)
+{
+    long i;
+    mcr_def_t d;
+
+    if (!chn || !mcr_getdef(chn, &d))
+        return NULL;
+    if (k == -1)
+        return d.pos;
+    if (k < -1) {
+        for (i = 0; d.param && d.param[i]; i++)
+            if (i == -2-k)
+                return d.param[i]->pos;
+        return NULL;
+    }
+    for (i = 0; d.rl[i]; i++)
+        if (i == k)
+            return d.rl[i]->pos;
+
+    return NULL;
+}
+
+
+/*
+ *  (replay) builds a locus table
+ */
+static int build(const lmap_t *pos)
+{
+    int sys;
+    long k;
+    unsigned long i, n;
+    lmap_t *q;
+    const lmap_t *p, *m, *from;
+    const char *f, *rf;
+
+    n = getn();
+    if (rerr || n > (unsigned long)(rlim - rp))
+        return 0;
+    if ((long)n + IDFIRST > rep.size) {
+        MEM_FREE(rep.locus);
+        rep.size = n + IDFIRST;
+        rep.locus = MEM_ALLOC(rep.size * sizeof(*rep.locus));
+    }
+    rep.locus[IDHDR] = pos;
+    rep.locus[IDBLTIN] = lmap_bltin;
+    rep.locus[IDCMD] = lmap_cmd;
+    rep.nlocus = IDFIRST;
+
+    for (i = 0; i < n && !rerr; i++) {
+        p = NULL;
+        switch(getb()) {
+            case 'I':
+                f = getstr();
+                rf = getstr();
+                sys = getn();
+                from = locus(getn());
+                if (f && rf && from && from->type == LMAP_NORMAL)
+                    p = lmap_include(hash_string(rf), hash_string(f), from, sys);
+                break;
+            case 'N':
+                q = ARENA_ALLOC(strg_perm, sizeof(*q));
+                q->type = LMAP_NORMAL;
+                q->u.n.py = getn();
+                q->u.n.wx = getn();
+                q->u.n.dy = getn();
+                q->u.n.dx = getn();
+                q->from = locus(getn());
+                if (q->from && q->from->type == LMAP_INC)
+                    p = q;
+                break;
+            case 'C':
+                m = locus(getn());
+                from = locus(getn());
+                if (m && from && (m->type == LMAP_NORMAL || m->type == LMAP_MACRO))
+                    p = lmap_macro(m, from, strg_perm);
+                break;
+            case 'X':
+                f = getstr();
+                k = geti();
+                p = extlocus(f, k);
+                break;
+            case 'Y':
+                if ((p = extlocus(getstr(), -1)) != NULL) {
+                    p = lmap_mstrip(p);
+                    p = (p->type == LMAP_NORMAL && p->from->type == LMAP_INC)? p->from: NULL;
+                }
+                break;
+        }
+        if (!p)
+            rerr = 1;
+        rep.locus[rep.nlocus++] = p;
+    }
+
+    return !rerr;
+}
+
+
+/*
+ *  (replay) loads and validates a cache file;
+ *  returns 1 if usable, 0 if missing, -1 if stale, -2 if not applicable
+ */
+static int load(const char *rf, int slot)
+{
+    int def;
+    size_t n;
+    unsigned long i, len, nfile, size, sum, fsize, mtime;
+    const char *s, *name, *cname;
+    char dig[64+1];
+    const unsigned char *p, *q;
+    mcr_def_t d;
+
+    MEM_FREE(rep.data);
+    if ((rep.data = readfile(path(rf, slot), &n)) == NULL)
+        return 0;
+    if (n < sizeof(MAGIC)-1 || memcmp(rep.data, MAGIC, sizeof(MAGIC)-1) != 0)
+        return -1;
+    rp = rep.data + sizeof(MAGIC)-1;
+    rlim = rep.data + n;
+    rerr = 0;
+    len = getn();
+    sum = getn();
+    if (rerr || len != (unsigned long)(rlim - rp) || sum != fnv(FNVINIT, rp, len))
+        return -1;
+    if ((s = getstr()) == NULL || strcmp(s, key) != 0 || (s = getstr()) == NULL ||
+        strcmp(s, rf) != 0)
+        return -1;
+    if (inc_level + 1 + (long)getn() >= TL_INC)
+        return -2;
+
+    /* files; checked later */
+    nfile = getn();
+    p = rp;
+    for (i = 0; i < nfile && !rerr; i++)
+        (void)(getstr(), getn(), getn(), getstr());
+
+    /* macro guards */
+    len = getn();
+    for (i = 0; i < len && !rerr; i++) {
+        s = getstr();
+        def = getn();
+        name = (def)? getstr(): NULL;
+        if (rerr || !s)
+            return -1;
+        if (mg_guard(hash_string(s), &cname) != def ||
+            (def && ((!name ^ !cname) || (name && strcmp(name, cname) != 0))))
+            return -2;
+    }
+
+    /* macros */
+    rep.nmdep = getn();
+    rep.mdep = rp;
+    for (i = 0; i < rep.nmdep && !rerr; i++) {
+        s = getstr();
+        def = getn();
+        if (def) {
+            size = getn();
+            name = (const char *)getm(size);
+        }
+        (void)getn();    /* used */
+        if (rerr || !s)
+            return -1;
+        if (mcr_getdef(s, &d) != def)
+            return -2;
+        if (def) {
+            sig(&sbuf, &d);
+            if (sbuf.n != size || memcmp(sbuf.p, name, size) != 0)
+                return -2;
+        }
+    }
+    if (rerr)
+        return -1;
+
+    /* files */
+    q = rp;    /* start of loci */
+    rp = p;
+    for (i = 0; i < nfile && !rerr; i++) {
+        s = getstr();
+        size = getn();
+        mtime = getn();
+        name = getstr();
+        if (rerr || !s || !name)
+            return -1;
+        if (mtime != 0 && fstamp(s, &fsize) == mtime && fsize == size)
+            continue;    /* unchanged */
+        if (!fsum(s, &fsize, dig) || fsize != size || strcmp(dig, name) != 0)
+            return -1;
+    }
+    rp = q;
+
+    return 1;
+}
+
+
+/*
+ *  initializes the header cache
+ */
+void (pch_init)(void)
+{
+    char buf[128];
+    struct buf b = { 0, };
+    const char *p;
+
+    if (!main_opt()->pchdir || main_opt()->pptool == 1 || main_opt()->pptool >= 3)
+        return;
+
+    sprintf(buf, "%s %d %d %d %d %d %d %d %d %d %d %d %d %d %d|", VERSION,
+            main_opt()->std, main_opt()->extension, main_opt()->trigraph, main_opt()->pponly,
+            main_opt()->path, main_opt()->wchart, main_opt()->logicshift, main_opt()->uchar,
+            main_opt()->little_endian, main_opt()->sizet, main_opt()->ptrdifft,
+            main_opt()->ptrlong, main_opt()->nostdinc, main_opt()->onlystdmcr);
+    putm(&b, buf, strlen(buf));
+#ifdef HAVE_ICONV
+    if ((p = main_opt()->icset) != NULL)
+        putm(&b, p, strlen(p));
+    putb(&b, '|');
+    if ((p = main_opt()->ecset) != NULL)
+        putm(&b, p, strlen(p));
+    putb(&b, '|');
+    if ((p = main_opt()->wcset) != NULL)
+        putm(&b, p, strlen(p));
+    putb(&b, '|');
+#endif    /* HAVE_ICONV */
+    p = inc_pathkey();
+    putm(&b, p, strlen(p)+1);
+    key = hash_string((char *)b.p);
+    MEM_FREE(b.p);
+
+    dir = main_opt()->pchdir;
+    pbuf = MEM_ALLOC(strlen(dir) + 1 + 8 + 1 + 11 + sizeof(".pch"));
+    strg = ARENA_NEW();
+}
+
+
+/*
+ *  finalizes the header cache
+ */
+void (pch_free)(void)
+{
+    if (!dir)
+        return;
+
+    if (rec.level)
+        abandon();
+    ARENA_DISPOSE(&strg);
+    MEM_FREE(rec.file.p);
+    MEM_FREE(rec.guard.p);
+    MEM_FREE(rec.locus.p);
+    MEM_FREE(rec.tok.p);
+    MEM_FREE(rec.ev.p);
+    MEM_FREE(rec.eoi.p);
+    MEM_FREE(sbuf.p);
+    MEM_FREE(obuf.p);
+    MEM_FREE(rep.data);
+    MEM_FREE(rep.locus);
+    MEM_FREE(pbuf);
+    dir = NULL;
+}
+
+
+/*
+ *  tries to replay a system header from the cache;
+ *  returns true if a replay is pending
+ */
+int (pch_replay)(const lmap_t *pos)
+{
+    int i, r, stale = -1;
+    const char *rf;
+
+    assert(pos);
+    assert(pos->type == LMAP_INC);
+
+    if (!dir || rec.level)
+        return 0;
+
+    rf = pos->u.i.rf;
+    for (i = 0; i < NSLOT; i++) {
+        if ((r = load(rf, i)) > 0) {
+            if (build(pos)) {
+                rep.on = 1;
+                rep.cur = rp;
+                return 1;
+            }
+            r = -1;
+        }
+        if (r == 0)
+            break;
+        if (r == -1 && stale < 0)
+            stale = i;
+    }
+    MEM_FREE(rep.data);
+
+    prf = rf;
+    pslot = (i < NSLOT)? i: (stale >= 0)? stale: NSLOT-1;
+
+    return 0;
+}
+
+
+/*
+ *  starts recording a system header
+ */
+void (pch_start)(const char *rf)
+{
+    struct ent *e;
+
+    assert(rf);
+
+    if (!dir)
+        return;
+
+    if (rec.level) {
+        if (inc_level - rec.level > rec.depth)
+            rec.depth = inc_level - rec.level;
+        if (!file(rf))
+            abandon();
+        return;
+    }
+    if (rf != prf)
+        return;
+    prf = NULL;
+
+    rec.level = inc_level;
+    rec.depth = 0;
+    rec.slot = pslot;
+    rec.rf = rf;
+    rec.ndiag = err_ndiag();
+    rec.marked = 0;
+    rec.mark = NULL;
+    rec.nid = IDFIRST;
+    rec.t = MEM_CALLOC(NENT, sizeof(*rec.t));
+    rec.nent = NENT;
+    rec.nuse = 0;
+    rec.macro = NULL;
+    rec.pmacro = &rec.macro;
+    rec.file.n = rec.guard.n = rec.locus.n = rec.tok.n = rec.ev.n = rec.eoi.n = 0;
+    rec.nfile = rec.nguard = rec.ntok = rec.nev = 0;
+
+    e = add(ELOCUS, lmap_from);
+    e->id = IDHDR;
+    if (!file(rf))
+        abandon();
+}
+
+
+/*
+ *  remembers a macro guard check
+ */
+void (pch_guard)(const char *path)
+{
+    int r;
+    const char *name;
+
+    assert(path);
+
+    if (!rec.level || find(EGUARD, path))
+        return;
+
+    (void)add(EGUARD, path);
+    r = mg_guard(path, &name);
+    putstr(&rec.guard, path);
+    putn(&rec.guard, r);
+    if (r)
+        putstr(&rec.guard, name);
+    rec.nguard++;
+}
+
+
+/*
+ *  marks the end of the output list
+ */
+void (pch_mark)(void)
+{
+    if (!rec.level)
+        return;
+
+    rec.mark = lst_tail();
+    rec.marked = 1;
+}
+
+
+/*
+ *  outputs a replayed header after the #include directive;
+ *  returns the last token output for -E or NULL
+ */
+lex_t *(pch_flush)(int *pstate)
+{
+    unsigned long i, n;
+    mcr_def_t d;
+    const lmap_t *pos;
+    const char *s, *name;
+    lex_t *l = NULL, *t, *u;
+
+    assert(pstate);
+
+    if (!rep.on) {
+        if (rec.level && !rec.marked)
+            pch_mark();
+        return NULL;
+    }
+    rep.on = 0;
+
+    /* marks macros used */
+    rp = rep.mdep;
+    for (i = 0; i < rep.nmdep; i++) {
+        s = getstr();
+        if (getn())
+            (void)getm(getn());
+        if (getn())
+            mcr_use(s);
+    }
+
+    rp = rep.cur;
+    n = getn();
+    for (i = 0; i < n; i++)
+        l = lst_append(l, gettok(strg_line, 0));
+    if (l)
+        lst_output(l);
+
+    n = getn();
+    for (i = 0; i < n && !rerr; i++)
+        switch(getb()) {
+            case 'D':
+                define();
+                break;
+            case 'P':
+                s = getstr();
+                pos = locus(getn());
+                if (s && pos && mcr_getdef(s, &d)) {
+                    d.pos = pos;
+                    mcr_setdef(s, &d);
+                }
+                break;
+            case 'U':
+                if ((s = getstr()) != NULL)
+                    mcr_undef(s);
+                break;
+            case 'O':
+                s = getstr();
+                name = getstr();
+                if (s)
+                    mg_add(hash_string(s), (name)? hash_string(name): NULL);
+                break;
+        }
+
+    *pstate = getn();
+    t = gettok(strg_line, 0);
+    ((lmap_t *)lmap_pfrom(lmap_from))->u.i.printed = 0;
+    MEM_FREE(rep.data);
+
+    if (main_opt()->pponly) {
+        t->id = LEX_NEWLINE;
+        t->f.sync = 2;
+        u = lex_make(0, NULL, 0);
+        lst_output(lst_append(t, u));
+        return u;
+    }
+
+    return NULL;
+}
+
+
+/*
+ *  captures tokens output since the last mark
+ */
+void (pch_capture)(void)
+{
+    lex_t *p, *t;
+
+    if (!rec.level || !rec.marked)
+        return;
+    if (err_ndiag() != rec.ndiag) {
+        abandon();
+        return;
+    }
+
+    t = lst_tail();
+    if (!t || t == rec.mark)
+        return;
+    p = (rec.mark)? rec.mark->next: t->next;
+    while (1) {
+        if (p->id != -1) {
+            if (!puttok(&rec.tok, p)) {
+                abandon();
+                return;
+            }
+            rec.ntok++;
+        }
+        if (p == t)
+            break;
+        p = p->next;
+    }
+    rec.mark = t;
+}
+
+
+/*
+ *  finishes recording at the end of a system header
+ */
+void (pch_end)(int state, const lex_t *t)
+{
+    assert(t);
+
+    if (!rec.level || inc_level != rec.level)
+        return;
+
+    pch_capture();
+    if (!rec.level)
+        return;
+    if (puttok(&rec.eoi, t))
+        save(state);
+    abandon();
+}
+
+
+/*
+ *  remembers a macro the header depends on
+ */
+void (pch_macro)(const char *chn)
+{
+    struct ent *e;
+    mcr_def_t d;
+
+    assert(chn);
+
+    if (!rec.level || find(EMACRO, chn))
+        return;
+
+    e = add(EMACRO, chn);    /* before mcr_getdef() that calls back */
+    e->f.dep = 1;
+    *rec.pmacro = e;
+    rec.pmacro = &e->next;
+    if (mcr_getdef(chn, &d)) {
+        e->f.defined = 1;
+        sig(&sbuf, &d);
+        e->sig = memcpy(ARENA_ALLOC(strg, sbuf.n), sbuf.p, sbuf.n);
+        e->nsig = sbuf.n;
+    }
+}
+
+
+/*
+ *  remembers a macro defined in the header
+ */
+void (pch_define)(const char *cn)
+{
+    int ext;
+    long id;
+    mcr_def_t d;
+    struct ent *e;
+    const char *chn;
+
+    assert(cn);
+
+    if (!rec.level)
+        return;
+
+    chn = hash_string(cn);
+    e = find(EMACRO, chn);
+    ext = (e && e->f.dep && e->f.defined && !e->f.touched);
+    touch(chn);
+    if (!mcr_getdef(chn, &d) || (id = posid(d.pos)) < 0) {
+        abandon();
+        return;
+    }
+    if (ext) {    /* redefined as before; only locus changes */
+        putb(&rec.ev, 'P');
+        putstr(&rec.ev, chn);
+        putn(&rec.ev, id+1);
+        rec.nev++;
+        return;
+    }
+    putb(&rec.ev, 'D');
+    putstr(&rec.ev, chn);
+    putn(&rec.ev, id+1);
+    puti(&rec.ev, d.argno);
+    putn(&rec.ev, d.vaarg | (d.sharp << 1) | ((d.param != NULL) << 2));
+    if ((d.param && !puttoks(&rec.ev, d.param)) || !puttoks(&rec.ev, d.rl)) {
+        abandon();
+        return;
+    }
+    rec.nev++;
+}
+
+
+/*
+ *  remembers a macro #undef'ed in the header
+ */
+void (pch_undef)(const char *cn)
+{
+    const char *chn;
+
+    assert(cn);
+
+    if (!rec.level)
+        return;
+
+    chn = hash_string(cn);
+    touch(chn);
+    putb(&rec.ev, 'U');
+    putstr(&rec.ev, chn);
+    rec.nev++;
+}
+
+
+/*
+ *  remembers a macro used in the header
+ */
+void (pch_use)(const char *chn)
+{
+    struct ent *e;
+
+    assert(chn);
+
+    if (rec.level && (e = find(EMACRO, chn)) != NULL && e->f.dep && !e->f.touched)
+        e->f.used = 1;
+}
+
+
+/*
+ *  remembers a macro guard set in the header
+ */
+void (pch_once)(const char *rf, const char *name)
+{
+    assert(rf);
+
+    if (!rec.level)
+        return;
+
+    putb(&rec.ev, 'O');
+    putstr(&rec.ev, rf);
+    putstr(&rec.ev, name);
+    rec.nev++;
+}
+
+
+/*
+ *  gives up recording when output depends on the context
+ */
+void (pch_taint)(void)
+{
+    if (rec.level)
+        abandon();
+}
+
+/* end of pch.c */
@@ -0,0 +1,31 @@
+/*
+ *  header cache for preprocessing
+ */
+
+#ifndef PCH_H
+#define PCH_H
+
+#include "lex.h"
+#include "lmap.h"
+
+
+void pch_init(void);
+void pch_free(void);
+int pch_replay(const lmap_t *);
+void pch_start(const char *);
+void pch_guard(const char *);
+void pch_mark(void);
+lex_t *pch_flush(int *);
+void pch_capture(void);
+void pch_end(int, const lex_t *);
+void pch_macro(const char *);
+void pch_define(const char *);
+void pch_undef(const char *);
+void pch_use(const char *);
+void pch_once(const char *, const char *);
+void pch_taint(void);
+
+
+#endif    /* PCH_H */
+
+/* end of pch.h */
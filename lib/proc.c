@@ -22,6 +22,7 @@
 #include "main.h"
 #include "mcr.h"
 #include "mg.h"
+#include "pch.h"
 #include "prgm.h"
 #include "strg.h"
 #include "util.h"
@@ -133,6 +134,7 @@ static lex_t *dinclude(const lmap_t *pos)
 {
     static char buf[64+1];    /* size must be (power of 2) + 1 */
 
+    int r;
     lex_t *t;
     const lmap_t *hpos;
     const char *inc = NULL;
@@ -226,9 +228,10 @@ static lex_t *dinclude(const lmap_t *pos)
             err_dpos(lmap_after(pos), ERR_PP_NOHEADER);
     }
 
-    if (!inc || !inc_start(inc, hpos))
+    r = (inc)? inc_start(inc, hpos): 0;
+    if (r != 1)
         in_nextline();    /* because lex_inc set */
-    else if (main_opt()->pponly) {
+    if (r && main_opt()->pponly) {
         t->f.sync = 1;
         lst_output(lst_copy(t, 0, strg_line));
     }
@@ -287,6 +290,10 @@ static lex_t *dif(const lmap_t *pos, int kind, int ign)
             else {
                 c = expr_start(&t, "#if");
                 cond_list->f.once = !(cond_list->f.ignore = xe(c->u.u, xO));
+                if (mg_state == MG_SINIT && state == SIDIREC && (s = expr_mgname()) != NULL) {
+                    mg_name = hash_string(s);
+                    mg_state = MG_SMACRO;
+                }
             }
             break;
         case COND_KIFNDEF:
@@ -450,6 +457,7 @@ static const char *recstr(lex_t *t)
         *p = (*s == '\\')? xnu(lex_bs(t, ss, &s, xiu(UCHAR_MAX), "file name")): *s++;
         p++;
     }
+    *p = '\0';
 
     return r;
 }
@@ -731,8 +739,9 @@ static void setdirecst(lex_t *t)
  */
 void (proc_prep)(void)
 {
-    lex_t *t = lst_nexti();
+    lex_t *t = lst_nexti(), *u;
 
+    pch_mark();
     while (1) {
         switch(state) {
             case SINIT:
@@ -760,19 +769,20 @@ void (proc_prep)(void)
                                 lst_flush(1);
                                 return;
                             }
+                            pch_end(state, t);
                             if (main_opt()->pponly) {
-                                lex_t *u = lst_copy(t, 0, strg_line);
+                                u = lst_copy(t, 0, strg_line);
                                 u->id = LEX_NEWLINE;
                                 u->f.sync = 2;
                                 u = lst_append(u, lex_make(0, NULL, 0));
                                 lst_output(u);
                                 lst_discard(1);    /* discards EOI */
-                                in_switch(NULL, 0);    /* pop */
+                                in_switch(NULL, NULL, 0);    /* pop */
                                 t = lst_nexti();
                                 u->pos = t->pos;
                             } else {
                                 lst_discard(1);    /* discards EOI */
-                                in_switch(NULL, 0);    /* pop */
+                                in_switch(NULL, NULL, 0);    /* pop */
                                 t = lst_nexti();
                             }
                             setdirecst(t);
@@ -785,7 +795,10 @@ void (proc_prep)(void)
             case SIDIREC:
             case SDIREC:
                 directive(t);
+                u = pch_flush(&state);
                 t = lst_nexti();    /* token after newline */
+                if (u)    /* replayed from header cache */
+                    u->pos = t->pos;
                 setdirecst(t);
                 break;
             case SNORM:
@@ -796,6 +809,7 @@ void (proc_prep)(void)
                     t = lst_nexti();
                 }
                 lst_flush(1);
+                pch_capture();
                 state = SAFTRNL;
                 return;    /* at least newline flushed */
             case SIGN:
@@ -0,0 +1,317 @@
+/*
+ *  compile server
+ */
+
+#ifdef HAVE_SOCKET
+#include <errno.h>         /* errno, EINTR, ENAMETOOLONG */
+#include <stddef.h>        /* NULL, size_t */
+#include <stdio.h>         /* FILE, fdopen, fclose, fflush */
+#include <stdlib.h>        /* EXIT_FAILURE */
+#include <string.h>        /* memchr, memcpy, memset, strcpy, strlen */
+#include <cbl/assert.h>    /* assert */
+#include <cbl/memory.h>    /* MEM_ALLOC, MEM_RESIZE, MEM_FREE */
+#include <cdsl/hash.h>     /* hash_string */
+#include <sys/types.h>     /* pid_t, ssize_t */
+#include <sys/socket.h>    /* socket, bind, listen, accept, recvmsg, struct msghdr, CMSG_* */
+#include <sys/select.h>    /* select, fd_set, FD_ZERO, FD_SET, FD_ISSET */
+#include <sys/uio.h>       /* struct iovec */
+#include <sys/un.h>        /* struct sockaddr_un */
+#include <sys/wait.h>      /* waitpid, WIFEXITED */
+#include <unistd.h>        /* fork, pipe, dup2, close, read, write, chdir, unlink, _exit */
+
+#include "common.h"
+#include "inc.h"
+#include "srv.h"
+
+#define NFD    3       /* # of descriptors passed for a request */
+#define RUNIT  1024    /* allocation unit for requests and reports */
+
+
+/* children compiling translation units */
+static struct child {
+    pid_t pid;        /* process id */
+    int fd;           /* read end of pipe for report */
+    char *buf;        /* report read */
+    size_t n, m;      /* # of bytes read and allocated */
+} *child;
+
+static int nchild, mchild;    /* # of children running and allocated */
+static int conn = -1;         /* (child) connection to client */
+static int rep = -1;          /* (child) write end of pipe for report */
+
+
+/*
+ *  reads a report from a child;
+ *  returns false when the child has finished
+ */
+static int collect(struct child *p)
+{
+    int st;
+    ssize_t n;
+
+    assert(p);
+
+    if (p->m - p->n < RUNIT)
+        MEM_RESIZE(p->buf, p->m += RUNIT);
+    if ((n = read(p->fd, p->buf+p->n, p->m-p->n-1)) > 0 || (n < 0 && errno == EINTR)) {
+        if (n > 0)
+            p->n += n;
+        return 1;
+    }
+
+    close(p->fd);
+    if (waitpid(p->pid, &st, 0) == p->pid && WIFEXITED(st) && p->n > 0) {
+        if (p->buf[p->n-1] != '\0')    /* truncated */
+            p->buf[p->n++] = '\0';
+        inc_learn(p->buf, p->buf+p->n);
+    }
+    MEM_FREE(p->buf);
+
+    return 0;
+}
+
+
+/*
+ *  forks a child for a connection;
+ *  returns true in the child
+ */
+static int start(int s, int c)
+{
+    int i, fd[2];
+    pid_t pid;
+
+    if (pipe(fd) < 0) {
+        close(c);
+        return 0;
+    }
+    fflush(NULL);
+    if ((pid = fork()) < 0) {
+        close(fd[0]);
+        close(fd[1]);
+        close(c);
+        return 0;
+    }
+
+    if (pid == 0) {    /* child */
+        close(s);
+        close(fd[0]);
+        for (i = 0; i < nchild; i++)
+            close(child[i].fd);
+        nchild = 0;
+        conn = c;
+        rep = fd[1];
+        return 1;
+    }
+
+    close(fd[1]);
+    close(c);
+    if (nchild == mchild) {
+        mchild += 8;
+        if (child)
+            MEM_RESIZE(child, mchild * sizeof(*child));
+        else
+            child = MEM_ALLOC(mchild * sizeof(*child));
+    }
+    child[nchild].pid = pid;
+    child[nchild].fd = fd[0];
+    child[nchild].buf = MEM_ALLOC(child[nchild].m = RUNIT);
+    child[nchild].n = 0;
+    nchild++;
+
+    return 0;
+}
+
+
+/*
+ *  counts null characters
+ */
+static int nnul(const char *p, size_t n)
+{
+    int c = 0;
+    const char *e = p + n;
+
+    assert(p);
+
+    while ((p = memchr(p, '\0', e-p)) != NULL) {
+        c++;
+        if (++p == e)
+            break;
+    }
+
+    return c;
+}
+
+
+/*
+ *  (child) receives a request;
+ *  a request consists of the working directory, input and output file names each terminated
+ *  by a null character, and descriptors for the standard input, output and error;
+ *  empty names denote the standard input or output
+ */
+static void receive(const char **pin, const char **pout)
+{
+    int i, *pfd;
+    ssize_t n;
+    char *buf, *p;
+    size_t len, m = RUNIT;
+    struct iovec v;
+    struct msghdr h;
+    struct cmsghdr *c;
+    union {
+        struct cmsghdr h;
+        char b[CMSG_SPACE(NFD * sizeof(int))];
+    } u;
+
+    assert(pin);
+    assert(pout);
+
+    buf = MEM_ALLOC(m);
+    v.iov_base = buf;
+    v.iov_len = m;
+    memset(&h, 0, sizeof(h));
+    h.msg_iov = &v;
+    h.msg_iovlen = 1;
+    h.msg_control = u.b;
+    h.msg_controllen = sizeof(u.b);
+    while ((n = recvmsg(conn, &h, 0)) < 0 && errno == EINTR)
+        continue;
+    if (n <= 0 || (c = CMSG_FIRSTHDR(&h)) == NULL || c->cmsg_level != SOL_SOCKET ||
+        c->cmsg_type != SCM_RIGHTS || c->cmsg_len != CMSG_LEN(NFD * sizeof(int)))
+        _exit(EXIT_FAILURE);
+    pfd = (int *)CMSG_DATA(c);
+    for (i = 0; i < NFD; i++) {
+        dup2(pfd[i], i);
+        if (pfd[i] >= NFD)
+            close(pfd[i]);
+    }
+
+    for (len = n; nnul(buf, len) < NFD; len += n) {
+        if (m - len < RUNIT)
+            MEM_RESIZE(buf, m += RUNIT);
+        while ((n = read(conn, buf+len, m-len)) < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            _exit(EXIT_FAILURE);
+    }
+
+    if (chdir(buf) < 0)
+        _exit(EXIT_FAILURE);
+    p = buf + strlen(buf) + 1;
+    *pin = (*p)? hash_string(p): NULL;
+    p += strlen(p) + 1;
+    *pout = (*p)? hash_string(p): NULL;
+    MEM_FREE(buf);
+}
+
+
+/*
+ *  accepts translation units on a UNIX domain socket until the standard input is closed;
+ *  returns 1 in a child process that compiles a translation unit, 0 when the server terminates,
+ *  and -1 with errno set if the server cannot start
+ */
+int (srv_serve)(const char *path, const char **pin, const char **pout)
+{
+    int i, s, c, n;
+    char buf[64];
+    fd_set fs;
+    struct sockaddr_un a;
+
+    assert(path);
+    assert(pin);
+    assert(pout);
+
+    if (strlen(path) >= sizeof(a.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memset(&a, 0, sizeof(a));
+    a.sun_family = AF_UNIX;
+    strcpy(a.sun_path, path);
+    if ((s = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+        return -1;
+    if (bind(s, (struct sockaddr *)&a, sizeof(a)) < 0 || listen(s, SOMAXCONN) < 0) {
+        close(s);
+        return -1;
+    }
+    fflush(NULL);
+    write(1, "\n", 1);    /* ready */
+
+    while (1) {
+        FD_ZERO(&fs);
+        FD_SET(0, &fs);
+        FD_SET(s, &fs);
+        n = s;
+        for (i = 0; i < nchild; i++) {
+            FD_SET(child[i].fd, &fs);
+            if (child[i].fd > n)
+                n = child[i].fd;
+        }
+        if (select(n+1, &fs, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (i = 0; i < nchild; )
+            if (FD_ISSET(child[i].fd, &fs) && !collect(&child[i]))
+                child[i] = child[--nchild];
+            else
+                i++;
+        if (FD_ISSET(0, &fs) && read(0, buf, sizeof(buf)) <= 0)
+            break;
+        if (FD_ISSET(s, &fs) && (c = accept(s, NULL, NULL)) >= 0 && start(s, c)) {
+            receive(pin, pout);
+            return 1;
+        }
+    }
+
+    close(s);
+    unlink(path);
+    while (nchild > 0)
+        if (!collect(&child[nchild-1]))
+            nchild--;
+    MEM_FREE(child);
+
+    return 0;
+}
+
+
+/*
+ *  (child) reports #include lookups to the server;
+ *  must be called before inc_free()
+ */
+void (srv_report)(void)
+{
+    FILE *fp;
+
+    if (rep < 0)
+        return;
+
+    if ((fp = fdopen(rep, "w")) != NULL) {
+        inc_report(fp);
+        fclose(fp);
+    } else
+        close(rep);
+    rep = -1;
+}
+
+
+/*
+ *  (child) reports the exit code to the client
+ */
+void (srv_done)(int code)
+{
+    unsigned char st = code;
+
+    if (conn < 0)
+        return;
+
+    if (rep >= 0)    /* nothing to report */
+        close(rep);
+    fflush(NULL);
+    write(conn, &st, 1);
+    close(conn);
+    conn = rep = -1;
+}
+#endif    /* HAVE_SOCKET */
+
+/* end of srv.c */
@@ -0,0 +1,16 @@
+/*
+ *  compile server
+ */
+
+#ifndef SRV_H
+#define SRV_H
+
+
+int srv_serve(const char *, const char **, const char **);
+void srv_report(void);
+void srv_done(int);
+
+
+#endif    /* SRV_H */
+
+/* end of srv.h */
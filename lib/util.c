@@ -3,7 +3,8 @@
  */
 
 #include <stddef.h>        /* size_t */
-#include <string.h>        /* strcpy, strrchr */
+#include <stdio.h>         /* sprintf */
+#include <string.h>        /* strcpy, strrchr, memcpy, memmove */
 #include <cbl/assert.h>    /* assert */
 #include <cbl/memory.h>    /* MEM_ALLOC, MEM_RESIZE, MEM_FREE */
 #include <cdsl/hash.h>     /* hash_string, hash_new */
@@ -300,4 +301,118 @@ const char *(extname)(const char *f, int dsep)
     return (p && p > f && p[-1] != dsep)? p+1: "";
 }
 
+
+#define M32(x)    ((x) & 0xffffffffUL)
+#define ROR(x, n) M32(((x) >> (n)) | ((x) << (32-(n))))
+
+/*
+ *  (SHA-256) processes a block
+ */
+static void block(sha256_t *c)
+{
+    static const unsigned long k[64] = {
+        0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL,
+        0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL,
+        0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL,
+        0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+        0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL,
+        0x06ca6351UL, 0x14292967UL, 0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL,
+        0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL, 0xa2bfe8a1UL, 0xa81a664bUL,
+        0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+        0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL,
+        0x5b9cca4fUL, 0x682e6ff3UL, 0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+        0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+    };
+    int i;
+    unsigned long w[64], v[8], t1, t2;
+
+    assert(c);
+
+    for (i = 0; i < 16; i++)
+        w[i] = ((unsigned long)c->b[4*i] << 24) | ((unsigned long)c->b[4*i+1] << 16) |
+               ((unsigned long)c->b[4*i+2] << 8) | c->b[4*i+3];
+    for (; i < 64; i++)
+        w[i] = M32((ROR(w[i-2], 17) ^ ROR(w[i-2], 19) ^ (w[i-2] >> 10)) + w[i-7] +
+                   (ROR(w[i-15], 7) ^ ROR(w[i-15], 18) ^ (w[i-15] >> 3)) + w[i-16]);
+    memcpy(v, c->h, sizeof(v));
+    for (i = 0; i < 64; i++) {
+        t1 = M32(v[7] + (ROR(v[4], 6) ^ ROR(v[4], 11) ^ ROR(v[4], 25)) +
+                 ((v[4] & v[5]) ^ (~v[4] & v[6])) + k[i] + w[i]);
+        t2 = M32((ROR(v[0], 2) ^ ROR(v[0], 13) ^ ROR(v[0], 22)) +
+                 ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2])));
+        memmove(v+1, v, sizeof(*v) * 7);
+        v[4] = M32(v[4] + t1);
+        v[0] = M32(t1 + t2);
+    }
+    for (i = 0; i < 8; i++)
+        c->h[i] = M32(c->h[i] + v[i]);
+}
+
+
+/*
+ *  (SHA-256) initializes a context
+ */
+void (sha256_init)(sha256_t *c)
+{
+    static const unsigned long h[8] = {
+        0x6a09e667UL, 0xbb67ae85UL, 0x3c6ef372UL, 0xa54ff53aUL,
+        0x510e527fUL, 0x9b05688cUL, 0x1f83d9abUL, 0x5be0cd19UL
+    };
+
+    assert(c);
+
+    memcpy(c->h, h, sizeof(h));
+    c->n[0] = c->n[1] = 0;
+}
+
+
+/*
+ *  (SHA-256) hashes bytes
+ */
+void (sha256_add)(sha256_t *c, const void *p, size_t n)
+{
+    const unsigned char *s = p;
+
+    assert(c);
+    assert(p || n == 0);
+
+    while (n-- > 0) {
+        c->b[c->n[0] & 63] = *s++;
+        if ((c->n[0] = M32(c->n[0] + 1)) == 0)
+            c->n[1]++;
+        if ((c->n[0] & 63) == 0)
+            block(c);
+    }
+}
+
+
+/*
+ *  (SHA-256) finishes hashing and writes a digest in 64 hexadecimal digits;
+ *  buf must have room for 64+1 characters
+ */
+char *(sha256_hex)(sha256_t *c, char *buf)
+{
+    int i;
+    unsigned char len[8];
+    unsigned long hi, lo;
+
+    assert(c);
+    assert(buf);
+
+    hi = M32((c->n[1] << 3) | (c->n[0] >> 29));
+    lo = M32(c->n[0] << 3);
+    for (i = 0; i < 4; i++) {
+        len[i] = (hi >> (24 - 8*i)) & 0xff;
+        len[4+i] = (lo >> (24 - 8*i)) & 0xff;
+    }
+    sha256_add(c, "\x80", 1);
+    while ((c->n[0] & 63) != 56)
+        sha256_add(c, "", 1);
+    sha256_add(c, len, sizeof(len));
+    for (i = 0; i < 8; i++)
+        sprintf(buf + 8*i, "%08lx", c->h[i]);
+
+    return buf;
+}
+
 /* end of util.c */
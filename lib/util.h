@@ -8,6 +8,14 @@
 #include <stddef.h>    /* size_t */
 
 
+/* SHA-256 context */
+typedef struct sha256_t {
+    unsigned long h[8];     /* intermediate hash */
+    unsigned long n[2];     /* # of bytes hashed; lower and upper 32 bits */
+    unsigned char b[64];    /* block being filled */
+} sha256_t;
+
+
 const char *rpath(const char *path);
 unsigned long utf8to32(const char **);
 int wcwidth(unsigned long);
@@ -15,6 +23,9 @@ size_t snlen(const char *, size_t);
 char *snbuf(size_t, int);
 const char *basename(const char *, int);
 const char *extname(const char *, int);
+void sha256_init(sha256_t *);
+void sha256_add(sha256_t *, const void *, size_t);
+char *sha256_hex(sha256_t *, char *);
 
 
 #endif    /* UTIL_H */
@@ -301,6 +301,15 @@ ir_t ir_bnull = {
         0,    /* left_to_right */
         0     /* want_dag */
     },
+    {
+        1,     /* cmp */
+        3,     /* table */
+        0,     /* bittest */
+        50,    /* density */
+        0      /* bits */
+    },
+    1,            /* maxscale */
+    0,            /* regparm */
     NULL,         /* out */
     symaddr,
     symgsc,
@@ -327,13 +336,16 @@ ir_t ir_bnull = {
         0,       /* nreg */
         0,       /* nnt */
         NULL,    /* rule */
+        NULL,    /* burs */
         NULL,    /* ntname */
         NULL,    /* rmapw */
         NULL,    /* rmaps */
         NULL,    /* prerewrite */
         NULL,    /* target */
         NULL,    /* clobber */
-        NULL     /* emit */
+        NULL,    /* vkill */
+        NULL,    /* emit */
+        NULL     /* peep */
     }
 };
 
@@ -3,8 +3,11 @@
  */
 
 #include <stddef.h>        /* NULL */
-#include <stdio.h>         /* FILE, fprintf, fputs */
-#include <string.h>        /* strlen */
+#include <limits.h>        /* UCHAR_MAX */
+#include <stdio.h>         /* FILE, fprintf, fputs, tmpfile, rewind, fclose, stderr */
+#include <stdlib.h>        /* exit, EXIT_FAILURE */
+#include <string.h>        /* strlen, strcmp, strstr */
+#include <cbl/arena.h>     /* ARENA_CALLOC */
 #include <cbl/assert.h>    /* assert */
 #include <cdsl/hash.h>     /* hash_int */
 #include <cel/opt.h>       /* opt_t, opt_reinit, opt_parse, opt_errmsg */
@@ -13,11 +16,15 @@
 #endif    /* !NDEBUG */
 
 #include "bnull.h"    /* common.h, dag.h, gen.h, ir.h, lex.h, op.h, sym.h */
+#include "alist.h"
 #include "clx.h"
 #include "cgr.h"
+#include "elf.h"
 #include "err.h"
 #include "init.h"
 #include "lmap.h"
+#include "main.h"
+#include "peep.h"
 #include "reg.h"
 #include "strg.h"
 #include "ty.h"
@@ -25,6 +32,9 @@
 #define P(x) bx86l_##x         /* prefix to avoid name conflict */
 #define S(p) ((sym_t *)(p))    /* shorthand for cast to sym_t * */
 
+/* checks if ARG passes argument in register; sym[1] replaced by prerewrite() */
+#define ARGREG(p) ((p)->sym[1]->x.regnode != NULL)
+
 /* token pasting */
 #define xpaste(p, n) paste(p, n)
 #define paste(p, n)  p ## n
@@ -55,6 +65,8 @@ enum {
 static int fprog;         /* true when progbeg() invoked */
 static int finit;         /* true when init() invoked */
 static FILE *out;         /* output file */
+static int fobj;          /* true if --object given */
+static FILE *obj;         /* object file for --object; NULL otherwise */
 static int endian = 1;    /* for LITTLE from common.h */
 
 static cgr_t rule[
@@ -63,6 +75,8 @@ static cgr_t rule[
 #include "bx86l.r"
 +1];    /* for end marker */
 
+#include "bx86l.tab"    /* burs; generated by cgrgen */
+
 static sym_t *intreg[MAX],      /* register set for 4-byte integers */
              *shortreg[MAX],    /* register set for 2-byte integers */
              *charreg[MAX],     /* register set for 1-byte integers */
@@ -73,6 +87,9 @@ static sym_t *intregw,          /* wildcard for intreg */
              *fltregw;          /* wildcard for fltreg */
 static sym_t *quo, *rem;        /* registers for div/rem */
 
+static const int parmreg[] = { EAX, EDX, ECX };    /* registers for arguments */
+static alist_t *stubs;                              /* functions whose stubs referenced */
+
 
 /*
  *  cost function: con1
@@ -135,7 +152,7 @@ static int memop(dag_node_t *p)
     assert(p->kid[1] && p->kid[1]->kid[0]);
 
     return (op_generic(p->kid[1]->kid[0]->op) == OP_INDIR &&
-            same(p->kid[0], p->kid[1]->kid[0]->kid[0]))? 3: CGR_CSTMAX;
+            same(p->kid[0], p->kid[1]->kid[0]->kid[0]))? 0: CGR_CSTMAX;
 }
 
 
@@ -147,12 +164,13 @@ static int arg(dag_node_t *p)
     assert(p);
     assert(p->sym[0]);
 
-    return (xgs(p->sym[0]->u.c.v.s, xO))? 1: CGR_CSTMAX;
+    return (xgs(p->sym[0]->u.c.v.s, xO))? 0: CGR_CSTMAX;
 }
 
 
 /*
- *  cost function: args
+ *  cost function: args;
+ *  the preceding rule with arg() covers calls returning no structure
  */
 static int args(dag_node_t *p)
 {
@@ -162,7 +180,31 @@ static int args(dag_node_t *p)
     assert(p->sym[0]);
 
     return (xe(p->sym[0]->u.c.v.s, xO))? CGR_CSTMAX:
-           (assert(p->sym[1]), rty=ty_freturn(p->sym[1]->type), TY_ISSTRUNI(rty))? 0: 1;
+           (assert(p->sym[1]), rty=ty_freturn(p->sym[1]->type), TY_ISSTRUNI(rty))? 0: CGR_CSTMAX;
+}
+
+
+/*
+ *  cost function: argstk
+ */
+static int argstk(dag_node_t *p)
+{
+    assert(p);
+    assert(p->sym[1]);
+
+    return ARGREG(p)? CGR_CSTMAX: 0;
+}
+
+
+/*
+ *  cost function: argreg
+ */
+static int argreg(dag_node_t *p)
+{
+    assert(p);
+    assert(p->sym[1]);
+
+    return ARGREG(p)? 0: CGR_CSTMAX;
 }
 
 
@@ -197,6 +239,7 @@ static void init(void)
         cgr_add(&rule[i]);
     }
     assert(i == NELEM(rule)-1);
+    assert(burs.nnt == cgr_ntidx(P(max)));
 }
 
 
@@ -301,6 +344,8 @@ static void symlocal(sym_t *p)
 static void option(int *pc, char **pv[], void (*oerr)(const char *, ...))
 {
     static opt_t tab[] = {
+        "regparm", UCHAR_MAX+1, OPT_ARG_OPT, OPT_TYPE_INT,
+        "object",  UCHAR_MAX+2, OPT_ARG_NO,  OPT_TYPE_NO,
         NULL,
     };
 
@@ -314,6 +359,22 @@ static void option(int *pc, char **pv[], void (*oerr)(const char *, ...))
 
     while ((c = opt_parse()) != -1) {
         switch(c) {
+            case UCHAR_MAX+1:    /* --regparm */
+                assert(ir_cur);
+                if (argptr) {
+                    long n = *(const long *)argptr;
+                    if (n < 0 || n > (long)NELEM(parmreg))
+                        oerr("number of register arguments must be between 0 and %d\n",
+                             (int)NELEM(parmreg));
+                    else
+                        ir_cur->regparm = n;
+                } else
+                    ir_cur->regparm = NELEM(parmreg);
+                break;
+            case UCHAR_MAX+2:    /* --object */
+                fobj = 1;
+                break;
+
             /* common case labels follow */
             case 0:    /* flag variable set; do nothing else now */
                 break;
@@ -374,7 +435,8 @@ static void progbeg(FILE *outfp)
         reg_umask[i] = reg_mask(strg_perm, -1);
     }
     reg_tmask[REG_SINT] = reg_mask(strg_perm, EAX, ECX, EDX, EBX, ESI, EDI, -1);
-    reg_vmask[REG_SINT] = reg_mask(strg_perm, -1);
+    reg_vmask[REG_SINT] = (main_opt()->olevel > 0)? reg_mask(strg_perm, EBX, ESI, EDI, -1):
+                                                     reg_mask(strg_perm, -1);
     reg_tmask[REG_SFP] = reg_mask(strg_perm, 0, 1, 2, 3, 4, 5, 6, 7, -1);
     reg_vmask[REG_SFP] = reg_mask(strg_perm, -1);
 
@@ -382,19 +444,103 @@ static void progbeg(FILE *outfp)
     quo = reg_new("%%eax", EAX, REG_SINT, EAX, EDX, -1);
     rem = reg_new("%%edx", EDX, REG_SINT, EDX, EAX, -1);
 
+    if (fobj) {    /* assembly kept until progend(); created here for compile server */
+        obj = outfp;
+        if ((outfp = tmpfile()) == NULL) {
+            fprintf(stderr, "%s: failed to create temporary file for --object\n",
+                    main_opt()->prgname);
+            exit(EXIT_FAILURE);
+        }
+    }
     ir_cur->out = out = outfp;
 }
 
 
+/*
+ *  returns the stub of a function taking arguments in registers;
+ *  the stub takes all arguments on the stack, thus can be called via a pointer
+ */
+static sym_t *stub(sym_t *f)
+{
+    sym_t *s;
+
+    assert(f);
+    assert(f->x.name);
+    assert(TY_ISFUNC(f->type) && f->u.f.regparm > 0);
+
+    if ((s = f->x.stub) == NULL) {
+        s = ARENA_CALLOC(strg_perm, 1, sizeof(*s));
+        s->name = s->x.name = gen_sfmt(strlen(f->x.name) + 4, "%s.stk", f->x.name);
+        s->type = f->type;
+        s->sclass = LEX_STATIC;
+        s->scope = SYM_SGLOBAL;
+        f->x.stub = s;
+        stubs = alist_append(stubs, f, strg_perm);
+    }
+
+    return s;
+}
+
+
+/*
+ *  emits the stub of a function;
+ *  copies arguments left on the stack and loads the others into registers
+ */
+static void emitstub(const sym_t *f)
+{
+    int i, lab;
+    ssz_t n = 0;
+    void **proto;    /* ty_t */
+
+    assert(f);
+    assert(f->x.stub);
+    assert(f->type->u.f.proto);
+
+    proto = f->type->u.f.proto;
+    for (i = f->u.f.regparm; proto[i]; i++)
+        n += ROUNDUP(((ty_t *)proto[i])->size, 4);
+
+    fputs(".align 16\n", out);
+    fprintf(out, ".type %s,@function\n", f->x.stub->x.name);
+    fprintf(out, "%s:\n", f->x.stub->x.name);
+    for (i = 0; i < n/4; i++)
+        fprintf(out, "pushl %"FMTSZ"d(%%esp)\n", 4*f->u.f.regparm + n);
+    for (i = 0; i < f->u.f.regparm; i++)
+        fprintf(out, "movl %"FMTSZ"d(%%esp),%s\n", 4*(i+1) + n, intreg[parmreg[i]]->x.name);
+    fprintf(out, "call %s\n", f->x.name);
+    if (n > 0)
+        fprintf(out, "addl $%"FMTSZ"d,%%esp\n", n);
+    fputs("ret\n", out);
+
+    lab = sym_genlab(1);
+    fprintf(out, ".Lf%d:\n", lab);
+    fprintf(out, ".size %s,.Lf%d-%s\n", f->x.stub->x.name, lab, f->x.stub->x.name);
+}
+
+
 /*
  *  finalizes a program
  */
 static void progend(void)
 {
+    sz_t n;
+    alist_t *pos;
+
     assert(fprog);
 
+    gen_close();
     init_swtoseg(INIT_SEGCODE);
+    ALIST_FOREACH(n, pos, stubs) {
+        emitstub(pos->data);
+    }
     fputs(".ident \"beluga: 0.0.1\"\n", out);
+    if (obj) {
+        rewind(out);
+        if (err_count() == 0)    /* no object from erroneous code */
+            elf_asm(out, obj);
+        fclose(out);
+        ir_cur->out = out = obj;
+    }
 }
 
 
@@ -448,6 +594,8 @@ static void initaddr(sym_t *p)
     assert(p);
     assert(p->x.name);
 
+    if (p->type && TY_ISFUNC(p->type) && p->u.f.regparm > 0)
+        p = stub(p);
     fprintf(out, ".long %s\n", p->x.name);
 }
 
@@ -603,6 +751,12 @@ static void function(sym_t *f, void *caller[], void *callee[], int n)    /* sym_
         reg_mclear(reg_umask[i]);
         reg_mfill(reg_fmask[i]);
     }
+    for (i = 0; i < MAX; i++)    /* unbinds register variables of previous function */
+        if (intreg[i]) {
+            intreg[i]->x.regnode->vbl = shortreg[i]->x.regnode->vbl = NULL;
+            if (charreg[i])
+                charreg[i]->x.regnode->vbl = NULL;
+        }
 
     assert(f->x.name);
     fputs(".align 16\n", out);
@@ -619,20 +773,33 @@ static void function(sym_t *f, void *caller[], void *callee[], int n)    /* sym_
         sym_t *p = callee[i],
               *q = caller[i];
         assert(p && q);
+        p->sclass = q->sclass = LEX_AUTO;
+        if (i < f->u.f.regparm)    /* stored into frame below */
+            continue;
         gen_off = ROUNDUP(gen_off, q->type->align);
         p->x.offset = q->x.offset = gen_off;
         p->x.name = q->x.name = hash_int(p->x.offset);
-        p->sclass = q->sclass = LEX_AUTO;
         gen_off += ROUNDUP(q->type->size, 4);
     }
     assert(!caller[i]);
 
     gen_off = gen_maxoff = 0;
+    for (i = 0; i < f->u.f.regparm; i++) {
+        sym_t *p = callee[i],
+              *q = caller[i];
+        gen_auto(q, 4);
+        p->x.offset = q->x.offset;
+        p->x.name = q->x.name;
+    }
+    gen_maxoff = gen_off;
     dag_gencode(caller, callee);
     gen_frame = ROUNDUP(gen_maxoff, 4);
     if (gen_frame > 0)
         fprintf(out, "subl $%"FMTSZ"d,%%esp\n", gen_frame);
+    for (i = 0; i < f->u.f.regparm; i++)
+        fprintf(out, "movl %s,%s(%%ebp)\n", intreg[parmreg[i]]->x.name, S(caller[i])->x.name);
     dag_emitcode();
+    gen_free();
 
     fputs("movl %ebp,%esp\n", out);
     fputs("popl %edi\n", out);
@@ -691,17 +858,80 @@ static const char *ntname(int nt)
 }
 
 
+/*
+ *  finds the function to which an argument is passed and the position of the argument;
+ *  returns NULL for an indirect call;
+ *  ASSUMPTION: arguments are listed just before their call in reverse order
+ */
+static sym_t *callee(const dag_node_t *p, int *pn)
+{
+    int n;
+    const dag_node_t *q;
+
+    assert(p);
+    assert(pn);
+
+    for (n = 0; p; p = p->link)
+        if (op_generic(p->op) == OP_ARG)
+            n++;
+        else {
+            q = (op_generic(p->op) == OP_ASGN)? p->kid[1]: p;
+            if (op_generic(q->op) == OP_CALL) {
+                *pn = n;
+                return (op_generic(q->kid[0]->op) == OP_ADDRG)? q->kid[0]->sym[0]: NULL;
+            }
+        }
+
+    return NULL;
+}
+
+
+/*
+ *  replaces references to functions taking arguments in registers with those to their stubs
+ *  except for direct calls
+ */
+static void funcaddr(dag_node_t *p)
+{
+    sym_t *f;
+
+    if (!p)
+        return;
+
+    if (op_generic(p->op) == OP_ADDRG) {
+        f = p->sym[0];
+        if (f->type && TY_ISFUNC(f->type) && f->u.f.regparm > 0)
+            p->sym[0] = stub(f);
+        return;
+    }
+    if (op_generic(p->op) != OP_CALL || op_generic(p->kid[0]->op) != OP_ADDRG)
+        funcaddr(p->kid[0]);
+    funcaddr(p->kid[1]);
+}
+
+
 /*
  *  prepares rewriting;
- *  - calculates the argument offset for ARG
+ *  - redirects references to functions taking arguments in registers;
+ *  - assigns registers or calculates the argument offset for ARG
  */
 static void prerewrite(dag_node_t *p)
 {
+    int n;
+    sym_t *f;
+
     assert(p);
+    assert(ir_cur);
 
+    if (ir_cur->regparm > 0)
+        funcaddr(p);
     switch(op_generic(p->op)) {
         case OP_ARG:
-            gen_arg(xns(p->sym[0]->u.c.v.s), 4);
+            if (ir_cur->regparm > 0 && (f = callee(p, &n)) != NULL && n <= f->u.f.regparm) {
+                assert(TY_ISFUNC(f->type));
+                assert(n > 0 && n <= NELEM(parmreg));
+                p->sym[1] = intreg[parmreg[n-1]];
+            } else
+                gen_arg(xns(p->sym[0]->u.c.v.s), 4);
             break;
     }
 }
@@ -721,7 +951,8 @@ static void target(dag_node_t *p)
         case OP_RSHI:
         case OP_RSHU:
             if (!((op_generic(p->kid[1]->op) == OP_CNST && range31(p->kid[1]) != CGR_CSTMAX) ||
-                  (GEN_READCSE(p->kid[1]) && op_generic(GEN_CSE(p->kid[1])->op) == OP_CNST &&
+                  (GEN_READCSE(p->kid[1]) && !GEN_CSE(p->kid[1])->usecse &&
+                   op_generic(GEN_CSE(p->kid[1])->op) == OP_CNST &&
                    range31(GEN_CSE(p->kid[1])) != CGR_CSTMAX)))
                 reg_target(p, 1, intreg[ECX]);
             break;
@@ -754,6 +985,11 @@ static void target(dag_node_t *p)
         case OP_RETI:
             reg_target(p, 0, intreg[EAX]);
             break;
+        case OP_ARGI:
+        case OP_ARGP:
+            if (ARGREG(p))
+                reg_target(p, 0, p->sym[1]);
+            break;
     }
 }
 
@@ -791,17 +1027,51 @@ static int chkstck(const dag_node_t *p, int n)
 }
 
 
+/*
+ *  returns registers an operation kills for register variables
+ */
+static const void *vkill(int op, int set)
+{
+    static reg_mask_t *m;
+
+    if (set == REG_SINT && (op_optype(op) == OP_ASGNB || op_optype(op) == OP_ARGB)) {
+        if (!m)
+            m = reg_mask(strg_perm, ECX, ESI, EDI, -1);
+        return m;
+    }
+
+    return NULL;
+}
+
+
 /*
  *  clobbers registers
  */
 static void clobber(dag_node_t *p)
 {
     static int nstck;
+    static int held;    /* registers with arguments; bit per register */
+
+    int i;
 
     assert(p);
 
     nstck = chkstck(p, nstck);
     switch(op_optype(p->op)) {
+        case OP_ARGI:
+        case OP_ARGP:
+            if (!ARGREG(p))
+                break;
+            if (p->sym[1] != intreg[parmreg[0]]) {    /* keeps until first argument passed */
+                reg_hold(p->sym[1], 1);
+                held |= 1 << p->sym[1]->x.regnode->num;
+            } else
+                for (i = 1; i < NELEM(parmreg); i++)
+                    if (held & (1 << parmreg[i])) {
+                        reg_hold(intreg[parmreg[i]], 0);
+                        held &= ~(1 << parmreg[i]);
+                    }
+            break;
         case OP_ASGNB:
         case OP_ARGB:
             reg_spill(reg_mask(strg_func, ECX, ESI, EDI, -1), REG_SINT, p);
@@ -861,8 +1131,8 @@ static void emit(dag_node_t *p)
 
                 if (c < op_size(p->op)) {    /* extend */
                     assert(c > 0 && c < NELEM(r) && c < NELEM(sfx) && r[c] && sfx[c] != '?');
-                    fprintf(out, "mov%c%cl %s,%s\n", (OP_ISSINT(p->op))? 's': 'z', sfx[c],
-                            preg(*r[c]), p->sym[REG_RX]->x.name);
+                    peep_printf("mov%c%cl %s,%s\n", (OP_ISSINT(p->op))? 's': 'z', sfx[c],
+                                preg(*r[c]), p->sym[REG_RX]->x.name);
                     break;
                 } else {    /* truncate */
                     const char *src, *dst;
@@ -870,22 +1140,167 @@ static void emit(dag_node_t *p)
                     src = preg(intreg);
                     dst = intreg[getnum(p)]->x.name;
                     if (src != dst)
-                        fprintf(out, "movl %s,%s\n", src, dst);
+                        peep_printf("movl %s,%s\n", src, dst);
                 }
             }
             break;
+        case OP_ARGI:
+        case OP_ARGP:    /* passed in register */
+            assert(ARGREG(p));
+            break;
         case OP_ARGB:
-            fprintf(out, "subl $%s,%%esp\n"
-                         "movl %%esp,%%edi\n"
-                         "movl $%s,%%ecx\n"
-                         "rep\n"
-                         "movsb\n",
-                     xtsd(XROUNDUP(p->sym[0]->u.c.v.s, 4)), xtsd(p->sym[0]->u.c.v.s));
+            peep_printf("subl $%s,%%esp\n"
+                        "movl %%esp,%%edi\n"
+                        "movl $%s,%%ecx\n"
+                        "rep\n"
+                        "movsb\n",
+                        xtsd(XROUNDUP(p->sym[0]->u.c.v.s, 4)), xtsd(p->sym[0]->u.c.v.s));
             break;
     }
 }
 
 
+/* checks if peephole operand is register or memory */
+#define ISREG(s) ((s)[0] == '%')
+#define ISMEM(s) ((s)[0] != '%' && (s)[0] != '$')
+
+/*
+ *  checks if a buffered line is a move between two operands
+ */
+static int movl(const peep_t *p)
+{
+    assert(p);
+    return (p->kind == PEEP_INST && p->nopd == 2 && strcmp(p->op, "movl") == 0);
+}
+
+
+/*
+ *  peephole: removes a jump to the label that follows
+ */
+static int jmpnext(peep_t *p)
+{
+    const peep_t *q;
+
+    assert(p);
+
+    if (p->nopd != 1 || strcmp(p->op, "jmp") != 0)
+        return 0;
+    for (q = p->next; q->kind == PEEP_LABEL; q = q->next)
+        if (q->op == p->opd[0]) {
+            peep_remove(p);
+            return 1;
+        }
+
+    return 0;
+}
+
+
+/*
+ *  peephole: removes a move that undoes the previous one
+ */
+static int movback(peep_t *p)
+{
+    peep_t *q = p->next;
+
+    assert(p);
+
+    if (!movl(p) || !movl(q) || q->opd[0] != p->opd[1] || q->opd[1] != p->opd[0] ||
+        (ISMEM(p->opd[0]) && strstr(p->opd[0], p->opd[1])))    /* address changed */
+        return 0;
+    peep_remove(q);
+
+    return 1;
+}
+
+
+/*
+ *  peephole: replaces a load after a store to the same slot with a register move
+ */
+static int storeload(peep_t *p)
+{
+    peep_t *q = p->next;
+
+    assert(p);
+
+    if (!movl(p) || !movl(q) || !ISREG(p->opd[0]) || !ISMEM(p->opd[1]) ||
+        q->opd[0] != p->opd[1] || !ISREG(q->opd[1]) || q->opd[1] == p->opd[0])
+        return 0;
+    peep_set(q, "movl", p->opd[0], q->opd[1]);
+
+    return 1;
+}
+
+
+/*
+ *  peephole: removes a comparison with 0 when flags are already set for the operand;
+ *  moves between them are tracked since they leave flags alone
+ */
+static int cmpzero(peep_t *p)
+{
+    static const char *logic[] = { "andl", "orl", "xorl", NULL },    /* clear CF and OF */
+                      *arith[] = { "addl", "subl", "incl", "decl", "negl", NULL };
+
+    int i, n = 0;
+    const char *x, *d = NULL, **op, *w[4];
+    const peep_t *q;
+
+    assert(p);
+
+    q = p->next;
+    if (p->nopd != 2 || strcmp(p->op, "cmpl") != 0 || strcmp(p->opd[0], "$0") != 0 ||
+        q->kind != PEEP_INST || q->op[0] != 'j' || strcmp(q->op, "jmp") == 0)
+        return 0;
+
+    x = p->opd[1];
+    for (q = p->prev; q->kind == PEEP_INST && q->nopd > 0; q = q->prev) {
+        d = q->opd[q->nopd-1];
+        if (!movl(q))
+            break;
+        if (d == x) {
+            x = q->opd[0];
+            if (!ISREG(x) && !ISMEM(x))
+                return 0;
+            for (i = 0; i < n; i++)
+                if (w[i] == x || (ISMEM(x) && (ISMEM(w[i]) || strstr(x, w[i]))))
+                    return 0;
+        } else if (ISMEM(x) && (ISMEM(d) || strstr(x, d)))
+            return 0;
+        if (n == NELEM(w))
+            return 0;
+        w[n++] = d;
+    }
+    if (q->kind != PEEP_INST || q->nopd == 0 || d != x)
+        return 0;
+
+    for (op = logic; *op && strcmp(q->op, *op) != 0; op++)
+        continue;
+    if (!*op) {
+        if (strcmp(p->next->op, "je") != 0 && strcmp(p->next->op, "jne") != 0)
+            return 0;
+        for (op = arith; *op && strcmp(q->op, *op) != 0; op++)
+            continue;
+        if (!*op)
+            return 0;
+    }
+    peep_remove(p);
+
+    return 1;
+}
+
+
+/* peephole rules */
+static const peep_rule_t peep[] = {
+    { "jmpnext",   jmpnext   },
+    { "movback",   movback   },
+    { "storeload", storeload },
+    { "cmpzero",   cmpzero   },
+    { NULL,        NULL      }
+};
+
+#undef ISMEM
+#undef ISREG
+
+
 /* IR interface for null binding */
 ir_t ir_bx86l = {
      1, 1, 0,     /* charmetric */
@@ -908,6 +1323,15 @@ ir_t ir_bx86l = {
         0,    /* left_to_right */
         0,    /* want_dag */
     },
+    {
+        1,     /* cmp */
+        4,     /* table */
+        2,     /* bittest */
+        33,    /* density */
+        32     /* bits */
+    },
+    8,             /* maxscale */
+    0,             /* regparm; set by option() */
     NULL,          /* out; set by progbeg() */
     symaddr,
     symgsc,
@@ -934,13 +1358,16 @@ ir_t ir_bx86l = {
         MAX,                  /* nreg */
         cgr_ntidx(P(max)),    /* nnt */
         rule,
+        &burs,
         ntname,
         rmapw,
         rmaps,
         prerewrite,
         target,
         clobber,
-        emit
+        vkill,
+        emit,
+        peep
     }
 };
 
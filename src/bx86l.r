@@ -66,77 +66,79 @@ rr(P(rc5),   OP_CNSTI4,  0,  range31,  "$%a")
 rr(P(rc5),   OP_CNSTU4,  0,  range31,  "$%a")
 
 /* ARG */
-rr(P(stmt),  OP_ARGF4 _ OP_1 _ P(reg),                    0,  NULL,  "subl $4,%%esp\n"
-                                                                     "fstps (%%esp)\n")
-rr(P(stmt),  OP_ARGF8 _ OP_1 _ P(reg),                    0,  NULL,  "subl $8,%%esp\n"
-                                                                     "fstpl (%%esp)\n")
-rr(P(stmt),  OP_ARGFc _ OP_1 _ P(reg),                    0,  NULL,  "subl $12,%%esp\n"
-                                                                     "fstpt (%%esp)\n")
-rr(P(stmt),  OP_ARGI4 _ OP_1 _ P(mrca),                   1,  NULL,  "pushl %0\n")
-rr(P(stmt),  OP_ARGP4 _ OP_1 _ P(mrca),                   1,  NULL,  "pushl %0\n")
-rr(P(stmt),  OP_ARGB _ OP_1 _ OP_INDIRB _ OP_1 _ P(reg),  0,  NULL,  "# ARGB\n")
+rr(P(stmt),  OP_ARGF4 _ OP_1 _ P(reg),                    0,  NULL,    "subl $4,%%esp\n"
+                                                                       "fstps (%%esp)\n")
+rr(P(stmt),  OP_ARGF8 _ OP_1 _ P(reg),                    0,  NULL,    "subl $8,%%esp\n"
+                                                                       "fstpl (%%esp)\n")
+rr(P(stmt),  OP_ARGFc _ OP_1 _ P(reg),                    0,  NULL,    "subl $12,%%esp\n"
+                                                                       "fstpt (%%esp)\n")
+rr(P(stmt),  OP_ARGI4 _ OP_1 _ P(mrca),                   1,  argstk,  "pushl %0\n")
+rr(P(stmt),  OP_ARGP4 _ OP_1 _ P(mrca),                   1,  argstk,  "pushl %0\n")
+rr(P(stmt),  OP_ARGI4 _ OP_1 _ P(reg),                    0,  argreg,  "# ARG\n")
+rr(P(stmt),  OP_ARGP4 _ OP_1 _ P(reg),                    0,  argreg,  "# ARG\n")
+rr(P(stmt),  OP_ARGB _ OP_1 _ OP_INDIRB _ OP_1 _ P(reg),  0,  NULL,    "# ARGB\n")
 
 /* ASGN */
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDI4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "incl %1\n")
+                 OP_ADDI4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "incl %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDU4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "incl %1\n")
+                 OP_ADDU4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "incl %1\n")
 rr(P(stmt),  OP_ASGNP4 _ OP_2 _
                  P(addr) _
-                 OP_ADDP4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "incl %1\n")
+                 OP_ADDP4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "incl %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBI4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "decl %1\n")
+                 OP_SUBI4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "decl %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBU4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "decl %1\n")
+                 OP_SUBU4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "decl %1\n")
 rr(P(stmt),  OP_ASGNP4 _ OP_2 _
                  P(addr) _
-                 OP_SUBP4 _ OP_2 _ P(mem4) _ P(con1),  0,  memop,  "decl %1\n")
+                 OP_SUBP4 _ OP_2 _ P(mem4) _ P(con1),  3,  memop,  "decl %1\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDI4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "addl %2,%1\n")
+                 OP_ADDI4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "addl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDU4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "addl %2,%1\n")
+                 OP_ADDU4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "addl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBI4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "subl %2,%1\n")
+                 OP_SUBI4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "subl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBU4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "subl %2,%1\n")
+                 OP_SUBU4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "subl %2,%1\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BANDU4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "andl %2,%1\n")
+                 OP_BANDU4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "andl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BORU4 _ OP_2 _ P(mem4) _ P(rc),   0,  memop,  "orl %2,%1\n")
+                 OP_BORU4 _ OP_2 _ P(mem4) _ P(rc),   3,  memop,  "orl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BXORU4 _ OP_2 _ P(mem4) _ P(rc),  0,  memop,  "xorl %2,%1\n")
+                 OP_BXORU4 _ OP_2 _ P(mem4) _ P(rc),  3,  memop,  "xorl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BCOMU4 _ OP_1 _ P(mem4),          0,  memop,  "notl %1\n")
+                 OP_BCOMU4 _ OP_1 _ P(mem4),          3,  memop,  "notl %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_NEGI4 _ OP_1 _ P(mem4),           0,  memop,  "negl %1\n")
+                 OP_NEGI4 _ OP_1 _ P(mem4),           3,  memop,  "negl %1\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_LSHI4 _ OP_2 _ P(mem4) _ P(rc5),  0,  memop,  "sall %2,%1\n")
+                 OP_LSHI4 _ OP_2 _ P(mem4) _ P(rc5),  3,  memop,  "sall %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_LSHU4 _ OP_2 _ P(mem4) _ P(rc5),  0,  memop,  "shll %2,%1\n")
+                 OP_LSHU4 _ OP_2 _ P(mem4) _ P(rc5),  3,  memop,  "shll %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_RSHI4 _ OP_2 _ P(mem4) _ P(rc5),  0,  memop,  "sarl %2,%1\n")
+                 OP_RSHI4 _ OP_2 _ P(mem4) _ P(rc5),  3,  memop,  "sarl %2,%1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_RSHU4 _ OP_2 _ P(mem4) _ P(rc5),  0,  memop,  "shrl %2,%1\n")
+                 OP_RSHU4 _ OP_2 _ P(mem4) _ P(rc5),  3,  memop,  "shrl %2,%1\n")
 
 rr(P(stmt),  OP_ASGNF4 _ OP_2 _
                  P(addr) _
@@ -223,23 +225,23 @@ rr(P(reg),  OP_CVIU24 _ OP_1 _
 rr(P(reg),  OP_CVIU14 _ OP_1 _ P(reg),        3,  NULL,          "# extend\n")
 rr(P(reg),  OP_CVIU24 _ OP_1 _ P(reg),        3,  NULL,          "# extend\n")
 rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        0,  gen_move,      "movl %0,%R\n")
+rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        1,  gen_move,      "movl %0,%R\n")
 
 /* CVUI */
 rr(P(reg),  OP_CVUI41 _ OP_1 _ P(reg),  1,  NULL,          "# truncate\n")
 rr(P(reg),  OP_CVUI42 _ OP_1 _ P(reg),  1,  NULL,          "# truncate\n")
 rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  0,  gen_move,      "movl %0,%R\n")
+rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  1,  gen_move,      "movl %0,%R\n")
 
 /* CVUU - not applicable */
 
 /* CVUP */
 rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  0,  gen_move,      "movl %0,%R\n")
+rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  1,  gen_move,      "movl %0,%R\n")
 
 /* CVPU */
 rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  0,  gen_move,      "movl %0,%R\n")
+rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  1,  gen_move,      "movl %0,%R\n")
 
 /* NEG */
 rr(P(reg),  OP_NEGF4 _ OP_1 _ P(reg),  0,  NULL,  "fchs\n")
@@ -249,24 +251,24 @@ rr(P(reg),  OP_NEGI4 _ OP_1 _ P(reg),  2,  NULL,  "?movl %0,%R\n"
                                                   "negl %R\n")
 
 /* CALL */
-rr(P(stmt),  OP_CALLF4 _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(stmt),  OP_CALLF4 _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n"
                                                       "fstp %%st(0)\n")
-rr(P(stmt),  OP_CALLF8 _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(stmt),  OP_CALLF8 _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n"
                                                       "fstp %%st(0)\n")
-rr(P(stmt),  OP_CALLFc _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(stmt),  OP_CALLFc _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n"
                                                       "fstp %%st(0)\n")
-rr(P(reg),   OP_CALLF4 _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(reg),   OP_CALLF4 _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n")
-rr(P(reg),   OP_CALLF8 _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(reg),   OP_CALLF8 _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n")
-rr(P(reg),   OP_CALLFc _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(reg),   OP_CALLFc _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n")
-rr(P(reg),   OP_CALLI4 _ OP_1 _ P(addrj),  0,  arg,   "call %0\n"
+rr(P(reg),   OP_CALLI4 _ OP_1 _ P(addrj),  1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n")
-rr(P(stmt),  OP_CALLV _ OP_1 _ P(addrj),   0,  arg,   "call %0\n"
+rr(P(stmt),  OP_CALLV _ OP_1 _ P(addrj),   1,  arg,   "call %0\n"
                                                       "addl $%a,%%esp\n")
 rr(P(stmt),  OP_CALLV _ OP_1 _ P(addrj),   0,  args,  "call %0\n"
                                                       "addl $%a-4,%%esp\n")
@@ -287,11 +289,11 @@ rr(P(stmt),  OP_CALLV _ OP_1 _ P(addrj),   1,  NULL,  "call %0\n")
 rr(P(reg),  OP_LOADFc _ OP_1 _ P(memt),  0,  NULL,      "fld%0\n")
 rr(P(reg),  OP_LOADF8 _ OP_1 _ P(memf),  0,  NULL,      "fld%0\n")
 rr(P(reg),  OP_LOADF4 _ OP_1 _ P(memf),  0,  NULL,      "fld%0\n")
-rr(P(reg),  OP_LOADI1 _ OP_1 _ P(reg),   0,  gen_move,  "movl %0,%R\n")
-rr(P(reg),  OP_LOADI2 _ OP_1 _ P(reg),   0,  gen_move,  "movl %0,%R\n")
-rr(P(reg),  OP_LOADI4 _ OP_1 _ P(reg),   0,  gen_move,  "movl %0,%R\n")
-rr(P(reg),  OP_LOADU4 _ OP_1 _ P(reg),   0,  gen_move,  "movl %0,%R\n")
-rr(P(reg),  OP_LOADP4 _ OP_1 _ P(reg),   0,  gen_move,  "movl %0,%R\n")
+rr(P(reg),  OP_LOADI1 _ OP_1 _ P(reg),   1,  gen_move,  "movl %0,%R\n")
+rr(P(reg),  OP_LOADI2 _ OP_1 _ P(reg),   1,  gen_move,  "movl %0,%R\n")
+rr(P(reg),  OP_LOADI4 _ OP_1 _ P(reg),   1,  gen_move,  "movl %0,%R\n")
+rr(P(reg),  OP_LOADU4 _ OP_1 _ P(reg),   1,  gen_move,  "movl %0,%R\n")
+rr(P(reg),  OP_LOADP4 _ OP_1 _ P(reg),   1,  gen_move,  "movl %0,%R\n")
 
 /* RET */
 rr(P(stmt),  OP_RETF4 _ OP_1 _ P(reg),  0,  NULL,  "# ret\n")
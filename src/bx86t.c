@@ -63,6 +63,8 @@ static cgr_t rule[
 #include "bx86t.r"
 +1];    /* for end marker */
 
+#include "bx86t.tab"    /* burs; generated by cgrgen */
+
 static sym_t *intreg[MAX],      /* register set for 4-byte integers */
              *shortreg[MAX],    /* register set for 2-byte integers */
              *charreg[MAX],     /* register set for 1-byte integers */
@@ -135,7 +137,7 @@ static int memop(dag_node_t *p)
     assert(p->kid[1] && p->kid[1]->kid[0]);
 
     return (op_generic(p->kid[1]->kid[0]->op) == OP_INDIR &&
-            same(p->kid[0], p->kid[1]->kid[0]->kid[0]))? 3: CGR_CSTMAX;
+            same(p->kid[0], p->kid[1]->kid[0]->kid[0]))? 0: CGR_CSTMAX;
 }
 
 
@@ -170,6 +172,7 @@ static void init(void)
         cgr_add(&rule[i]);
     }
     assert(i == NELEM(rule)-1);
+    assert(burs.nnt == cgr_ntidx(P(max)));
 }
 
 
@@ -378,6 +381,7 @@ static void progend(void)
 {
     assert(fprog);
 
+    gen_close();
     init_swtoseg(0);
     fputs("end\n", out);
 }
@@ -613,6 +617,7 @@ static void function(sym_t *f, void *caller[], void *callee[], int n)    /* sym_
     if (gen_frame > 0)
         fprintf(out, "sub esp,%"FMTSZ"d\n", gen_frame);
     dag_emitcode();
+    gen_free();
 
     fputs("mov esp,ebp\n", out);
     fputs("pop ebp\n", out);
@@ -715,7 +720,8 @@ static void target(dag_node_t *p)
         case OP_RSHI:
         case OP_RSHU:
             if (!((op_generic(p->kid[1]->op) == OP_CNST && range31(p->kid[1]) != CGR_CSTMAX) ||
-                  (GEN_READCSE(p->kid[1]) && op_generic(GEN_CSE(p->kid[1])->op) == OP_CNST &&
+                  (GEN_READCSE(p->kid[1]) && !GEN_CSE(p->kid[1])->usecse &&
+                   op_generic(GEN_CSE(p->kid[1])->op) == OP_CNST &&
                    range31(GEN_CSE(p->kid[1])) != CGR_CSTMAX)))
                 reg_target(p, 1, intreg[ECX]);
             break;
@@ -887,6 +893,15 @@ ir_t ir_bx86t = {
         0,    /* left_to_right */
         0,    /* want_dag */
     },
+    {
+        1,     /* cmp */
+        4,     /* table */
+        2,     /* bittest */
+        33,    /* density */
+        32     /* bits */
+    },
+    8,             /* maxscale */
+    0,             /* regparm */
     NULL,          /* out; set by progbeg() */
     symaddr,
     symgsc,
@@ -913,13 +928,16 @@ ir_t ir_bx86t = {
         MAX,                  /* nreg */
         cgr_ntidx(P(max)),    /* nnt */
         rule,
+        &burs,
         ntname,
         rmapw,
         rmaps,
         prerewrite,
         target,
         clobber,
-        emit
+        NULL,    /* vkill */
+        emit,
+        NULL     /* peep */
     }
 };
 
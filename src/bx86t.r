@@ -75,64 +75,64 @@ rr(P(stmt),  OP_ARGB _ OP_1 _ OP_INDIRB _ OP_1 _ P(reg),  0,  NULL,  "sub esp,%a
 /* ASGN */
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDI4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "inc %1\n")
+                 OP_ADDI4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "inc %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDU4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "inc %1\n")
+                 OP_ADDU4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "inc %1\n")
 rr(P(stmt),  OP_ASGNP4 _ OP_2 _
                  P(addr) _
-                 OP_ADDP4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "inc %1\n")
+                 OP_ADDP4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "inc %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBI4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "dec %1\n")
+                 OP_SUBI4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "dec %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBU4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "dec %1\n")
+                 OP_SUBU4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "dec %1\n")
 rr(P(stmt),  OP_ASGNP4 _ OP_2 _
                  P(addr) _
-                 OP_SUBP4 _ OP_2 _ P(mem) _ P(con1),  0,  memop,  "dec %1\n")
+                 OP_SUBP4 _ OP_2 _ P(mem) _ P(con1),  3,  memop,  "dec %1\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDI4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "add %1,%2\n")
+                 OP_ADDI4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "add %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_ADDU4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "add %1,%2\n")
+                 OP_ADDU4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "add %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBI4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "sub %1,%2\n")
+                 OP_SUBI4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "sub %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_SUBU4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "sub %1,%2\n")
+                 OP_SUBU4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "sub %1,%2\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BANDU4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "and %1,%2\n")
+                 OP_BANDU4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "and %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BORU4 _ OP_2 _ P(mem) _ P(rc),   0,  memop,  "or %1,%2\n")
+                 OP_BORU4 _ OP_2 _ P(mem) _ P(rc),   3,  memop,  "or %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BXORU4 _ OP_2 _ P(mem) _ P(rc),  0,  memop,  "xor %1,%2\n")
+                 OP_BXORU4 _ OP_2 _ P(mem) _ P(rc),  3,  memop,  "xor %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_BCOMU4 _ OP_1 _ P(mem),          0,  memop,  "not %1\n")
+                 OP_BCOMU4 _ OP_1 _ P(mem),          3,  memop,  "not %1\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_NEGI4 _ OP_1 _ P(mem),           0,  memop,  "neg %1\n")
+                 OP_NEGI4 _ OP_1 _ P(mem),           3,  memop,  "neg %1\n")
 
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_LSHI4 _ OP_2 _ P(mem) _ P(rc5),  0,  memop,  "sal %1,%2\n")
+                 OP_LSHI4 _ OP_2 _ P(mem) _ P(rc5),  3,  memop,  "sal %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_LSHU4 _ OP_2 _ P(mem) _ P(rc5),  0,  memop,  "shl %1,%2\n")
+                 OP_LSHU4 _ OP_2 _ P(mem) _ P(rc5),  3,  memop,  "shl %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_RSHI4 _ OP_2 _ P(mem) _ P(rc5),  0,  memop,  "sar %1,%2\n")
+                 OP_RSHI4 _ OP_2 _ P(mem) _ P(rc5),  3,  memop,  "sar %1,%2\n")
 rr(P(stmt),  OP_ASGNI4 _ OP_2 _
                  P(addr) _
-                 OP_RSHU4 _ OP_2 _ P(mem) _ P(rc5),  0,  memop,  "shr %1,%2\n")
+                 OP_RSHU4 _ OP_2 _ P(mem) _ P(rc5),  3,  memop,  "shr %1,%2\n")
 
 rr(P(stmt),  OP_ASGNF4 _ OP_2 _
                  P(addr) _
@@ -214,23 +214,23 @@ rr(P(reg),  OP_CVIU24 _ OP_1 _
 rr(P(reg),  OP_CVIU14 _ OP_1 _ P(reg),        3,  NULL,          "# extend\n")
 rr(P(reg),  OP_CVIU24 _ OP_1 _ P(reg),        3,  NULL,          "# extend\n")
 rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        0,  gen_move,      "mov %R,%0\n")
+rr(P(reg),  OP_CVIU44 _ OP_1 _ P(reg),        1,  gen_move,      "mov %R,%0\n")
 
 /* CVUI */
 rr(P(reg),  OP_CVUI41 _ OP_1 _ P(reg),  1,  NULL,          "# truncate\n")
 rr(P(reg),  OP_CVUI42 _ OP_1 _ P(reg),  1,  NULL,          "# truncate\n")
 rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  0,  gen_move,      "mov %R,%0\n")
+rr(P(reg),  OP_CVUI44 _ OP_1 _ P(reg),  1,  gen_move,      "mov %R,%0\n")
 
 /* CVUU - not applicable */
 
 /* CVUP */
 rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  0,  gen_move,      "mov %R,%0\n")
+rr(P(reg),  OP_CVUP44 _ OP_1 _ P(reg),  1,  gen_move,      "mov %R,%0\n")
 
 /* CVPU */
 rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  0,  gen_notarget,  "%0")
-rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  0,  gen_move,      "mov %R,%0\n")
+rr(P(reg),  OP_CVPU44 _ OP_1 _ P(reg),  1,  gen_move,      "mov %R,%0\n")
 
 /* NEG */
 rr(P(reg),  OP_NEGF4 _ OP_1 _ P(reg),  0,  NULL,  "fchs\n")
@@ -261,11 +261,11 @@ rr(P(stmt),  OP_CALLV _ OP_1 _ P(addrj),   0,  NULL,  "call %0\n"
                                                       "add esp,%a\n")
 
 /* LOAD */
-rr(P(reg),  OP_LOADI1 _ OP_1 _ P(reg),  0,  gen_move,  "mov %R,%0\n")
-rr(P(reg),  OP_LOADI2 _ OP_1 _ P(reg),  0,  gen_move,  "mov %R,%0\n")
-rr(P(reg),  OP_LOADI4 _ OP_1 _ P(reg),  0,  gen_move,  "mov %R,%0\n")
-rr(P(reg),  OP_LOADU4 _ OP_1 _ P(reg),  0,  gen_move,  "mov %R,%0\n")
-rr(P(reg),  OP_LOADP4 _ OP_1 _ P(reg),  0,  gen_move,  "mov %R,%0\n")
+rr(P(reg),  OP_LOADI1 _ OP_1 _ P(reg),  1,  gen_move,  "mov %R,%0\n")
+rr(P(reg),  OP_LOADI2 _ OP_1 _ P(reg),  1,  gen_move,  "mov %R,%0\n")
+rr(P(reg),  OP_LOADI4 _ OP_1 _ P(reg),  1,  gen_move,  "mov %R,%0\n")
+rr(P(reg),  OP_LOADU4 _ OP_1 _ P(reg),  1,  gen_move,  "mov %R,%0\n")
+rr(P(reg),  OP_LOADP4 _ OP_1 _ P(reg),  1,  gen_move,  "mov %R,%0\n")
 
 /* RET */
 rr(P(stmt),  OP_RETF4 _ OP_1 _ P(reg),  0,  NULL,  "# ret\n")
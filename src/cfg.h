@@ -11,11 +11,14 @@
 struct dag_node_t;
 struct sym_t;
 struct cgr_t;
+struct cgr_burs_t;
 
 /* dag node extension (for dag_node_t) */
 typedef struct cfg_node_t {
     short *rn;                     /* nt index to rule number */
     short *cost;                   /* nt index to cost */
+    short state;                   /* labeller state; 0 if none */
+    short base;                    /* cost added to those in cost */
     struct dag_node_t **vr;        /* children to reduce */
     struct dag_node_t *kid[3];     /* children for register allocation */
     short inst;                    /* index from NT if instruction */
@@ -50,6 +53,8 @@ typedef struct cfg_sym_t {
     int usecnt;                    /* */
     struct sym_t **wildcard;       /* register wildcard */
     struct dag_node_t *lastuse;    /* last use of cse */
+    int live;                      /* index+1 of live interval; reg_scan() */
+    struct sym_t *stub;            /* entry with arguments on stack for function */
 } cfg_sym_t;
 
 /* interface extension (for ir_t) */
@@ -58,13 +63,16 @@ typedef struct cfg_ir_t {
     short nreg;            /* # of registers */
     short nnt;             /* # of non-terminals */
     struct cgr_t *rule;    /* rules */
+    const struct cgr_burs_t *burs;              /* BURS tables; NULL if none */
     const char *(*ntname)(int);                 /* returns name of a non-terminal */
     struct sym_t *(*rmapw)(int);                /* returns wildcard for ty/scode */
     int (*rmaps)(int);                          /* returns register set for ty/scode */
     void (*prerewrite)(struct dag_node_t *);    /* prepares rewrite */
     void (*target)(struct dag_node_t *);        /* targets register */
     void (*clobber)(struct dag_node_t *);       /* clobbers registers */
+    const void *(*vkill)(int, int);             /* registers op kills for variables */
     void (*emit)(struct dag_node_t *);          /* emits target-specific output */
+    const struct peep_rule_t *peep;             /* peephole rules; NULL if none */
 } cfg_ir_t;
 
 
@@ -199,10 +199,9 @@ void (cgr_print)(const cgr_t *p, FILE *fp)
     fprintf(fp, "%d: %s: ", p->rn, ir_cur->x.ntname(p->nt));
     print(p->tree, fp);
     fputs(" / [", fp);
+    fprintf(fp, "%d", p->cost);
     if (p->costf)
-        fprintf(fp, "%p", (void *)p->costf);
-    else
-        fprintf(fp, "%d", p->cost);
+        fprintf(fp, "+%p", (void *)p->costf);
     fputs(", \"", fp);
     cgr_tmpl(p->tmpl, fp);
     fputs("\"]\n", fp);
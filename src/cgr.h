@@ -30,14 +30,48 @@ typedef struct cgr_t {
     short rn;                      /* rule number */
     int nt;                        /* non-terminal */
     const int *ot;                 /* array representation */
-    short cost;                    /* cost if costf is NULL */
-    int (*costf)(dag_node_t *);    /* cost function if not NULL */
+    short cost;                    /* cost */
+    int (*costf)(dag_node_t *);    /* residual check if not NULL; 0 or CGR_CSTMAX */
     const char *tmpl;              /* asm template */
     cgr_tree_t *tree;              /* tree representation */
     unsigned char nnt;             /* # of non-terminals in rule */
     unsigned char isinst;          /* true if instruction */
 } cgr_t;
 
+/* op code entry of BURS tables */
+typedef struct cgr_bop_t {
+    int map[2];    /* offsets of state-to-class maps for children; -1 if no child */
+    int ncls;      /* # of classes for second child */
+    int tr;        /* offset of transitions */
+    int bonus;     /* offset of results for reuse bonus by zero-cost set; -1 if none */
+} cgr_bop_t;
+
+/* transition of BURS tables */
+typedef struct cgr_btr_t {
+    int res;    /* offset of results by outcome of residual checks */
+    int dyn;    /* offset of residual checks; -1 if none */
+} cgr_btr_t;
+
+/* result of BURS tables */
+typedef struct cgr_bres_t {
+    short state;    /* state */
+    short base;     /* cost added to costs of state */
+} cgr_bres_t;
+
+/* BURS tables generated by cgrgen */
+typedef struct cgr_burs_t {
+    int nnt;                   /* # of non-terminals */
+    int nop;                   /* # of op codes */
+    const int *op;             /* op codes in ascending order */
+    const cgr_bop_t *bop;      /* entries for op codes */
+    const short *map;          /* state-to-class maps */
+    const cgr_btr_t *tr;       /* transitions */
+    const short *dyn;          /* rule numbers for residual checks; lists end with -1 */
+    const cgr_bres_t *res;     /* results */
+    const short *zero;         /* state to zero-cost set; -1 if no match */
+    short *state;              /* rule numbers and costs for states */
+} cgr_burs_t;
+
 
 alist_t *cgr_lookup(int);
 cgr_t *cgr_add(cgr_t *);
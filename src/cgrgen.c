@@ -0,0 +1,819 @@
+/*
+ *  BURS table generator
+ */
+
+#include <stddef.h>    /* size_t, NULL */
+#include <stdio.h>     /* printf, fprintf, stderr */
+#include <stdlib.h>    /* malloc, realloc, free, exit, EXIT_FAILURE */
+#include <string.h>    /* strcmp, memcmp, memcpy, memmove, memset */
+
+#include "cgr.h"
+#include "op.h"
+
+#define INF    CGR_CSTMAX    /* cost of no match */
+#define MAXDYN 8             /* max # of residual checks for a transition */
+
+#define _ ,
+#define xpaste(p, n) paste(p, n)
+#define paste(p, n)  p ## n
+
+/* generates hash key for cost vectors */
+#define HCOST(v) (hash(v, nnt) & (NELEM(hstate)-1))
+
+
+/* rule as written in machine descriptions */
+typedef struct rule_t {
+    int nt;               /* non-terminal */
+    const int *ot;        /* array representation */
+    int cost;             /* cost */
+    const char *costf;    /* name of residual check; "NULL" if none */
+} rule_t;
+
+
+/* rules from machine descriptions */
+#define P(x) l_##x
+enum {
+    P(_) = OP_2+1,
+#define tt(t) P(t),
+#define rr(n, ops, c, cf, t)
+#include "bx86l.r"
+    P(max)
+};
+#define tt(t)
+#define rr(n, ops, c, cf, t) static const int xpaste(P(ot), __LINE__)[] = { ops, -1 };
+#include "bx86l.r"
+static const rule_t l_rule[] = {
+#define tt(t)
+#define rr(n, ops, c, cf, t) { n, xpaste(P(ot), __LINE__), c, #cf },
+#include "bx86l.r"
+    { 0, }
+};
+#undef P
+
+#define P(x) t_##x
+enum {
+    P(_) = OP_2+1,
+#define tt(t) P(t),
+#define rr(n, ops, c, cf, t)
+#include "bx86t.r"
+    P(max)
+};
+#define tt(t)
+#define rr(n, ops, c, cf, t) static const int xpaste(P(ot), __LINE__)[] = { ops, -1 };
+#include "bx86t.r"
+static const rule_t t_rule[] = {
+#define tt(t)
+#define rr(n, ops, c, cf, t) { n, xpaste(P(ot), __LINE__), c, #cf },
+#include "bx86t.r"
+    { 0, }
+};
+#undef P
+
+/* machine descriptions */
+static const struct {
+    const char *name;       /* name */
+    const rule_t *rule;     /* rules */
+    int nnt;                /* # of non-terminals */
+} md[] = {
+    { "bx86l", l_rule, cgr_ntidx(l_max) },
+    { "bx86t", t_rule, cgr_ntidx(t_max) }
+};
+
+
+/* normalized rule; children are non-terminals */
+typedef struct nrule_t {
+    int rn;        /* rule number; -1 for part of rule */
+    int nt;        /* non-terminal; parts have their own */
+    int kid[2];    /* non-terminals for children; -1 if none */
+    int cost;      /* cost */
+    int dyn;       /* true if residual check */
+} nrule_t;
+
+/* transition */
+typedef struct tr_t {
+    int cls[2];    /* classes of children */
+    int res;       /* index of first result */
+    int dyn;       /* index of residual checks; -1 if none */
+} tr_t;
+
+/* op code */
+typedef struct op_t {
+    int op;              /* op code */
+    int arity;           /* # of children */
+    nrule_t *rule;       /* rules rooted at op code */
+    int nrule, mrule;    /* # of rules and allocated size */
+    int proj[2];         /* projections for children; -1 if none */
+    int ncls[2];         /* # of classes of children seen */
+    tr_t *tr;            /* transitions */
+    int ntr, mtr;        /* # of transitions and allocated size */
+    int *bonus;          /* results for reuse bonus indexed by zero set; NULL if none */
+    int mbonus;          /* allocated size of bonus */
+} op_t;
+
+/* projection of states to non-terminals used by children */
+typedef struct proj_t {
+    int *nt;             /* non-terminals */
+    int n;               /* # of non-terminals */
+    int **cls;           /* cost vectors of classes */
+    int ncls, mcls;      /* # of classes and allocated size */
+} proj_t;
+
+/* labeller state */
+typedef struct state_t {
+    int *cost;    /* costs for non-terminals including parts */
+    int *rn;      /* rule numbers for non-terminals from rules */
+    int zero;     /* id of set of zero-cost non-terminals; -1 if no match */
+    int link;     /* hash chain; -1 if none */
+} state_t;
+
+
+static const rule_t *rule;    /* rules of machine description */
+static int nnt;               /* # of non-terminals from rules */
+static int nt;                /* # of non-terminals including parts */
+
+static nrule_t *chain;        /* chain rules */
+static int nchain, mchain;
+
+static int (*part)[3];        /* parts of rules; op code and non-terminals for children */
+static int npart, mpart;
+
+static op_t *op;              /* op codes in ascending order */
+static int nop, mop;
+
+static proj_t *proj;          /* projections */
+static int nproj, mproj;
+
+static state_t *state;        /* states */
+static int nstate, mstate;
+static int hstate[1024];      /* hash table for states */
+
+static int (*res)[2];         /* results; state and cost added */
+static int nres, mres;
+
+static int *dyn;              /* rule numbers for residual checks; lists end with -1 */
+static int ndyn, mdyn;
+
+static int **zero;            /* sets of zero-cost non-terminals; sets end with -1 */
+static int nzero, mzero;
+
+
+/*
+ *  checks memory allocation
+ */
+static void *chk(void *p)
+{
+    if (!p) {
+        fprintf(stderr, "cgrgen: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return p;
+}
+
+
+/*
+ *  grows a dynamic array to hold n elements
+ */
+static void *grow(void *a, int n, int *pm, size_t size)
+{
+    if (n > *pm) {
+        *pm = (n < 16)? 16: 2*n;
+        a = chk(realloc(a, *pm * size));
+    }
+
+    return a;
+}
+
+
+/*
+ *  stops generation with a message
+ */
+static void fail(const char *msg, int n)
+{
+    fprintf(stderr, "cgrgen: %s %d\n", msg, n);
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ *  computes a hash key from integers
+ */
+static unsigned hash(const int *v, int n)
+{
+    unsigned h = 0;
+
+    while (n-- > 0)
+        h = h*31 + (unsigned)*v++;
+
+    return h;
+}
+
+
+/*
+ *  finds or adds an op code
+ */
+static op_t *opcode(int o, int arity)
+{
+    int i;
+
+    for (i = 0; i < nop && op[i].op < o; i++)
+        continue;
+    if (i < nop && op[i].op == o) {
+        if (op[i].arity != arity)
+            fail("inconsistent arity for op code", o);
+        return &op[i];
+    }
+
+    op = grow(op, nop+1, &mop, sizeof(*op));
+    memmove(&op[i+1], &op[i], (nop-i) * sizeof(*op));
+    nop++;
+    memset(&op[i], 0, sizeof(*op));
+    op[i].op = o;
+    op[i].arity = arity;
+    op[i].proj[0] = op[i].proj[1] = -1;
+
+    return &op[i];
+}
+
+
+/*
+ *  adds a normalized rule to an op code
+ */
+static void addrule(op_t *p, int rn, int n, const int *kid, int cost, int dyn)
+{
+    nrule_t *r;
+
+    p->rule = grow(p->rule, p->nrule+1, &p->mrule, sizeof(*p->rule));
+    r = &p->rule[p->nrule++];
+    r->rn = rn;
+    r->nt = n;
+    r->kid[0] = kid[0];
+    r->kid[1] = kid[1];
+    r->cost = cost;
+    r->dyn = dyn;
+}
+
+
+/*
+ *  normalizes a pattern from its array representation;
+ *  returns the non-terminal for a non-terminal pattern or -1 with its op code and children
+ *  stored into po and kid; children of op codes become parts with their own non-terminals
+ */
+static int pattern(const int **pp, int *po, int *kid)
+{
+    int i, n, o;
+
+    o = *(*pp)++;
+    if (cgr_isnt(o))
+        return cgr_ntidx(o);
+
+    n = (**pp == OP_1)? 1: (**pp == OP_2)? 2: 0;
+    if (n > 0)
+        (*pp)++;
+    kid[0] = kid[1] = -1;
+    for (i = 0; i < n; i++) {
+        int ko, kk[2];
+        if ((kid[i] = pattern(pp, &ko, kk)) >= 0)
+            continue;
+        for (kid[i] = 0; kid[i] < npart; kid[i]++)
+            if (part[kid[i]][0] == ko && part[kid[i]][1] == kk[0] && part[kid[i]][2] == kk[1])
+                break;
+        if (kid[i] == npart) {
+            part = grow(part, npart+1, &mpart, sizeof(*part));
+            part[npart][0] = ko;
+            part[npart][1] = kk[0];
+            part[npart][2] = kk[1];
+            npart++;
+        }
+        kid[i] = -2 - kid[i];    /* renumbered after all parts known */
+    }
+    *po = o;
+
+    return -1;
+}
+
+
+/*
+ *  renumbers non-terminals for parts
+ */
+static int renum(int n)
+{
+    return (n < -1)? nnt + (-2 - n): n;
+}
+
+
+/*
+ *  reads rules of a machine description
+ */
+static void readmd(int m)
+{
+    int i, n, o, k[2];
+    const int *ot;
+
+    rule = md[m].rule;
+    nnt = md[m].nnt;
+
+    for (i = 0; rule[i].nt > 0; i++) {
+        int d = (strcmp(rule[i].costf, "NULL") != 0);
+        ot = rule[i].ot;
+        n = pattern(&ot, &o, k);
+        if (*ot != -1)
+            fail("ill-formed rule", i);
+        if (n >= 0) {    /* chain rule */
+            if (d)
+                fail("residual check not supported for chain rule", i);
+            chain = grow(chain, nchain+1, &mchain, sizeof(*chain));
+            chain[nchain].rn = i;
+            chain[nchain].nt = cgr_ntidx(rule[i].nt);
+            chain[nchain].kid[0] = n;
+            chain[nchain].kid[1] = -1;
+            chain[nchain].cost = rule[i].cost;
+            chain[nchain++].dyn = 0;
+        } else {
+            k[0] = renum(k[0]);
+            k[1] = renum(k[1]);
+            addrule(opcode(o, (k[0] >= 0) + (k[1] >= 0)), i, cgr_ntidx(rule[i].nt), k,
+                    rule[i].cost, d);
+        }
+    }
+
+    for (i = 0; i < npart; i++) {
+        k[0] = renum(part[i][1]);
+        k[1] = renum(part[i][2]);
+        addrule(opcode(part[i][0], (k[0] >= 0) + (k[1] >= 0)), -1, nnt+i, k, 0, 0);
+    }
+    nt = nnt + npart;
+}
+
+
+/*
+ *  finds or adds a projection to non-terminals used by children at a position
+ */
+static int project(const op_t *p, int pos)
+{
+    int i, j, n, *v;
+
+    v = chk(malloc(nt * sizeof(*v)));
+    for (i = 0; i < nt; i++)
+        v[i] = 0;
+    for (i = 0; i < p->nrule; i++)
+        v[p->rule[i].kid[pos]] = 1;
+    for (i = n = 0; i < nt; i++)
+        if (v[i])
+            v[n++] = i;
+
+    for (j = 0; j < nproj; j++)
+        if (proj[j].n == n && memcmp(proj[j].nt, v, n*sizeof(*v)) == 0) {
+            free(v);
+            return j;
+        }
+    proj = grow(proj, nproj+1, &mproj, sizeof(*proj));
+    memset(&proj[nproj], 0, sizeof(*proj));
+    proj[nproj].nt = v;
+    proj[nproj].n = n;
+
+    return nproj++;
+}
+
+
+/*
+ *  finds or adds the class of a state for a projection
+ */
+static int classify(proj_t *p, int s)
+{
+    int i, j, *v;
+
+    v = chk(malloc((p->n+1) * sizeof(*v)));
+    for (i = 0; i < p->n; i++)
+        v[i] = state[s].cost[p->nt[i]];
+    for (j = 0; j < p->ncls; j++)
+        if (memcmp(p->cls[j], v, p->n*sizeof(*v)) == 0) {
+            free(v);
+            return j;
+        }
+    p->cls = grow(p->cls, p->ncls+1, &p->mcls, sizeof(*p->cls));
+    p->cls[p->ncls] = v;
+
+    return p->ncls++;
+}
+
+
+/*
+ *  finds or adds the set of zero-cost non-terminals from rules for a state
+ */
+static int zeroset(const state_t *s)
+{
+    int i, j, n, *v;
+
+    for (i = 1; i < nnt; i++)
+        if (s->cost[i] < INF)
+            break;
+    if (i == nnt)
+        return -1;
+
+    v = chk(malloc(nnt * sizeof(*v)));
+    for (i = 1, n = 0; i < nnt; i++)
+        if (s->cost[i] == 0)
+            v[n++] = i;
+    v[n] = -1;
+    for (j = 0; j < nzero; j++) {
+        for (i = 0; zero[j][i] == v[i] && v[i] >= 0; i++)
+            continue;
+        if (zero[j][i] == v[i]) {
+            free(v);
+            return j;
+        }
+    }
+    zero = grow(zero, nzero+1, &mzero, sizeof(*zero));
+    zero[nzero] = v;
+
+    return nzero++;
+}
+
+
+/*
+ *  finds or adds a state
+ */
+static int intern(const int *cost, const int *rn)
+{
+    int i;
+    unsigned h;
+
+    h = HCOST(cost);
+    for (i = hstate[h]-1; i >= 0; i = state[i].link)
+        if (memcmp(state[i].cost, cost, nt*sizeof(*cost)) == 0 &&
+            memcmp(state[i].rn, rn, nnt*sizeof(*rn)) == 0)
+            return i;
+
+    state = grow(state, nstate+1, &mstate, sizeof(*state));
+    state[nstate].cost = chk(malloc(nt * sizeof(*cost)));
+    state[nstate].rn = chk(malloc(nnt * sizeof(*rn)));
+    memcpy(state[nstate].cost, cost, nt*sizeof(*cost));
+    memcpy(state[nstate].rn, rn, nnt*sizeof(*rn));
+    state[nstate].zero = zeroset(&state[nstate]);
+    state[nstate].link = hstate[h]-1;
+    hstate[h] = nstate+1;
+
+    return nstate++;
+}
+
+
+/*
+ *  adds a result after normalizing costs so that the least one is 0;
+ *  the difference is added at run time
+ */
+static int result(int *cost, const int *rn)
+{
+    int i, m = INF;
+
+    for (i = 0; i < nt; i++)
+        if (cost[i] < m)
+            m = cost[i];
+    if (m < INF)
+        for (i = 0; i < nt; i++)
+            if (cost[i] < INF)
+                cost[i] -= m;
+
+    res = grow(res, nres+1, &mres, sizeof(*res));
+    res[nres][0] = intern(cost, rn);
+    res[nres][1] = (m < INF)? m: 0;
+
+    return nres++;
+}
+
+
+/*
+ *  sets a cost and follows chain rules as setcost() from gen.c does
+ */
+static void setcost(int *cost, int *rn, int r, int n, int c)
+{
+    int i;
+
+    if (c >= INF || c >= cost[n])
+        return;
+    cost[n] = c;
+    rn[n] = r;
+    for (i = 0; i < nchain; i++)
+        if (chain[i].kid[0] == n)
+            setcost(cost, rn, chain[i].rn, chain[i].nt, chain[i].cost + c);
+}
+
+
+/*
+ *  computes a transition for classes of children;
+ *  results are enumerated for all outcomes of residual checks
+ */
+static void transition(op_t *p, int c0, int c1)
+{
+    int i, j, m, w, nd;
+    int *k[2], *cost, *rn;
+    tr_t *t;
+    const nrule_t *r;
+
+    for (i = 0; i < 2; i++) {
+        k[i] = NULL;
+        if (p->proj[i] >= 0) {
+            const proj_t *q = &proj[p->proj[i]];
+            k[i] = chk(malloc(nt * sizeof(*k[i])));
+            for (j = 0; j < nt; j++)
+                k[i][j] = INF;
+            for (j = 0; j < q->n; j++)
+                k[i][q->nt[j]] = q->cls[(i == 0)? c0: c1][j];
+        }
+    }
+#define W(r) (((k[0])? k[0][(r)->kid[0]]: 0) + ((k[1])? k[1][(r)->kid[1]]: 0))
+
+    p->tr = grow(p->tr, p->ntr+1, &p->mtr, sizeof(*p->tr));
+    t = &p->tr[p->ntr++];
+    t->cls[0] = c0;
+    t->cls[1] = c1;
+    t->res = nres;
+    t->dyn = -1;
+
+    /* residual checks are done only for rules otherwise matched as setcost() from gen.c
+       does; they can have side effects */
+    dyn = grow(dyn, ndyn+MAXDYN+1, &mdyn, sizeof(*dyn));
+    for (i = nd = 0; i < p->nrule; i++) {
+        r = &p->rule[i];
+        if (r->dyn && W(r) < INF) {
+            if (nd == MAXDYN)
+                fail("too many residual checks for op code", p->op);
+            dyn[ndyn+nd++] = r->rn;
+        }
+    }
+    if (nd > 0) {
+        t->dyn = ndyn;
+        dyn[ndyn+nd] = -1;
+        ndyn += nd + 1;
+    }
+
+    cost = chk(malloc(nt * sizeof(*cost)));
+    rn = chk(malloc(nnt * sizeof(*rn)));
+    for (m = 0; m < (1 << nd); m++) {
+        int d = 0;
+        for (j = 0; j < nt; j++)
+            cost[j] = INF;
+        for (j = 0; j < nnt; j++)
+            rn[j] = 0;
+        for (i = 0; i < p->nrule; i++) {
+            r = &p->rule[i];
+            if ((w = W(r)) >= INF)
+                continue;
+            if (r->dyn && !(m & (1 << d++)))
+                continue;
+            if (r->rn < 0) {    /* part */
+                if (r->cost + w < cost[r->nt])
+                    cost[r->nt] = r->cost + w;
+            } else
+                setcost(cost, rn, r->rn, r->nt, r->cost + w);
+        }
+        result(cost, rn);
+    }
+#undef W
+    free(cost);
+    free(rn);
+    free(k[0]);
+    free(k[1]);
+}
+
+
+/*
+ *  computes transitions involving a state
+ */
+static void visit(int s)
+{
+    int j, c;
+    op_t *p;
+
+    for (p = op; p < op + nop; p++) {
+        if (p->arity == 0)
+            continue;
+        c = classify(&proj[p->proj[0]], s);
+        if (c == p->ncls[0]) {
+            for (j = 0; j < ((p->arity == 2)? p->ncls[1]: 1); j++)
+                transition(p, c, (p->arity == 2)? j: 0);
+            p->ncls[0]++;
+        }
+        if (p->arity == 2) {
+            c = classify(&proj[p->proj[1]], s);
+            if (c == p->ncls[1]) {
+                for (j = 0; j < p->ncls[0]; j++)
+                    transition(p, j, c);
+                p->ncls[1]++;
+            }
+        }
+    }
+}
+
+
+/*
+ *  finds a transition
+ */
+static const tr_t *find(const op_t *p, int c0, int c1)
+{
+    int i;
+
+    for (i = 0; i < p->ntr; i++)
+        if (p->tr[i].cls[0] == c0 && p->tr[i].cls[1] == c1)
+            return &p->tr[i];
+    fail("no transition for op code", p->op);
+
+    return NULL;
+}
+
+
+/*
+ *  computes all states reachable by labelling;
+ *  a register read for a cse takes over the costs of the cse for non-terminals whose costs
+ *  are zero (see label() from gen.c), which makes a state for each combination of a read and
+ *  a set of zero-cost non-terminals
+ */
+static void closure(void)
+{
+    int i, s, z, *cost, *rn;
+    op_t *p, *v;
+    const tr_t *t;
+
+    cost = chk(malloc(nt * sizeof(*cost)));
+    rn = chk(malloc(nnt * sizeof(*rn)));
+    for (i = 0; i < nt; i++)
+        cost[i] = INF;
+    for (i = 0; i < nnt; i++)
+        rn[i] = 0;
+    intern(cost, rn);    /* state 0 for no match and null child */
+
+    for (p = op; p < op + nop; p++) {
+        for (i = 0; i < p->arity; i++)
+            p->proj[i] = project(p, i);
+        if (p->arity == 0)
+            transition(p, 0, 0);
+    }
+
+    v = opcode(OP_VREGP, 0);
+    if (v->ntr != 1)
+        fail("no rule for op code", OP_VREGP);
+    for (s = z = 0; s < nstate || z < nzero; ) {
+        while (s < nstate)
+            visit(s++);
+        for (; z < nzero; z++)
+            for (p = op; p < op + nop; p++) {
+                int b, d, *w;
+                if (op_generic(p->op) != OP_INDIR || p->arity != 1)
+                    continue;
+                t = find(p, classify(&proj[p->proj[0]], res[v->tr[0].res][0]), 0);
+                if (t->dyn >= 0)
+                    fail("residual check not supported for register read", p->op);
+                b = res[t->res][0];
+                d = res[v->tr[0].res][1] + res[t->res][1];
+                for (i = 0; i < nt; i++)
+                    cost[i] = (state[b].cost[i] < INF)? state[b].cost[i] + d: INF;
+                for (w = zero[z]; *w >= 0; w++)
+                    cost[*w] = 0;
+                p->bonus = grow(p->bonus, z+1, &p->mbonus, sizeof(*p->bonus));
+                p->bonus[z] = result(cost, state[b].rn);
+            }
+    }
+    free(cost);
+    free(rn);
+}
+
+
+/*
+ *  prints an array of integers
+ */
+static void print(const char *type, const char *name, const int *v, int n)
+{
+    int i;
+
+    printf("static %s %s[] = {", type, name);
+    for (i = 0; i < n; i++)
+        printf("%s%d%s", (i % 16 == 0)? "\n    ": "", v[i], (i+1 < n)? ",": "");
+    printf("\n};\n\n");
+}
+
+
+/*
+ *  emits tables
+ */
+static void emit(int m)
+{
+    int i, j, n, *v;
+    op_t *p;
+
+    n = nop;
+    for (i = 0; i < nproj; i++)
+        n += nstate;
+    for (p = op; p < op + nop; p++)
+        n += p->ntr*2 + nzero*2;
+    n += nstate*(1+2*nnt);
+    v = chk(malloc(n * sizeof(*v)));
+
+    printf("/*\n"
+           " *  BURS tables generated by cgrgen from %s.r; do not edit\n"
+           " */\n\n", md[m].name);
+    printf("/* %d op code(s), %d state(s), %d result(s), %d zero-cost set(s) */\n\n",
+           nop, nstate, nres, nzero);
+
+    for (i = 0; i < nop; i++)
+        v[i] = op[i].op;
+    print("const int", "burs_op", v, nop);
+
+    for (i = n = 0; i < nproj; i++)
+        for (j = 0; j < nstate; j++)
+            v[n++] = classify(&proj[i], j);
+    print("const short", "burs_map", v, n);
+
+    /* results for reuse bonus are made contiguous for each op code */
+    for (p = op; p < op + nop; p++)
+        if (p->bonus) {
+            res = grow(res, nres+nzero, &mres, sizeof(*res));
+            for (i = 0; i < nzero; i++) {
+                res[nres+i][0] = res[p->bonus[i]][0];
+                res[nres+i][1] = res[p->bonus[i]][1];
+            }
+            p->bonus[0] = nres;
+            nres += nzero;
+        }
+
+    printf("static const cgr_bop_t burs_bop[] = {\n");
+    for (p = op, n = 0; p < op + nop; p++) {
+        printf("    { { %d, %d }, %d, %d, %d }%s\n",
+               (p->proj[0] >= 0)? p->proj[0]*nstate: -1,
+               (p->proj[1] >= 0)? p->proj[1]*nstate: -1,
+               (p->arity == 2)? p->ncls[1]: 1, n,
+               (p->bonus)? p->bonus[0]: -1, (p+1 < op + nop)? ",": "");
+        n += (p->arity == 0)? 1: (p->arity == 1)? p->ncls[0]: p->ncls[0]*p->ncls[1];
+    }
+    printf("};\n\n");
+
+    printf("static const cgr_btr_t burs_tr[] = {");
+    for (p = op, n = 0; p < op + nop; p++) {
+        int c0, c1;
+        int n0 = (p->arity > 0)? p->ncls[0]: 1, n1 = (p->arity == 2)? p->ncls[1]: 1;
+        for (c0 = 0; c0 < n0; c0++)
+            for (c1 = 0; c1 < n1; c1++) {
+                const tr_t *t = find(p, c0, c1);
+                printf("%s{ %d, %d }%s", (n++ % 6 == 0)? "\n    ": "", t->res, t->dyn,
+                       (p+1 < op + nop || c0+1 < n0 || c1+1 < n1)? ", ": "");
+            }
+    }
+    printf("\n};\n\n");
+
+    if (ndyn == 0)
+        dyn = grow(dyn, ++ndyn, &mdyn, sizeof(*dyn)), dyn[0] = -1;
+    print("const short", "burs_dyn", dyn, ndyn);
+    printf("static const cgr_bres_t burs_res[] = {");
+    for (i = 0; i < nres; i++)
+        printf("%s{ %d, %d }%s", (i % 6 == 0)? "\n    ": "", res[i][0], res[i][1],
+               (i+1 < nres)? ", ": "");
+    printf("\n};\n\n");
+
+    for (i = 0; i < nstate; i++)
+        v[i] = state[i].zero;
+    print("const short", "burs_zero", v, nstate);
+
+    for (i = n = 0; i < nstate; i++) {
+        for (j = 0; j < nnt; j++)
+            v[n++] = state[i].rn[j];
+        for (j = 0; j < nnt; j++)
+            v[n++] = state[i].cost[j];
+    }
+    print("short", "burs_state", v, n);
+
+    printf("static const cgr_burs_t burs = {\n"
+           "    %d,    /* nnt */\n"
+           "    %d,    /* nop */\n"
+           "    burs_op,\n"
+           "    burs_bop,\n"
+           "    burs_map,\n"
+           "    burs_tr,\n"
+           "    burs_dyn,\n"
+           "    burs_res,\n"
+           "    burs_zero,\n"
+           "    burs_state\n"
+           "};\n\n", nnt, nop);
+    printf("/* end of %s.tab */\n", md[m].name);
+    free(v);
+}
+
+
+int main(int argc, char *argv[])
+{
+    int m;
+
+    for (m = 0; m < NELEM(md); m++)
+        if (argc == 2 && strcmp(argv[1], md[m].name) == 0)
+            break;
+    if (m == NELEM(md)) {
+        fprintf(stderr, "usage: cgrgen bx86l|bx86t\n");
+        return EXIT_FAILURE;
+    }
+
+    readmd(m);
+    closure();
+    emit(m);
+
+    return 0;
+}
+
+/* end of cgrgen.c */
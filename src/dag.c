@@ -3,8 +3,9 @@
  */
 
 #include <stddef.h>       /* NULL */
-#include <string.h>       /* memset, memcpy */
+#include <string.h>       /* memcpy */
 #include <cbl/arena.h>    /* ARENA_CALLOC, ARENA_FREE */
+#include <cbl/memory.h>   /* MEM_CALLOC, MEM_FREE */
 #include <cbl/assert.h>   /* assert */
 #ifndef NDEBUG
 #include <stdio.h>        /* FILE, fprintf, putc */
@@ -15,11 +16,14 @@
 #include "decl.h"
 #include "enode.h"
 #include "err.h"
+#include "flow.h"
 #include "init.h"
 #include "ir.h"
 #include "lex.h"
 #include "main.h"
 #include "op.h"
+#include "peep.h"
+#include "reg.h"
 #include "stmt.h"
 #include "strg.h"
 #include "sym.h"
@@ -37,17 +41,33 @@
 #define S(p) ((sym_t *)(p))    /* shorthand for cast to sym_t * */
 
 
+/* hashes a pointer */
+#define HP(p) ((unsigned)((unsigned long)(p) >> 3))
+
+/* computes an index into kill lists */
+#define KIDX(p) (HP(p) & (nbucket-1))
+
+
 int dag_nodecount;    /* # of nodes in hash buckets */
 
 
-/* hash buckets for reuse of dag nodes */
+/* hash table for reuse of dag nodes;
+   rvalue nodes are also linked into kill lists by symbols they read to avoid full scans */
 struct dag_t {
-    dag_node_t node;        /* dag node; not pointer */
-    struct dag_t *hlink;    /* hash link */
+    dag_node_t node;         /* dag node; not pointer */
+    unsigned h;              /* hash value */
+    struct dag_t *hlink;     /* hash link */
+    struct dag_t **hprev;    /* pointer to hash link to this; NULL if killed */
+    struct dag_t *klink;     /* link for kill list */
+    struct dag_t *alink;     /* link for nodes added since last reset */
 };
 
 
-static struct dag_t *bucket[16];    /* hash buckets */
+static struct dag_t **bucket;       /* hash buckets */
+static struct dag_t **kbucket;      /* kill lists for rvalue nodes of symbols */
+static struct dag_t *kindir;        /* kill list for rvalue nodes of computed addresses */
+static struct dag_t *alist;         /* nodes added since last reset */
+static unsigned nbucket;            /* # of buckets; power of 2 */
 static dag_node_t *forest;          /* dag forest */
 static tree_t *firstarg;            /* hidden first argument (!want_callb) */
 static int depth;                   /* nesting depth of && and || */
@@ -73,22 +93,71 @@ static struct dag_t *dagnode(int op, dag_node_t *l, dag_node_t *r, sym_t *sym)
 }
 
 
+/*
+ *  inserts a dag node into hash buckets and a kill list
+ */
+static void insert(struct dag_t *p)
+{
+    struct dag_t **pp;
+    const dag_node_t *k;
+
+    assert(p);
+
+    pp = &bucket[p->h & (nbucket-1)];
+    if ((p->hlink = *pp) != NULL)
+        p->hlink->hprev = &p->hlink;
+    p->hprev = pp;
+    *pp = p;
+
+    if (op_generic(p->node.op) == OP_INDIR) {
+        k = p->node.kid[0];
+        pp = (OP_ISADDR(k->op))? &kbucket[KIDX(k->sym[0])]: &kindir;
+        p->klink = *pp;
+        *pp = p;
+    }
+}
+
+
+/*
+ *  doubles hash buckets and kill lists
+ */
+static void grow(void)
+{
+    struct dag_t *p;
+
+    nbucket = (nbucket == 0)? 64: nbucket * 2;
+    MEM_FREE(bucket);
+    MEM_FREE(kbucket);
+    bucket = MEM_CALLOC(nbucket, sizeof(*bucket));
+    kbucket = MEM_CALLOC(nbucket, sizeof(*kbucket));
+    kindir = NULL;
+    for (p = alist; p; p = p->alink)
+        if (p->hprev)
+            insert(p);
+}
+
+
 /*
  *  returns a dag node with inspection on hash buckets
  */
 static dag_node_t *node(int op, dag_node_t *l, dag_node_t *r, sym_t *sym)
 {
-    int i;
+    unsigned h;
     struct dag_t *p;
 
-    i = (op_index(op) ^ ((unsigned)sym >> 3)) & (NELEM(bucket)-1);
-    for (p = bucket[i]; p; p = p->hlink)
-        if (p->node.op == op && p->node.sym[0] == sym && p->node.kid[0] == l &&
+    if (dag_nodecount >= (int)nbucket)
+        grow();
+
+    h = (op_index(op) * 31) ^ HP(sym) ^ (HP(l) * 7) ^ HP(r);
+    for (p = bucket[h & (nbucket-1)]; p; p = p->hlink)
+        if (p->h == h && p->node.op == op && p->node.sym[0] == sym && p->node.kid[0] == l &&
             p->node.kid[1] == r)
             return &p->node;
     p = dagnode(op, l, r, sym);
-    p->hlink = bucket[i];
-    bucket[i] = p;
+    p->h = h;
+    insert(p);
+    p->alink = alist;
+    alist = p;
     dag_nodecount++;
 
     return &p->node;
@@ -105,23 +174,41 @@ dag_node_t *(dag_newnode)(int op, dag_node_t *l, dag_node_t *r, sym_t *sym)
 
 
 /*
- *  kills rvalue nodes in hash buckets
+ *  removes a dag node from hash buckets
+ */
+static void unhash(struct dag_t *p)
+{
+    assert(p);
+    assert(p->hprev);
+
+    if ((*p->hprev = p->hlink) != NULL)
+        p->hlink->hprev = p->hprev;
+    p->hprev = NULL;
+    dag_nodecount--;
+}
+
+
+/*
+ *  kills rvalue nodes in hash buckets;
+ *  those reading p and those reading computed addresses
  */
 static void kill(const sym_t *p)
 {
-    int i;
     struct dag_t **q;
 
     assert(p);
 
-    for (i = 0; i < NELEM(bucket); i++)
-        for (q = &bucket[i]; *q; )
-            if (op_generic((*q)->node.op) == OP_INDIR &&
-                (!OP_ISADDR((*q)->node.kid[0]->op) || (*q)->node.kid[0]->sym[0] == p)) {
-                *q = (*q)->hlink;
-                dag_nodecount--;
-            } else
-                q = &(*q)->hlink;
+    if (dag_nodecount == 0)
+        return;
+
+    for (q = &kbucket[KIDX(p)]; *q; )
+        if ((*q)->node.kid[0]->sym[0] == p) {
+            unhash(*q);
+            *q = (*q)->klink;
+        } else
+            q = &(*q)->klink;
+    for (; kindir; kindir = kindir->klink)
+        unhash(kindir);
 }
 
 
@@ -130,8 +217,15 @@ static void kill(const sym_t *p)
  */
 static void reset(void)
 {
-    if (dag_nodecount > 0)
-        memset(bucket, 0, sizeof(bucket));
+    struct dag_t *p;
+
+    for (p = alist; p; p = p->alink) {
+        bucket[p->h & (nbucket-1)] = NULL;
+        if (op_generic(p->node.op) == OP_INDIR && OP_ISADDR(p->node.kid[0]->op))
+            kbucket[KIDX(p->node.kid[0]->sym[0])] = NULL;
+    }
+    kindir = NULL;
+    alist = NULL;
     dag_nodecount = 0;
 }
 
@@ -758,6 +852,10 @@ void (dag_gencode)(void *caller[], void *callee[])    /* sym_t */
         stmt_list->next = cp;
         cp->prev = stmt_list;
     }
+    if (err_count() == 0) {
+        flow_opt();
+        reg_scan();
+    }
     for (cp = stmt_head.next; err_count() == 0 && cp; cp = cp->next)
         switch(cp->kind) {
             case STMT_ADDRESS:
@@ -835,6 +933,7 @@ void (dag_emitcode)(void)
                     int i;
                     sym_t *deflab = equated(cp->u.swtch.deflab);
 
+                    peep_flush();
                     decl_defglobal(cp->u.swtch.table, INIT_SEGLIT);
                     ir_cur->initaddr(equated(cp->u.swtch.label[0]));
                     for (i = 1; i < cp->u.swtch.size; i++) {
@@ -850,6 +949,7 @@ void (dag_emitcode)(void)
                 assert(!"invalid code list -- should never reach here");
                 break;
         }
+    peep_flush();
     clx_cpos = pos;
 }
 
@@ -16,6 +16,7 @@
 #include "err.h"
 #include "expr.h"
 #include "init.h"
+#include "inl.h"
 #include "ir.h"
 #include "lex.h"
 #include "main.h"
@@ -1390,7 +1391,10 @@ static sym_t *dcllocal(int sclass, const char *id, ty_t *ty, const lmap_t *posa[
                     e = tree_id(t1, tree_npos1(lmap_range(poss, clx_ppos)));
                 }
                 if (p->type->size > 0) {
-                    dag_walk(tree_asgnid(p, e, tree_npos(p->pos, pos, TREE_NR(e))), 0, 0);
+                    e = tree_asgnid(p, e, tree_npos(p->pos, pos, TREE_NR(e)));
+                    if (e)
+                        inl_expr(e);
+                    dag_walk(e, 0, 0);
                     p->f.set = 1;
                 }
             } else
@@ -1536,6 +1540,7 @@ static void doconst(sym_t *p, void *cl)
  */
 void (decl_finalize)(void)
 {
+    inl_flush();
     sym_foreach(sym_extern, SYM_SGLOBAL, doextern, NULL);
     sym_foreach(sym_ident,  SYM_SGLOBAL, doglobal, NULL);
     sym_foreach(sym_ident,  SYM_SGLOBAL, checkref, NULL);
@@ -1709,6 +1714,36 @@ static void chkmain(void)
 }
 
 
+/*
+ *  determines how many leading arguments of a function can be passed in registers;
+ *  the address of a function referenced before its definition may have escaped
+ */
+static int regparm(sym_t *f, node_t caller[])    /* sym_t */
+{
+    int i;
+    sym_t *q;
+
+    assert(f);
+    assert(TY_ISFUNC(f->type));
+    assert(caller);
+    assert(ty_inttype);    /* ensures types initialized */
+    assert(ir_cur);
+
+    if (ir_cur->regparm == 0 || ir_cur->f.left_to_right || main_opt()->glevel ||
+        f->sclass != LEX_STATIC || f->type->u.f.oldstyle || ty_variadic(f->type) ||
+        TY_ISSTRUNI(ty_freturn(f->type)))
+        return 0;
+    if (f->ref > 0 || ((q = sym_lookup(f->name, sym_extern)) != NULL && q->ref > 0))
+        return 0;
+    for (i = 0; caller[i] && i < ir_cur->regparm; i++)
+        if (!(TY_ISINTEGER(S(caller[i])->type) || TY_ISPTR(S(caller[i])->type)) ||
+            S(caller[i])->type->size != ty_inttype->size)
+            break;
+
+    return i;
+}
+
+
 /*
  *  parses a function definition
  */
@@ -1848,6 +1883,7 @@ static void funcdefn(int sclass, const char *id, ty_t *ty, node_t param[],    /*
     decl_cfunc->u.f.label = sym_genlab(1);
     decl_cfunc->u.f.pt = clx_cpos;    /* { or start of body */
     decl_cfunc->f.defined = 1;
+    decl_cfunc->u.f.regparm = regparm(decl_cfunc, caller);
     decl_callee = callee;
     if (sclass != LEX_STATIC && strcmp(id, "main") == 0) {
         decl_mainfunc = 1;
@@ -1911,10 +1947,12 @@ static void funcdefn(int sclass, const char *id, ty_t *ty, node_t param[],    /*
     if (main_opt()->glevel)
         for (i = 0; callee[i]; i++)
             S(callee[i])->sclass = LEX_AUTO;
-    if (decl_cfunc->sclass != LEX_STATIC)
-        ir_cur->export(decl_cfunc);
-    init_swtoseg(INIT_SEGCODE);
-    ir_cur->function(decl_cfunc, caller, callee, decl_cfunc->u.f.ncall);
+    if (!inl_defer(decl_cfunc, caller, callee)) {
+        if (decl_cfunc->sclass != LEX_STATIC)
+            ir_cur->export(decl_cfunc);
+        init_swtoseg(INIT_SEGCODE);
+        ir_cur->function(decl_cfunc, caller, callee, decl_cfunc->u.f.ncall);
+    }
     sym_foreach(stmt_lab, SYM_SLABEL, checklab, NULL);
     sym_exitscope(posm);
     sset_expect('}', posm);
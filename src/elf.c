@@ -0,0 +1,1995 @@
+/*
+ *  ELF object writer for x86-linux
+ */
+
+#include <ctype.h>         /* isdigit, isalpha, isalnum, isspace */
+#include <stddef.h>        /* size_t, NULL */
+#include <stdio.h>         /* FILE, EOF, getc, putc, fwrite, sprintf */
+#include <stdlib.h>        /* strtoul */
+#include <string.h>        /* strlen, strcmp, strncmp, memcpy, memset */
+#include <cbl/arena.h>     /* ARENA_ALLOC, ARENA_CALLOC */
+#include <cbl/assert.h>    /* assert */
+#include <cbl/memory.h>    /* MEM_ALLOC, MEM_RESIZE, MEM_FREE */
+#include <cdsl/hash.h>     /* hash_new, hash_string */
+
+#include "common.h"
+#include "strg.h"
+#include "elf.h"
+
+/* truncates to 32 bits */
+#define M32(v) ((v) & 0xffffffffUL)
+
+/* checks if value fits in signed 8 bits */
+#define FITS8(v) (M32((v) + 0x80) < 0x100)
+
+/* checks if name is of assembler-local label */
+#define LOCALNAME(s) ((s)[0] == '.' && (s)[1] == 'L')
+
+/* checks if character can start or continue symbol name */
+#define ISID1(c) (isalpha((unsigned char)(c)) || (c) == '_' || (c) == '.')
+#define ISID(c)  (isalnum((unsigned char)(c)) || (c) == '_' || (c) == '.' || (c) == '$')
+
+/* checks if symbol is local and defined */
+#define LOCAL(p) ((p)->sec >= 0 && !(p)->global)
+
+/* skips white-spaces */
+#define SKIPWS(s) while (isspace((unsigned char)*(s))) (s)++
+
+#define SCOMMON (-2)    /* pseudo section for common symbols */
+
+
+/* sections */
+enum {
+    STEXT,       /* .text */
+    SDATA,       /* .data */
+    SBSS,        /* .bss */
+    SCOMMENT,    /* .comment */
+    SMAX
+};
+
+/* section headers */
+enum {
+    HNULL,
+    HTEXT,
+    HRELTEXT,
+    HDATA,
+    HRELDATA,
+    HBSS,
+    HCOMMENT,
+    HSYMTAB,
+    HSTRTAB,
+    HSHSTRTAB,
+    HMAX
+};
+
+/* kinds of fragments */
+enum {
+    FFIXED,    /* fixed bytes */
+    FJUMP,     /* jump whose size depends on distance */
+    FALIGN     /* padding for alignment */
+};
+
+/* kinds of operands */
+enum {
+    OREG,    /* integer register */
+    OST,     /* floating-point register */
+    OIMM,    /* immediate */
+    OMEM     /* memory or branch target */
+};
+
+/* registers */
+enum {
+    EAX,
+    ECX,
+    EDX,
+    EBX,
+    ESP,
+    EBP,
+    ESI,
+    EDI
+};
+
+/* from ELF specification */
+enum {
+    SHT_PROGBITS = 1,
+    SHT_SYMTAB   = 2,
+    SHT_STRTAB   = 3,
+    SHT_NOBITS   = 8,
+    SHT_REL      = 9
+};
+
+enum {
+    SHF_WRITE     = 0x01,
+    SHF_ALLOC     = 0x02,
+    SHF_EXECINSTR = 0x04,
+    SHF_MERGE     = 0x10,
+    SHF_STRINGS   = 0x20,
+    SHF_INFO_LINK = 0x40
+};
+
+enum {
+    STT_NOTYPE,
+    STT_OBJECT,
+    STT_FUNC,
+    STT_SECTION
+};
+
+enum {
+    R_386_32   = 1,
+    R_386_PC32 = 2
+};
+
+#define STB_LOCAL  0
+#define STB_GLOBAL 1
+#define SHN_COMMON 0xfff2
+
+#define EHSIZE  52    /* size of ELF header */
+#define SHSIZE  40    /* size of section header */
+#define SYMSIZE 16    /* size of symbol table entry */
+#define RELSIZE 8     /* size of relocation entry */
+
+
+/* symbol */
+typedef struct esym_t {
+    const char *name;          /* name; hashed */
+    int sec;                   /* section; -1 if undefined */
+    struct frag_t *frag;       /* fragment containing definition */
+    unsigned long off;         /* offset in fragment; alignment for common */
+    unsigned long size;        /* size */
+    struct esym_t *end;        /* label marking end if size given as difference */
+    int type;                  /* STT_NOTYPE, STT_OBJECT or STT_FUNC */
+    unsigned global: 1;        /* true if exported */
+    unsigned used:   1;        /* true if referenced */
+    unsigned long idx;         /* index in symbol table */
+    unsigned long sname;       /* offset of name in string table */
+    struct esym_t *link;       /* hash chain */
+    struct esym_t *next;       /* next symbol in order of appearance */
+} esym_t;
+
+/* fragment */
+typedef struct frag_t {
+    int kind;                 /* FFIXED, FJUMP or FALIGN */
+    unsigned long pos;        /* position in section buffer */
+    int cc;                   /* condition code for FJUMP; -1 for jmp */
+    int big;                  /* true if FJUMP takes 32-bit displacement */
+    esym_t *target;           /* target of FJUMP */
+    unsigned long align;      /* alignment for FALIGN */
+    unsigned long addr;       /* offset in section */
+    unsigned long size;       /* # of bytes */
+    struct frag_t *next;      /* next fragment */
+} frag_t;
+
+/* 32-bit field referring to symbol */
+typedef struct fix_t {
+    frag_t *frag;          /* fragment containing field */
+    unsigned long off;     /* offset of field in fragment */
+    esym_t *sym;           /* symbol referenced */
+    int pcrel;             /* true if pc-relative */
+    struct fix_t *next;    /* next fixup */
+} fix_t;
+
+/* operand */
+typedef struct opd_t {
+    int kind;                   /* OREG, OST, OIMM or OMEM */
+    int ind;                    /* true if prefixed by * */
+    int reg, size;              /* register number and size for OREG and OST */
+    int base, index, scale;     /* registers and scale for OMEM; -1 if absent */
+    esym_t *sym;                /* symbol part of immediate or displacement */
+    unsigned long v;            /* constant part of immediate or displacement */
+} opd_t;
+
+/* expression */
+typedef struct expr_t {
+    esym_t *sym;        /* symbol added */
+    esym_t *sub;        /* symbol subtracted */
+    unsigned long v;    /* constant */
+} expr_t;
+
+/* instruction */
+typedef struct inst_t {
+    const char *name;                                   /* mnemonic */
+    void (*f)(const struct inst_t *, opd_t [], int);    /* encoder */
+    unsigned long op;                                   /* opcode */
+    int ext;                                            /* opcode extension */
+    int size;                                           /* operand size; 0 if from register */
+    struct inst_t *link;                                /* hash chain */
+} inst_t;
+
+
+static void alu(const inst_t *, opd_t [], int);
+static void mov(const inst_t *, opd_t [], int);
+static void movx(const inst_t *, opd_t [], int);
+static void lea(const inst_t *, opd_t [], int);
+static void push(const inst_t *, opd_t [], int);
+static void pop(const inst_t *, opd_t [], int);
+static void call(const inst_t *, opd_t [], int);
+static void jump(const inst_t *, opd_t [], int);
+static void ret(const inst_t *, opd_t [], int);
+static void imul(const inst_t *, opd_t [], int);
+static void unary(const inst_t *, opd_t [], int);
+static void shift(const inst_t *, opd_t [], int);
+static void raw(const inst_t *, opd_t [], int);
+static void fmem(const inst_t *, opd_t [], int);
+static void fstp(const inst_t *, opd_t [], int);
+static void fpop(const inst_t *, opd_t [], int);
+
+
+/* section data */
+static struct sect {
+    unsigned char *buf;       /* bytes of fixed fragments; NULL for .bss */
+    unsigned long n, size;    /* # of bytes used and allocated */
+    frag_t *head, *frag;      /* first and current fragments */
+    fix_t *fix, **pfix;       /* fixups */
+    unsigned long align;      /* alignment */
+    unsigned long lc;         /* size after layout */
+    unsigned char *img;       /* final contents */
+    unsigned char *rel;       /* relocation entries */
+    unsigned long nrel;       /* # of relocation entries */
+    unsigned long relsize;    /* size of rel */
+    unsigned long offset;     /* offset in file */
+    unsigned long reloff;     /* offset of relocation entries in file */
+} sect[SMAX];
+
+/* section header indices */
+static const int shndx[SMAX] = { HTEXT, HDATA, HBSS, HCOMMENT };
+
+/* instruction table */
+static inst_t itab[] = {
+    { "addl",   alu,    0x00,     0, 4, NULL },
+    { "addw",   alu,    0x00,     0, 2, NULL },
+    { "addb",   alu,    0x00,     0, 1, NULL },
+    { "orl",    alu,    0x01,     0, 4, NULL },
+    { "orw",    alu,    0x01,     0, 2, NULL },
+    { "orb",    alu,    0x01,     0, 1, NULL },
+    { "adcl",   alu,    0x02,     0, 4, NULL },
+    { "sbbl",   alu,    0x03,     0, 4, NULL },
+    { "andl",   alu,    0x04,     0, 4, NULL },
+    { "andw",   alu,    0x04,     0, 2, NULL },
+    { "andb",   alu,    0x04,     0, 1, NULL },
+    { "subl",   alu,    0x05,     0, 4, NULL },
+    { "subw",   alu,    0x05,     0, 2, NULL },
+    { "subb",   alu,    0x05,     0, 1, NULL },
+    { "xorl",   alu,    0x06,     0, 4, NULL },
+    { "xorw",   alu,    0x06,     0, 2, NULL },
+    { "xorb",   alu,    0x06,     0, 1, NULL },
+    { "cmpl",   alu,    0x07,     0, 4, NULL },
+    { "cmpw",   alu,    0x07,     0, 2, NULL },
+    { "cmpb",   alu,    0x07,     0, 1, NULL },
+    { "mov",    mov,    0,        0, 0, NULL },
+    { "movl",   mov,    0,        0, 4, NULL },
+    { "movw",   mov,    0,        0, 2, NULL },
+    { "movb",   mov,    0,        0, 1, NULL },
+    { "movsbl", movx,   0xbe,     0, 4, NULL },
+    { "movswl", movx,   0xbf,     0, 4, NULL },
+    { "movzbl", movx,   0xb6,     0, 4, NULL },
+    { "movzwl", movx,   0xb7,     0, 4, NULL },
+    { "leal",   lea,    0x8d,     0, 4, NULL },
+    { "pushl",  push,   0,        0, 4, NULL },
+    { "popl",   pop,    0,        0, 4, NULL },
+    { "call",   call,   0,        0, 4, NULL },
+    { "jmp",    jump,   0,       -1, 4, NULL },
+    { "jo",     jump,   0,        0, 4, NULL },
+    { "jno",    jump,   0,        1, 4, NULL },
+    { "jb",     jump,   0,        2, 4, NULL },
+    { "jae",    jump,   0,        3, 4, NULL },
+    { "je",     jump,   0,        4, 4, NULL },
+    { "jne",    jump,   0,        5, 4, NULL },
+    { "jbe",    jump,   0,        6, 4, NULL },
+    { "ja",     jump,   0,        7, 4, NULL },
+    { "js",     jump,   0,        8, 4, NULL },
+    { "jns",    jump,   0,        9, 4, NULL },
+    { "jp",     jump,   0,       10, 4, NULL },
+    { "jnp",    jump,   0,       11, 4, NULL },
+    { "jl",     jump,   0,       12, 4, NULL },
+    { "jge",    jump,   0,       13, 4, NULL },
+    { "jle",    jump,   0,       14, 4, NULL },
+    { "jg",     jump,   0,       15, 4, NULL },
+    { "ret",    ret,    0,        0, 4, NULL },
+    { "imull",  imul,   0xf7,     5, 4, NULL },
+    { "notl",   unary,  0xf7,     2, 4, NULL },
+    { "negl",   unary,  0xf7,     3, 4, NULL },
+    { "mull",   unary,  0xf7,     4, 4, NULL },
+    { "divl",   unary,  0xf7,     6, 4, NULL },
+    { "idivl",  unary,  0xf7,     7, 4, NULL },
+    { "incl",   unary,  0xff,     0, 4, NULL },
+    { "decl",   unary,  0xff,     1, 4, NULL },
+    { "roll",   shift,  0,        0, 4, NULL },
+    { "rorl",   shift,  0,        1, 4, NULL },
+    { "shll",   shift,  0,        4, 4, NULL },
+    { "sall",   shift,  0,        4, 4, NULL },
+    { "shrl",   shift,  0,        5, 4, NULL },
+    { "sarl",   shift,  0,        7, 4, NULL },
+    { "cdq",    raw,    0x99,     0, 0, NULL },
+    { "sahf",   raw,    0x9e,     0, 0, NULL },
+    { "rep",    raw,    0xf3,     0, 0, NULL },
+    { "movsb",  raw,    0xa4,     0, 0, NULL },
+    { "fchs",   raw,    0xd9e0,   0, 0, NULL },
+    { "fcompp", raw,    0xded9,   0, 0, NULL },
+    { "fnstsw", raw,    0xdfe0,   0, 0, NULL },
+    { "fstsw",  raw,    0x9bdfe0, 0, 0, NULL },
+    { "fadds",  fmem,   0xd8,     0, 0, NULL },
+    { "faddl",  fmem,   0xdc,     0, 0, NULL },
+    { "fmuls",  fmem,   0xd8,     1, 0, NULL },
+    { "fmull",  fmem,   0xdc,     1, 0, NULL },
+    { "fcoms",  fmem,   0xd8,     2, 0, NULL },
+    { "fcoml",  fmem,   0xdc,     2, 0, NULL },
+    { "fcomps", fmem,   0xd8,     3, 0, NULL },
+    { "fcompl", fmem,   0xdc,     3, 0, NULL },
+    { "fsubs",  fmem,   0xd8,     4, 0, NULL },
+    { "fsubl",  fmem,   0xdc,     4, 0, NULL },
+    { "fsubrs", fmem,   0xd8,     5, 0, NULL },
+    { "fsubrl", fmem,   0xdc,     5, 0, NULL },
+    { "fdivs",  fmem,   0xd8,     6, 0, NULL },
+    { "fdivl",  fmem,   0xdc,     6, 0, NULL },
+    { "fdivrs", fmem,   0xd8,     7, 0, NULL },
+    { "fdivrl", fmem,   0xdc,     7, 0, NULL },
+    { "flds",   fmem,   0xd9,     0, 0, NULL },
+    { "fldl",   fmem,   0xdd,     0, 0, NULL },
+    { "fldt",   fmem,   0xdb,     5, 0, NULL },
+    { "fildl",  fmem,   0xdb,     0, 0, NULL },
+    { "fistpl", fmem,   0xdb,     3, 0, NULL },
+    { "fsts",   fmem,   0xd9,     2, 0, NULL },
+    { "fstl",   fmem,   0xdd,     2, 0, NULL },
+    { "fstps",  fmem,   0xd9,     3, 0, NULL },
+    { "fstpl",  fmem,   0xdd,     3, 0, NULL },
+    { "fstpt",  fmem,   0xdb,     7, 0, NULL },
+    { "fldcw",  fmem,   0xd9,     5, 0, NULL },
+    { "fnstcw", fmem,   0xd9,     7, 0, NULL },
+    { "fstp",   fstp,   0xdd,     3, 0, NULL },
+    { "faddp",  fpop,   0xde,  0xc0, 0, NULL },
+    { "fmulp",  fpop,   0xde,  0xc8, 0, NULL },
+    { "fsubp",  fpop,   0xde,  0xe0, 0, NULL },    /* AT&T; fsubrp in Intel */
+    { "fsubrp", fpop,   0xde,  0xe8, 0, NULL },    /* AT&T; fsubp in Intel */
+    { "fdivp",  fpop,   0xde,  0xf0, 0, NULL },    /* AT&T; fdivrp in Intel */
+    { "fdivrp", fpop,   0xde,  0xf8, 0, NULL },    /* AT&T; fdivp in Intel */
+};
+
+static int finit;                  /* true if instruction table initialized */
+static inst_t *ibucket[256];       /* hash buckets for instructions */
+static esym_t *sbucket[1024];      /* hash buckets for symbols */
+static esym_t *shead, **psym;      /* symbols in order of appearance */
+static struct sect *cur;           /* current section */
+static unsigned nlab[10];          /* counters for numeric labels */
+static char *lbuf;                 /* line buffer */
+static unsigned long lsize;        /* size of line buffer */
+
+
+/*
+ *  makes a buffer hold at least n bytes
+ */
+static void *grow(void *p, unsigned long *psize, unsigned long n)
+{
+    unsigned long size;
+
+    assert(psize);
+
+    if (n <= *psize)
+        return p;
+    for (size = (*psize)? *psize: BUFUNIT; size < n; size *= 2)
+        continue;
+    *psize = size;
+
+    return (p)? MEM_RESIZE(p, size): MEM_ALLOC(size);
+}
+
+
+/*
+ *  looks up a symbol; creates one if not found
+ */
+static esym_t *lookup(const char *name)
+{
+    unsigned h;
+    esym_t *p;
+
+    assert(name);
+
+    h = hashkey(name, NELEM(sbucket));
+    for (p = sbucket[h]; p; p = p->link)
+        if (p->name == name)
+            return p;
+
+    p = ARENA_CALLOC(strg_perm, 1, sizeof(*p));
+    p->name = name;
+    p->sec = -1;
+    p->link = sbucket[h];
+    sbucket[h] = p;
+    *psym = p;
+    psym = &p->next;
+
+    return p;
+}
+
+
+/*
+ *  returns a symbol for a numeric label;
+ *  dir is 'f' or 'b' for references, 0 for definitions
+ */
+static esym_t *numlab(int d, int dir)
+{
+    char buf[2 + 1 + 1 + (sizeof(unsigned)*CHAR_BIT+2)/3 + 1];
+    unsigned n;
+
+    assert(d >= 0 && d < NELEM(nlab));
+
+    n = nlab[d];
+    if (dir == 'b') {
+        assert(n > 0);
+        n--;
+    } else if (dir == 0)
+        nlab[d]++;
+    sprintf(buf, ".L%d\001%u", d, n);
+
+    return lookup(hash_string(buf));
+}
+
+
+/*
+ *  returns the value of a symbol
+ */
+static unsigned long value(const esym_t *p)
+{
+    assert(p);
+
+    return (p->frag)? p->frag->addr + p->off: p->off;
+}
+
+
+/*
+ *  reserves n bytes in the current section
+ */
+static unsigned char *room(unsigned long n)
+{
+    unsigned char *p;
+
+    assert(cur != &sect[SBSS]);
+
+    cur->buf = grow(cur->buf, &cur->size, cur->n + n);
+    p = cur->buf + cur->n;
+    cur->n += n;
+
+    return p;
+}
+
+
+/*
+ *  emits a byte
+ */
+static void byte(unsigned long v)
+{
+    *room(1) = v & 0xff;
+}
+
+
+/*
+ *  stores a 16-bit value in little-endian
+ */
+static void set16(unsigned char *p, unsigned long v)
+{
+    assert(p);
+
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+
+/*
+ *  stores a 32-bit value in little-endian
+ */
+static void set32(unsigned char *p, unsigned long v)
+{
+    assert(p);
+
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+
+/*
+ *  fetches a 32-bit value in little-endian
+ */
+static unsigned long get32(const unsigned char *p)
+{
+    assert(p);
+
+    return p[0] | ((unsigned long)p[1] << 8) | ((unsigned long)p[2] << 16) |
+           ((unsigned long)p[3] << 24);
+}
+
+
+/*
+ *  emits n bytes filled with c
+ */
+static void fill(int c, unsigned long n)
+{
+    if (cur == &sect[SBSS]) {
+        assert(c == 0);
+        cur->n += n;
+    } else if (n > 0)
+        memset(room(n), c, n);
+}
+
+
+/*
+ *  starts a new fragment in the current section
+ */
+static frag_t *newfrag(int kind)
+{
+    frag_t *f;
+
+    f = ARENA_CALLOC(strg_perm, 1, sizeof(*f));
+    f->kind = kind;
+    f->pos = cur->n;
+    if (cur->frag)
+        cur->frag->next = f;
+    else
+        cur->head = f;
+    cur->frag = f;
+
+    return f;
+}
+
+
+/*
+ *  records a 32-bit field to refer to a symbol;
+ *  should be invoked right before the field emitted
+ */
+static void fixup(esym_t *p, int pcrel)
+{
+    fix_t *f;
+
+    assert(p);
+
+    f = ARENA_ALLOC(strg_perm, sizeof(*f));
+    f->frag = cur->frag;
+    f->off = cur->n - cur->frag->pos;
+    f->sym = p;
+    f->pcrel = pcrel;
+    f->next = NULL;
+    *cur->pfix = f;
+    cur->pfix = &f->next;
+    p->used = 1;
+}
+
+
+/*
+ *  emits an immediate or a 32-bit displacement
+ */
+static void imm(const opd_t *o, int size)
+{
+    assert(o);
+    assert(!o->sym || size == 4);
+
+    switch(size) {
+        case 1:
+            byte(o->v);
+            break;
+        case 2:
+            set16(room(2), o->v);
+            break;
+        case 4:
+            if (o->sym)
+                fixup(o->sym, 0);
+            set32(room(4), o->v);
+            break;
+        default:
+            assert(!"invalid operand size -- should never reach here");
+            break;
+    }
+}
+
+
+/*
+ *  aligns the current section;
+ *  .align 0 is a no-op as with as
+ */
+static void align(unsigned long n)
+{
+    if (n == 0)
+        return;
+    assert((n & (n-1)) == 0);
+
+    if (n > cur->align)
+        cur->align = n;
+    if (n > 1) {
+        newfrag(FALIGN)->align = n;
+        newfrag(FFIXED);
+    }
+}
+
+
+/*
+ *  defines a label at the current location
+ */
+static void label(esym_t *p)
+{
+    assert(p);
+    assert(p->sec == -1);
+
+    p->sec = cur - sect;
+    p->frag = cur->frag;
+    p->off = cur->n - cur->frag->pos;
+}
+
+
+/*
+ *  parses a number
+ */
+static const char *number(const char *s, unsigned long *pv)
+{
+    char *p;
+
+    assert(s);
+    assert(pv);
+
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+        *pv = strtoul(s+2, &p, 16);
+    else
+        *pv = strtoul(s, &p, 10);
+
+    return p;
+}
+
+
+/*
+ *  parses an expression with at most one symbol added and one subtracted
+ */
+static const char *expr(const char *s, expr_t *e)
+{
+    int neg = 0;
+    const char *t;
+    unsigned long v;
+    esym_t *p;
+
+    assert(s);
+    assert(e);
+
+    e->sym = e->sub = NULL;
+    e->v = 0;
+    if (*s == '-' || *s == '+')
+        neg = (*s++ == '-');
+    while (1) {
+        p = NULL;
+        if (isdigit((unsigned char)*s)) {
+            t = number(s, &v);
+            if ((*t == 'f' || *t == 'b') && !ISID(t[1]) && t - s == 1) {
+                p = numlab(*s - '0', *t);
+                t++;
+            }
+            s = t;
+        } else {
+            assert(ISID1(*s));
+            for (t = s; ISID(*t); t++)
+                continue;
+            p = lookup(hash_new(s, t-s));
+            s = t;
+        }
+        if (p && neg) {
+            assert(!e->sub);
+            e->sub = p;
+        } else if (p) {
+            assert(!e->sym);
+            e->sym = p;
+        } else
+            e->v = (neg)? e->v - v: e->v + v;
+        if (*s != '+' && *s != '-')
+            break;
+        neg = (*s++ == '-');
+    }
+    e->v = M32(e->v);
+
+    return s;
+}
+
+
+/*
+ *  parses a register name
+ */
+static const char *reg(const char *s, opd_t *o)
+{
+    static const char r16[] = "axcxdxbxspbpsidi",
+                      r8[] = "alcldlblahchdhbh";
+
+    int i;
+
+    assert(s);
+    assert(o);
+
+    if (s[0] == 's' && s[1] == 't') {
+        o->kind = OST;
+        o->reg = 0;
+        s += 2;
+        if (*s == '(') {
+            assert(isdigit((unsigned char)s[1]) && s[2] == ')');
+            o->reg = s[1] - '0';
+            s += 3;
+        }
+        return s;
+    }
+
+    o->kind = OREG;
+    o->size = 2;
+    if (*s == 'e') {
+        o->size = 4;
+        s++;
+    }
+    for (i = 0; i < 8; i++)
+        if (s[0] == r16[2*i] && s[1] == r16[2*i+1]) {
+            o->reg = i;
+            return s + 2;
+        }
+    assert(o->size == 2);
+    o->size = 1;
+    for (i = 0; i < 8; i++)
+        if (s[0] == r8[2*i] && s[1] == r8[2*i+1]) {
+            o->reg = i;
+            return s + 2;
+        }
+
+    assert(!"invalid register -- should never reach here");
+    return s;
+}
+
+
+/*
+ *  parses an operand
+ */
+static const char *operand(const char *s, opd_t *o)
+{
+    expr_t e;
+    opd_t r;
+
+    assert(s);
+    assert(o);
+
+    o->ind = 0;
+    o->sym = NULL;
+    o->v = 0;
+    o->base = o->index = -1;
+    o->scale = 1;
+
+    if (*s == '*') {
+        o->ind = 1;
+        s++;
+    }
+    if (*s == '%')
+        return reg(s+1, o);
+    if (*s == '$') {
+        s = expr(s+1, &e);
+        assert(!e.sub);
+        o->kind = OIMM;
+        o->sym = e.sym;
+        o->v = e.v;
+        return s;
+    }
+
+    o->kind = OMEM;
+    if (*s != '(') {
+        s = expr(s, &e);
+        assert(!e.sub);
+        o->sym = e.sym;
+        o->v = e.v;
+    }
+    if (*s == '(') {
+        if (*++s == '%') {
+            s = reg(s+1, &r);
+            assert(r.kind == OREG && r.size == 4);
+            o->base = r.reg;
+        }
+        if (*s == ',') {
+            assert(s[1] == '%');
+            s = reg(s+2, &r);
+            assert(r.kind == OREG && r.size == 4 && r.reg != ESP);
+            o->index = r.reg;
+            if (*s == ',') {
+                o->scale = s[1] - '0';
+                s += 2;
+            }
+        }
+        assert(*s == ')');
+        s++;
+    }
+
+    return s;
+}
+
+
+/*
+ *  emits a ModR/M byte with a SIB byte and a displacement if necessary
+ */
+static void modrm(int r, const opd_t *o)
+{
+    int mod;
+
+    assert(r >= 0 && r < 8);
+    assert(o);
+
+    if (o->kind == OREG) {
+        byte(0xc0 | (r << 3) | o->reg);
+        return;
+    }
+    assert(o->kind == OMEM);
+
+    if (o->base < 0 && o->index < 0) {
+        byte(0x05 | (r << 3));
+        imm(o, 4);
+        return;
+    }
+
+    if (o->base < 0 || o->sym || !FITS8(o->v))
+        mod = (o->base < 0)? 0: 2;
+    else if (o->v == 0 && o->base != EBP)
+        mod = 0;
+    else
+        mod = 1;
+
+    if (o->index < 0 && o->base != ESP)
+        byte((mod << 6) | (r << 3) | o->base);
+    else {
+        byte((mod << 6) | (r << 3) | 4);
+        byte((((o->scale == 8)? 3: o->scale >> 1) << 6) | (((o->index < 0)? 4: o->index) << 3) |
+             ((o->base < 0)? 5: o->base));
+    }
+    if (mod == 1)
+        byte(o->v);
+    else if (mod == 2 || o->base < 0)
+        imm(o, 4);
+}
+
+
+/*
+ *  determines the operand size of an instruction
+ */
+static int opsize(const inst_t *ip, const opd_t o[], int n)
+{
+    int i;
+
+    assert(ip);
+    assert(o);
+
+    if (ip->size > 0)
+        return ip->size;
+    for (i = 0; i < n; i++)
+        if (o[i].kind == OREG)
+            return o[i].size;
+
+    assert(!"operand size unknown -- should never reach here");
+    return 4;
+}
+
+
+/*
+ *  checks if an immediate fits in signed 8 bits for an operand size
+ */
+static int fits8(const opd_t *o, int size)
+{
+    assert(o);
+
+    if (o->sym)
+        return 0;
+    return (size == 2)? ((o->v + 0x80) & 0xffff) < 0x100: FITS8(o->v);
+}
+
+
+/*
+ *  encodes add, or, adc, sbb, and, sub, xor and cmp
+ */
+static void alu(const inst_t *ip, opd_t o[], int n)
+{
+    int k, size;
+
+    assert(ip);
+    assert(o);
+    assert(n == 2);
+
+    k = ip->op;
+    size = opsize(ip, o, n);
+    if (size == 2)
+        byte(0x66);
+    if (o[0].kind == OIMM) {
+        if (size == 1) {
+            if (o[1].kind == OREG && o[1].reg == EAX)
+                byte(k*8 + 4);
+            else {
+                byte(0x80);
+                modrm(k, &o[1]);
+            }
+        } else if (fits8(&o[0], size)) {
+            byte(0x83);
+            modrm(k, &o[1]);
+            size = 1;
+        } else if (o[1].kind == OREG && o[1].reg == EAX)
+            byte(k*8 + 5);
+        else {
+            byte(0x81);
+            modrm(k, &o[1]);
+        }
+        imm(&o[0], size);
+    } else if (o[0].kind == OREG) {
+        byte(k*8 + (size > 1));
+        modrm(o[0].reg, &o[1]);
+    } else {
+        assert(o[1].kind == OREG);
+        byte(k*8 + 2 + (size > 1));
+        modrm(o[1].reg, &o[0]);
+    }
+}
+
+
+/*
+ *  checks if an operand is an absolute address
+ */
+static int absolute(const opd_t *o)
+{
+    assert(o);
+
+    return (o->kind == OMEM && o->base < 0 && o->index < 0);
+}
+
+
+/*
+ *  encodes mov
+ */
+static void mov(const inst_t *ip, opd_t o[], int n)
+{
+    int size;
+
+    assert(ip);
+    assert(o);
+    assert(n == 2);
+
+    size = opsize(ip, o, n);
+    if (size == 2)
+        byte(0x66);
+    if (o[0].kind == OIMM) {
+        if (o[1].kind == OREG)
+            byte(((size == 1)? 0xb0: 0xb8) + o[1].reg);
+        else {
+            byte((size == 1)? 0xc6: 0xc7);
+            modrm(0, &o[1]);
+        }
+        imm(&o[0], size);
+    } else if (o[0].kind == OREG) {
+        if (o[0].reg == EAX && absolute(&o[1])) {
+            byte((size == 1)? 0xa2: 0xa3);
+            imm(&o[1], 4);
+        } else {
+            byte((size == 1)? 0x88: 0x89);
+            modrm(o[0].reg, &o[1]);
+        }
+    } else {
+        assert(o[1].kind == OREG);
+        if (o[1].reg == EAX && absolute(&o[0])) {
+            byte((size == 1)? 0xa0: 0xa1);
+            imm(&o[0], 4);
+        } else {
+            byte((size == 1)? 0x8a: 0x8b);
+            modrm(o[1].reg, &o[0]);
+        }
+    }
+}
+
+
+/*
+ *  encodes movsx and movzx
+ */
+static void movx(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 2 && o[1].kind == OREG);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    byte(0x0f);
+    byte(ip->op);
+    modrm(o[1].reg, &o[0]);
+}
+
+
+/*
+ *  encodes lea
+ */
+static void lea(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 2 && o[0].kind == OMEM && o[1].kind == OREG);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    byte(ip->op);
+    modrm(o[1].reg, &o[0]);
+}
+
+
+/*
+ *  encodes push
+ */
+static void push(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(ip);
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    switch(o[0].kind) {
+        case OREG:
+            byte(0x50 + o[0].reg);
+            break;
+        case OIMM:
+            if (fits8(&o[0], 4)) {
+                byte(0x6a);
+                byte(o[0].v);
+            } else {
+                byte(0x68);
+                imm(&o[0], 4);
+            }
+            break;
+        default:
+            byte(0xff);
+            modrm(6, &o[0]);
+            break;
+    }
+}
+
+
+/*
+ *  encodes pop
+ */
+static void pop(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(ip);
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    if (o[0].kind == OREG)
+        byte(0x58 + o[0].reg);
+    else {
+        byte(0x8f);
+        modrm(0, &o[0]);
+    }
+}
+
+
+/*
+ *  encodes call
+ */
+static void call(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(ip);
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    if (o[0].ind) {
+        byte(0xff);
+        modrm(2, &o[0]);
+    } else {
+        assert(absolute(&o[0]) && o[0].sym);
+        byte(0xe8);
+        fixup(o[0].sym, 1);
+        set32(room(4), o[0].v - 4);
+    }
+}
+
+
+/*
+ *  encodes jmp and jcc;
+ *  direct jumps left to layout()
+ */
+static void jump(const inst_t *ip, opd_t o[], int n)
+{
+    frag_t *f;
+
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    if (o[0].ind) {
+        assert(ip->ext < 0);
+        byte(0xff);
+        modrm(4, &o[0]);
+    } else {
+        assert(absolute(&o[0]) && o[0].sym && o[0].v == 0);
+        f = newfrag(FJUMP);
+        f->cc = ip->ext;
+        f->target = o[0].sym;
+        o[0].sym->used = 1;
+        newfrag(FFIXED);
+    }
+}
+
+
+/*
+ *  encodes ret
+ */
+static void ret(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+#ifdef NDEBUG
+    UNUSED(ip);
+#endif    /* NDEBUG */
+
+    if (n == 0)
+        byte(0xc3);
+    else {
+        assert(n == 1 && o[0].kind == OIMM);
+        byte(0xc2);
+        imm(&o[0], 2);
+    }
+}
+
+
+/*
+ *  encodes imul
+ */
+static void imul(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+
+    switch(n) {
+        case 1:
+            unary(ip, o, n);
+            break;
+        case 2:
+            assert(o[1].kind == OREG);
+            if (o[0].kind == OIMM) {    /* imull $imm, %reg */
+                o[2] = o[1];
+                imul(ip, o, 3);
+                break;
+            }
+            byte(0x0f);
+            byte(0xaf);
+            modrm(o[1].reg, &o[0]);
+            break;
+        case 3:
+            assert(o[0].kind == OIMM && o[2].kind == OREG);
+            byte((fits8(&o[0], 4))? 0x6b: 0x69);
+            modrm(o[2].reg, &o[1]);
+            imm(&o[0], (fits8(&o[0], 4))? 1: 4);
+            break;
+        default:
+            assert(!"invalid number of operands -- should never reach here");
+            break;
+    }
+}
+
+
+/*
+ *  encodes instructions taking one operand in ModR/M
+ */
+static void unary(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    if (ip->op == 0xff && o[0].kind == OREG)    /* inc/dec */
+        byte(0x40 + 8*ip->ext + o[0].reg);
+    else {
+        byte(ip->op);
+        modrm(ip->ext, &o[0]);
+    }
+}
+
+
+/*
+ *  encodes shifts and rotations
+ */
+static void shift(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1 || n == 2);
+
+    if (n == 1 || (o[0].kind == OIMM && !o[0].sym && o[0].v == 1)) {
+        byte(0xd1);
+        modrm(ip->ext, &o[n-1]);
+    } else if (o[0].kind == OIMM) {
+        byte(0xc1);
+        modrm(ip->ext, &o[1]);
+        imm(&o[0], 1);
+    } else {
+        assert(o[0].kind == OREG && o[0].reg == ECX && o[0].size == 1);
+        byte(0xd3);
+        modrm(ip->ext, &o[1]);
+    }
+}
+
+
+/*
+ *  encodes instructions with fixed bytes
+ */
+static void raw(const inst_t *ip, opd_t o[], int n)
+{
+    int i;
+
+    assert(ip);
+    assert(o);
+    assert(n == 0 || (n == 1 && o[0].kind == OREG && o[0].reg == EAX && o[0].size == 2));
+#ifdef NDEBUG
+    UNUSED(o);
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    for (i = 24; i > 0; i -= 8)
+        if (ip->op >> i)
+            byte(ip->op >> i);
+    byte(ip->op);
+}
+
+
+/*
+ *  encodes floating-point instructions with memory operands
+ */
+static void fmem(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1 && o[0].kind == OMEM);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    byte(ip->op);
+    modrm(ip->ext, &o[0]);
+}
+
+
+/*
+ *  encodes fstp
+ */
+static void fstp(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 1);
+#ifdef NDEBUG
+    UNUSED(n);
+#endif    /* NDEBUG */
+
+    byte(ip->op);
+    if (o[0].kind == OST)
+        byte(0xd8 + o[0].reg);
+    else
+        modrm(ip->ext, &o[0]);
+}
+
+
+/*
+ *  encodes floating-point instructions popping the stack
+ */
+static void fpop(const inst_t *ip, opd_t o[], int n)
+{
+    assert(ip);
+    assert(o);
+    assert(n == 0 || o[n-1].kind == OST);
+
+    byte(ip->op);
+    byte(ip->ext + ((n == 0)? 1: o[n-1].reg));
+}
+
+
+/*
+ *  handles an instruction
+ */
+static void inst(const char *s)
+{
+    opd_t o[3];
+    int n;
+    const char *t, *name;
+    inst_t *ip;
+
+    assert(s);
+
+    for (t = s; *t && !isspace((unsigned char)*t); t++)
+        continue;
+    name = hash_new(s, t-s);
+    for (ip = ibucket[hashkey(name, NELEM(ibucket))]; ip; ip = ip->link)
+        if (ip->name == name)
+            break;
+    assert(ip);
+
+    s = t;
+    SKIPWS(s);
+    for (n = 0; *s; n++) {
+        assert(n < NELEM(o));
+        s = operand(s, &o[n]);
+        SKIPWS(s);
+        if (*s == ',') {
+            s++;
+            SKIPWS(s);
+        } else
+            assert(*s == '\0');
+    }
+
+    ip->f(ip, o, n);
+}
+
+
+/*
+ *  parses a symbol name
+ */
+static esym_t *name(const char **ps)
+{
+    const char *s, *t;
+
+    assert(ps);
+    assert(*ps);
+
+    s = *ps;
+    SKIPWS(s);
+    assert(ISID1(*s));
+    for (t = s; ISID(*t); t++)
+        continue;
+    *ps = t;
+
+    return lookup(hash_new(s, t-s));
+}
+
+
+/*
+ *  skips a comma in directive arguments
+ */
+static const char *comma(const char *s)
+{
+    assert(s);
+
+    SKIPWS(s);
+    assert(*s == ',');
+    s++;
+    SKIPWS(s);
+
+    return s;
+}
+
+
+/*
+ *  returns the alignment gas gives to a common symbol
+ */
+static unsigned long comalign(unsigned long size)
+{
+    unsigned long n;
+
+    for (n = 1; n < size && n < 16; n *= 2)
+        continue;
+
+    return n;
+}
+
+
+/*
+ *  returns the alignment gas gives to a local common symbol
+ */
+static unsigned long lcomalign(unsigned long size)
+{
+    return (size >= 8)? 8: (size >= 4)? 4: (size >= 2)? 2: 1;
+}
+
+
+/*
+ *  emits data of a directive
+ */
+static void data(const char *s, int size)
+{
+    expr_t e;
+    opd_t o;
+
+    assert(s);
+
+    while (1) {
+        s = expr(s, &e);
+        assert(!e.sub);
+        o.sym = e.sym;
+        o.v = e.v;
+        imm(&o, size);
+        SKIPWS(s);
+        if (*s != ',')
+            break;
+        s++;
+        SKIPWS(s);
+    }
+    assert(*s == '\0');
+}
+
+
+/*
+ *  handles a directive
+ */
+static void directive(const char *s)
+{
+    const char *t;
+    size_t len;
+    unsigned long v;
+    esym_t *p;
+    expr_t e;
+    struct sect *save;
+
+    assert(s);
+
+    for (t = s; *t && !isspace((unsigned char)*t); t++)
+        continue;
+    len = t - s;
+    SKIPWS(t);
+
+#define is(d) (len == sizeof(d)-1 && strncmp(s, d, len) == 0)
+    if (is(".byte"))
+        data(t, 1);
+    else if (is(".long"))
+        data(t, 4);
+    else if (is(".word"))
+        data(t, 2);
+    else if (is(".space")) {
+        number(t, &v);
+        fill(0, v);
+    } else if (is(".align")) {
+        number(t, &v);
+        if (cur == &sect[SBSS]) {    /* as does not pad .lcomm with .align */
+            if (v > cur->align)
+                cur->align = v;
+        } else
+            align(v);
+    } else if (is(".text"))
+        cur = &sect[STEXT];
+    else if (is(".data"))
+        cur = &sect[SDATA];
+    else if (is(".bss"))
+        cur = &sect[SBSS];
+    else if (is(".globl"))
+        name(&t)->global = 1;
+    else if (is(".type")) {
+        p = name(&t);
+        t = comma(t);
+        assert(*t == '@');
+        p->type = (strcmp(t+1, "function") == 0)? STT_FUNC: STT_OBJECT;
+    } else if (is(".size")) {
+        p = name(&t);
+        expr(comma(t), &e);
+        if (e.sym) {
+            assert(e.sub == p && e.v == 0);
+            p->end = e.sym;
+        } else
+            p->size = e.v;
+    } else if (is(".comm")) {
+        p = name(&t);
+        number(comma(t), &v);
+        assert(p->sec == -1);
+        p->sec = SCOMMON;
+        p->global = 1;
+        p->size = v;
+        p->off = comalign(v);
+    } else if (is(".lcomm")) {
+        p = name(&t);
+        number(comma(t), &v);
+        save = cur;
+        cur = &sect[SBSS];
+        align(lcomalign(v));
+        label(p);
+        fill(0, v);
+        p->size = v;
+        cur = save;
+    } else if (is(".ident")) {
+        assert(*t == '"');
+        save = cur;
+        cur = &sect[SCOMMENT];
+        if (cur->n == 0)
+            byte(0);
+        for (t++; *t && *t != '"'; t++)
+            byte(*t);
+        byte(0);
+        cur = save;
+    } else
+        assert(!"unknown directive -- should never reach here");
+#undef is
+}
+
+
+/*
+ *  reads a line; returns NULL on EOF
+ */
+static char *readline(FILE *fp)
+{
+    int c;
+    unsigned long n = 0;
+
+    assert(fp);
+
+    while ((c = getc(fp)) != EOF && c != '\n') {
+        lbuf = grow(lbuf, &lsize, n+2);
+        lbuf[n++] = c;
+    }
+    if (c == EOF && n == 0)
+        return NULL;
+    lbuf = grow(lbuf, &lsize, n+1);
+    while (n > 0 && isspace((unsigned char)lbuf[n-1]))
+        n--;
+    lbuf[n] = '\0';
+
+    return lbuf;
+}
+
+
+/*
+ *  checks if a symbol is local and defined in a section
+ */
+static int near(const esym_t *p, const struct sect *s)
+{
+    assert(p);
+    assert(s);
+
+    return (LOCAL(p) && p->sec == s - sect);
+}
+
+
+/*
+ *  determines addresses of fragments in a section;
+ *  jumps start short and grow until all fit
+ */
+static void layout(struct sect *s)
+{
+    int again;
+    frag_t *f;
+    unsigned long addr;
+
+    assert(s);
+
+    for (f = s->head; f; f = f->next)
+        if (f->kind == FFIXED)
+            f->size = ((f->next)? f->next->pos: s->n) - f->pos;
+        else if (f->kind == FJUMP)
+            f->big = !near(f->target, s);
+
+    do {
+        for (addr = 0, f = s->head; f; f = f->next) {
+            f->addr = addr;
+            if (f->kind == FALIGN)
+                f->size = (f->align - (addr & (f->align-1))) & (f->align-1);
+            else if (f->kind == FJUMP)
+                f->size = (!f->big)? 2: (f->cc < 0)? 5: 6;
+            addr += f->size;
+        }
+        again = 0;
+        for (f = s->head; f; f = f->next)
+            if (f->kind == FJUMP && !f->big && !FITS8(value(f->target) - (f->addr+2)))
+                f->big = again = 1;
+    } while(again);
+
+    s->lc = addr;
+}
+
+
+/*
+ *  adds a relocation entry to a section
+ */
+static void addrel(struct sect *s, unsigned long off, unsigned long sym, int type)
+{
+    assert(s);
+
+    s->rel = grow(s->rel, &s->relsize, (s->nrel+1) * RELSIZE);
+    set32(s->rel + s->nrel*RELSIZE, off);
+    set32(s->rel + s->nrel*RELSIZE + 4, (sym << 8) | type);
+    s->nrel++;
+}
+
+
+/*
+ *  resolves a 32-bit field referring to a symbol;
+ *  the field holds an addend
+ */
+static void resolve(struct sect *s, unsigned long at, const esym_t *p, int pcrel)
+{
+    unsigned long v;
+
+    assert(s);
+    assert(p);
+    assert(p->sec != -1 || !LOCALNAME(p->name));    /* undefined local label */
+
+    v = get32(s->img + at);
+    if (pcrel && near(p, s))
+        v += value(p) - at;
+    else if (LOCAL(p)) {
+        v += value(p);
+        addrel(s, at, 1 + p->sec, (pcrel)? R_386_PC32: R_386_32);
+    } else
+        addrel(s, at, p->idx, (pcrel)? R_386_PC32: R_386_32);
+    set32(s->img + at, v);
+}
+
+
+/*
+ *  constructs the final contents of a section
+ */
+static void image(struct sect *s)
+{
+    frag_t *f;
+    fix_t *x;
+    unsigned char *p;
+
+    assert(s);
+
+    s->img = MEM_ALLOC(s->lc + 1);
+    for (f = s->head; f; f = f->next) {
+        p = s->img + f->addr;
+        switch(f->kind) {
+            case FFIXED:
+                if (f->size > 0)
+                    memcpy(p, s->buf + f->pos, f->size);
+                break;
+            case FALIGN:
+                memset(p, (s == &sect[STEXT])? 0x90: 0, f->size);
+                break;
+            case FJUMP:
+                if (!f->big) {
+                    p[0] = (f->cc < 0)? 0xeb: 0x70 + f->cc;
+                    p[1] = (value(f->target) - (f->addr+2)) & 0xff;
+                } else {
+                    if (f->cc < 0)
+                        *p++ = 0xe9;
+                    else {
+                        *p++ = 0x0f;
+                        *p++ = 0x80 + f->cc;
+                    }
+                    set32(p, M32(-4UL));
+                    resolve(s, p - s->img, f->target, 1);
+                }
+                break;
+            default:
+                assert(!"invalid fragment -- should never reach here");
+                break;
+        }
+    }
+    for (x = s->fix; x; x = x->next)
+        resolve(s, x->frag->addr + x->off, x->sym, x->pcrel);
+}
+
+
+/*
+ *  assigns indices to symbols;
+ *  returns the number of local symbols including null and section symbols
+ */
+static unsigned long symindex(unsigned long *pn, unsigned long *pstr)
+{
+    unsigned long n, nlocal;
+    esym_t *p;
+
+    assert(pn);
+    assert(pstr);
+
+    n = 1 + SBSS+1;    /* null and section symbols */
+    *pstr = 1;
+    for (p = shead; p; p = p->next)
+        if (!LOCALNAME(p->name) && LOCAL(p)) {
+            p->idx = n++;
+            p->sname = *pstr;
+            *pstr += strlen(p->name) + 1;
+        }
+    nlocal = n;
+    for (p = shead; p; p = p->next)
+        if (!LOCALNAME(p->name) && !LOCAL(p) && (p->global || p->used)) {
+            p->idx = n++;
+            p->sname = *pstr;
+            *pstr += strlen(p->name) + 1;
+        }
+    *pn = n;
+
+    return nlocal;
+}
+
+
+/*
+ *  writes bytes
+ */
+static void put(FILE *fp, const void *p, unsigned long n)
+{
+    assert(fp);
+    assert(p || n == 0);
+
+    if (n > 0)
+        fwrite(p, 1, n, fp);
+}
+
+
+/*
+ *  writes a 16-bit value
+ */
+static void put16(FILE *fp, unsigned long v)
+{
+    unsigned char b[2];
+
+    set16(b, v);
+    put(fp, b, 2);
+}
+
+
+/*
+ *  writes a 32-bit value
+ */
+static void put32(FILE *fp, unsigned long v)
+{
+    unsigned char b[4];
+
+    set32(b, v);
+    put(fp, b, 4);
+}
+
+
+/*
+ *  pads the output up to an offset
+ */
+static void padto(FILE *fp, unsigned long *ppos, unsigned long off)
+{
+    assert(fp);
+    assert(ppos);
+    assert(*ppos <= off);
+
+    for (; *ppos < off; (*ppos)++)
+        putc(0, fp);
+}
+
+
+/*
+ *  writes the object file
+ */
+static void output(FILE *fp, unsigned long nsym, unsigned long nlocal, unsigned long strsize)
+{
+    static const char *shname[HMAX] = {
+        "", ".text", ".rel.text", ".data", ".rel.data", ".bss", ".comment", ".symtab",
+        ".strtab", ".shstrtab"
+    };
+    static const int relof[HMAX] = { -1, -1, STEXT, -1, SDATA, -1, -1, -1, -1, -1 };
+    static const int secof[HMAX] = { -1, STEXT, -1, SDATA, -1, SBSS, SCOMMENT, -1, -1, -1 };
+
+    int i;
+    esym_t *p;
+    struct sect *s;
+    unsigned long off, pos, shstrsize, shoff, symoff, stroff, shstroff, name[HMAX];
+
+    assert(fp);
+
+    for (shstrsize = 0, i = 0; i < HMAX; i++) {
+        name[i] = shstrsize;
+        shstrsize += strlen(shname[i]) + 1;
+    }
+
+    /* computes layout of file */
+    off = EHSIZE;
+    for (s = sect; s < sect+SMAX; s++) {
+        off = ROUNDUP(off, s->align);
+        s->offset = off;
+        if (s != &sect[SBSS])
+            off += s->lc;
+    }
+    for (i = STEXT; i <= SDATA; i++) {
+        off = ROUNDUP(off, 4);
+        sect[i].reloff = off;
+        off += sect[i].nrel * RELSIZE;
+    }
+    symoff = off = ROUNDUP(off, 4);
+    off += nsym * SYMSIZE;
+    stroff = off;
+    off += strsize;
+    shstroff = off;
+    off += shstrsize;
+    shoff = ROUNDUP(off, 4);
+
+    /* ELF header */
+    put(fp, "\177ELF\1\1\1\0\0\0\0\0\0\0\0\0", 16);
+    put16(fp, 1);             /* ET_REL */
+    put16(fp, 3);             /* EM_386 */
+    put32(fp, 1);             /* EV_CURRENT */
+    put32(fp, 0);             /* entry */
+    put32(fp, 0);             /* program header offset */
+    put32(fp, shoff);
+    put32(fp, 0);             /* flags */
+    put16(fp, EHSIZE);
+    put16(fp, 0);             /* program header entry size */
+    put16(fp, 0);             /* # of program headers */
+    put16(fp, SHSIZE);
+    put16(fp, HMAX);
+    put16(fp, HSHSTRTAB);
+    pos = EHSIZE;
+
+    /* section contents */
+    for (s = sect; s < sect+SMAX; s++)
+        if (s != &sect[SBSS]) {
+            padto(fp, &pos, s->offset);
+            put(fp, s->img, s->lc);
+            pos += s->lc;
+        }
+    for (i = STEXT; i <= SDATA; i++) {
+        padto(fp, &pos, sect[i].reloff);
+        put(fp, sect[i].rel, sect[i].nrel * RELSIZE);
+        pos += sect[i].nrel * RELSIZE;
+    }
+
+    /* symbol table */
+    padto(fp, &pos, symoff);
+    for (i = 0; i < SYMSIZE; i++)
+        putc(0, fp);
+    for (i = STEXT; i <= SBSS; i++) {
+        put32(fp, 0);
+        put32(fp, 0);
+        put32(fp, 0);
+        putc((STB_LOCAL << 4) | STT_SECTION, fp);
+        putc(0, fp);
+        put16(fp, shndx[i]);
+    }
+    for (i = 0; i < 2; i++)    /* locals first */
+        for (p = shead; p; p = p->next)
+            if (p->idx > 0 && (p->idx < nlocal) == (i == 0)) {
+                put32(fp, p->sname);
+                put32(fp, value(p));
+                put32(fp, p->size);
+                putc((((p->idx < nlocal)? STB_LOCAL: STB_GLOBAL) << 4) | p->type, fp);
+                putc(0, fp);
+                put16(fp, (p->sec == SCOMMON)? SHN_COMMON: (p->sec == -1)? 0: shndx[p->sec]);
+            }
+    pos += nsym * SYMSIZE;
+
+    /* string tables */
+    putc(0, fp);
+    for (i = 0; i < 2; i++)
+        for (p = shead; p; p = p->next)
+            if (p->idx > 0 && (p->idx < nlocal) == (i == 0))
+                put(fp, p->name, strlen(p->name) + 1);
+    for (i = 0; i < HMAX; i++)
+        put(fp, shname[i], strlen(shname[i]) + 1);
+    pos += strsize + shstrsize;
+
+    /* section headers */
+    padto(fp, &pos, shoff);
+    for (i = 0; i < HMAX; i++) {
+        unsigned long type = 0, flags = 0, offset = 0, size = 0, link = 0, info = 0, align = 0,
+                      entsize = 0;
+
+        if (secof[i] >= 0) {
+            s = &sect[secof[i]];
+            type = (i == HBSS)? SHT_NOBITS: SHT_PROGBITS;
+            flags = (i == HTEXT)? SHF_ALLOC | SHF_EXECINSTR:
+                    (i == HCOMMENT)? SHF_MERGE | SHF_STRINGS: SHF_WRITE | SHF_ALLOC;
+            offset = s->offset;
+            size = s->lc;
+            align = s->align;
+            entsize = (i == HCOMMENT);
+        } else if (relof[i] >= 0) {
+            s = &sect[relof[i]];
+            type = SHT_REL;
+            flags = SHF_INFO_LINK;
+            offset = s->reloff;
+            size = s->nrel * RELSIZE;
+            link = HSYMTAB;
+            info = shndx[relof[i]];
+            align = 4;
+            entsize = RELSIZE;
+        } else if (i == HSYMTAB) {
+            type = SHT_SYMTAB;
+            offset = symoff;
+            size = nsym * SYMSIZE;
+            link = HSTRTAB;
+            info = nlocal;
+            align = 4;
+            entsize = SYMSIZE;
+        } else if (i != HNULL) {
+            type = SHT_STRTAB;
+            offset = (i == HSTRTAB)? stroff: shstroff;
+            size = (i == HSTRTAB)? strsize: shstrsize;
+            align = 1;
+        }
+        put32(fp, name[i]);
+        put32(fp, type);
+        put32(fp, flags);
+        put32(fp, 0);    /* address */
+        put32(fp, offset);
+        put32(fp, size);
+        put32(fp, link);
+        put32(fp, info);
+        put32(fp, align);
+        put32(fp, entsize);
+    }
+}
+
+
+/*
+ *  assembles x86 assembly from the back-end into an ELF relocatable object;
+ *  accepts only what the x86-linux back-end emits
+ */
+void (elf_asm)(FILE *in, FILE *out)
+{
+    int i;
+    char *s;
+    esym_t *p;
+    struct sect *t;
+    unsigned long nsym, nlocal, strsize;
+
+    assert(in);
+    assert(out);
+
+    if (!finit) {
+        for (i = 0; i < NELEM(itab); i++) {
+            unsigned h;
+
+            itab[i].name = hash_string(itab[i].name);
+            h = hashkey(itab[i].name, NELEM(ibucket));
+            itab[i].link = ibucket[h];
+            ibucket[h] = &itab[i];
+        }
+        finit = 1;
+    }
+    memset(sect, 0, sizeof(sect));
+    memset(sbucket, 0, sizeof(sbucket));
+    memset(nlab, 0, sizeof(nlab));
+    shead = NULL;
+    psym = &shead;
+    for (t = sect; t < sect+SMAX; t++) {
+        t->align = 1;
+        t->pfix = &t->fix;
+        cur = t;
+        newfrag(FFIXED);
+    }
+    cur = &sect[STEXT];
+
+    while ((s = readline(in)) != NULL) {
+        SKIPWS(s);
+        if (*s == '\0' || *s == '#')
+            continue;
+        if (s[strlen(s)-1] == ':') {
+            s[strlen(s)-1] = '\0';
+            if (isdigit((unsigned char)*s)) {
+                assert(s[1] == '\0');
+                label(numlab(*s - '0', 0));
+            } else
+                label(lookup(hash_string(s)));
+        } else if (*s == '.')
+            directive(s);
+        else
+            inst(s);
+    }
+
+    for (t = sect; t < sect+SMAX; t++)
+        layout(t);
+    for (p = shead; p; p = p->next)
+        if (p->end) {
+            assert(p->end->sec == p->sec);
+            p->size = value(p->end) - value(p);
+        }
+    nlocal = symindex(&nsym, &strsize);
+    for (t = sect; t < sect+SMAX; t++)
+        if (t != &sect[SBSS])
+            image(t);
+    output(out, nsym, nlocal, strsize);
+
+    for (t = sect; t < sect+SMAX; t++) {
+        if (t->buf)
+            MEM_FREE(t->buf);
+        if (t->img)
+            MEM_FREE(t->img);
+        if (t->rel)
+            MEM_FREE(t->rel);
+    }
+    if (lbuf)
+        MEM_FREE(lbuf);
+}
+
+/* end of elf.c */
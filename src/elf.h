@@ -0,0 +1,16 @@
+/*
+ *  ELF object writer for x86-linux
+ */
+
+#ifndef ELF_H
+#define ELF_H
+
+#include <stdio.h>    /* FILE */
+
+
+void elf_asm(FILE *, FILE *);
+
+
+#endif    /* ELF_H */
+
+/* end of elf.h */
@@ -0,0 +1,1542 @@
+/*
+ *  flow graph and optimization passes
+ */
+
+#include <limits.h>       /* INT_MAX */
+#include <stddef.h>       /* NULL */
+#include <stdio.h>        /* fprintf, stderr */
+#include <time.h>         /* clock_t, clock, CLOCKS_PER_SEC */
+#include <cbl/arena.h>    /* ARENA_ALLOC, ARENA_CALLOC */
+#include <cbl/assert.h>   /* assert */
+
+#include "common.h"
+#include "dag.h"
+#include "ir.h"
+#include "lex.h"
+#include "main.h"
+#include "op.h"
+#include "stmt.h"
+#include "strg.h"
+#include "sym.h"
+#include "ty.h"
+#include "flow.h"
+
+/* checks if code list entry generates code or defines label */
+#define CODE(cp) ((cp)->kind == STMT_LABEL || (cp)->kind >= STMT_GEN)
+
+/* checks if code list entry opens or closes scope or declares local */
+#define SCOPE(cp) ((cp)->kind == STMT_BLOCKBEG || (cp)->kind == STMT_BLOCKEND || \
+                   (cp)->kind == STMT_LOCAL)
+
+#define MAXTMP   4       /* max # of temporaries introduced for loop */
+#define LOOPCNST 4096    /* max magnitude of constants for strength reduction */
+
+
+/* basic block */
+struct blk {
+    stmt_t *first, *last;    /* first and last code entries */
+    int fall;                /* true if control falls into next block */
+    int scope, escope;       /* # of scope entries before first and last entries */
+    int mark;                /* marks block as visited or touched */
+};
+
+/* optimization pass */
+struct pass {
+    const char *name;    /* pass name */
+    int level;           /* minimum optimization level */
+    int (*run)(void);    /* performs pass; returns # of changes */
+    clock_t time;        /* time spent */
+    long nchange;        /* # of changes made */
+};
+
+/* loop with single entry */
+struct loop {
+    struct blk *head, *tail;    /* first and last blocks */
+    stmt_t *pre;                /* entry before which preheader goes */
+    stmt_t *gen;                /* preheader; NULL if not created yet */
+    float ref;                  /* weight for references in loop */
+    int ntmp;                   /* # of temporaries introduced */
+    struct {
+        sym_t *sym;             /* variable assigned */
+        dag_node_t *p;          /* assignment */
+        stmt_t *cp;             /* code list entry containing assignment */
+    } *asgn;                    /* assignments to variables in loop */
+    int nasgn;                  /* # of assignments */
+    struct {
+        sym_t *iv;              /* induction variable */
+        long k;                 /* scale */
+        const dag_node_t *base; /* base address */
+        int op;                 /* operation replaced */
+        sym_t *tmp;             /* temporary for reduced value */
+    } red[MAXTMP];              /* strength-reduced values */
+    int nred;                   /* # of strength-reduced values */
+};
+
+
+static struct blk *blk;      /* blocks for current function */
+static int nblk;             /* # of blocks */
+static struct blk **ltab;    /* maps label # to block */
+static int llo, lhi;         /* range of label # */
+
+/* statistics */
+static struct {
+    long nfunc;    /* # of functions optimized */
+    long nblk;     /* # of blocks */
+} stat;
+
+
+/*
+ *  finds the real label from a list of label synonyms
+ */
+static sym_t *equated(sym_t *p)
+{
+    assert(p);
+
+    while (p->u.l.equatedto)
+        p = p->u.l.equatedto;
+
+    return p;
+}
+
+
+/*
+ *  returns the last root of a forest
+ */
+static dag_node_t *lastroot(dag_node_t *p)
+{
+    assert(p);
+
+    while (p->link)
+        p = p->link;
+
+    return p;
+}
+
+
+/*
+ *  returns the label a root branches to; NULL if none or computed
+ */
+static sym_t *target(const dag_node_t *p)
+{
+    assert(p);
+
+    if (op_generic(p->op) == OP_JMP)
+        return (p->kid[0] && op_generic(p->kid[0]->op) == OP_ADDRG)?
+                   equated(p->kid[0]->sym[0]): NULL;
+    if (OP_ISCMP(p->op))
+        return equated(p->sym[0]);
+
+    return NULL;
+}
+
+
+/*
+ *  checks how a code list entry ends a block;
+ *  0 if it does not end one, 1 if it ends one and may fall through, 2 if it
+ *  ends one and never falls through and 3 if it ends with a computed jump
+ */
+static int ends(const stmt_t *cp)
+{
+    dag_node_t *p;
+
+    assert(cp);
+
+    switch(cp->kind) {
+        case STMT_GEN:
+            p = lastroot(cp->u.forest);
+            if (op_generic(p->op) == OP_JMP)
+                return (target(p))? 2: 3;
+            for (p = cp->u.forest; p; p = p->link)
+                if (op_generic(p->op) == OP_JMP || OP_ISCMP(p->op))
+                    return 1;
+            break;
+        case STMT_JUMP:
+        case STMT_SWITCH:
+            return 2;
+    }
+
+    return 0;
+}
+
+
+/*
+ *  checks if a code list entry begins a block
+ */
+static int begins(const stmt_t *cp)
+{
+    dag_node_t *p;
+
+    assert(cp);
+
+    if (cp->kind == STMT_LABEL)
+        return 1;
+    if (cp->kind == STMT_GEN)
+        for (p = cp->u.forest; p; p = p->link)
+            if (op_generic(p->op) == OP_LABEL)
+                return 1;
+
+    return 0;
+}
+
+
+/*
+ *  maps a label to a block
+ */
+static void maplabel(sym_t *p, struct blk *b)
+{
+    assert(p);
+    assert(b);
+
+    if (p->u.l.label >= llo && p->u.l.label <= lhi)
+        ltab[p->u.l.label - llo] = b;
+}
+
+
+/*
+ *  returns the block a label belongs to; NULL if unknown
+ */
+static struct blk *block(sym_t *p)
+{
+    assert(p);
+
+    return (p->u.l.label >= llo && p->u.l.label <= lhi)? ltab[p->u.l.label - llo]: NULL;
+}
+
+
+/*
+ *  builds blocks from the code list
+ */
+static void build(void)
+{
+    int n, e, scope;
+    stmt_t *cp;
+    dag_node_t *p;
+    struct blk *b;
+
+    n = 0, llo = INT_MAX, lhi = 0;
+    for (cp = stmt_head.next; cp; cp = cp->next) {
+        if (!CODE(cp))
+            continue;
+        n++;
+        if (cp->kind == STMT_LABEL || cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                if (op_generic(p->op) == OP_LABEL) {
+                    if (p->sym[0]->u.l.label < llo)
+                        llo = p->sym[0]->u.l.label;
+                    if (p->sym[0]->u.l.label > lhi)
+                        lhi = p->sym[0]->u.l.label;
+                }
+    }
+    blk = ARENA_ALLOC(strg_func, (n+1) * sizeof(*blk));
+    ltab = (llo <= lhi)? ARENA_CALLOC(strg_func, lhi-llo+1, sizeof(*ltab)): NULL;
+
+    b = NULL, e = 2, scope = 0;
+    for (cp = stmt_head.next; cp; cp = cp->next) {
+        if (SCOPE(cp))
+            scope++;
+        if (!CODE(cp))
+            continue;
+        if (!b || (e == 3 && cp->kind != STMT_SWITCH) || (e && e != 3) || begins(cp)) {
+            b = (b)? b+1: blk;
+            b->first = cp;
+            b->scope = scope;
+            b->mark = 0;
+        }
+        b->last = cp;
+        b->escope = scope;
+        e = (e == 3 && cp->kind == STMT_SWITCH)? 2: ends(cp);
+        b->fall = (e < 2);
+        if (cp->kind == STMT_LABEL || cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                if (op_generic(p->op) == OP_LABEL)
+                    maplabel(p->sym[0], b);
+    }
+    nblk = (b)? b-blk+1: 0;
+}
+
+
+/*
+ *  checks if a code list entry is followed by a label before other code
+ */
+static int follows(const stmt_t *cp, const sym_t *l)
+{
+    assert(cp);
+    assert(l);
+
+    for (cp = cp->next; cp && cp->kind <= STMT_LABEL; cp = cp->next)
+        if (cp->kind == STMT_LABEL && equated(cp->u.forest->sym[0]) == l)
+            return 1;
+
+    return 0;
+}
+
+
+/*
+ *  returns the next code list entry
+ */
+static stmt_t *nextcode(stmt_t *cp)
+{
+    assert(cp);
+
+    for (cp = cp->next; cp && !CODE(cp); cp = cp->next)
+        continue;
+
+    return cp;
+}
+
+
+/*
+ *  removes an entry from the code list
+ */
+static void drop(stmt_t *cp)
+{
+    assert(cp);
+    assert(cp->prev);
+
+    cp->prev->next = cp->next;
+    if (cp->next)
+        cp->next->prev = cp->prev;
+}
+
+
+/*
+ *  marks blocks reachable from the entry;
+ *  returns false if some destinations are unknown
+ */
+static int reach(void)
+{
+    int i, n;
+    sym_t *l;
+    stmt_t *cp;
+    dag_node_t *p;
+    struct blk *b, *t, **stk;
+
+#define PUSH(x) do {                       \
+                    if ((t = (x)) == NULL) \
+                        return 0;          \
+                    if (!t->mark) {        \
+                        t->mark = 1;       \
+                        stk[n++] = t;      \
+                    }                      \
+                } while(0)
+
+    for (b = blk; b < blk+nblk; b++)
+        b->mark = 0;
+    if (nblk == 0)
+        return 1;
+
+    n = 0;
+    stk = ARENA_ALLOC(strg_func, nblk * sizeof(*stk));
+    PUSH(blk);
+    while (n > 0) {
+        b = stk[--n];
+        for (cp = b->first; ; cp = cp->next) {
+            switch(cp->kind) {
+                case STMT_GEN:
+                    for (p = cp->u.forest; p; p = p->link)
+                        if ((l = target(p)) != NULL)
+                            PUSH(block(l));
+                    break;
+                case STMT_JUMP:
+                    if ((l = target(cp->u.forest)) == NULL)
+                        return 0;
+                    PUSH(block(l));
+                    break;
+                case STMT_SWITCH:
+                    for (i = 0; i < cp->u.swtch.size; i++)
+                        PUSH(block(equated(cp->u.swtch.label[i])));
+                    PUSH(block(equated(cp->u.swtch.deflab)));
+                    break;
+            }
+            if (cp == b->last)
+                break;
+        }
+        if (b->fall && b+1 < blk+nblk)
+            PUSH(b+1);
+    }
+
+#undef PUSH
+
+    return 1;
+}
+
+
+/*
+ *  redirects labels of jump-only blocks to their destinations
+ */
+static int thread(void)
+{
+    int n = 0;
+    sym_t *l;
+    stmt_t *cp;
+    struct blk *b;
+
+    for (b = blk; b < blk+nblk; b++) {
+        if (b->last->kind != STMT_JUMP || (l = target(b->last->u.forest)) == NULL)
+            continue;
+        for (cp = b->first; cp != b->last && (!CODE(cp) || cp->kind == STMT_LABEL);
+             cp = cp->next)
+            continue;
+        if (cp != b->last)
+            continue;
+        for (cp = b->first; cp != b->last; cp = cp->next)
+            if (cp->kind == STMT_LABEL && cp->u.forest->sym[0] != l) {
+                stmt_eqlabel(cp->u.forest->sym[0], l);
+                drop(cp);
+                n++;
+            }
+    }
+
+    return n;
+}
+
+
+/*
+ *  removes jumps to next code and
+ *  turns conditional branches over jumps into branches to their destinations
+ */
+static int branch(void)
+{
+    static const int inv[] = {    /* indexed by generic op - OP_EQ */
+        OP_NE, OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ
+    };
+
+    int n = 0;
+    sym_t *l, *m;
+    dag_node_t *p;
+    stmt_t *cp, *jp;
+
+    for (cp = stmt_head.next; cp; cp = cp->next)
+        if (cp->kind == STMT_JUMP && (l = target(cp->u.forest)) != NULL && follows(cp, l)) {
+            sym_ref(l, -1);
+            drop(cp);
+            n++;
+        } else if (cp->kind == STMT_GEN) {
+            p = lastroot(cp->u.forest);
+            if (!OP_ISCMP(p->op) || op_type(p->op) == OP_F || (jp = nextcode(cp)) == NULL ||
+                jp->kind != STMT_JUMP || (m = target(jp->u.forest)) == NULL)
+                continue;
+            if (!follows(jp, l = target(p)))
+                continue;
+            p->op = inv[(op_generic(p->op)-OP_EQ) >> OP_SOP] + op_tyscode(p->op);
+            p->sym[0] = m;
+            sym_ref(l, -1);
+            drop(jp);
+            n++;
+        }
+
+    return n;
+}
+
+
+/*
+ *  removes code of unreachable blocks
+ */
+static int unreach(void)
+{
+    int n = 0;
+    stmt_t *cp, *next;
+    struct blk *b;
+
+    if (!reach())
+        return 0;
+
+    for (b = blk; b < blk+nblk; b++)
+        if (!b->mark) {
+            for (cp = b->first; ; cp = next) {
+                next = cp->next;
+                if (CODE(cp))
+                    drop(cp);
+                if (cp == b->last)
+                    break;
+            }
+            n++;
+        }
+
+    return n;
+}
+
+
+/*
+ *  moves blocks reached only by jumps to follow their jumps
+ */
+static int layout(void)
+{
+    int n = 0;
+    sym_t *l;
+    stmt_t *jp;
+    struct blk *b, *t;
+
+    for (b = blk; b < blk+nblk; b++)
+        b->mark = 0;
+
+    for (b = blk; b < blk+nblk; b++) {
+        if (b->mark || b->last->kind != STMT_JUMP || (l = target(b->last->u.forest)) == NULL ||
+            (t = block(l)) == NULL)
+            continue;
+        if (t == blk || t == b || t == b+1 || t->mark || t[-1].mark || t->fall || t[-1].fall ||
+            t->first->kind != STMT_LABEL || t->scope != t->escope || t->scope != b->escope)
+            continue;
+        jp = b->last;
+        sym_ref(l, -1);
+        t->first->prev->next = t->last->next;
+        if (t->last->next)
+            t->last->next->prev = t->first->prev;
+        t->first->prev = jp->prev;
+        jp->prev->next = t->first;
+        t->last->next = jp->next;
+        if (jp->next)
+            jp->next->prev = t->last;
+        b->mark = t->mark = t[-1].mark = 1;
+        if (b+1 < blk+nblk)
+            b[1].mark = 1;
+        if (t+1 < blk+nblk)
+            t[1].mark = 1;
+        n++;
+    }
+
+    return n;
+}
+
+
+/*
+ *  returns the header block of a loop closed by a block; NULL if none
+ */
+static struct blk *backedge(const struct blk *b)
+{
+    sym_t *l = NULL;
+    struct blk *h;
+
+    assert(b);
+
+    if (b->last->kind == STMT_JUMP)
+        l = target(b->last->u.forest);
+    else if (b->last->kind == STMT_GEN && OP_ISCMP(lastroot(b->last->u.forest)->op))
+        l = target(lastroot(b->last->u.forest));
+
+    return (l && (h = block(l)) != NULL && h <= b)? h: NULL;
+}
+
+
+/*
+ *  returns the code list entry before which the preheader of a loop goes;
+ *  NULL unless the loop is entered by falling into the header or by a single jump from above
+ */
+static stmt_t *preheader(struct blk *h, struct blk *t)
+{
+    int i, n;
+    sym_t *l;
+    stmt_t *cp, *pre;
+    dag_node_t *p;
+    struct blk *b, *d;
+
+#define ENTER(x, c) do {                                \
+                        if ((d = (x)) == NULL)          \
+                            return NULL;                \
+                        if (d >= h && d <= t)           \
+                            n++, pre = (c);             \
+                    } while(0)
+
+    assert(h);
+    assert(t);
+
+    n = 0, pre = NULL;
+    if (h == blk || h[-1].fall)
+        n++, pre = h->first;
+    for (b = blk; b < blk+nblk; b++) {
+        if (b >= h && b <= t)
+            continue;
+        for (cp = b->first; ; cp = cp->next) {
+            switch(cp->kind) {
+                case STMT_GEN:
+                    for (p = cp->u.forest; p; p = p->link)
+                        if ((l = target(p)) != NULL)
+                            ENTER(block(l), NULL);
+                    break;
+                case STMT_JUMP:
+                    if ((l = target(cp->u.forest)) == NULL)
+                        return NULL;
+                    ENTER(block(l), (b < h)? cp: NULL);
+                    break;
+                case STMT_SWITCH:
+                    for (i = 0; i < cp->u.swtch.size; i++)
+                        ENTER(block(equated(cp->u.swtch.label[i])), NULL);
+                    ENTER(block(equated(cp->u.swtch.deflab)), NULL);
+                    break;
+            }
+            if (cp == b->last)
+                break;
+        }
+    }
+
+#undef ENTER
+
+    if (n != 1 || !pre)
+        return NULL;
+
+    /* checks if loop stays in scope of preheader */
+    for (n = 0, cp = pre; cp; cp = cp->next) {
+        if (cp->kind == STMT_BLOCKBEG)
+            n++;
+        else if (cp->kind == STMT_BLOCKEND && --n < 0)
+            return NULL;
+        if (cp == t->last)
+            return pre;
+    }
+
+    return NULL;
+}
+
+
+/*
+ *  inserts a new code list entry before another
+ */
+static stmt_t *insert(int kind, stmt_t *next)
+{
+    stmt_t *cp;
+
+    assert(next);
+    assert(next->prev);
+
+    cp = ARENA_ALLOC(strg_func, sizeof(*cp));
+    cp->kind = kind;
+    cp->prev = next->prev;
+    cp->next = next;
+    next->prev->next = cp;
+    next->prev = cp;
+
+    return cp;
+}
+
+
+/*
+ *  checks if a variable changes only by assignments to it
+ */
+static int local(const sym_t *p)
+{
+    assert(p);
+
+    return (p->scope >= SYM_SPARAM && TY_ISSCALAR(p->type) && !TY_ISVOLATILE(p->type) &&
+            (p->sclass == LEX_REGISTER || (p->sclass == LEX_AUTO && !p->f.addressed)));
+}
+
+
+/*
+ *  returns the variable a dag node reads; NULL if not a local variable
+ */
+static sym_t *var(const dag_node_t *p)
+{
+    assert(p);
+
+    if (op_generic(p->op) == OP_INDIR &&
+        (op_generic(p->kid[0]->op) == OP_ADDRL || op_generic(p->kid[0]->op) == OP_ADDRF) &&
+        local(p->kid[0]->sym[0]))
+        return p->kid[0]->sym[0];
+
+    return NULL;
+}
+
+
+/*
+ *  gets the value of a small integer constant node
+ */
+static int cnstval(const dag_node_t *p, long *pv)
+{
+    long v;
+
+    assert(p);
+    assert(pv);
+
+    if (op_generic(p->op) != OP_CNST || !OP_ISINT(p->op))
+        return 0;
+    if (OP_ISSINT(p->op)) {
+        if (xls(p->sym[0]->u.c.v.s, xis(-LOOPCNST)) || xgs(p->sym[0]->u.c.v.s, xis(LOOPCNST)))
+            return 0;
+        v = xns(p->sym[0]->u.c.v.s);
+    } else {
+        if (xgu(p->sym[0]->u.c.v.u, xiu(LOOPCNST)))
+            return 0;
+        v = xnu(p->sym[0]->u.c.v.u);
+    }
+    *pv = v;
+
+    return 1;
+}
+
+
+/*
+ *  returns the scale of a scaled index and sets its index; 0 if not scaled
+ */
+static long scale(const dag_node_t *p, dag_node_t **px)
+{
+    long k;
+
+    assert(p);
+    assert(px);
+
+    if (!OP_ISINT(p->op))
+        return 0;
+    if (op_generic(p->op) == OP_LSH && cnstval(p->kid[1], &k) && k >= 0 && k < 16) {
+        *px = p->kid[0];
+        return 1L << k;
+    }
+    if (op_generic(p->op) == OP_MUL) {
+        if (cnstval(p->kid[1], &k) && k > 0) {
+            *px = p->kid[0];
+            return k;
+        }
+        if (cnstval(p->kid[0], &k) && k > 0) {
+            *px = p->kid[1];
+            return k;
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ *  checks if a scale can be folded into an address
+ */
+static int folds(long k)
+{
+    assert(ir_cur);
+
+    return (k > 0 && k <= ir_cur->maxscale && (k & (k-1)) == 0);
+}
+
+
+/*
+ *  counts assignments to a variable in a loop;
+ *  sets the assignment and its code list entry if found
+ */
+static int assigned(const struct loop *lp, const sym_t *p, dag_node_t **pa, stmt_t **pcp)
+{
+    int i, n = 0;
+
+    assert(lp);
+    assert(p);
+
+    for (i = 0; i < lp->nasgn; i++)
+        if (lp->asgn[i].sym == p) {
+            if (pa)
+                *pa = lp->asgn[i].p;
+            if (pcp)
+                *pcp = lp->asgn[i].cp;
+            n++;
+        }
+
+    return n;
+}
+
+
+/*
+ *  checks if a dag computes the same value on every iteration of a loop without trapping
+ */
+static int invariant(const struct loop *lp, const dag_node_t *p)
+{
+    sym_t *v;
+
+    assert(lp);
+    assert(p);
+
+    switch(op_generic(p->op)) {
+        case OP_CNST:
+            return OP_ISINT(p->op) || op_type(p->op) == OP_P;
+        case OP_ADDRG:
+        case OP_ADDRF:
+        case OP_ADDRL:
+            return 1;
+        case OP_INDIR:
+            return ((v = var(p)) != NULL && !assigned(lp, v, NULL, NULL));
+        case OP_CVI:
+        case OP_CVU:
+        case OP_CVP:
+        case OP_NEG:
+        case OP_BCOM:
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_LSH:
+        case OP_RSH:
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+            return (op_type(p->op) != OP_F && invariant(lp, p->kid[0]) &&
+                    (!p->kid[1] || invariant(lp, p->kid[1])));
+    }
+
+    return 0;
+}
+
+
+/*
+ *  estimates the cost of evaluating a dag;
+ *  address arithmetic the target folds into addressing is free
+ */
+static int cost(const dag_node_t *p, int addr)
+{
+    int c;
+    dag_node_t *x;
+
+    assert(p);
+
+    switch(op_generic(p->op)) {
+        case OP_CNST:
+        case OP_ADDRG:
+        case OP_ADDRF:
+        case OP_ADDRL:
+        case OP_INDIR:
+            return 0;
+        case OP_ADD:
+            if (op_type(p->op) == OP_P)
+                return cost(p->kid[0], 1) + cost(p->kid[1], 1);
+            c = 1;
+            break;
+        case OP_LSH:
+        case OP_MUL:
+            if (addr && folds(scale(p, &x)))
+                return cost(x, 0);
+            c = (op_generic(p->op) == OP_MUL)? 3: 1;
+            break;
+        default:
+            c = 1;
+            break;
+    }
+
+    return c + cost(p->kid[0], 0) + ((p->kid[1])? cost(p->kid[1], 0): 0);
+}
+
+
+/*
+ *  checks if two dags compute the same value
+ */
+static int same(const dag_node_t *p, const dag_node_t *q)
+{
+    if (!p || !q)
+        return (p == q);
+
+    return (p == q || (p->op == q->op && p->sym[0] == q->sym[0] && same(p->kid[0], q->kid[0]) &&
+                       same(p->kid[1], q->kid[1])));
+}
+
+
+/*
+ *  deep-copies a dag into a tree
+ */
+static dag_node_t *copy(const dag_node_t *p)
+{
+    dag_node_t *q;
+
+    if (!p)
+        return NULL;
+
+    q = dag_newnode(p->op, copy(p->kid[0]), copy(p->kid[1]), p->sym[0]);
+    q->sym[1] = p->sym[1];
+
+    return q;
+}
+
+
+/*
+ *  drops a reference to a dag node
+ */
+static void release(dag_node_t *p, const dag_node_t *forest)
+{
+    const dag_node_t *q;
+
+    if (!p || --p->count > 0)
+        return;
+    for (q = forest; q; q = q->link)
+        if (q == p)
+            return;
+    release(p->kid[0], forest);
+    release(p->kid[1], forest);
+}
+
+
+/*
+ *  constructs an assignment to a temporary
+ */
+static dag_node_t *asgn(sym_t *tmp, dag_node_t *p)
+{
+    assert(tmp);
+    assert(p);
+
+    p = dag_newnode(OP_ASGN+op_sfxs(tmp->type), dag_newnode(op_addr(L), NULL, NULL, tmp), p, NULL);
+    p->sym[0] = sym_findint(tmp->type->size);
+    p->sym[1] = sym_findint(tmp->type->align);
+
+    return p;
+}
+
+
+/*
+ *  constructs a read of a temporary
+ */
+static dag_node_t *rtmp(sym_t *tmp)
+{
+    assert(tmp);
+
+    return dag_newnode(OP_INDIR+op_sfxs(tmp->type), dag_newnode(op_addr(L), NULL, NULL, tmp),
+                       NULL, NULL);
+}
+
+
+/*
+ *  replaces a dag in a loop with a temporary initialized in the preheader
+ */
+static sym_t *settmp(struct loop *lp, dag_node_t *p, const dag_node_t *forest)
+{
+    int n;
+    sym_t *tmp;
+    dag_node_t *q, *r;
+
+    assert(lp);
+    assert(p);
+
+    tmp = sym_new(SYM_KTEMP, LEX_REGISTER, op_stot(p->op), SYM_SLOCAL);
+    tmp->f.defined = 1;
+    insert(STMT_LOCAL, (lp->gen)? lp->gen: lp->pre)->u.var = tmp;
+    r = asgn(tmp, copy(p));
+    if (lp->gen) {
+        for (q = lp->gen->u.forest; q->link; q = q->link)
+            continue;
+        q->link = r;
+    } else
+        (lp->gen = insert(STMT_GEN, lp->pre))->u.forest = r;
+    lp->ntmp++;
+
+    n = p->count;
+    sym_ref(tmp, lp->ref * n);
+    release(p->kid[0], forest);
+    release(p->kid[1], forest);
+    *p = *rtmp(tmp);
+    p->count = n;
+
+    return tmp;
+}
+
+
+/*
+ *  hoists invariant computations of a dag out of a loop
+ */
+static int hoistdag(struct loop *lp, dag_node_t *p, int addr, const dag_node_t *forest)
+{
+    int i, n;
+
+    assert(lp);
+
+    if (!p || lp->ntmp >= MAXTMP)
+        return 0;
+    if (invariant(lp, p)) {
+        if (cost(p, addr) < 2)
+            return 0;
+        settmp(lp, p, forest);
+        return 1;
+    }
+
+    addr = (op_generic(p->op) == OP_ADD && op_type(p->op) == OP_P);
+    for (n = i = 0; i < NELEM(p->kid); i++)
+        n += hoistdag(lp, p->kid[i], addr, forest);
+
+    return n;
+}
+
+
+/*
+ *  moves loop-invariant computations to the preheader of a loop
+ */
+static int hoist(struct loop *lp)
+{
+    int n = 0;
+    stmt_t *cp;
+    dag_node_t *p;
+
+    assert(lp);
+
+    for (cp = lp->head->first; ; cp = cp->next) {
+        if (cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                n += hoistdag(lp, p->kid[0], 0, cp->u.forest) +
+                     hoistdag(lp, p->kid[1], 0, cp->u.forest);
+        if (cp == lp->tail->last)
+            break;
+    }
+
+    return n;
+}
+
+
+/*
+ *  returns the update of a basic induction variable and sets its step;
+ *  NULL if not such a variable
+ */
+static dag_node_t *induct(const struct loop *lp, const sym_t *v, long *pstep)
+{
+    int i;
+    long c;
+    stmt_t *cp;
+    dag_node_t *a, *e, *q;
+
+    assert(lp);
+    assert(v);
+    assert(pstep);
+
+    if (!local(v) || assigned(lp, v, &a, &cp) != 1 || cp->u.forest != a || !OP_ISINT(a->op))
+        return NULL;
+    for (q = a->link; q; q = q->link) {    /* allows updates of reduced temporaries */
+        for (i = 0; i < lp->nred && q->kid[0]->sym[0] != lp->red[i].tmp; i++)
+            continue;
+        if (i == lp->nred)
+            return NULL;
+    }
+
+    e = a->kid[1];
+    if (!OP_ISINT(e->op))
+        return NULL;
+    if (op_generic(e->op) == OP_ADD && var(e->kid[0]) == v && cnstval(e->kid[1], &c))
+        *pstep = c;
+    else if (op_generic(e->op) == OP_ADD && var(e->kid[1]) == v && cnstval(e->kid[0], &c))
+        *pstep = c;
+    else if (op_generic(e->op) == OP_SUB && var(e->kid[0]) == v && cnstval(e->kid[1], &c))
+        *pstep = -c;
+    else
+        return NULL;
+
+    return a;
+}
+
+
+/*
+ *  constructs an integer constant node for an operation
+ */
+static dag_node_t *cnst(int op, long v)
+{
+    ty_t *ty;
+    sym_val_t c;
+
+    if (op_type(op) == OP_U) {
+        ty = op_stot(op);
+        c.u = xiu(v);
+    } else {
+        ty = op_stot(OP_I + op_scode(op));
+        c.s = xis(v);
+    }
+
+    return dag_newnode(OP_CNST+op_sfx(ty), NULL, NULL, sym_findconst(ty, c));
+}
+
+
+/*
+ *  checks if a dag reads a variable
+ */
+static int reads(const dag_node_t *p, const sym_t *v)
+{
+    return (p && (var(p) == v || reads(p->kid[0], v) || reads(p->kid[1], v)));
+}
+
+
+/*
+ *  returns the scale of an address adding a variable scaled by a constant the target cannot
+ *  fold to an invariant base and sets the kid holding the base; 0 if not such an address
+ */
+static long scaled(const struct loop *lp, const dag_node_t *p, const sym_t *v, int *pb)
+{
+    int i;
+    long k;
+    dag_node_t *x;
+
+    assert(lp);
+    assert(p);
+    assert(pb);
+
+    if (op_generic(p->op) == OP_ADD && op_type(p->op) == OP_P)
+        for (i = 0; i < NELEM(p->kid); i++)
+            if ((k = scale(p->kid[i], &x)) > 0 && !folds(k) && var(x) == v &&
+                invariant(lp, p->kid[!i])) {
+                *pb = !i;
+                return k;
+            }
+
+    return 0;
+}
+
+
+/*
+ *  returns the kid of a comparison holding a variable compared with an invariant;
+ *  -1 if not such a comparison
+ */
+static int tested(const struct loop *lp, const dag_node_t *p, const sym_t *v)
+{
+    int i;
+
+    assert(lp);
+    assert(p);
+
+    if (OP_ISCMP(p->op) && op_type(p->op) != OP_F)
+        for (i = 0; i < NELEM(p->kid); i++)
+            if (var(p->kid[i]) == v && invariant(lp, p->kid[!i]))
+                return i;
+
+    return -1;
+}
+
+
+/*
+ *  checks if a variable is read in a dag only by scaled addresses sharing one reduced value;
+ *  sets the first of them
+ */
+static int uses(const struct loop *lp, const dag_node_t *p, const sym_t *v,
+                const dag_node_t **pr)
+{
+    int i, j;
+    long k;
+
+    assert(pr);
+
+    if (!p)
+        return 1;
+    if ((k = scaled(lp, p, v, &i)) > 0) {
+        if (!*pr) {
+            *pr = p;
+            return 1;
+        }
+        return (p->op == (*pr)->op && scaled(lp, *pr, v, &j) == k &&
+                same(p->kid[i], (*pr)->kid[j]));
+    }
+    if (var(p) == v)
+        return 0;
+
+    return (uses(lp, p->kid[0], v, pr) && uses(lp, p->kid[1], v, pr));
+}
+
+
+/*
+ *  checks if a variable is dead on every exit from a loop;
+ *  a path kills it with an assignment before a read
+ */
+static int dead(const struct loop *lp, const sym_t *v)
+{
+    int i, n, k;
+    sym_t *l;
+    stmt_t *cp;
+    dag_node_t *p;
+    struct blk *b, *t, **stk;
+
+#define PUSH(x) do {                       \
+                    if ((t = (x)) == NULL) \
+                        return 0;          \
+                    if (!t->mark) {        \
+                        t->mark = 1;       \
+                        stk[n++] = t;      \
+                    }                      \
+                } while(0)
+#define EXIT(x) do {                                  \
+                    if ((t = (x)) == NULL)            \
+                        return 0;                     \
+                    if (t < lp->head || t > lp->tail) \
+                        PUSH(t);                      \
+                } while(0)
+
+    assert(lp);
+    assert(v);
+
+    for (b = blk; b < blk+nblk; b++)
+        b->mark = 0;
+
+    n = 0;
+    stk = ARENA_ALLOC(strg_func, nblk * sizeof(*stk));
+    for (b = lp->head; b <= lp->tail; b++)
+        for (cp = b->first; ; cp = cp->next) {
+            switch(cp->kind) {
+                case STMT_GEN:
+                case STMT_JUMP:
+                    for (p = cp->u.forest; p; p = p->link)
+                        if ((l = target(p)) != NULL)
+                            EXIT(block(l));
+                        else if (op_generic(p->op) == OP_JMP)
+                            return 0;
+                    break;
+                case STMT_SWITCH:
+                    for (i = 0; i < cp->u.swtch.size; i++)
+                        EXIT(block(equated(cp->u.swtch.label[i])));
+                    EXIT(block(equated(cp->u.swtch.deflab)));
+                    break;
+            }
+            if (cp == b->last)
+                break;
+        }
+    if (lp->tail->fall && lp->tail+1 < blk+nblk)
+        PUSH(lp->tail+1);
+
+    while (n > 0) {
+        b = stk[--n];
+        for (k = 0, cp = b->first; !k; cp = cp->next) {
+            switch(cp->kind) {
+                case STMT_GEN:
+                case STMT_JUMP:
+                    for (p = cp->u.forest; p && !k; p = p->link)
+                        if (reads(p, v))
+                            return 0;
+                        else if (op_generic(p->op) == OP_ASGN && p->kid[0]->sym[0] == v &&
+                                 (op_generic(p->kid[0]->op) == OP_ADDRL ||
+                                  op_generic(p->kid[0]->op) == OP_ADDRF))
+                            k = 1;
+                        else if ((l = target(p)) != NULL)
+                            PUSH(block(l));
+                        else if (op_generic(p->op) == OP_JMP)
+                            return 0;
+                    break;
+                case STMT_SWITCH:
+                    for (i = 0; i < cp->u.swtch.size; i++)
+                        PUSH(block(equated(cp->u.swtch.label[i])));
+                    PUSH(block(equated(cp->u.swtch.deflab)));
+                    break;
+            }
+            if (cp == b->last)
+                break;
+        }
+        if (!k && b->fall && b+1 < blk+nblk)
+            PUSH(b+1);
+    }
+
+#undef EXIT
+#undef PUSH
+
+    return 1;
+}
+
+
+/*
+ *  checks if an induction variable can give way to a single reduced temporary;
+ *  the variable has to be read in a loop only by its update, by comparisons with invariants
+ *  and by scaled addresses sharing one reduced value and be dead on exits from the loop
+ */
+static int elim(const struct loop *lp, const sym_t *v, const dag_node_t *u)
+{
+    stmt_t *cp;
+    dag_node_t *p;
+    const dag_node_t *r = NULL;
+
+    assert(lp);
+
+    for (cp = lp->head->first; ; cp = cp->next) {
+        if (cp->kind == STMT_GEN) {
+            for (p = cp->u.forest; p; p = p->link)
+                if (p != u && tested(lp, p, v) < 0 && !uses(lp, p, v, &r))
+                    return 0;
+        } else if (cp->kind == STMT_JUMP && reads(cp->u.forest, v))
+            return 0;
+        if (cp == lp->tail->last)
+            break;
+    }
+
+    return (r && dead(lp, v));
+}
+
+
+/*
+ *  replaces a scaled induction variable with a temporary updated along with the variable
+ */
+static int replace(struct loop *lp, dag_node_t *p, long k, const dag_node_t *base,
+                   dag_node_t *u, long step, const dag_node_t *forest)
+{
+    int i, n;
+    long d;
+    sym_t *tmp;
+    dag_node_t *q;
+
+    assert(lp);
+    assert(p);
+    assert(u);
+
+    for (i = 0; i < lp->nred; i++)
+        if (lp->red[i].iv == u->kid[0]->sym[0] && lp->red[i].k == k && lp->red[i].op == p->op &&
+            same(lp->red[i].base, base))
+            break;
+    if (i < lp->nred) {
+        n = p->count;
+        sym_ref(lp->red[i].tmp, lp->ref * n);
+        release(p->kid[0], forest);
+        release(p->kid[1], forest);
+        *p = *rtmp(lp->red[i].tmp);
+        p->count = n;
+        return 1;
+    }
+    if (lp->ntmp >= MAXTMP)
+        return 0;
+
+    lp->red[lp->nred].iv = u->kid[0]->sym[0];
+    lp->red[lp->nred].k = k;
+    lp->red[lp->nred].base = base;
+    lp->red[lp->nred].op = p->op;
+    lp->red[lp->nred++].tmp = tmp = settmp(lp, p, forest);
+    d = step * k;
+    q = dag_newnode(((d < 0)? OP_SUB: OP_ADD) + op_tyscode(p->op), rtmp(tmp),
+                    cnst(p->op, (d < 0)? -d: d), NULL);
+    lastroot(u)->link = asgn(tmp, q);
+    sym_ref(tmp, lp->ref);
+
+    return 1;
+}
+
+
+/*
+ *  reduces scaled addresses of an induction variable in a dag in a loop
+ */
+static int reducedag(struct loop *lp, dag_node_t *p, const sym_t *v, const dag_node_t *forest)
+{
+    int i, n;
+    long k, step;
+    dag_node_t *u;
+
+    assert(lp);
+
+    if (!p)
+        return 0;
+
+    if ((k = scaled(lp, p, v, &i)) > 0 && (u = induct(lp, v, &step)) != NULL)
+        return replace(lp, p, k, p->kid[i], u, step, forest);
+
+    for (n = i = 0; i < NELEM(p->kid); i++)
+        n += reducedag(lp, p->kid[i], v, forest);
+
+    return n;
+}
+
+
+/*
+ *  rewrites comparisons of an induction variable in terms of its reduced temporary;
+ *  a variable scaled by a positive constant and added to a base keeps its order as an address
+ */
+static int retest(struct loop *lp, const sym_t *v, int r)
+{
+    int i, n = 0;
+    long c;
+    stmt_t *cp;
+    dag_node_t *p, *q, *x;
+
+    assert(lp);
+    assert(r >= 0 && r < lp->nred);
+
+    for (cp = lp->head->first; ; cp = cp->next) {
+        if (cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                if ((i = tested(lp, p, v)) >= 0) {
+                    q = p->kid[!i];
+                    if (!cnstval(q, &c))
+                        x = dag_newnode(OP_MUL+op_tyscode(q->op), copy(q),
+                                        cnst(q->op, lp->red[r].k), NULL);
+                    else
+                        x = (c != 0)? cnst(q->op, c * lp->red[r].k): NULL;
+                    p->kid[!i] = (x)? dag_newnode(lp->red[r].op, copy(lp->red[r].base), x, NULL):
+                                      copy(lp->red[r].base);
+                    p->kid[!i]->count++;
+                    release(q, cp->u.forest);
+                    q = p->kid[i];
+                    p->kid[i] = rtmp(lp->red[r].tmp);
+                    p->kid[i]->count++;
+                    release(q, cp->u.forest);
+                    p->op = op_generic(p->op) + op_scode(lp->red[r].op) +
+                            ((op_generic(p->op) == OP_EQ || op_generic(p->op) == OP_NE)?
+                                 OP_I: OP_U);    /* no unsigned equality */
+                    sym_ref(lp->red[r].tmp, lp->ref);
+                    hoistdag(lp, p->kid[!i], 0, cp->u.forest);
+                    n++;
+                }
+        if (cp == lp->tail->last)
+            break;
+    }
+
+    return n;
+}
+
+
+/*
+ *  strength-reduces scaled induction variables in a loop;
+ *  a variable is reduced only when its temporary replaces it, since an extra variable live
+ *  across the loop would likely go to memory and cost more than the multiplication saved
+ */
+static int reduce(struct loop *lp)
+{
+    int i, n = 0;
+    long step;
+    sym_t *v;
+    stmt_t *cp;
+    dag_node_t *p, *u;
+
+    assert(lp);
+
+    for (i = 0; i < lp->nasgn; i++) {
+        v = lp->asgn[i].sym;
+        if (lp->ntmp+2 > MAXTMP || (u = induct(lp, v, &step)) == NULL || !elim(lp, v, u))
+            continue;
+        for (cp = lp->head->first; ; cp = cp->next) {
+            if (cp->kind == STMT_GEN)
+                for (p = cp->u.forest; p; p = p->link)
+                    n += reducedag(lp, p->kid[0], v, cp->u.forest) +
+                         reducedag(lp, p->kid[1], v, cp->u.forest);
+            if (cp == lp->tail->last)
+                break;
+        }
+        n += retest(lp, v, lp->nred-1);
+        cp = lp->asgn[i].cp;    /* drops update of variable */
+        assert(cp->u.forest == u && u->link);
+        cp->u.forest = u->link;
+        release(u->kid[0], cp->u.forest);
+        release(u->kid[1], cp->u.forest);
+    }
+
+    return n;
+}
+
+
+/*
+ *  collects assignments to local variables in a loop
+ */
+static void collect(struct loop *lp)
+{
+    int n;
+    stmt_t *cp;
+    dag_node_t *p;
+
+    assert(lp);
+
+    for (n = 0, cp = lp->head->first; ; cp = cp->next) {
+        if (cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                n += (op_generic(p->op) == OP_ASGN);
+        if (cp == lp->tail->last)
+            break;
+    }
+
+    lp->asgn = ARENA_ALLOC(strg_func, (n+1) * sizeof(*lp->asgn));
+    for (lp->nasgn = 0, cp = lp->head->first; ; cp = cp->next) {
+        if (cp->kind == STMT_GEN)
+            for (p = cp->u.forest; p; p = p->link)
+                if (op_generic(p->op) == OP_ASGN && (op_generic(p->kid[0]->op) == OP_ADDRL ||
+                                                     op_generic(p->kid[0]->op) == OP_ADDRF)) {
+                    lp->asgn[lp->nasgn].sym = p->kid[0]->sym[0];
+                    lp->asgn[lp->nasgn].p = p;
+                    lp->asgn[lp->nasgn++].cp = cp;
+                }
+        if (cp == lp->tail->last)
+            break;
+    }
+}
+
+
+/*
+ *  applies an optimization to loops with single entries;
+ *  a loop is a range of blocks closed by a backward branch
+ */
+static int loops(int (*opt)(struct loop *))
+{
+    int i, k, n = 0;
+    struct blk *b, *c, *g, *h;
+    struct loop lp;
+
+    assert(opt);
+
+    for (i = 0; i < nblk; i++) {
+        b = blk + i;
+        if ((h = backedge(b)) == NULL || (lp.pre = preheader(h, b)) == NULL)
+            continue;
+        lp.head = h;
+        lp.tail = b;
+        lp.gen = NULL;
+        lp.ntmp = lp.nred = 0;
+        for (lp.ref = 1, c = b; c < blk+nblk; c++)
+            if ((g = backedge(c)) != NULL && g <= h)
+                lp.ref *= 10;
+        collect(&lp);
+        if ((k = opt(&lp)) > 0) {
+            n += k;
+            build();
+        }
+    }
+
+    return n;
+}
+
+
+/*
+ *  moves loop-invariant computations out of loops
+ */
+static int licm(void)
+{
+    return loops(hoist);
+}
+
+
+/*
+ *  replaces scaled induction variables with temporaries updated in loops
+ */
+static int sr(void)
+{
+    return loops(reduce);
+}
+
+
+/* optimization passes in order */
+static struct pass pass[] = {
+    { "thread",  1, thread,  0, 0 },
+    { "branch",  1, branch,  0, 0 },
+    { "unreach", 1, unreach, 0, 0 },
+    { "layout",  2, layout,  0, 0 },
+    { "licm",    2, licm,    0, 0 },
+    { "sr",      2, sr,      0, 0 }
+};
+
+
+/*
+ *  optimizes the code list of the current function
+ */
+void (flow_opt)(void)
+{
+    sz_t i;
+    int k, n, iter;
+    clock_t c;
+
+    if (main_opt()->olevel == 0)
+        return;
+
+    for (iter = 0; iter < 4; iter++) {
+        n = 0;
+        for (i = 0; i < NELEM(pass); i++)
+            if (main_opt()->olevel >= pass[i].level) {
+                c = clock();
+                build();
+                k = pass[i].run();
+                pass[i].time += clock() - c;
+                pass[i].nchange += k;
+                n += k;
+            }
+        if (n == 0)
+            break;
+    }
+
+    build();
+    stat.nfunc++;
+    stat.nblk += nblk;
+}
+
+
+/*
+ *  prints statistics for flow optimization
+ */
+void (flow_close)(void)
+{
+    sz_t i;
+
+    if (!main_opt()->_stat || stat.nfunc == 0)
+        return;
+
+    fprintf(stderr, "flow: %ld function(s), %ld block(s)\n", stat.nfunc, stat.nblk);
+    for (i = 0; i < NELEM(pass); i++)
+        fprintf(stderr, "flow: %-7s %ld change(s), %.3fs\n", pass[i].name, pass[i].nchange,
+                (double)pass[i].time / CLOCKS_PER_SEC);
+}
+
+/* end of flow.c */
@@ -0,0 +1,15 @@
+/*
+ *  flow graph and optimization passes
+ */
+
+#ifndef FLOW_H
+#define FLOW_H
+
+
+void flow_opt(void);
+void flow_close(void);
+
+
+#endif    /* FLOW_H */
+
+/* end of flow.h */
@@ -5,9 +5,9 @@
 #include <ctype.h>         /* isdigit */
 #include <stdarg.h>        /* va_list, va_start, va_end */
 #include <stddef.h>        /* size_t, NULL */
-#include <stdio.h>         /* FILE, vsprintf */
-#include <string.h>        /* strchr */
-#include <cbl/arena.h>     /* ARENA_ALLOC */
+#include <stdio.h>         /* FILE, sprintf, vsprintf, fprintf, stderr */
+#include <string.h>        /* strchr, memcpy */
+#include <cbl/arena.h>     /* arena_t, ARENA_NEW, ARENA_ALLOC, ARENA_FREE, ARENA_DISPOSE */
 #include <cbl/assert.h>    /* assert */
 #include <cdsl/hash.h>     /* hash_int, hash_string */
 #ifndef NDEBUG
@@ -20,7 +20,9 @@
 #include "dag.h"
 #include "ir.h"
 #include "lex.h"
+#include "main.h"
 #include "op.h"
+#include "peep.h"
 #include "reg.h"
 #include "strg.h"
 #include "sym.h"
@@ -37,6 +39,20 @@ ssz_t gen_aoff, gen_maxaoff;    /* offset and max offset for arguments */
 ssz_t gen_frame;                /* frame size */
 
 
+/* arena for instruction selection; freed after each function emitted */
+static arena_t *strg_gen;
+
+/* statistics on instruction selection */
+static struct {
+    long nfunc;     /* # of functions */
+    long nnode;     /* # of dag nodes labelled */
+    long ncheck;    /* # of residual checks from BURS tables */
+    size_t cur;     /* bytes allocated in strg_gen for current function */
+    size_t peak;    /* peak of cur */
+    size_t sum;     /* sum of cur */
+} stat;
+
+
 /* internal functions referenced forwardly */
 static void chain(int, dag_node_t *, int);
 static void prereduce(dag_node_t **, int);
@@ -46,6 +62,37 @@ static void dumpcover(dag_node_t *, FILE *);
 #endif    /* !NDEBUG */
 
 
+/*
+ *  allocates storage for instruction selection
+ */
+static void *galloc(size_t n)
+{
+    if (!strg_gen)
+        strg_gen = ARENA_NEW();
+    stat.cur += n;
+
+    return ARENA_ALLOC(strg_gen, n);
+}
+
+
+/*
+ *  allocates rule numbers and costs for a dag node;
+ *  both are packed into a single block as in BURS tables
+ */
+static void newcost(short **prn, short **pcost)
+{
+    short *b;
+
+    assert(prn);
+    assert(pcost);
+    assert(ir_cur);
+
+    b = galloc(2 * ir_cur->x.nnt * sizeof(*b));
+    *prn = b;
+    *pcost = b + ir_cur->x.nnt;
+}
+
+
 /*
  *  prepares rewriting;
  *  - remembers the argument offset for CALL;
@@ -138,15 +185,15 @@ static void setcost(cgr_t *x, dag_node_t *p, int w)
 
     if (w >= CGR_CSTMAX)    /* avoids costf() for unmatched dags; see memop() */
         return;
-    cost = ((x->costf)? x->costf(p): x->cost) + w;
+    cost = x->cost + ((x->costf)? x->costf(p): 0) + w;
     if (cost >= CGR_CSTMAX)
         return;
     if (!p->x.rn) {    /* allocates only when necessary */
-        p->x.rn = ARENA_ALLOC(strg_perm, ir_cur->x.nnt * sizeof(*p->x.rn));
-        p->x.cost = ARENA_ALLOC(strg_perm, ir_cur->x.nnt * sizeof(*p->x.cost));
-        p->x.rn[0] = 0;
-        for (i = 0; i < ir_cur->x.nnt ; i++)
+        newcost(&p->x.rn, &p->x.cost);
+        for (i = 0; i < ir_cur->x.nnt ; i++) {
+            p->x.rn[i] = 0;
             p->x.cost[i] = CGR_CSTMAX;
+        }
     } else if (cost >= p->x.cost[cgr_ntidx(x->nt)])
         return;
     p->x.cost[cgr_ntidx(x->nt)] = cost;
@@ -170,13 +217,106 @@ static void chain(int nt, dag_node_t *p, int w)
 
 
 /*
- *  BURS labeller
+ *  labels a dag node by trying all rules for its op code
  */
-static void label(dag_node_t *p)
+static void labelnode(dag_node_t *p)
 {
     size_t n;
     alist_t *r, *ri;
 
+    assert(p);
+
+    r = cgr_lookup(p->op);
+    ALIST_FOREACH(n, ri, r) {
+        setcost(ri->data, p, match(p, ((cgr_t *)ri->data)->tree));
+    }
+}
+
+
+/*
+ *  finds an op code from BURS tables;
+ *  returns -1 if no rule for it
+ */
+static int opidx(const cgr_burs_t *b, int op)
+{
+    int i, lo, hi;
+
+    assert(b);
+
+    for (lo = 0, hi = b->nop; lo < hi; ) {
+        i = (lo+hi) / 2;
+        if (b->op[i] < op)
+            lo = i + 1;
+        else
+            hi = i;
+    }
+
+    return (lo < b->nop && b->op[lo] == op)? lo: -1;
+}
+
+
+/*
+ *  sets the state of a dag node labelled with BURS tables
+ */
+static void tstate(dag_node_t *p, const cgr_bres_t *r)
+{
+    const cgr_burs_t *b = ir_cur->x.burs;
+
+    assert(p);
+    assert(r);
+
+    p->x.state = r->state;
+    p->x.base = r->base;
+    if (b->zero[r->state] >= 0) {
+        p->x.rn = b->state + 2*r->state*b->nnt;
+        p->x.cost = p->x.rn + b->nnt;
+    }
+}
+
+
+/*
+ *  labels a dag node with BURS tables;
+ *  one transition is looked up by the states of its children and residual checks pick
+ *  the result where rules with cost functions are involved
+ */
+static void lookup(dag_node_t *p)
+{
+    int i, k[2];
+    const short *d;
+    const cgr_bop_t *e;
+    const cgr_btr_t *t;
+    const cgr_bres_t *r;
+    const cgr_burs_t *b = ir_cur->x.burs;
+
+    assert(p);
+    assert(b);
+
+    if ((i = opidx(b, p->op)) < 0)
+        return;
+    e = &b->bop[i];
+    for (i = 0; i < 2; i++)
+        k[i] = (e->map[i] < 0)? 0: b->map[e->map[i] + ((p->kid[i])? p->kid[i]->x.state: 0)];
+    t = &b->tr[e->tr + k[0]*e->ncls + k[1]];
+    r = &b->res[t->res];
+    if (t->dyn >= 0)
+        for (i = 0, d = &b->dyn[t->dyn]; *d >= 0; d++, i++) {
+            stat.ncheck++;
+            if (ir_cur->x.rule[*d].costf(p) < CGR_CSTMAX)
+                r += 1 << i;
+        }
+    tstate(p, r);
+    for (i = 0; i < 2; i++)
+        if (p->kid[i])
+            p->x.base += p->kid[i]->x.base;
+}
+
+
+/*
+ *  BURS labeller;
+ *  labels with BURS tables unless --_interp-label given
+ */
+static void label(dag_node_t *p)
+{
     if (!p)
         return;
     label(p->kid[0]);
@@ -185,23 +325,35 @@ static void label(dag_node_t *p)
     assert(!p->x.rn);
     assert(!p->x.cost);
 
-    r = cgr_lookup(p->op);
-    ALIST_FOREACH(n, ri, r) {
-        setcost(ri->data, p, match(p, ((cgr_t *)ri->data)->tree));
-    }
+    stat.nnode++;
+    if (!ir_cur->x.burs || main_opt()->_ilabel)
+        labelnode(p);
+    else
+        lookup(p);
 
     /* corresponds to reuse() */
-    if (op_generic(p->op) == OP_INDIR && p->kid[0]->op == OP_VREGP) {
+    if (READREG(p)) {
         sym_t *s = p->sym[REG_RX];
-        if (s && s->u.t.cse && !s->u.t.cse->usecse) {
+        if (s && s->u.t.cse && !s->u.t.cse->usecse && s->u.t.cse->x.base == 0) {
             int i;
+            short *rn, *cost;
             dag_node_t *q = s->u.t.cse;
             assert(p->x.cost && q->x.cost);
+            newcost(&rn, &cost);
+            memcpy(rn, p->x.rn, ir_cur->x.nnt * sizeof(*rn));    /* may be shared */
+            memcpy(cost, p->x.cost, ir_cur->x.nnt * sizeof(*cost));
+            if (p->x.state > 0) {    /* state for bonus from tables */
+                const cgr_burs_t *b = ir_cur->x.burs;
+                tstate(p, &b->res[b->bop[opidx(b, p->op)].bonus + b->zero[q->x.state]]);
+                memcpy(cost, p->x.cost, ir_cur->x.nnt * sizeof(*cost));
+            }
             for (i = 0; i < ir_cur->x.nnt; i++)
                 if (q->x.cost[i] == 0) {
-                    p->x.cost[i] = 0;
-                    p->x.rn[i] = q->x.rn[i];
+                    cost[i] = 0;
+                    rn[i] = q->x.rn[i];
                 }
+            p->x.rn = rn;
+            p->x.cost = cost;
         }
     }
 }
@@ -231,7 +383,22 @@ static dag_node_t **findnt(dag_node_t **pp, const cgr_tree_t *r, dag_node_t *ppv
 
 
 /*
- *  returns a copy of the original node for a cse if bonus match
+ *  clears instruction marks copied from the original node for a cse
+ */
+static void uninst(dag_node_t *p)
+{
+    if (!p)
+        return;
+
+    p->x.inst = 0;
+    uninst(p->kid[0]);
+    uninst(p->kid[1]);
+}
+
+
+/*
+ *  returns a copy of the original node for a cse if bonus match;
+ *  the copy is recomputed in place and reduced afresh for idx
  */
 static dag_node_t *reuse(dag_node_t *p, int idx)
 {
@@ -243,8 +410,11 @@ static dag_node_t *reuse(dag_node_t *p, int idx)
     if (op_generic(p->op) == OP_INDIR && p->kid[0]->op == OP_VREGP && s && s->u.t.cse &&
         !s->u.t.cse->usecse) {
         dag_node_t *r = s->u.t.cse;
-        if (r->x.cost && r->x.cost[idx] == 0)
-            return dag_copy(r);
+        if (r->x.cost && r->x.base == 0 && r->x.cost[idx] == 0) {
+            p = dag_copy(r);
+            uninst(p);
+            return p;
+        }
     }
 
     return p;
@@ -273,7 +443,7 @@ static void prereduce(dag_node_t **pp, int idx)
         prereduce(pp, cgr_ntidx(r->tree->op));
     else if (r->nnt > 0) {
         dag_node_t **ppv;
-        ppv = p->x.vr = ARENA_ALLOC(strg_perm, (r->nnt+1)*sizeof(*p->x.vr));
+        ppv = p->x.vr = galloc((r->nnt+1)*sizeof(*p->x.vr));
         ppv[r->nnt] = NULL;
         findnt(&p->kid[1], r->tree->kid[1], findnt(&p->kid[0], r->tree->kid[0], ppv));
     }
@@ -462,13 +632,14 @@ dag_node_t *(gen_code)(dag_node_t *forest)
         }
 
     for (p = forest; p; p = p->x.next)
-        if (p->x.f.copy && p->x.kid[0]->sym[REG_RX]->u.t.cse) {
+        if (p->x.f.copy && p->x.kid[0]->sym[REG_RX]->u.t.cse &&
+            !p->sym[REG_RX]->x.wildcard) {    /* copied only for precluding mask if wildcard */
             sym_t *tmp = p->x.kid[0]->sym[REG_RX],
                   *dst = p->sym[REG_RX];
             dag_node_t *q;
             int flag = 0;
 
-            assert(!dst->x.wildcard && tmp->x.lastuse);
+            assert(tmp->x.lastuse);
             for (q = tmp->u.t.cse; q; q = q->x.next) {
                 FORXKIDS(q, 0) {
                     if (q->x.kid[i] == tmp->x.lastuse)
@@ -521,6 +692,10 @@ dag_node_t *(gen_code)(dag_node_t *forest)
         if (NELEM(p->x.kid) > 1 && r->tmpl[0] == '?' && p->x.kid[1] &&
             s && !s->x.wildcard && !s->u.t.cse && !REG_ISRVAR(s))    /* targetted */
             reg_pmask(p);
+        FORXKIDS(p, 0) {
+            if (p->x.kid[i]->x.pmask && GEN_READCSE(p->x.kid[i]))
+                reg_pmcse(p->x.kid[i]);
+        }
     }
     for (p = forest; p; p = p->x.next)
         reg_alloc(p);
@@ -678,16 +853,12 @@ static void emitasm(dag_node_t *p, int idx)
 {
     const cgr_t *r;
     const char *tmpl;
-    FILE *out;
     const char *abc = "abcdefghijklmnopqrstuvwxyz", *q;
 
     assert(p);
     assert(p->x.rn);
     assert(ir_cur && idx > 0 && idx < ir_cur->x.nnt);
 
-    out = ir_cur->out;
-    assert(out);
-
     r = &ir_cur->x.rule[p->x.rn[idx]];
     assert(r->rn >= 0 && r->nt > 0);
 
@@ -697,7 +868,7 @@ static void emitasm(dag_node_t *p, int idx)
     DEBUG(putc('\n', stderr));
     if (r->isinst && p->x.f.emitted) {
         assert(p->sym[REG_RX]);
-        fputs(p->sym[REG_RX]->x.name, out);
+        peep_puts(p->sym[REG_RX]->x.name);
     } else if (*tmpl == '#')
         ir_cur->x.emit(p);
     else {
@@ -710,11 +881,12 @@ static void emitasm(dag_node_t *p, int idx)
         }
         for (; *tmpl; tmpl++)
             if (*tmpl != ir_cur->x.fmt)
-                putc(*tmpl, out);
-            else if (*++tmpl == 'F')    /* skips %; %F */
-                fprintf(out, "%"FMTSZ"d", gen_frame);
-            else if (*tmpl == 'R')    /* %R */
-                fprintf(out, "%s", p->sym[REG_RX]->x.name);
+                peep_putc(*tmpl);
+            else if (*++tmpl == 'F') {    /* skips %; %F */
+                sprintf(strg_nbuf, "%"FMTSZ"d", gen_frame);
+                peep_puts(strg_nbuf);
+            } else if (*tmpl == 'R')    /* %R */
+                peep_puts(p->sym[REG_RX]->x.name);
             else if (isdigit(*(unsigned char *)tmpl)) {    /* %[0-9] */
                 if (cgr_isnt(r->tree->op)) {    /* chain rule */
                     assert(*tmpl == '0');
@@ -736,9 +908,9 @@ static void emitasm(dag_node_t *p, int idx)
                 }
             } else if ((q = strchr(abc, *tmpl)) != NULL) {    /* %[a-z] */
                 assert(p->sym[q-abc]);
-                fprintf(out, "%s", p->sym[q-abc]->x.name);
+                peep_puts(p->sym[q-abc]->x.name);
             } else
-               putc(*tmpl, out);
+               peep_putc(*tmpl);
     }
 }
 
@@ -789,17 +961,50 @@ int (gen_move)(dag_node_t *p)
 {
     assert(p);
     p->x.f.copy = 1;
-    return 1;
+    return 0;
 }
 
 
 /*
- *  common cost function: notarget
+ *  common cost function: notarget;
+ *  a precluding mask also needs a register of its own
  */
 int (gen_notarget)(dag_node_t *p)
 {
     assert(p);
-    return (!p->sym[REG_RX])? 0: CGR_CSTMAX;
+    return (!p->sym[REG_RX] && !p->x.pmask)? 0: CGR_CSTMAX;
+}
+
+
+/*
+ *  releases storage for instruction selection of a function;
+ *  x.rn, x.cost and x.vr of dag nodes are invalid after this call
+ */
+void (gen_free)(void)
+{
+    stat.nfunc++;
+    stat.sum += stat.cur;
+    if (stat.cur > stat.peak)
+        stat.peak = stat.cur;
+    stat.cur = 0;
+    if (strg_gen)
+        ARENA_FREE(strg_gen);
+}
+
+
+/*
+ *  finalizes the code generator
+ */
+void (gen_close)(void)
+{
+    if (main_opt()->_stat) {
+        fprintf(stderr, "gen: %ld function(s), %ld node(s) labelled, %ld residual check(s)\n",
+                stat.nfunc, stat.nnode, stat.ncheck);
+        fprintf(stderr, "gen: %lu byte(s) peak per function, %lu byte(s) in total\n",
+                (unsigned long)stat.peak, (unsigned long)stat.sum);
+    }
+    if (strg_gen)
+        ARENA_DISPOSE(&strg_gen);
 }
 
 
@@ -35,6 +35,8 @@ void gen_auto(sym_t *, int);
 ssz_t gen_arg(ssz_t, int);
 void gen_emit(dag_node_t *);
 const char *gen_sfmt(size_t, const char *, ...);
+void gen_free(void);
+void gen_close(void);
 
 /* common cost functions */
 int gen_move(dag_node_t *);
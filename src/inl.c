@@ -0,0 +1,541 @@
+/*
+ *  inline expansion
+ */
+
+#include <stddef.h>        /* NULL */
+#include <stdio.h>         /* fprintf, stderr */
+#include <cbl/arena.h>     /* arena_t, ARENA_NEW, ARENA_ALLOC, ARENA_DISPOSE */
+#include <cbl/assert.h>    /* assert */
+
+#include "common.h"
+#include "dag.h"
+#include "decl.h"
+#include "err.h"
+#include "init.h"
+#include "ir.h"
+#include "lex.h"
+#include "main.h"
+#include "op.h"
+#include "simp.h"
+#include "stmt.h"
+#include "strg.h"
+#include "sym.h"
+#include "tree.h"
+#include "ty.h"
+#include "inl.h"
+
+#define MAXNODE 32    /* max # of tree nodes in function body to inline */
+
+#define S(p) ((sym_t *)(p))    /* shorthand for cast to sym_t * */
+
+
+/* function retained for inlining */
+typedef struct inl_t {
+    sym_t *f;                   /* function */
+    tree_t **stmt;              /* expression statements before return; in strg_perm */
+    int nstmt;                  /* # of expression statements */
+    tree_t *body;               /* return expression; in strg_perm */
+    sym_t **param;              /* copies of parameters */
+    char *set;                  /* true if parameter assigned */
+    int nparam;                 /* # of parameters */
+    int nuse;                   /* # of references after definition */
+    int ninl;                   /* # of references inlined */
+    void **caller, **callee;    /* (sym_t) parameters for deferred emission */
+    stmt_t *code;               /* code list for deferred emission; NULL if emitted */
+    sym_tab_t *label;           /* label table for deferred emission */
+    arena_t *arena;             /* function arena for deferred emission */
+    struct inl_t *link;         /* next deferred function */
+} inl_t;
+
+
+static inl_t *defer, **tail = &defer;    /* deferred functions */
+
+/* function whose statements are inspected */
+static struct {
+    sym_t *f;                  /* function */
+    int fail;                  /* true if function cannot be inlined */
+    tree_t *stmt[MAXNODE];     /* retained expression statements */
+    int nstmt;                 /* # of retained expression statements */
+    tree_t *body;              /* retained return expression; NULL if none */
+    int nnode;                 /* # of tree nodes retained */
+    sym_t **param;             /* copies of parameters */
+    char *set;                 /* true if parameter assigned */
+    int nparam;                /* # of parameters */
+} cur;
+
+/* trees and symbols mapped while copying */
+static struct {
+    int n;                                     /* # of mapped trees */
+    tree_t *from[MAXNODE], *to[MAXNODE];       /* trees */
+    int nsym;                                  /* # of mapped symbols */
+    sym_t *sfrom[MAXNODE], *sto[MAXNODE];      /* symbols */
+    int fail;                                  /* true if tree cannot be retained */
+} map;
+
+/* statistics */
+static struct {
+    long nfunc;    /* # of functions retained */
+    long ncall;    /* # of calls inlined */
+    long ndrop;    /* # of functions not emitted */
+} stat;
+
+
+/*
+ *  checks if a function can be inlined before its body parsed
+ */
+static int candidate(sym_t *f)
+{
+    void **p;    /* sym_t */
+    ty_t *ty;
+
+    assert(f);
+    assert(TY_ISFUNC(f->type));
+
+    if (main_opt()->olevel == 0 || main_opt()->glevel || f->sclass != LEX_STATIC ||
+        f->type->u.f.oldstyle || ty_variadic(f->type) || decl_retv)
+        return 0;
+    ty = ty_freturn(f->type);
+    if (!TY_ISSCALAR(ty) || TY_ISVOLATILE(ty))
+        return 0;
+    for (p = decl_callee; *p; p++)
+        if (!TY_ISSCALAR(S(*p)->type) || TY_ISVOLATILE(S(*p)->type))
+            return 0;
+
+    return 1;
+}
+
+
+/*
+ *  maps a temporary to its copy
+ */
+static sym_t *mapsym(sym_t *p, arena_t *a)
+{
+    int i;
+    sym_t *q;
+
+    assert(p);
+    assert(a);
+
+    for (i = 0; i < map.nsym; i++)
+        if (map.sfrom[i] == p)
+            return map.sto[i];
+    assert(map.nsym < MAXNODE);
+    if (a == strg_perm) {
+        q = ARENA_ALLOC(strg_perm, sizeof(*q));
+        *q = *p;
+    } else
+        q = sym_new(SYM_KTEMP, p->sclass, p->type, sym_scope);
+    map.sfrom[map.nsym] = p;
+    map.sto[map.nsym++] = q;
+
+    return q;
+}
+
+
+/*
+ *  copies an expression into the permanent arena;
+ *  ind is 1 if p is the operand of OP_INDIR and 2 if p is the destination of OP_ASGN
+ */
+static tree_t *retain(tree_t *p, int ind)
+{
+    int i;
+    tree_t *q;
+
+    if (!p || map.fail)
+        return NULL;
+
+    for (i = 0; i < map.n; i++)
+        if (map.from[i] == p)
+            return map.to[i];
+    if (map.n == MAXNODE || op_type(p->op) == OP_B) {
+        map.fail = 1;
+        return NULL;
+    }
+
+    q = ARENA_ALLOC(strg_perm, sizeof(*q));
+    *q = *p;
+    q->node = NULL;
+    q->pos = NULL;
+    q->orgn = q;
+    q->f.rooted = q->f.checked = 0;
+    map.from[map.n] = p;
+    map.to[map.n++] = q;
+
+    switch(op_generic(p->op)) {
+        case OP_ADDRF:
+            for (i = 0; i < cur.nparam && decl_callee[i] != p->u.sym; i++)
+                continue;
+            if (!ind || i == cur.nparam)
+                map.fail = 1;
+            else {
+                q->u.sym = cur.param[i];
+                if (ind == 2)
+                    cur.set[i] = 1;
+            }
+            break;
+        case OP_ADDRL:
+            if (p->u.sym->f.temporary)
+                q->u.sym = mapsym(p->u.sym, strg_perm);
+            else if (ind && TY_ISSCALAR(p->u.sym->type) && !TY_ISVOLATILE(p->u.sym->type)) {
+                q->u.sym = mapsym(p->u.sym, strg_perm);
+                q->u.sym->sclass = LEX_REGISTER;    /* address never taken */
+            } else
+                map.fail = 1;
+            break;
+        case OP_ADDRG:
+            if (p->u.sym->scope >= SYM_SPARAM)
+                map.fail = 1;
+            break;
+        case OP_COND:
+            if (p->u.sym)
+                q->u.sym = mapsym(p->u.sym, strg_perm);
+            break;
+    }
+    q->kid[0] = retain(p->kid[0], (op_generic(p->op) == OP_INDIR)? 1:
+                                  (op_generic(p->op) == OP_ASGN)? 2: 0);
+    q->kid[1] = retain(p->kid[1], 0);
+    q->kid[2] = retain(p->kid[2], ind);
+
+    return q;
+}
+
+
+/*
+ *  starts inspecting the function being parsed unless already started
+ */
+static void inspect(void)
+{
+    int i;
+
+    assert(decl_cfunc);
+
+    if (cur.f == decl_cfunc)
+        return;
+
+    cur.f = decl_cfunc;
+    cur.nstmt = cur.nnode = 0;
+    cur.body = NULL;
+    if ((cur.fail = !candidate(decl_cfunc)) != 0)
+        return;
+
+    for (i = 0; decl_callee[i]; i++)
+        continue;
+    cur.nparam = i;
+    cur.param = ARENA_ALLOC(strg_perm, (i+1)*sizeof(*cur.param));
+    cur.set = ARENA_CALLOC(strg_perm, i+1, sizeof(*cur.set));
+    for (i = 0; i < cur.nparam; i++) {
+        cur.param[i] = ARENA_ALLOC(strg_perm, sizeof(*cur.param[i]));
+        *cur.param[i] = *S(decl_callee[i]);
+    }
+    cur.param[i] = NULL;
+    map.nsym = map.fail = 0;
+}
+
+
+/*
+ *  retains a statement of the function being inspected;
+ *  trees are mapped afresh for each statement since their memory is reused
+ */
+static tree_t *keep(tree_t *p)
+{
+    assert(p);
+
+    map.n = 0;
+    p = retain(p, 0);
+    if (map.fail || (cur.nnode += map.n) > MAXNODE) {
+        cur.fail = 1;
+        return NULL;
+    }
+
+    return p;
+}
+
+
+/*
+ *  inspects an expression statement or initialization of a local of the function being
+ *  parsed; retains it if the function is a candidate for inlining
+ */
+void (inl_expr)(tree_t *p)
+{
+    assert(p);
+
+    inspect();
+    if (cur.fail)
+        return;
+    if (cur.body || cur.nstmt == MAXNODE) {    /* code after return or too many statements */
+        cur.fail = 1;
+        return;
+    }
+
+    cur.stmt[cur.nstmt++] = keep(p);
+}
+
+
+/*
+ *  inspects a return expression of the function being parsed;
+ *  retains it if the function is a candidate for inlining
+ */
+void (inl_ret)(tree_t *p)
+{
+    assert(p);
+
+    inspect();
+    if (cur.fail || cur.body) {    /* more than one return */
+        cur.fail = 1;
+        return;
+    }
+
+    cur.body = keep(p);
+}
+
+
+/*
+ *  records an inlinable function after its body parsed;
+ *  returns true if emission of the function is deferred
+ */
+int (inl_defer)(sym_t *f, void *caller[], void *callee[])
+{
+    int i, ret = 0;
+    inl_t *p;
+    stmt_t *cp;
+    dag_node_t *r;
+    sym_t *q;
+
+    assert(f);
+    assert(caller);
+    assert(callee);
+
+    if (cur.f != f || cur.fail || !cur.body || err_count() > 0)
+        return 0;
+    /* code has to run straight to the return; labels and branches from control statements
+       come as separate entries while those from conditional expressions stay in forests */
+    for (cp = stmt_head.next; cp; cp = cp->next)
+        switch(cp->kind) {
+            case STMT_ADDRESS:
+            case STMT_SWITCH:
+                return 0;
+            case STMT_LABEL:
+            case STMT_JUMP:
+                if (!ret)
+                    return 0;
+                break;
+            case STMT_GEN:
+                if (ret)
+                    return 0;
+                for (r = cp->u.forest; r; r = r->link)
+                    if (op_generic(r->op) == OP_RET)
+                        ret = 1;
+                break;
+        }
+    if (!ret)
+        return 0;
+
+    p = ARENA_CALLOC(strg_perm, 1, sizeof(*p));
+    p->f = f;
+    p->nstmt = cur.nstmt;
+    p->stmt = ARENA_ALLOC(strg_perm, (cur.nstmt+1)*sizeof(*p->stmt));
+    for (i = 0; i < cur.nstmt; i++)
+        p->stmt[i] = cur.stmt[i];
+    p->body = cur.body;
+    p->param = cur.param;
+    p->set = cur.set;
+    p->nparam = cur.nparam;
+    f->u.f.inl = p;
+    cur.f = NULL;
+    stat.nfunc++;
+
+    if (f->ref > 0 || ((q = sym_lookup(f->name, sym_extern)) != NULL && q->ref > 0))
+        return 0;    /* referenced before definition */
+
+    p->caller = caller;
+    p->callee = callee;
+    p->code = stmt_head.next;
+    p->label = sym_label;
+    p->arena = strg_func;
+    strg_func = ARENA_NEW();
+    *tail = p;
+    tail = &p->link;
+
+    return 1;
+}
+
+
+/*
+ *  counts a reference to a function
+ */
+void (inl_use)(sym_t *p)
+{
+    inl_t *q;
+
+    assert(p);
+    assert(TY_ISFUNC(p->type));
+
+    if (p->scope > SYM_SGLOBAL) {    /* block-scope declaration */
+        sym_t *g = sym_lookup(p->name, sym_global);
+        if (g && g->f.defined)
+            p = g;
+    }
+    if ((q = p->u.f.inl) != NULL)
+        q->nuse++;
+}
+
+
+/*
+ *  copies a retained expression for a call site
+ */
+static tree_t *expand(inl_t *r, tree_t *p, tree_t *arg[], sym_t *t[], tree_pos_t *tpos)
+{
+    int i;
+    tree_t *q;
+
+    assert(r);
+
+    if (!p)
+        return NULL;
+
+    for (i = 0; i < map.n; i++)
+        if (map.from[i] == p)
+            return map.to[i];
+    assert(map.n < MAXNODE);
+
+    if (op_generic(p->op) == OP_INDIR && op_generic(p->kid[0]->op) == OP_ADDRF) {
+        for (i = 0; r->param[i] != p->kid[0]->u.sym; i++)
+            assert(i < r->nparam);
+        if (t[i])
+            q = tree_id(t[i], tpos);
+        else {
+            q = tree_new(arg[i]->op, arg[i]->type, NULL, NULL, tpos);
+            q->u.v = arg[i]->u.v;
+        }
+        map.from[map.n] = p;
+        map.to[map.n++] = q;
+        return q;
+    }
+    if (op_generic(p->op) == OP_ADDRF) {    /* assigned parameter */
+        for (i = 0; r->param[i] != p->u.sym; i++)
+            assert(i < r->nparam);
+        assert(t[i]);
+        q = tree_id(t[i], tpos)->kid[0];
+        map.from[map.n] = p;
+        map.to[map.n++] = q;
+        return q;
+    }
+
+    q = tree_new(p->op, p->type, NULL, NULL, tpos);
+    q->f = p->f;
+    q->u = p->u;
+    if (op_generic(p->op) == OP_ADDRL || (op_generic(p->op) == OP_COND && p->u.sym))
+        q->u.sym = mapsym(p->u.sym, strg_func);
+    map.from[map.n] = p;
+    map.to[map.n++] = q;
+    q->kid[0] = expand(r, p->kid[0], arg, t, tpos);
+    q->kid[1] = expand(r, p->kid[1], arg, t, tpos);
+    q->kid[2] = expand(r, p->kid[2], arg, t, tpos);
+
+    return q;
+}
+
+
+/*
+ *  replaces a call with the retained expression of the callee;
+ *  args is the list of OP_ARG trees and c the call tree constructed from it
+ */
+tree_t *(inl_call)(tree_t *f, tree_t *args, tree_t *c, tree_pos_t *tpos)
+{
+    int i, n;
+    inl_t *r;
+    tree_t *p, *e, *a = NULL;
+    tree_t **arg;
+    sym_t **t;
+
+    assert(f);
+    assert(c);
+    assert(tpos);
+
+    if (op_generic(f->op) != OP_ADDRG || (r = f->u.sym->u.f.inl) == NULL ||
+        sym_scope < SYM_SLOCAL || simp_needconst > 0)
+        return c;
+
+    for (n = 0, p = args; p; p = p->kid[1])
+        n++;
+    if (n != r->nparam || !ty_same(TY_UNQUAL(c->type), TY_UNQUAL(r->body->type)))
+        return c;
+
+    arg = ARENA_ALLOC(strg_func, (n+1)*sizeof(*arg));
+    t = ARENA_ALLOC(strg_func, (n+1)*sizeof(*t));
+    for (i = n, p = args; p; p = p->kid[1]) {
+        assert(op_generic(p->op) == OP_ARG);
+        arg[--i] = p->kid[0];
+    }
+    for (i = 0; i < n; i++) {
+        ty_t *ty = TY_UNQUAL(r->param[i]->type);
+        if (op_generic(arg[i]->op) == OP_CNST && ty_same(arg[i]->type, ty) && !r->set[i])
+            t[i] = NULL;
+        else {
+            t[i] = sym_new(SYM_KTEMP, LEX_REGISTER, ty, sym_scope);
+            e = tree_asgnid(t[i], arg[i], tpos);
+            a = (a)? tree_right(a, e, ty_voidtype, tpos): e;
+        }
+    }
+
+    map.n = map.nsym = 0;
+    for (i = 0; i < r->nstmt; i++) {
+        e = expand(r, r->stmt[i], arg, t, tpos);
+        a = (a)? tree_right(a, e, ty_voidtype, tpos): e;
+    }
+    e = tree_right(a, expand(r, r->body, arg, t, tpos), c->type, tpos);
+    e->orgn = c->orgn;
+    r->ninl++;
+    stat.ncall++;
+
+    return e;
+}
+
+
+/*
+ *  emits deferred functions still referenced
+ */
+void (inl_flush)(void)
+{
+    inl_t *p;
+    arena_t *a;
+    sym_t *f;
+    sym_tab_t *lab;
+
+    a = strg_func;
+    f = decl_cfunc;
+    lab = sym_label;
+    for (p = defer; p; p = p->link) {
+        if (p->nuse > p->ninl && err_count() == 0) {
+            strg_func = p->arena;
+            decl_cfunc = p->f;
+            sym_label = p->label;
+            stmt_head.next = p->code;
+            init_swtoseg(INIT_SEGCODE);
+            ir_cur->function(p->f, p->caller, p->callee, p->f->u.f.ncall);
+        } else
+            stat.ndrop++;
+        p->code = NULL;
+        ARENA_DISPOSE(&p->arena);
+    }
+    defer = NULL;
+    tail = &defer;
+    strg_func = a;
+    decl_cfunc = f;
+    sym_label = lab;
+}
+
+
+/*
+ *  prints statistics for inline expansion
+ */
+void (inl_close)(void)
+{
+    if (!main_opt()->_stat || stat.nfunc == 0)
+        return;
+
+    fprintf(stderr, "inl: %ld function(s), %ld call(s) inlined, %ld not emitted\n", stat.nfunc,
+            stat.ncall, stat.ndrop);
+}
+
+/* end of inl.c */
@@ -0,0 +1,23 @@
+/*
+ *  inline expansion
+ */
+
+#ifndef INL_H
+#define INL_H
+
+#include "sym.h"
+#include "tree.h"
+
+
+void inl_expr(tree_t *);
+void inl_ret(tree_t *);
+int inl_defer(sym_t *, void *[], void *[]);    /* sym_t */
+void inl_use(sym_t *);
+tree_t *inl_call(tree_t *, tree_t *, tree_t *, tree_pos_t *);
+void inl_flush(void);
+void inl_close(void);
+
+
+#endif    /* INL_H */
+
+/* end of inl.h */
@@ -38,6 +38,15 @@ typedef struct ir_t {
         unsigned left_to_right: 1;    /* true if arguments passed from left to right */
         unsigned want_dag:      1;    /* true if no need to undag */
     } f;
+    struct {
+        unsigned char cmp,        /* cost of compare and branch */
+                      table,      /* cost of branch table including range check */
+                      bittest,    /* cost of setup for bit test */
+                      density,    /* min density in percent for branch table */
+                      bits;       /* max span of case values for bit test; 0 if disabled */
+    } swcost;    /* costs for switch lowering when optimizing */
+    unsigned char maxscale;    /* max scale of index folded into address; 1 if none */
+    unsigned char regparm;     /* max # of integer arguments in registers for static functions */
     FILE *out;    /* output file */
 
     void (*symaddr)(sym_t *, sym_t *, ssz_t);              /* sets x of address symbol */
@@ -0,0 +1,268 @@
+/*
+ *  peephole optimizer
+ */
+
+#include <stdarg.h>        /* va_list, va_start, va_end */
+#include <stddef.h>        /* size_t, NULL */
+#include <stdio.h>         /* FILE, putc, fputs, fprintf, stderr */
+#include <string.h>        /* memcpy */
+#include <cbl/arena.h>     /* ARENA_ALLOC, ARENA_CALLOC */
+#include <cbl/assert.h>    /* assert */
+#include <cdsl/hash.h>     /* hash_new, hash_string */
+
+#include "common.h"
+#include "ir.h"
+#include "main.h"
+#include "strg.h"
+#include "peep.h"
+
+/* checks if peephole optimization is on */
+#define ON() (ir_cur->x.peep && main_opt()->olevel > 0)
+
+
+static peep_t head = { PEEP_OTHER, 0, NULL, { NULL, NULL }, NULL, &head, &head };    /* buffer */
+static char *lbuf, *lp;    /* line buffer and current position */
+static size_t lsize;       /* size of line buffer */
+static long *nfire;        /* # of rewrites for each rule */
+
+/* statistics */
+static struct {
+    long nline;    /* # of lines buffered */
+    long nkill;    /* # of lines removed */
+} stat;
+
+
+/*
+ *  parses the line buffer and appends it to the buffer
+ */
+static void append(void)
+{
+    const char *s, *t;
+    char *text;
+    peep_t *p;
+    size_t n;
+    int lev;
+
+    n = lp - lbuf;
+    p = ARENA_ALLOC(strg_func, sizeof(*p));
+    text = ARENA_ALLOC(strg_func, n+1);
+    memcpy(text, lbuf, n);
+    text[n] = '\0';
+    p->text = text;
+    p->kind = PEEP_OTHER;
+    p->nopd = 0;
+    p->op = NULL;
+
+    if (n > 1 && lbuf[n-1] == ':') {
+        p->kind = PEEP_LABEL;
+        p->op = hash_new(lbuf, n-1);
+    } else if (n > 0 && *lbuf != '.' && *lbuf != '#' && *lbuf != ' ' && *lbuf != '\t') {
+        for (s = lbuf; s < lp && *s != ' '; s++)
+            continue;
+        p->kind = PEEP_INST;
+        p->op = hash_new(lbuf, s-lbuf);
+        while (s < lp) {
+            for (t = ++s, lev = 0; s < lp && (lev > 0 || *s != ','); s++)
+                if (*s == '(')
+                    lev++;
+                else if (*s == ')')
+                    lev--;
+            if (s == t || p->nopd == NELEM(p->opd)) {
+                p->kind = PEEP_OTHER;
+                break;
+            }
+            p->opd[p->nopd++] = hash_new(t, s-t);
+        }
+    }
+
+    p->prev = head.prev;
+    p->next = &head;
+    head.prev->next = p;
+    head.prev = p;
+    stat.nline++;
+    lp = lbuf;
+}
+
+
+/*
+ *  puts a character into the line buffer
+ */
+static void addc(int c)
+{
+    if (c == '\n') {
+        append();
+        return;
+    }
+    if (lp == lbuf+lsize) {
+        char *p = ARENA_ALLOC(strg_perm, (lsize)? lsize*2: 128);
+        if (lsize > 0)
+            memcpy(p, lbuf, lsize);
+        lp = p + lsize;
+        lbuf = p;
+        lsize = (lsize)? lsize*2: 128;
+    }
+    *lp++ = c;
+}
+
+
+/*
+ *  emits a character
+ */
+void (peep_putc)(int c)
+{
+    assert(ir_cur);
+
+    if (ON())
+        addc(c);
+    else
+        putc(c, ir_cur->out);
+}
+
+
+/*
+ *  emits a string
+ */
+void (peep_puts)(const char *s)
+{
+    assert(s);
+    assert(ir_cur);
+
+    if (ON())
+        while (*s)
+            addc(*s++);
+    else
+        fputs(s, ir_cur->out);
+}
+
+
+/*
+ *  emits a formatted string;
+ *  only %s, %c and %% are recognized so that the result is emitted in pieces
+ */
+void (peep_printf)(const char *fmt, ...)
+{
+    va_list ap;
+
+    assert(fmt);
+    assert(ir_cur);
+
+    va_start(ap, fmt);
+    for (; *fmt; fmt++)
+        if (*fmt != '%')
+            peep_putc(*fmt);
+        else
+            switch(*++fmt) {
+                case 's':
+                    peep_puts(va_arg(ap, const char *));
+                    break;
+                case 'c':
+                    peep_putc(va_arg(ap, int));
+                    break;
+                default:
+                    assert(*fmt == '%');
+                    peep_putc('%');
+                    break;
+            }
+    va_end(ap);
+}
+
+
+/*
+ *  removes a line from the buffer
+ */
+void (peep_remove)(peep_t *p)
+{
+    assert(p && p != &head);
+
+    p->prev->next = p->next;
+    p->next->prev = p->prev;
+    stat.nkill++;
+}
+
+
+/*
+ *  rewrites an instruction;
+ *  operands have to be hashed
+ */
+void (peep_set)(peep_t *p, const char *op, const char *a, const char *b)
+{
+    assert(p && p->kind == PEEP_INST);
+    assert(op);
+    assert(a || !b);
+
+    p->op = hash_string(op);
+    p->opd[0] = a;
+    p->opd[1] = b;
+    p->nopd = (b)? 2: (a)? 1: 0;
+    p->text = NULL;
+}
+
+
+/*
+ *  applies rewrite rules to the buffer and writes it out;
+ *  has to be called before anything is emitted bypassing the buffer
+ */
+void (peep_flush)(void)
+{
+    int i, chg;
+    peep_t *p;
+    const peep_rule_t *r;
+    FILE *out;
+
+    assert(ir_cur);
+
+    if (lp > lbuf)    /* unterminated line */
+        append();
+    if (head.next == &head)
+        return;
+
+    assert(ir_cur->x.peep);
+    if (!nfire) {
+        for (r = ir_cur->x.peep; r->name; r++)
+            continue;
+        nfire = ARENA_CALLOC(strg_perm, r - ir_cur->x.peep + 1, sizeof(*nfire));
+    }
+    do {
+        chg = 0;
+        for (p = head.next; p != &head; p = p->next)
+            for (r = ir_cur->x.peep; p->kind == PEEP_INST && r->name; r++)
+                if (r->f(p)) {
+                    nfire[r - ir_cur->x.peep]++;
+                    chg = 1;
+                    break;
+                }
+    } while(chg);
+
+    out = ir_cur->out;
+    for (p = head.next; p != &head; p = p->next) {
+        if (p->text)
+            fputs(p->text, out);
+        else {
+            fputs(p->op, out);
+            for (i = 0; i < p->nopd; i++) {
+                putc((i == 0)? ' ': ',', out);
+                fputs(p->opd[i], out);
+            }
+        }
+        putc('\n', out);
+    }
+    head.next = head.prev = &head;
+}
+
+
+/*
+ *  prints statistics for peephole optimization
+ */
+void (peep_close)(void)
+{
+    const peep_rule_t *r;
+
+    if (!main_opt()->_stat || !nfire)
+        return;
+
+    fprintf(stderr, "peep: %ld line(s), %ld removed\n", stat.nline, stat.nkill);
+    for (r = ir_cur->x.peep; r->name; r++)
+        fprintf(stderr, "peep: %-12s %ld rewrite(s)\n", r->name, nfire[r - ir_cur->x.peep]);
+}
+
+/* end of peep.c */
@@ -0,0 +1,46 @@
+/*
+ *  peephole optimizer
+ */
+
+#ifndef PEEP_H
+#define PEEP_H
+
+#include <stddef.h>    /* size_t */
+
+
+/* kinds of buffered lines */
+enum {
+    PEEP_INST,     /* instruction */
+    PEEP_LABEL,    /* label */
+    PEEP_OTHER     /* directive or unrecognized line; barrier to rules */
+};
+
+/* buffered line */
+typedef struct peep_t {
+    int kind;                      /* PEEP_INST, PEEP_LABEL or PEEP_OTHER */
+    int nopd;                      /* # of operands */
+    const char *op;                /* opcode or label; hashed */
+    const char *opd[2];            /* operands; hashed */
+    const char *text;              /* text to emit; NULL if rewritten */
+    struct peep_t *prev, *next;    /* links */
+} peep_t;
+
+/* rewrite rule */
+typedef struct peep_rule_t {
+    const char *name;      /* rule name */
+    int (*f)(peep_t *);    /* rewrites from instruction; returns true if changed */
+} peep_rule_t;
+
+
+void peep_putc(int);
+void peep_puts(const char *);
+void peep_printf(const char *, ...);
+void peep_flush(void);
+void peep_remove(peep_t *);
+void peep_set(peep_t *, const char *, const char *, const char *);
+void peep_close(void);
+
+
+#endif    /* PEEP_H */
+
+/* end of peep.h */
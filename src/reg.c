@@ -2,8 +2,10 @@
  *  register
  */
 
+#include <limits.h>        /* INT_MAX */
 #include <stdarg.h>        /* va_list, va_start, va_arg, va_end */
 #include <stddef.h>        /* NULL */
+#include <stdlib.h>        /* qsort */
 #include <string.h>        /* strlen, memset, memcpy */
 #include <cbl/arena.h>     /* arena_t, ARENA_CALLOC */
 #include <cbl/assert.h>    /* assert */
@@ -17,8 +19,10 @@
 #include "gen.h"
 #include "ir.h"
 #include "lex.h"
+#include "main.h"
 #include "op.h"
 #include "reg.h"
+#include "stmt.h"
 #include "strg.h"
 #include "sym.h"
 #include "ty.h"
@@ -51,6 +55,23 @@ reg_mask_t *reg_fmask[REG_SMAX],    /* free register mask */
            *reg_vmask[REG_SMAX];    /* register variable mask */
 
 
+/* live interval of register variable */
+struct live {
+    sym_t *sym;      /* register variable */
+    int beg, end;    /* first and last positions referenced */
+    sym_t *r;        /* register assigned */
+};
+
+/* branch */
+struct edge {
+    int from, to;    /* positions of branch and destination */
+    sym_t *lab;      /* destination label */
+};
+
+static struct live *live;              /* live intervals for current function */
+static reg_mask_t *kill[REG_SMAX];     /* registers killed in current function */
+
+
 #ifndef NDEBUG
 /* internal functions referenced forwardly */
 static void printbv(reg_mask_t *[], FILE *);
@@ -336,6 +357,13 @@ int (reg_askvar)(sym_t *s, sym_t *rs)
         s->x.name = "?";
         return 1;
     }
+    if (s->x.regnode) {    /* assigned by reg_scan() */
+        maskoff(reg_fmask[s->x.regnode->set], s->x.regnode->bv);
+        maskon(reg_umask[s->x.regnode->set], s->x.regnode->bv);
+        s->x.regnode->vbl = s;
+        DEBUG(printreg(stderr, "= binding %s to %s\n", s->x.name, s->name));
+        return 1;
+    }
     if ((r=askreg(rs, reg_vmask, NULL)) != NULL) {
         s->x.regnode = r->x.regnode;
         s->x.regnode->vbl = s;
@@ -385,6 +413,305 @@ int (reg_shares)(const sym_t *s, const sym_t *t)
 }
 
 
+/*
+ *  checks if a symbol is a candidate for register variable
+ */
+static int candidate(const sym_t *p)
+{
+    assert(p);
+
+    return (p->sclass == LEX_REGISTER && TY_ISSCALAR(p->type) && !p->u.t.cse);
+}
+
+
+/*
+ *  extends live intervals for variables a dag refers to and collects registers killed
+ */
+static void refer(const dag_node_t *p, int pos)
+{
+    int i;
+    const reg_mask_t *m;
+
+    if (!p)
+        return;
+
+    if ((op_generic(p->op) == OP_ADDRL || op_generic(p->op) == OP_ADDRF) &&
+        p->sym[0]->x.live > 0) {
+        struct live *l = &live[p->sym[0]->x.live-1];
+        if (pos < l->beg)
+            l->beg = pos;
+        if (pos > l->end)
+            l->end = pos;
+    }
+    for (i = 0; i < REG_SMAX; i++)
+        if ((m = ir_cur->x.vkill(p->op, i)) != NULL)
+            maskon(kill[i], m);
+    for (i = 0; i < NELEM(p->kid); i++)
+        refer(p->kid[i], pos);
+}
+
+
+/*
+ *  estimates the number of registers to evaluate a dag;
+ *  a shared node is counted as a register held over the whole forest and division takes
+ *  at least three as usually done with a register pair
+ */
+static int need(const dag_node_t *p, int *pn)
+{
+    int l, r;
+
+    assert(pn);
+
+    if (!p)
+        return 0;
+    if (p->count > 1) {
+        (*pn)++;
+        return 1;
+    }
+    l = need(p->kid[0], pn);
+    r = need(p->kid[1], pn);
+    l = (l == r)? l+1: (l > r)? l: r;
+    if ((op_generic(p->op) == OP_DIV || op_generic(p->op) == OP_MOD) && l < 3)
+        l = 3;
+
+    return l;
+}
+
+
+/*
+ *  checks if an interval leaves enough temporary registers when it gets a register;
+ *  v, if not NULL, is an interval to give its register up
+ */
+static int fits(const struct live *l, const struct live *v, const int *cnt, const int *press,
+                int ntmp)
+{
+    int i;
+
+    assert(l);
+    assert(cnt);
+    assert(press);
+
+    for (i = l->beg; i <= l->end; i++)
+        if (cnt[i] - (v && i >= v->beg && i <= v->end) + 1 + press[i] > ntmp)
+            return 0;
+
+    return 1;
+}
+
+
+/*
+ *  compares live intervals by their starting positions
+ */
+static int cmplive(const void *p, const void *q)
+{
+    const struct live *l = p,
+                      *m = q;
+
+    return (l->beg < m->beg)? -1: (l->beg > m->beg)? 1:
+           (l->sym->ref > m->sym->ref)? -1: (l->sym->ref < m->sym->ref)? 1: 0;
+}
+
+
+/*
+ *  assigns registers to variables of the current function by scanning their live
+ *  intervals in linear order;
+ *  a variable is live from its first reference to its last one on the code list, extended
+ *  over loops (backward branches) overlapping with that range; when registers run out, the
+ *  variable with the least weight (sym_t.ref already scaled by loop depth) goes to memory;
+ *  variables assigned here are bound to their registers by reg_askvar()
+ */
+void (reg_scan)(void)
+{
+    int i, j, n, m, pos, lo, hi, chg;
+    stmt_t *cp;
+    dag_node_t *p;
+    sym_t *rs, **q;
+    int *lpos, *cnt, *press;
+    struct edge *e;
+    struct live *l, **act;
+
+    assert(ir_cur);
+
+    if (main_opt()->olevel == 0 || !ir_cur->x.vkill)
+        return;
+
+    /* collects candidates, labels and branches */
+    n = m = pos = 0, lo = INT_MAX, hi = 0;
+    for (cp = stmt_head.next; cp; cp = cp->next, pos++)
+        switch(cp->kind) {
+            case STMT_BLOCKBEG:
+                for (q = (sym_t **)cp->u.block.local; *q; q++)
+                    n += candidate(*q);
+                break;
+            case STMT_LOCAL:
+                n += candidate(cp->u.var);
+                break;
+            case STMT_LABEL:
+            case STMT_GEN:
+            case STMT_JUMP:
+                for (p = cp->u.forest; p; p = p->link, m++)
+                    if (op_generic(p->op) == OP_LABEL) {
+                        if (p->sym[0]->u.l.label < lo)
+                            lo = p->sym[0]->u.l.label;
+                        if (p->sym[0]->u.l.label > hi)
+                            hi = p->sym[0]->u.l.label;
+                    }
+                break;
+            case STMT_SWITCH:
+                m += cp->u.swtch.size + 1;
+                break;
+        }
+    if (n == 0)
+        return;
+
+    live = ARENA_CALLOC(strg_func, n, sizeof(*live));
+    e = ARENA_ALLOC(strg_func, (m+1) * sizeof(*e));
+    lpos = (lo <= hi)? ARENA_CALLOC(strg_func, hi-lo+1, sizeof(*lpos)): NULL;
+    cnt = ARENA_CALLOC(strg_func, pos, sizeof(*cnt));
+    press = ARENA_CALLOC(strg_func, pos, sizeof(*press));
+    for (i = 0; i < REG_SMAX; i++)
+        kill[i] = newbitv(strg_func);
+
+#define ADD(s) do {                                                     \
+                   if (candidate(s)) {                                  \
+                       live[n].sym = (s), live[n].beg = INT_MAX;        \
+                       live[n].end = -1, (s)->x.live = ++n;             \
+                   }                                                    \
+               } while(0)
+
+    /* computes references, label positions and branches */
+    n = m = pos = 0;
+    for (cp = stmt_head.next; cp; cp = cp->next, pos++)
+        switch(cp->kind) {
+            case STMT_BLOCKBEG:
+                for (q = (sym_t **)cp->u.block.local; *q; q++)
+                    ADD(*q);
+                break;
+            case STMT_LOCAL:
+                ADD(cp->u.var);
+                break;
+            case STMT_LABEL:
+            case STMT_GEN:
+            case STMT_JUMP:
+                for (p = cp->u.forest; p; p = p->link) {
+                    j = 0;
+                    i = need(p, &j) + j;
+                    if (i > press[pos])
+                        press[pos] = i;
+                    if (op_generic(p->op) == OP_LABEL)
+                        lpos[p->sym[0]->u.l.label-lo] = pos + 1;
+                    else if (op_generic(p->op) == OP_JMP) {
+                        if (op_generic(p->kid[0]->op) == OP_ADDRG)
+                            e[m].from = pos, e[m++].lab = p->kid[0]->sym[0];
+                    } else if (OP_ISCMP(p->op))
+                        e[m].from = pos, e[m++].lab = p->sym[0];
+                    refer(p, pos);
+                }
+                break;
+            case STMT_SWITCH:
+                for (i = 0; i < cp->u.swtch.size; i++)
+                    e[m].from = pos, e[m++].lab = cp->u.swtch.label[i];
+                e[m].from = pos, e[m++].lab = cp->u.swtch.deflab;
+                break;
+        }
+
+#undef ADD
+
+    /* keeps backward branches only */
+    for (i = j = 0; i < m; i++) {
+        sym_t *t = e[i].lab;
+        while (t->u.l.equatedto)
+            t = t->u.l.equatedto;
+        pos = (t->u.l.label >= lo && t->u.l.label <= hi && lpos[t->u.l.label-lo])?
+                  lpos[t->u.l.label-lo] - 1: 0;    /* unknown destination spans function */
+        if (pos <= e[i].from) {
+            e[j].from = e[i].from;
+            e[j++].to = pos;
+        }
+    }
+    m = j;
+
+    /* extends intervals over loops */
+    do {
+        chg = 0;
+        for (l = live; l < live+n; l++)
+            for (i = 0; l->beg <= l->end && i < m; i++)
+                if (l->beg <= e[i].from && l->end >= e[i].to &&
+                    (e[i].to < l->beg || e[i].from > l->end)) {
+                    if (e[i].to < l->beg)
+                        l->beg = e[i].to;
+                    if (e[i].from > l->end)
+                        l->end = e[i].from;
+                    chg = 1;
+                }
+    } while(chg);
+
+    /* scans intervals */
+    qsort(live, n, sizeof(*live), cmplive);
+    act = ARENA_CALLOC(strg_func, REG_SMAX * ir_cur->x.nreg, sizeof(*act));
+    for (l = live; l < live+n; l++) {
+        int ntmp = 0;
+        struct live *v = NULL;
+        if (l->beg > l->end || (rs = ir_cur->x.rmapw(op_sfx(l->sym->type))) == NULL ||
+            !rs->x.wildcard)
+            continue;
+        for (i = 0; i < ir_cur->x.nreg; i++)
+            if (rs->x.wildcard[i] &&
+                !inuse(rs->x.wildcard[i]->x.regnode->bv,
+                       reg_tmask[rs->x.wildcard[i]->x.regnode->set]))
+                ntmp++;
+        for (i = ir_cur->x.nreg-1; i >= 0; i--) {
+            sym_t *r = rs->x.wildcard[i];
+            struct live **a;
+            if (!r)
+                continue;
+            assert(r->x.regnode);
+            if (inuse(r->x.regnode->bv, reg_vmask[r->x.regnode->set]) ||
+                sharem(r->x.regnode->bv, kill[r->x.regnode->set]))
+                continue;
+            a = &act[r->x.regnode->set*ir_cur->x.nreg + r->x.regnode->num];
+            if (*a && (*a)->end < l->beg)
+                *a = NULL;
+            if (!*a) {
+                if (fits(l, NULL, cnt, press, ntmp)) {
+                    l->r = r;
+                    *a = l;
+                }
+                break;
+            }
+            if (!v || (*a)->sym->ref < v->sym->ref)
+                v = *a;
+        }
+        if (!l->r && v && v->sym->ref < l->sym->ref && fits(l, v, cnt, press, ntmp)) {
+            sym_t *r = v->r;
+            for (i = v->beg; i <= v->end; i++)
+                cnt[i]--;
+            l->r = rs->x.wildcard[r->x.regnode->num];
+            v->r = NULL;
+            act[r->x.regnode->set*ir_cur->x.nreg + r->x.regnode->num] = l;
+        }
+        if (l->r)
+            for (i = l->beg; i <= l->end; i++)
+                cnt[i]++;
+    }
+
+    /* applies result */
+    for (l = live; l < live+n; l++) {
+        l->sym->x.live = 0;
+        if (l->r) {
+            l->sym->x.regnode = l->r->x.regnode;
+            l->sym->x.name = l->r->x.name;
+            DEBUG(fprintf(stderr, "= scan: %s [%d, %d] to %s\n", l->sym->name, l->beg, l->end,
+                          l->r->x.name));
+        } else {
+            l->sym->sclass = LEX_AUTO;
+            DEBUG(fprintf(stderr, "= scan: %s [%d, %d] to memory\n", l->sym->name, l->beg,
+                          l->end));
+        }
+    }
+}
+
+
 /*
  *  sets the precluding mask
  */
@@ -438,6 +765,32 @@ void (reg_pmask)(dag_node_t *p)
 }
 
 
+/*
+ *  moves the precluding mask set by reg_ptarget() on a cse use to the first use of the cse
+ */
+void (reg_pmcse)(dag_node_t *p)
+{
+    sym_t *s;
+    dag_node_t *f;
+
+    assert(p);
+    assert(p->x.pmask);
+
+    s = p->sym[REG_RX];
+    assert(s && s->u.t.cse);
+    if (!s->x.lastuse)
+        return;
+    FIRSTUSE(s, f);
+    if (f == p)
+        return;
+    DEBUG(fprintf(stderr, "= pmask first use (%p) for (%p)\n", (void *)f, (void *)p));
+    if (!f->x.pmask)
+        f->x.pmask = reg_mbackup(p->x.pmask);
+    else
+        maskon(f->x.pmask, p->x.pmask);
+}
+
+
 /*
  *  checks if a dag node uses a register
  */
@@ -593,11 +946,13 @@ static void reprune(dag_node_t *p, const dag_node_t *k, dag_node_t *q)
 static void genreload(dag_node_t *p, sym_t *t, int i)
 {
     int ty;
+    sym_t *s;
     dag_node_t *q, *dummy;
 
     assert(p);
     assert(p->x.kid[i]);
     assert(t);
+    assert(ir_cur);
 
     DEBUG(fputs(">> genreload starts\n", stderr));
     DEBUG(fprintf(stderr, "= replacing %p with reload from %s\n", (void *)p->x.kid[i], t->x.name));
@@ -614,6 +969,11 @@ static void genreload(dag_node_t *p, sym_t *t, int i)
 
     gen_rewrite(q);
     gen_prune(q, &dummy, &dummy+1);
+    s = p->sym[REG_RX];
+    if (i > 0 && s && !s->x.wildcard && !s->u.t.cse && !REG_ISRVAR(s) &&
+        s->x.regnode->set == ir_cur->x.rmaps(p->op) &&
+        ir_cur->x.rule[p->x.rn[p->x.inst]].tmpl[0] == '?')
+        reg_pmset(q, s);    /* as reg_pmask() did for spilled cse */
     reprune(p, p->x.kid[i], q);
     gen_prune(p, &dummy, &dummy+1);
     gen_linearize(p->x.kid[i], p);
@@ -623,6 +983,22 @@ static void genreload(dag_node_t *p, sym_t *t, int i)
 }
 
 
+/*
+ *  checks if q is listed after p
+ */
+static int follows(const dag_node_t *p, const dag_node_t *q)
+{
+    assert(p);
+    assert(q);
+
+    while ((p = p->x.next) != NULL)
+        if (p == q)
+            return 1;
+
+    return 0;
+}
+
+
 /*
  *  frees a register
  */
@@ -636,15 +1012,78 @@ static void putreg(const sym_t *r)
 }
 
 
+/*
+ *  keeps a register allocated past its last use or releases it;
+ *  used for values that stay in registers with no node to use them, e.g., arguments
+ */
+void (reg_hold)(const sym_t *r, int hold)
+{
+    assert(r);
+    assert(r->x.regnode);
+
+    if (hold) {
+        maskoff(reg_fmask[r->x.regnode->set], r->x.regnode->bv);
+        maskon(reg_umask[r->x.regnode->set], r->x.regnode->bv);
+        DEBUG(printreg(stderr, " - held %s\n", r->x.name));
+    } else
+        putreg(r);
+}
+
+
+/*
+ *  removes an instruction listed after the spilling node s and those for its operands;
+ *  registers losing their last uses are freed if already allocated;
+ *  only checks if possible when dry is set
+ */
+static int unlist(dag_node_t *p, const dag_node_t *s, int dry)
+{
+    int i;
+
+    assert(p);
+    assert(s);
+
+    FORXKIDS(p, 0) {
+        dag_node_t *k = p->x.kid[i];
+        sym_t *r = k->sym[REG_RX];
+        assert(r);
+        if (!READ(k) && follows(s, k)) {
+            if (!unlist(k, s, dry))
+                return 0;
+        } else if (r->x.lastuse == k) {
+            if (!k->x.f.registered) {
+                if (!k->x.prevuse)    /* cse computed later */
+                    return 0;
+            } else if (REG_ISRVAR(r))
+                continue;
+            if (!dry) {
+                r->x.lastuse = k->x.prevuse;
+                if (k->x.f.registered && (!r->x.lastuse || !follows(s, r->x.lastuse)))
+                    putreg(r);
+            }
+        }
+    }
+    if (!dry) {
+        assert(p->x.prev && p->x.next);
+        DEBUG(fprintf(stderr, "= unlisting %p\n", (void *)p));
+        p->x.prev->x.next = p->x.next;
+        p->x.next->x.prev = p->x.prev;
+    }
+
+    return 1;
+}
+
+
 /*
  *  spills a register;
- *  spilling renders x.lastuse useless; see equate() from gen.c
+ *  spilling renders x.lastuse useless; see equate() from gen.c;
+ *  copies for cse from reuse() in gen.c listed after p are dropped since they would
+ *  overwrite the freed register
  */
 static void spillr(sym_t *r, dag_node_t *p)
 {
     int i;
     sym_t *t;
-    dag_node_t *f;
+    dag_node_t *f, *q;
 
     assert(r);
     assert(p);
@@ -669,12 +1108,15 @@ static void spillr(sym_t *r, dag_node_t *p)
 #endif    /* !NDEBUG */
     t = sym_new(SYM_KTEMPB, LEX_AUTO, f->op);
     genspill(r, f, t);
-    while ((p = p->x.next) != NULL)
-        FORXKIDS(p, 0) {
-            dag_node_t *k = p->x.kid[i];
+    for (q = p; (q = q->x.next) != NULL; )
+        FORXKIDS(q, 0) {
+            dag_node_t *k = q->x.kid[i];
             if (k->x.f.registered && k->sym[REG_RX] == r)
-                genreload(p, t, i);
+                genreload(q, t, i);
         }
+    for (q = p; (q = q->x.next) != NULL; )
+        if (q->x.f.registered && q->sym[REG_RX] == r && !READ(q) && unlist(q, p, 1))
+            unlist(q, p, 0);
     putreg(r);
 }
 
@@ -720,7 +1162,7 @@ static sym_t *getreg(sym_t *rs, reg_mask_t *ms[], reg_mask_t *em[], dag_node_t *
         assert(r);
     }
     assert(r->x.regnode);
-    assert(!r->x.regnode->vbl);
+    r->x.regnode->vbl = NULL;    /* variable out of scope */
 
     return r;
 }
@@ -801,7 +1243,8 @@ void (reg_alloc)(dag_node_t *p)
             DEBUG(printreg(stderr, " - allocated %s to %p\n", r->x.name, (void *)p));
         } else {    /* register variable or pseudo one from spill */
             assert(sym->x.regnode && (sym->x.regnode->vbl == sym ||
-                                      sym->x.regnode->vbl->name == sym->x.name));
+                                      sym->x.regnode->vbl->name == sym->x.name ||
+                                      REG_FORRVAR(sym, sym)));    /* shared by reg_scan() */
             DEBUG(fprintf(stderr, " - %s targeted to %p\n", sym->x.name, (void *)p));
 #ifndef NDEBUG
             if (ir_cur->x.rule[p->x.rn[p->x.inst]].tmpl[0] == '?' &&
@@ -858,7 +1301,8 @@ static void addload(dag_node_t *p, int n, sym_t *r)
     assert(r);
 
     q = p->kid[n];
-    assert(q->count == 1);
+    assert(q->count == 1 ||
+           (op_generic(q->op) == OP_INDIR && q->kid[0]->op == OP_VREGP));    /* register variable */
     q = dag_newnode(OP_LOAD+op_tyscode(q->op), q, NULL, q->sym[0]);
     q->count = 1;
     if (r->u.t.cse == p->kid[n])
@@ -867,6 +1311,21 @@ static void addload(dag_node_t *p, int n, sym_t *r)
 }
 
 
+/*
+ *  checks if a dag reads a register variable in operands other than the leftmost ones;
+ *  a '?' template targeted to the variable would overwrite it before reading them
+ */
+static int reads(const dag_node_t *p, const sym_t *r, int left)
+{
+    if (!p)
+        return 0;
+    if (READ(p))
+        return (!left && p->kid[0]->sym[0] == r);
+
+    return (reads(p->kid[0], r, left) || reads(p->kid[1], r, 0));
+}
+
+
 /*
  *  performs register targetting
  */
@@ -877,7 +1336,8 @@ void (reg_target)(dag_node_t *p, int n, sym_t *r)
     assert(r);
     assert(r->sclass == LEX_REGISTER || !r->x.wildcard);
 
-    if (p->kid[n]->sym[REG_RX] && r != p->kid[n]->sym[REG_RX])
+    if ((p->kid[n]->sym[REG_RX] && r != p->kid[n]->sym[REG_RX]) ||
+        (r->x.regnode && REG_ISRVAR(r) && reads(p->kid[n], r, 1)))
         addload(p, n, r);
     reg_set(p->kid[n], r);
     DEBUG(fprintf(stderr, "= target (%p)->x.kid[%d] = (%p) to %s\n",
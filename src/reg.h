@@ -44,8 +44,11 @@ sym_t *reg_new(const char *, int, int, ...);
 sym_t *reg_wildcard(sym_t *[]);
 int reg_askvar(sym_t *, sym_t *);
 int reg_shares(const sym_t *, const sym_t *);
+void reg_scan(void);
 void reg_pmset(dag_node_t *, const sym_t *);
 void reg_pmask(dag_node_t *);
+void reg_pmcse(dag_node_t *);
+void reg_hold(const sym_t *, int);
 void reg_spill(const reg_mask_t *, int, dag_node_t *);
 void reg_alloc(dag_node_t *);
 void reg_set(dag_node_t *, sym_t *);
@@ -56,7 +59,9 @@ void reg_ptarget(dag_node_t *, int, sym_t *);
 
 /* checks if symbol/register is allocated for variable */
 #define REG_ISRVAR(s)     ((s)->x.regnode->vbl)
-#define REG_FORRVAR(s, t) ((s)->x.regnode->vbl == (t))
+#define REG_FORRVAR(s, t) ((s)->x.regnode->vbl == (t) ||                                \
+                           ((s)->x.regnode->vbl && (t) && (t)->sclass &&                 \
+                            (s)->x.regnode == (t)->x.regnode))
 
 /* checks if dag node needs register;
    ASSUMPTION: CALL and LOAD are only ops that can take registers on root */
@@ -4,11 +4,9 @@
 
 #include <limits.h>        /* INT_MAX */
 #include <stddef.h>        /* NULL */
+#include <stdio.h>         /* FILE, fprintf, fputs, putc, stderr */
 #include <cbl/arena.h>     /* ARENA_ALLOC, ARENA_FREE */
 #include <cbl/assert.h>    /* assert */
-#ifndef NDEBUG
-#include <stdio.h>         /* FILE, fprintf, fputs */
-#endif    /* !NDEBUG */
 
 #include "clx.h"
 #include "common.h"
@@ -17,6 +15,7 @@
 #include "enode.h"
 #include "err.h"
 #include "expr.h"
+#include "inl.h"
 #include "ir.h"
 #include "lex.h"
 #include "main.h"
@@ -35,6 +34,9 @@
    ASSUMPTION: signed overflow wraps around on the host */
 #define DENSITY(i, j) (((j)-(i)+1.0)/xcsf(xas(xss(v[j], v[i]), xI)))
 
+/* computes span of case values in cluster */
+#define SPAN(i, j) (xsu(xctu(v[j]), xctu(v[i])))
+
 /* checks if cp denotes unconditional jump */
 #define UNCONDJMP(cp) ((cp)->kind == STMT_JUMP || (cp)->kind == STMT_SWITCH)
 
@@ -55,6 +57,19 @@ struct stmt_swtch_t {
     const lmap_t *pos;    /* locus of switch statement */
 };
 
+/* kinds of switch clusters */
+enum {
+    SW_COMPARE,    /* compare chain */
+    SW_TABLE,      /* branch table */
+    SW_BITTEST     /* bit test against masks */
+};
+
+/* cluster of case values */
+struct swclus {
+    int kind;    /* SW_COMPARE, SW_TABLE or SW_BITTEST */
+    int l, u;    /* range of indices into case array */
+};
+
 /* to diagnose ambiguous else */
 struct aelse {
     int amb;              /* flag to track elses */
@@ -67,6 +82,15 @@ stmt_t *stmt_list = &stmt_head;       /* statement list */
 double stmt_density = 0.5;            /* density for branch table */
 sym_tab_t *stmt_lab;                  /* symbol table for source-code label */
 
+/* costs for switch lowering; see ir_t */
+static struct {
+    int cmp;           /* cost of compare and branch */
+    int table;         /* cost of branch table */
+    int bittest;       /* cost of setup for bit test */
+    int bits;          /* max span for bit test; 0 if disabled */
+    double density;    /* min density for branch table */
+} swcost;
+
 
 /*
  *  parses an expression and make it a conditional;
@@ -358,7 +382,9 @@ static void forstmt(int lab, stmt_swtch_t *swp, int lev, struct aelse *paelse)
 
 
 /*
- *  generates a code list that compares two integers
+ *  generates a code list that compares two integers;
+ *  compared in the type of p to agree with the order of case values;
+ *  ASSUMPTION: signed/unsigned integers are compatible on the host
  */
 static void cmp(int op, sym_t *p, sx_t n, int lab, tree_pos_t *tpos)
 {
@@ -368,8 +394,96 @@ static void cmp(int op, sym_t *p, sx_t n, int lab, tree_pos_t *tpos)
     assert(lab > 0);
     assert(ty_longtype);    /* ensures types initialized */
 
-    ty = ty_scounter(TY_UNQUAL(p->type));
-    dag_listnode(tree_cmp(op, tree_id(p, tpos), tree_sconst(n, ty, tpos), ty, tpos), lab, 0);
+    ty = TY_RMQENUM(p->type);
+    if (op == OP_LT && TY_ISUNSIGN(ty) && xe(n, xO))
+        return;    /* never taken */
+    dag_listnode(tree_cmp(op, tree_id(p, tpos),
+                          (TY_ISUNSIGN(ty))? tree_uconst(xctu(n), ty, tpos):
+                                             tree_sconst(n, ty, tpos),
+                          ty, tpos),
+                 lab, 0);
+}
+
+
+/*
+ *  finds the final target of a case label
+ */
+static sym_t *target(sym_t *p)
+{
+    assert(p);
+
+    while (p->u.l.equatedto)
+        p = p->u.l.equatedto;
+
+    return p;
+}
+
+
+/*
+ *  counts distinct targets of case labels
+ */
+static int ntarget(const stmt_swtch_t *swp, int l, int u)
+{
+    int i, j, n;
+
+    assert(swp);
+    assert(l >= 0 && u >= l);
+
+    for (n = 0, i = l; i <= u; i++) {
+        for (j = l; j < i && target(swp->label[j]) != target(swp->label[i]); j++)
+            continue;
+        if (j == i)
+            n++;
+    }
+
+    return n;
+}
+
+
+/*
+ *  generates a code list that tests a bit for each target;
+ *  ASSUMPTION: signed/unsigned integers are compatible on the host
+ */
+static void bittest(stmt_swtch_t *swp, int l, int u, tree_pos_t *tpos)
+{
+    sx_t *v;
+    int i, j;
+    ux_t mask;
+    sym_t *t;
+
+    assert(swp);
+    assert(l >= 0 && u >= l);
+    assert(ty_ulongtype);    /* ensures types initialized */
+
+    v = swp->value;    /* used in SPAN() */
+    t = sym_new(SYM_KGEN, LEX_REGISTER, ty_ulongtype, sym_scope);
+    stmt_local(t);
+    dag_walk(tree_asgnid(t,
+                 tree_sha(OP_LSH,
+                     tree_uconst(xiu(1), ty_ulongtype, tpos),
+                     tree_sub(OP_SUB,
+                         enode_cast(tree_id(swp->sym, tpos), ty_longtype, 0, NULL),
+                         tree_sconst(v[l], ty_longtype, tpos), NULL, tpos),
+                     ty_ulongtype, tpos),
+                 tpos),
+             0, 0);
+    for (i = l; i <= u; i++) {
+        for (j = l; j < i && target(swp->label[j]) != target(swp->label[i]); j++)
+            continue;
+        if (j < i)    /* already tested */
+            continue;
+        mask = xO;
+        for (; j <= u; j++)
+            if (target(swp->label[j]) == target(swp->label[i]))
+                mask = xbo(mask, xsl(xiu(1), xnu(SPAN(l, j))));
+        dag_listnode(tree_cmp(OP_NE,
+                         tree_bit(OP_BAND, tree_id(t, tpos),
+                                  tree_uconst(mask, ty_ulongtype, tpos),
+                                  ty_ulongtype, tpos),
+                         tree_uconst(xO, ty_ulongtype, tpos),
+                         ty_ulongtype, tpos),
+                     swp->label[i]->u.l.label, 0);
+    }
 }
 
 
@@ -378,7 +492,7 @@ static void cmp(int op, sym_t *p, sx_t n, int lab, tree_pos_t *tpos)
  *  ASSUMPTION: signed/unsigned integers are compatible on the host;
  *  ASSUMPTION: code location can be represented by void pointer on the target
  */
-static void swcode(stmt_swtch_t *swp, int b[], int lb, int ub)
+static void swcode(stmt_swtch_t *swp, const struct swclus c[], int lb, int ub)
 {
     sx_t *v;
     int hilab, lolab;
@@ -387,7 +501,7 @@ static void swcode(stmt_swtch_t *swp, int b[], int lb, int ub)
     tree_pos_t *tpos;
 
     assert(swp);
-    assert(b);
+    assert(c);
     assert(lb >= 0 && ub >= lb);
     assert(ty_voidptype);    /* ensures types initialized */
     assert(ir_cur);
@@ -395,7 +509,7 @@ static void swcode(stmt_swtch_t *swp, int b[], int lb, int ub)
     pos = swp->pos;
     tpos = tree_npos1(pos);
 
-    v = swp->value;    /* used in DENSITY() */
+    v = swp->value;
     hilab = lolab = swp->deflab->u.l.label;
     if (k > lb && k < ub) {
         lolab = sym_genlab(1);
@@ -407,78 +521,198 @@ static void swcode(stmt_swtch_t *swp, int b[], int lb, int ub)
     else
         assert(lolab == hilab && lolab == swp->deflab->u.l.label);
 
-    l = b[k];
-    u = b[k+1] - 1;
-    if (u - l + 1 <= 3) {
-        int i;
-        for (i = l; i <= u; i++)
-           cmp(OP_EQ, swp->sym, v[i], swp->label[i]->u.l.label, tpos);
-        if (k > lb && k < ub)
-           cmp(OP_GT, swp->sym, v[u], hilab, tpos);
-        else if (k > lb)
-           cmp(OP_GT, swp->sym, v[u], hilab, tpos);
-        else if (k < ub)
-           cmp(OP_LT, swp->sym, v[l], lolab, tpos);
-        else
-           branch(lolab, pos);
-    } else {
-        sym_t *table;
-
-        table = sym_new(SYM_KGEN, LEX_STATIC, ty_array(ty_voidptype, u-l+1, NULL), SYM_SLABEL);
-        ir_cur->symgsc(table);
-        cmp(OP_LT, swp->sym, v[l], lolab, tpos);
-        cmp(OP_GT, swp->sym, v[u], hilab, tpos);
-        dag_walk(tree_new(OP_JMP, ty_voidtype,
-                     tree_indir(
-                         tree_add(OP_ADD,
-                             enode_pointer(tree_id(table, tpos)),
-                             tree_sub(OP_SUB,
-                                 enode_cast(tree_id(swp->sym, tpos), ty_longtype, 0, NULL),
-                                 tree_sconst(v[l], ty_longtype, tpos), NULL, tpos),
+    l = c[k].l;
+    u = c[k].u;
+    switch(c[k].kind) {
+        case SW_COMPARE:
+            {
+                int i;
+                for (i = l; i <= u; i++)
+                   cmp(OP_EQ, swp->sym, v[i], swp->label[i]->u.l.label, tpos);
+                if (k > lb && k < ub)
+                   cmp(OP_GT, swp->sym, v[u], hilab, tpos);
+                else if (k > lb)
+                   cmp(OP_GT, swp->sym, v[u], hilab, tpos);
+                else if (k < ub)
+                   cmp(OP_LT, swp->sym, v[l], lolab, tpos);
+                else
+                   branch(lolab, pos);
+            }
+            break;
+        case SW_BITTEST:
+            cmp(OP_LT, swp->sym, v[l], lolab, tpos);
+            cmp(OP_GT, swp->sym, v[u], hilab, tpos);
+            bittest(swp, l, u, tpos);
+            branch(swp->deflab->u.l.label, pos);
+            break;
+        case SW_TABLE:
+            {
+                sym_t *table;
+
+                table = sym_new(SYM_KGEN, LEX_STATIC, ty_array(ty_voidptype, u-l+1, NULL),
+                                SYM_SLABEL);
+                ir_cur->symgsc(table);
+                cmp(OP_LT, swp->sym, v[l], lolab, tpos);
+                cmp(OP_GT, swp->sym, v[u], hilab, tpos);
+                dag_walk(tree_new(OP_JMP, ty_voidtype,
+                             tree_indir(
+                                 tree_add(OP_ADD,
+                                     enode_pointer(tree_id(table, tpos)),
+                                     tree_sub(OP_SUB,
+                                         enode_cast(tree_id(swp->sym, tpos), ty_longtype, 0, NULL),
+                                         tree_sconst(v[l], ty_longtype, tpos), NULL, tpos),
+                                     NULL, tpos),
+                                 ty_voidptype, 0, tpos),
                              NULL, tpos),
-                         ty_voidptype, 0, tpos),
-                     NULL, tpos),
-                 0, 0);
-        stmt_new(STMT_SWITCH);
-        stmt_list->u.swtch.table = table;
-        stmt_list->u.swtch.sym = swp->sym;
-        stmt_list->u.swtch.deflab = swp->deflab;
-        stmt_list->u.swtch.size = u - l + 1;
-        stmt_list->u.swtch.value = &v[l];
-        stmt_list->u.swtch.label = &swp->label[l];
-        if (xges(xas(xss(v[u], v[l]), xI), xis(10000)))
-            err_dpos(pos, ERR_STMT_HUGETABLE);
+                         0, 0);
+                stmt_new(STMT_SWITCH);
+                stmt_list->u.swtch.table = table;
+                stmt_list->u.swtch.sym = swp->sym;
+                stmt_list->u.swtch.deflab = swp->deflab;
+                stmt_list->u.swtch.size = u - l + 1;
+                stmt_list->u.swtch.value = &v[l];
+                stmt_list->u.swtch.label = &swp->label[l];
+                if (xges(xas(xss(v[u], v[l]), xI), xis(10000)))
+                    err_dpos(pos, ERR_STMT_HUGETABLE);
+            }
+            break;
+        default:
+            assert(!"invalid cluster kind -- should never reach here");
+            break;
     }
     if (k > lb) {
         stmt_deflabel(lolab);
-        swcode(swp, b, lb, k-1);
+        swcode(swp, c, lb, k-1);
     }
     if (k < ub) {
         stmt_deflabel(hilab);
-        swcode(swp, b, k+1, ub);
+        swcode(swp, c, k+1, ub);
+    }
+}
+
+
+/*
+ *  merges runs of compare clusters into bit tests where cheaper;
+ *  returns the new number of clusters
+ */
+static int bitmerge(const stmt_swtch_t *swp, struct swclus c[], int n)
+{
+    sx_t *v;
+    int i, j, k, best;
+
+    assert(swp);
+    assert(c);
+    assert(swcost.bits > 0);
+
+    v = swp->value;    /* used in SPAN() */
+    for (i = k = 0; i < n; k++) {
+        best = -1;
+        for (j = i; j < n && c[j].kind == SW_COMPARE && xlu(SPAN(c[i].l, c[j].u), xiu(swcost.bits));
+             j++)
+            if (swcost.bittest + ntarget(swp, c[i].l, c[j].u)*swcost.cmp <
+                (c[j].u-c[i].l+1) * swcost.cmp)
+                best = j;
+        if (best >= 0) {
+            c[k].kind = SW_BITTEST;
+            c[k].l = c[i].l;
+            c[k].u = c[best].u;
+            i = best + 1;
+        } else
+            c[k] = c[i++];
     }
+
+    return k;
 }
 
 
 /*
- *  generates branch tables for a switch
+ *  prints a case value for a switch plan
+ */
+static void swval(const stmt_swtch_t *swp, sx_t v)
+{
+    assert(swp);
+
+    fputs((TY_ISUNSIGN(swp->sym->type))? xtud(xctu(v)): xtsd(v), stderr);
+}
+
+
+/*
+ *  prints the plan for a switch
+ */
+static void swplan(const stmt_swtch_t *swp, const struct swclus c[], int n)
+{
+    static const char *name[] = { "compare", "table", "bittest" };
+
+    int i;
+
+    assert(swp);
+    assert(c);
+
+    fprintf(stderr, "%s: switch: %d case(s) in %d cluster(s)\n", lmap_out(swp->pos), swp->ncase,
+            n);
+    for (i = 0; i < n; i++) {
+        fprintf(stderr, "  - %-7s [", name[c[i].kind]);
+        swval(swp, swp->value[c[i].l]);
+        fputs(", ", stderr);
+        swval(swp, swp->value[c[i].u]);
+        fprintf(stderr, "], %d case(s)", c[i].u - c[i].l + 1);
+        if (c[i].kind == SW_BITTEST)
+            fprintf(stderr, ", %d target(s)", ntarget(swp, c[i].l, c[i].u));
+        putc('\n', stderr);
+    }
+}
+
+
+/*
+ *  generates branch tables for a switch;
+ *  costs from the back-end used only when optimizing
  */
 static void swgen(stmt_swtch_t *swp)
 {
     sx_t *v;
     int *bucket, k, n;
+    struct swclus *clus;
 
     assert(swp);
+    assert(ir_cur);
+    assert(ty_ulongtype);    /* ensures types initialized */
+
+    if (main_opt()->olevel > 0) {
+        swcost.cmp = ir_cur->swcost.cmp;
+        swcost.table = ir_cur->swcost.table;
+        swcost.bittest = ir_cur->swcost.bittest;
+        swcost.density = ir_cur->swcost.density / 100.0;
+        swcost.bits = ir_cur->swcost.bits;
+        if (swcost.bits > TG_CHAR_BIT*ty_ulongtype->size)
+            swcost.bits = TG_CHAR_BIT*ty_ulongtype->size;
+    } else {
+        swcost.cmp = 1;
+        swcost.table = 3;
+        swcost.bittest = 0;
+        swcost.density = stmt_density;
+        swcost.bits = 0;
+    }
 
     v = swp->value;    /* used in DENSITY() */
     bucket = ARENA_ALLOC(strg_func, (swp->ncase+1)*sizeof(*bucket));
     for (n = k = 0; k < swp->ncase; k++, n++) {
         bucket[n] = k;
-        while (n > 0 && DENSITY(bucket[n-1], k) >= stmt_density)
+        while (n > 0 && DENSITY(bucket[n-1], k) >= swcost.density)
             n--;
     }
     bucket[n] = swp->ncase;
-    swcode(swp, bucket, 0, n-1);
+
+    clus = ARENA_ALLOC(strg_func, n*sizeof(*clus));
+    for (k = 0; k < n; k++) {
+        clus[k].l = bucket[k];
+        clus[k].u = bucket[k+1] - 1;
+        clus[k].kind = (swcost.table < (clus[k].u-clus[k].l+1) * swcost.cmp)? SW_TABLE: SW_COMPARE;
+    }
+    if (swcost.bits > 0)
+        n = bitmerge(swp, clus, n);
+    if (main_opt()->_swplan)
+        swplan(swp, clus, n);
+    swcode(swp, clus, 0, n-1);
 }
 
 
@@ -700,6 +934,7 @@ void (stmt_retcode)(tree_t *p, const lmap_t *pos)
         dag_walk(p, 0, 0);
         return;
     }
+    inl_ret(p);
     p = enode_cast(p, ty_ipromote(p->type), 0, pos);
     if (TY_ISPTR(p->type)) {
         sym_t *q = localaddr(p);
@@ -1029,8 +1264,10 @@ void (stmt_stmt)(int loop, stmt_swtch_t *swp, int lev, const lmap_t *post,    /*
                 clx_tc = clx_next();
             } else {
                 tree_t *e = expr_expr0(0, 0, NULL);
+                if (e)
+                    inl_expr(e);
                 DAG_LISTNODE(e, 0, 0);
-                if (dag_nodecount == 0 || dag_nodecount > 200 || main_opt()->glevel)
+                if (dag_nodecount == 0 || main_opt()->glevel)
                     dag_walk(NULL, 0, 0);
                 ARENA_FREE(strg_stmt);
             }
@@ -103,6 +103,8 @@ struct sym_t {
             const lmap_t *pt;    /* location of definition; used for profiling */
             int label;           /* label for function exit */
             int ncall;           /* # of calls made in function */
+            void *inl;           /* (inl_t) inlining info; NULL if not inlinable */
+            int regparm;         /* # of leading arguments passed in registers */
         } f;                     /* function */
         int seg;    /* global; segment where global defined */
         struct {
@@ -17,6 +17,7 @@
 #include "enode.h"
 #include "err.h"
 #include "expr.h"
+#include "inl.h"
 #include "ir.h"
 #include "lex.h"
 #include "lmap.h"
@@ -1221,6 +1222,37 @@ static int hascall(const tree_t *p)
 }
 
 
+/*
+ *  rebuilds arguments for a function taking k arguments in registers;
+ *  values of those arguments are computed into temporaries beforehand so that no register
+ *  argument is live while evaluating another;
+ *  ASSUMPTION: arguments are evaluated from right to left
+ */
+static tree_t *regarg(tree_t *arg, int i, int k, tree_t **pr)
+{
+    int op;
+    sym_t *t;
+    tree_t *q, *e;
+
+    assert(pr);
+
+    if (!arg)
+        return NULL;
+
+    q = arg->kid[0];
+    op = op_generic(q->op);
+    if (i < k && !(op == OP_CNST || OP_ISADDR(op) ||
+                   (op == OP_INDIR && OP_ISADDR(op_generic(q->kid[0]->op))))) {
+        t = sym_new(SYM_KTEMP, LEX_REGISTER, TY_UNQUAL(q->type), sym_scope);
+        e = tree_asgnid(t, q, q->orgn->pos);
+        *pr = (*pr)? tree_right(*pr, e, ty_voidtype, e->orgn->pos): e;
+        q = tree_id(t, q->orgn->pos);
+    }
+
+    return tree_new(arg->op, arg->type, q, regarg(arg->kid[1], i-1, k, pr), arg->orgn->pos);
+}
+
+
 /*
  *  parses arguments and calls tree_call();
  *  pointer() and value() apply to the function operand and each argument;
@@ -1230,11 +1262,12 @@ tree_t *(tree_pcall)(tree_t *p)
 {
     ty_t *ty;
     unsigned n = 0;
-    tree_t *o, *arg = NULL, *r = NULL;
+    tree_t *o, *arg = NULL, *argl, *r = NULL;
     ty_t *rty;
     void **proto;    /* ty_t */
     sym_t *t3 = NULL;
     const lmap_t *pos, *posp = NULL;
+    tree_pos_t *tpos;
 
     assert(!p || p->type);
     assert(ty_voidtype);    /* ensures types initialized */
@@ -1334,10 +1367,14 @@ tree_t *(tree_pcall)(tree_t *p)
         (void)(err_dpos((posp)? posp: lmap_after(clx_ppos), ERR_EXPR_INSUFFARG, p) &&
                err_dpos(ty->u.f.pos, ERR_PARSE_DECLHERE));
 
+    argl = arg;
+    if (op_generic(p->op) == OP_ADDRG && p->u.sym->u.f.regparm > 0)
+        arg = regarg(arg, (int)n-1, ((int)n < p->u.sym->u.f.regparm)? n: p->u.sym->u.f.regparm, &r);
     if (r)
         arg = tree_right(r, arg, ty_voidtype, r->orgn->pos);
 
-    p = call(p, rty, arg, t3, tree_npos(TREE_TL(p), pos, clx_ppos));
+    tpos = tree_npos(TREE_TL(p), pos, clx_ppos);
+    p = inl_call(p, argl, call(p, rty, arg, t3, tpos), tpos);
     if (TY_ISSTRUNI(rty) && rty->size == 0)
         err_dpos(TREE_TW(p), ERR_EXPR_RETINCOMP, rty);
     return p;
@@ -1559,7 +1596,14 @@ tree_t *(tree_id)(sym_t *p, tree_pos_t *tpos)
 
     ty = TY_UNQUAL(p->type);
 
+    if (TY_ISFUNC(ty) && p->scope > SYM_SGLOBAL) {    /* block-scope declaration */
+        sym_t *g = sym_lookup(p->name, sym_global);
+        if (g && TY_ISFUNC(g->type) && g->f.defined && g->u.f.regparm > 0)
+            p = g;    /* calling convention follows definition */
+    }
     sym_ref(p, expr_refinc);
+    if (TY_ISFUNC(ty))
+        inl_use(p);
 
     if (p->scope == SYM_SGLOBAL || p->sclass == LEX_STATIC || p->sclass == LEX_EXTERN)
         op = op_addr(G);
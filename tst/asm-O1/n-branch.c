@@ -0,0 +1,33 @@
+int f(int a, int b)
+{
+    if (a < b && b < 10)
+        return 1;
+    else if (a == b || b == 10)
+        return 2;
+    if (!(a > 0))
+        return 3;
+    return 4;
+}
+
+int g(int n)
+{
+    int k = 0;
+
+    while (n > 1 && k < 100) {
+        if (n & 1)
+            n = 3*n + 1;
+        else
+            n /= 2;
+        k++;
+    }
+
+    return k;
+}
+
+int main(void)
+{
+    printf("%d %d %d %d %d\n", f(1, 2), f(3, 3), f(12, 10), f(-1, -5), f(7, 5));
+    printf("%d %d %d\n", g(1), g(6), g(27));
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+int a[4] = { 1, 2, 3, 4 };
+
+int f(int i, int j)
+{
+    int x = (i > j)? a[i & 3] + a[j & 3]: a[i & 3] - a[j & 3];
+
+    {
+        int y = (i && j)? x * 2: x;
+        x = y + ((i || j)? 1: 0);
+    }
+
+    return x;
+}
+
+int main(void)
+{
+    printf("%d %d %d %d\n", f(0, 0), f(3, 1), f(1, 3), f(2, 0));
+
+    return 0;
+}
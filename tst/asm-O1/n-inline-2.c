@@ -0,0 +1,24 @@
+int printf(const char *, ...);
+
+static unsigned acc;
+
+/* statements and locals before return: inlined */
+static int id(int x) { acc += x; return x; }
+static int poly(int a, int b) { int t = a * b; t += 3; return t - a; }
+static int bump(int x, int k) { x += k; x *= 2; return x; }
+static int swap(int a, int b) { int c = b; b = a; a = c; return a * 10 + b; }
+
+/* branch or aggregate local: not inlined */
+static int chk(int x) { if (x > 3) acc++; return x - 1; }
+static int pair(int a) { struct { int a, b; } q; q.a = a; q.b = 2; return q.a + q.b; }
+
+int main(void)
+{
+    int i, s = 0;
+
+    for (i = 0; i < 5; i++)
+        s += id(i) + chk(i) + poly(i, 3) + bump(i, 2) + bump(4, i) + swap(i, 7) + pair(i);
+    printf("%d %u\n", s, acc);
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+int printf(const char *, ...);
+
+static int n;
+
+static int sq(int x) { return x * x; }
+static int add3(int a, int b, int c) { return a + b + c; }
+static int mid(int a, int b) { return add3(a, b, 0) / 2; }
+static unsigned rot(unsigned x, int k) { return (x << k) | (x >> (32-k)); }
+static int next(void) { return n++; }
+static int div(int a, int b) { return a / b; }
+static char *pick(char *p, int i) { return p + i; }
+
+/* not inlined: address of parameter taken */
+static int *addr(int x) { int *p = &x; return (*p == x)? &n: 0; }
+
+/* not inlined: more than one return */
+static int sgn(int x) { if (x < 0) return -1; return x > 0; }
+
+/* referenced through a pointer: must still be emitted */
+static int twice(int x) { return 2 * x; }
+
+int main(void)
+{
+    int i = 3, (*fp)(int) = twice;
+    char s[] = "inline";
+
+    printf("%d %d\n", sq(7), sq(i++));
+    printf("%d %d\n", add3(1, 2, 3), add3(i, sq(i), next()));
+    printf("%d %d\n", mid(9, 5), mid(-9, 5));
+    printf("%x %x\n", rot(0x12345678, 8), rot(0x80000001u, 1));
+    i = next();
+    printf("%d %d\n", i, n);
+    printf("%d %d\n", div(100, n), div(-7, 2));
+    printf("%c%c\n", *pick(s, 0), *pick(s, 5));
+    printf("%d %d %d %d\n", addr(1) == &n, sgn(-5), sgn(0), sgn(8));
+    printf("%d %d\n", fp(21), twice(4));
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+int g;
+
+int f(int a, int b)
+{
+    int r = 0;
+
+    if ((a & b) > 0)
+        r |= 1;
+    if ((a | b) < 0)
+        r |= 2;
+    if ((a ^ b) >= 0)
+        r |= 4;
+    if (a - b == 0)
+        r |= 8;
+    if (a + b != 0)
+        r |= 16;
+    if ((a - b) < 0)
+        r |= 32;
+
+    return r;
+}
+
+int h(int n)
+{
+    int s = 0;
+
+    while (--n)
+        s += n;
+    g = s;
+    s = g + 1;
+    if (n == 0)
+        goto out;
+    out:
+    return s;
+}
+
+int main(void)
+{
+    printf("%d %d %d\n", f(3, 5), f(-1, 1), f(7, 7));
+    printf("%d %d\n", f(0x7ffffffe, 1), f(-5, -5));
+    printf("%d %d\n", h(1), h(10));
+
+    return 0;
+}
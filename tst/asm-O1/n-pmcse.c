@@ -0,0 +1,21 @@
+int g;
+
+int f(int a, int b, int c)
+{
+    register int x = a;
+    char v = (1 != b);
+
+    g = (unsigned)a >> ((unsigned)c % 15u * a & 15);
+
+    return x + c;
+}
+
+int main(void)
+{
+    printf("%d ", f(1, 1, 0));
+    printf("%d ", g);
+    printf("%d ", f(2, 1, 3));
+    printf("%d\n", g);
+
+    return 0;
+}
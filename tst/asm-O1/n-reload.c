@@ -0,0 +1,24 @@
+int arr[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+int *pp = &arr[3];
+
+unsigned f(int a, int b)
+{
+    register int x = a, y = b;
+    register unsigned v1 = 1;
+    unsigned v3 = *pp;
+
+    switch((unsigned)*pp / (unsigned)y) {
+        case 1:
+            v1 <<= 1;
+    }
+    v3 = (unsigned)(x + arr[a & 7]) * a / x;
+
+    return v3;
+}
+
+int main(void)
+{
+    printf("%u %u %u\n", f(1, 3), f(5, 2), f(9, 4));
+
+    return 0;
+}
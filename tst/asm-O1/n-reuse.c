@@ -0,0 +1,25 @@
+struct { int a; } st = { 4 };
+int arr[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+int id(int x)
+{
+    return x;
+}
+
+int f(int a, int c)
+{
+    register int v = id(a);
+
+    arr[3] = arr[v & 7] * (2 >= arr[c & 7]) - st.a;
+
+    return arr[3];
+}
+
+int main(void)
+{
+    printf("%d ", f(5, 0));
+    printf("%d ", f(2, 1));
+    printf("%d\n", f(6, 7));
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+int f(int a, int b)
+{
+    register int x = a, y = b;
+
+    x = y - x;
+
+    return x + y;
+}
+
+int g(int a, int b)
+{
+    register int x = a, y = b;
+
+    x = y << x;
+    y = (y - x) * y;
+
+    return x + y;
+}
+
+int main(void)
+{
+    printf("%d %d\n", f(3, 10), f(-4, 6));
+    printf("%d %d\n", g(2, 3), g(1, -5));
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+int f(int n)
+{
+    register int i, s = 0;
+
+    for (i = 0; i < n; i++) {
+        register int t = i * i;
+        s += t;
+    }
+    {
+        register int u = s / 2;
+        s -= u;
+    }
+
+    return s;
+}
+
+int g(int n)
+{
+    register int a = n, b = n + 1, c = n + 2;
+
+    return a*b - c;
+}
+
+int main(void)
+{
+    printf("%d %d\n", f(5), g(3));
+    printf("%d %d\n", g(4), f(10));
+
+    return 0;
+}
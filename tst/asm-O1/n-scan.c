@@ -0,0 +1,40 @@
+int a[10] = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+
+int f(int n)
+{
+    int x = n, y = 2*n, z = 3*n, w = 4*n, i, s = 0;
+
+    for (i = 0; i < 10; i++)
+        s += a[i] * w;
+    s += x + y + z;
+
+    return s;
+}
+
+int g(int n)
+{
+    int i = 0, s = 0, t = n;
+
+    top:
+    s += a[i] / (t | 1);
+    if (++i < 10)
+        goto top;
+
+    return s + t;
+}
+
+int h(int p, int q)
+{
+    int x = p + q, y = p - q, z = p * q;
+
+    return (x / (y | 1)) + (z % (x | 1)) + (y / (z | 1)) + x + y + z;
+}
+
+int main(void)
+{
+    printf("%d %d\n", f(1), f(-2));
+    printf("%d %d\n", g(1), g(2));
+    printf("%d %d\n", h(7, 3), h(-5, 11));
+
+    return 0;
+}
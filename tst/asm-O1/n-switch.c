@@ -0,0 +1,77 @@
+int printf(const char *, ...);
+
+/* dense values: branch table */
+static int table(int x)
+{
+    switch(x) {
+        case 1:  return 10;
+        case 2:  return 20;
+        case 3:  return 30;
+        case 4:  return 40;
+        case 6:  return 60;
+        case 7:  return 70;
+        case 9:  return 90;
+        case 10: return 100;
+    }
+    return -1;
+}
+
+/* sparse values: compare chains */
+static int compare(int x)
+{
+    switch(x) {
+        case -100000: return 1;
+        case 7:       return 2;
+        case 5000:    return 3;
+        case 123456:  return 7;
+    }
+    return 0;
+}
+
+/* few targets in a narrow span: bit test */
+static int vowel(int c)
+{
+    switch(c) {
+        case 'a': case 'e': case 'i': case 'o': case 'u':
+        case 'A': case 'E': case 'I': case 'O': case 'U':
+            return 1;
+        case 'y': case 'w':
+            return 2;
+    }
+    return 0;
+}
+
+/* mixed clusters */
+static int mixed(unsigned x)
+{
+    switch(x) {
+        case 0: case 1: case 2: case 3: case 4: case 5:
+            return x;
+        case 40: case 44: case 48: case 52: case 60:
+            return 100;
+        case 1000:
+            return 1000;
+        case 70000:
+            return 7;
+    }
+    return -1;
+}
+
+int main(void)
+{
+    int i;
+
+    for (i = -1; i <= 12; i++)
+        printf("%d ", table(i));
+    printf("\n");
+    printf("%d %d %d %d %d %d\n", compare(-100000), compare(7), compare(5000), compare(123456),
+           compare(8), compare(-7));
+    for (i = '@'; i <= 'z'; i++)
+        printf("%d", vowel(i));
+    printf("\n");
+    for (i = 0; i <= 64; i++)
+        printf("%d ", mixed(i));
+    printf("\n%d %d %d\n", mixed(1000), mixed(70000), mixed(69999));
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+int f(int n)
+{
+    int r = 0;
+
+    if (n > 0)
+        goto a;
+    goto b;
+    a:
+    goto c;
+    b:
+    r = -1;
+    c:
+    goto d;
+    d:
+    return r + n;
+}
+
+int g(int n)
+{
+    int i, j, s = 0;
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (j == i)
+                continue;
+            if (j > i + 2)
+                break;
+            s += i * j;
+        }
+    }
+
+    return s;
+}
+
+int main(void)
+{
+    printf("%d %d %d\n", f(-3), f(0), f(5));
+    printf("%d %d\n", g(4), g(7));
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+int f(int n)
+{
+    if (0)
+        n++;
+    return n;
+    n--;
+    printf("unreachable\n");
+    return n;
+}
+
+int g(int n)
+{
+    int i;
+
+    for (i = 0; ; i++) {
+        if (i * i > n)
+            break;
+        continue;
+        printf("unreachable\n");
+    }
+    goto end;
+    i = 0;
+    end:
+    return i;
+}
+
+int h(int n)
+{
+    switch(n) {
+        case 1:
+            return 10;
+            n = 2;
+        case 2:
+            return 20;
+        default:
+            break;
+            return -1;
+    }
+
+    return n;
+}
+
+int main(void)
+{
+    printf("%d %d\n", f(1), f(-1));
+    printf("%d %d %d\n", g(0), g(10), g(100));
+    printf("%d %d %d\n", h(1), h(2), h(3));
+
+    return 0;
+}
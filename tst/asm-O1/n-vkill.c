@@ -0,0 +1,36 @@
+struct s { int a[8]; } s1 = { 1, 2, 3, 4, 5, 6, 7, 8 }, s2;
+
+int sum(struct s s)
+{
+    int i, r = 0;
+
+    for (i = 0; i < 8; i++)
+        r += s.a[i];
+
+    return r;
+}
+
+int f(int n)
+{
+    int x = n, y = n + 1, z = n + 2;
+
+    s2 = s1;
+    s2.a[0] = x;
+
+    return sum(s2) + x + y + z;
+}
+
+int g(int n)
+{
+    int x = n, y = n * 2, z = n * 3;
+
+    return x + y + z;
+}
+
+int main(void)
+{
+    printf("%d %d\n", f(1), f(10));
+    printf("%d\n", g(5));
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+int printf(const char *, ...);
+
+int k(int n)
+{
+    int r;
+
+    goto first;
+    second:
+    r = n * 3;
+    goto out;
+    first:
+    n += 1;
+    goto second;
+    out:
+    return r;
+}
+
+int m(int n)
+{
+    int r = 0;
+
+    if (n < 0)
+        goto neg;
+    r = n;
+    goto tail;
+    neg:
+    r = -n;
+    goto done;
+    tail:
+    r *= 2;
+    goto done;
+    big:
+    r = 1000;
+    return r;
+    done:
+    if (r > 100)
+        goto big;
+    return r + 1;
+}
+
+int main(void)
+{
+    printf("%d %d %d\n", k(0), k(4), k(-2));
+    printf("%d %d %d %d\n", m(0), m(7), m(-9), m(80));
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+int printf(const char *, ...);
+
+struct rec { int a, b, c; } r[16];
+int m[8][24];
+
+/* invariant product hoisted out of the loop */
+static int inv(int n, int k, int j)
+{
+    int i, s = 0;
+
+    for (i = 0; i < n; i++)
+        s += (k * j + 3) ^ i;
+    return s;
+}
+
+/* scale 12 cannot be folded into an address */
+static int field(int n)
+{
+    int i, s = 0;
+
+    for (i = 0; i < n; i++)
+        s += r[i].b;
+    return s;
+}
+
+/* scale 96 for rows; induction variable counting down */
+static int column(int c)
+{
+    int i, s = 0;
+
+    for (i = 7; i >= 0; i--)
+        s += m[i][c];
+    return s;
+}
+
+/* loop built from gotos */
+static int gloop(int n, int k)
+{
+    int i = 0, s = 0;
+
+top:
+    s += k * 7 + i * 20;
+    i += 2;
+    if (i < n)
+        goto top;
+    return s;
+}
+
+/* loop entered from two places: not transformed */
+static int twoentry(int n, int k)
+{
+    int i = 0, s = 0;
+
+    if (n > 5)
+        goto mid;
+    for (; i < n; i++) {
+        s += k * k;
+    mid:
+        s += i * 12;
+    }
+    return s;
+}
+
+/* variable assigned in the loop is not invariant */
+static int variant(int n, int k)
+{
+    int i, s = 0;
+
+    for (i = 0; i < n; i++) {
+        s += k * 5;
+        k++;
+    }
+    return s;
+}
+
+int main(void)
+{
+    int i, j;
+
+    for (i = 0; i < 16; i++)
+        r[i].a = i, r[i].b = i * i, r[i].c = -i;
+    for (i = 0; i < 8; i++)
+        for (j = 0; j < 24; j++)
+            m[i][j] = i * 100 + j;
+
+    printf("%d %d %d\n", inv(10, 3, 4), inv(0, 3, 4), inv(1, -2, 5));
+    printf("%d %d\n", field(16), field(1));
+    printf("%d %d\n", column(0), column(23));
+    printf("%d %d\n", gloop(10, 3), gloop(1, 2));
+    printf("%d %d %d\n", twoentry(3, 2), twoentry(8, 2), twoentry(0, 9));
+    printf("%d %d\n", variant(4, 1), variant(0, 1));
+
+    return 0;
+}
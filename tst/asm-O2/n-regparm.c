@@ -0,0 +1,3 @@
+/* --target=x86-linux --regparm=3 */
+
+#include "../asm/n-regparm.h"
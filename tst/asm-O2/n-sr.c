@@ -0,0 +1,61 @@
+int printf(const char *, ...);
+
+struct rec { int a, b, c; } r[16];
+
+/* reduced address replaces the induction variable in a register */
+static int sum(struct rec *p, int n)
+{
+    int i, t = 0;
+
+    for (i = 0; i < n; i++)
+        t += p[i].b;
+    return t;
+}
+
+/* variable read after the loop: not reduced */
+static int last(struct rec *p, int n)
+{
+    int i, t = 0;
+
+    for (i = 0; i < n; i++)
+        t += p[i].b;
+    return t + i;
+}
+
+/* variable read in the loop body: not reduced */
+static int weight(struct rec *p, int n)
+{
+    int i, t = 0;
+
+    for (i = 0; i < n; i++)
+        t += p[i].b * i;
+    return t;
+}
+
+/* inner loop entered again without resetting its variable */
+static int resume(struct rec *p, int n)
+{
+    int i = 0, j, t = 0;
+
+    for (j = 0; j < 3; j++) {
+        for (; i < n; i++)
+            t += p[i].b;
+        n += 4;
+    }
+    return t;
+}
+
+int main(void)
+{
+    int i;
+
+    for (i = 0; i < 16; i++)
+        r[i].a = i, r[i].b = i * i, r[i].c = -i;
+
+    printf("%d %d %d\n", sum(r, 16), sum(r, 0), sum(r+3, 2));
+    printf("%d %d\n", last(r, 16), last(r, 0));
+    printf("%d %d\n", weight(r, 16), weight(r, 2));
+    printf("%d %d\n", resume(r, 4), resume(r, 0));
+
+    return 0;
+}
@@ -0,0 +1,3 @@
+/* --target=x86-linux --regparm=0 */
+
+#include "n-regparm.h"
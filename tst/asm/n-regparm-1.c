@@ -0,0 +1,3 @@
+/* --target=x86-linux --regparm=1 */
+
+#include "n-regparm.h"
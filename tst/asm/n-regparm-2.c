@@ -0,0 +1,3 @@
+/* --target=x86-linux --regparm=2 */
+
+#include "n-regparm.h"
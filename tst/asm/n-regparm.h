@@ -0,0 +1,98 @@
+/*
+ *  body of regparm tests; included with different --regparm values
+ */
+
+int printf(const char *, ...);
+
+struct pt { int x, y; };
+
+static int later(int, int);
+
+static int add3(int a, int b, int c)
+{
+    return a*100 + b*10 + c;
+}
+
+/* int-sized arguments of narrower types */
+static int narrow(char c, short s, unsigned char u, unsigned short w)
+{
+    return c + s + u + w;
+}
+
+/* struct arguments mixed with ints */
+static int mix1(int a, struct pt p, int b)
+{
+    return a + p.x*10 + p.y*100 + b*1000;
+}
+
+static int mix2(struct pt p, int a, char *s, struct pt q)
+{
+    return p.x + a + s[1] + q.y;
+}
+
+static struct pt mkpt(int x, int y)
+{
+    struct pt p;
+
+    p.x = x;
+    p.y = y;
+    return p;
+}
+
+/* varargs: never in registers */
+static int vsum(int n, ...)
+{
+    int *ap = &n + 1, s = 0;
+
+    while (n-- > 0)
+        s += *ap++;
+    return s;
+}
+
+/* old-style definition: never in registers */
+static int old(a, b, c)
+int a;
+char *b;
+int c;
+{
+    return a + b[0] + c;
+}
+
+/* called directly and through a pointer */
+static int viaptr(int a, int b, int c, int d)
+{
+    return a - b + c*d;
+}
+
+static int fib(int n)
+{
+    return (n < 2)? n: fib(n-1) + fib(n-2);
+}
+
+/* referenced before its definition */
+static int before(int a)
+{
+    return later(a, a+1);
+}
+
+static int later(int a, int b)
+{
+    return a * b;
+}
+
+int main(void)
+{
+    struct pt p = { 1, 2 }, q = { 3, 4 };
+    int (*fp)(int, int, int, int) = viaptr;
+    int a = 5, b = 6, c = 7;
+
+    printf("%d %d\n", add3(1, 2, 3), add3(add3(1, 2, 3), add3(a, b, c) % 10, later(a, b)));
+    printf("%d %d\n", narrow(-1, -300, 200, 60000), narrow('a', 1, 255, 1));
+    printf("%d %d\n", mix1(a, p, b), mix2(q, c, "xyz", mkpt(8, 9)));
+    printf("%d %d\n", vsum(3, 1, 2, 3), vsum(0));
+    printf("%d\n", old(1, "A", 2));
+    printf("%d %d\n", viaptr(10, 3, 4, 5), fp(10, 3, 4, 5));
+    printf("%d %d\n", fib(15), before(6));
+
+    return 0;
+}
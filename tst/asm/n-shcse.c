@@ -0,0 +1,23 @@
+int printf(const char *, ...);
+
+/* shift counts read from constant cses kept in registers */
+int rsh(int n)
+{
+    int k;
+
+    return n >> (k = 3);
+}
+
+unsigned lsh(unsigned n)
+{
+    int k;
+
+    return (n << (k = 4)) + k;
+}
+
+int main(void)
+{
+    printf("%d %d %u\n", rsh(800), rsh(-64), lsh(0x10000001));
+
+    return 0;
+}
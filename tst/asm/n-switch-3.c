@@ -0,0 +1,28 @@
+int printf(const char *, ...);
+
+int f(unsigned x)
+{
+    switch(x) {
+        case 1:          return 1;
+        case 2:          return 2;
+        case 3:          return 3;
+        case 0x80000000: return 4;
+        case 0x90000000: return 5;
+        case 0xa0000000: return 6;
+        case 0xfffffffe: return 7;
+        case 0xffffffff: return 8;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    static unsigned v[] = { 1, 3, 4, 0x80000000, 0xa0000000, 0xfffffffe, 0xffffffff };
+    int i;
+
+    for (i = 0; i < sizeof(v)/sizeof(*v); i++)
+        printf("%d", f(v[i]));
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,2 @@
+dir c
+#include "pp-inc-resolve-1-b.c"
@@ -0,0 +1 @@
+dir d
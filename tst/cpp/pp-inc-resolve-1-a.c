@@ -0,0 +1,12 @@
+/* -Wv -Ipp-inc-dir -I. */
+
+#include "pp-inc-resolve-1-b.c"
+#include "pp-inc-dir/pp-inc-resolve-1-c.c"
+#include <pp-inc-resolve-1-b.c>
+#include "pp-inc-resolve-1-b.c"
+#include "pp-inc-resolve-1-d.c"
+#include "pp-inc-resolve-1-d.c"
+#include <pp-inc-resolve-1-d.c>
+#include <pp-inc-resolve-1-f.c>
+#include "pp-inc-resolve-1-f.c"
+#include "pp-inc-dir/pp-inc-resolve-1-f.c"
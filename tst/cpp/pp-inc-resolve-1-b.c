@@ -0,0 +1 @@
+cwd b
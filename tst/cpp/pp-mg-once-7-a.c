@@ -0,0 +1,10 @@
+
+PRE
+#include "pp-mg-once-7-b.c"
+#include "pp-mg-once-7-c.c"
+POST
+
+PRE-AGAIN
+#include "pp-mg-once-7-b.c"
+#include "pp-mg-once-7-c.c"
+POST-AGAIN
@@ -0,0 +1,7 @@
+
+#if !defined(BAR)
+#define BAR
+
+BODY-B
+
+#endif
@@ -0,0 +1,7 @@
+
+#if ! defined BAZ && 1
+#define BAZ
+
+BODY-C
+
+#endif
@@ -0,0 +1,11 @@
+/* -Wv */
+
+#include "dummy.c"
+#line 10 "esc\\ape\x2d\101\"d.c"
+__FILE__ __LINE__
+#warning escaped
+#line 20 "a-file-name-long-enough-to-need-memory-from-elsewhere\\x.c"
+__FILE__ __LINE__
+#warning long
+#line 30 "plain.c"
+__FILE__ __LINE__
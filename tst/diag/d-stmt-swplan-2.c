@@ -0,0 +1,39 @@
+/* --std=c90 -Wv --target=x86-linux --_switch-plan */
+/* without -O, the classic plan regardless of target costs */
+int f(int x)
+{
+    switch(x) {    /* table */
+        case 1: case 2: case 3: case 4: case 6: case 7: case 9: case 10:
+            return x;
+    }
+    switch(x) {    /* table only with lower density */
+        case 0: case 3: case 6: case 9: case 12: case 15: case 18:
+            return -x;
+    }
+    switch(x) {    /* compare */
+        case -100000: case 7: case 5000: case 123456:
+            return 1;
+    }
+    switch(x) {    /* bit tests */
+        case 'a': case 'e': case 'i': case 'o': case 'u':
+        case 'A': case 'E': case 'I': case 'O': case 'U':
+            return 1;
+        case 'y': case 'w':
+            return 2;
+    }
+    return 0;
+}
+
+int g(unsigned x)
+{
+    switch(x) {    /* mixed */
+        case 0: case 1: case 2: case 3: case 4: case 5:
+            return x;
+        case 40: case 44: case 48: case 52: case 60:
+            return 100;
+        case 1000:
+        case 4000000000u:
+            return 4;
+    }
+    return -1;
+}
@@ -0,0 +1,21 @@
+# -fcache-dir: hits, misses on changes to code or options, warnings never lost
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+
+cc() {
+    $BCC -B$BELUGA -Wc,--no-warning-code -fcache-dir=C "$@" 2>&1
+    echo "exit status $? (hits and misses: $(cat C/stats))"
+}
+
+echo 'int f(void) { return N; }' > a.c
+echo 'int g(void) { return; }' > w.c
+
+echo "first:";          cc -DN=1 -c a.c; cp a.o a1.o
+echo "again:";          cc -DN=1 -c a.c; cmp a.o a1.o && echo "same object"
+echo "spaces changed:"; echo 'int f(void){return N;}' > a.c; cc -DN=1 -c a.c
+echo "macro changed:";  cc -DN=2 -c a.c
+echo "option changed:"; cc -DN=2 -O -c a.c
+echo "code changed:";   echo 'int f(void) { return N+1; }' > a.c; cc -DN=2 -c a.c
+echo "warning:";        cc -c w.c
+echo "warning again:";  cc -c w.c
+ls C | grep -c '\.o$'
@@ -0,0 +1,23 @@
+# -j: diagnostics printed in the order of files; errors counted over all files
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+mkdir bin
+cat > bin/beluga <<EOT
+#!/bin/sh
+case "\$*" in *a.c*) sleep 1;; esac    # finishes last
+exec $BELUGA/beluga "\$@"
+EOT
+chmod +x bin/beluga
+
+echo 'int a(void) { return; }' > a.c
+echo 'int b(void) { return x; }' > b.c
+echo 'int c(void) { return; }' > c.c
+echo 'int d(void) { return 0; }' > d.c
+
+for j in 1 4; do
+    echo "-j$j:"
+    $BCC -B$T/bin -Wc,--no-warning-code -j$j -c a.c b.c c.c d.c 2>&1
+    echo "exit status $?"
+    ls *.o
+    rm -f *.o
+done
@@ -0,0 +1,23 @@
+# -j: a command terminated by a signal stops new commands after running ones reaped
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+mkdir bin
+cat > bin/beluga <<EOT
+#!/bin/sh
+case "\$*" in
+    *k.c*) kill -KILL \$\$;;
+    *s.c*) sleep 1; touch s.done;;
+esac
+exec $BELUGA/beluga "\$@"
+EOT
+chmod +x bin/beluga
+
+echo 'int k(void) { return 0; }' > k.c
+echo 'int s(void) { return 0; }' > s.c
+echo 'int t(void) { return 0; }' > t.c
+
+$BCC -B$T/bin -j2 -c k.c s.c t.c >out 2>&1
+r=$?
+sed "s|$T|T|g" out
+echo "exit status $r"
+ls *.o s.done
@@ -0,0 +1,14 @@
+# --object: no object from erroneous code, whose assembly has .align 0
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+
+printf 'int a = 1;\nstruct t b = { 0 };\nint f(void) { return a; }\n' > e.c
+
+$BELUGA/beluga --target=x86-linux --no-warning-code --object -o e.o e.c 2>&1
+echo "exit status $?"
+echo "$(wc -c < e.o) byte(s)"
+rm -f e.o
+
+$BCC -B$BELUGA -Wc,--no-warning-code -fintegrated-as -c e.c 2>&1
+echo "exit status $?"
+ls *.o 2>/dev/null
@@ -0,0 +1,47 @@
+# --pch-dir: headers replayed across runs, re-recorded after changes, keyed on macros used
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+mkdir inc pch
+
+pp() {
+    $BELUGA/beluga -E --include-builtin=inc --pch-dir=pch "$@" >out 2>&1
+    echo "exit status $?"
+    grep -v '^#' out | grep -v '^$'
+}
+
+# prints cache slots with whether each has been written since last call
+cache() {
+    ls -i pch | sed 's/ [0-9a-f]*-/ /' | sort -k2 > ls.new
+    [ -f ls.old ] && awk 'NR == FNR { i[$2] = $1; next }
+                          { print $2, ($2 in i)? ((i[$2] == $1)? "kept": "rewritten"): "new" }' \
+                         ls.old ls.new ||
+                     awk '{ print $2, "new" }' ls.new
+    mv ls.new ls.old
+}
+
+printf '#ifdef MODE\nint m_on;\n#else\nint m_off;\n#endif\n#define X 42\nint v = VAL;\n' > inc/m.h
+printf '#include <m.h>\nint x = X;\n' > a.c
+printf '#define MODE\n#include <m.h>\nint x = X;\n' > b.c
+
+echo "recorded:";              pp -DVAL=1 a.c; cache
+echo "reused:";                pp -DVAL=1 a.c; cache
+echo "macro used changed:";    pp -DVAL=2 a.c; cache
+echo "macro tested defined:";  pp -DVAL=1 b.c; cache
+echo "reused after others:";   pp -DVAL=1 a.c; cache
+echo "header changed:"
+sed 's/42/43/' inc/m.h > m.h && mv m.h inc/m.h
+pp -DVAL=1 a.c; cache
+echo "reused after change:";   pp -DVAL=1 a.c; cache
+
+# contents are hashed again only when the size or modification time differs
+rm -f pch/* ls.old
+printf '#define Y 7\nint y = Y;\n' > inc/n.h && touch -t 202001010000 inc/n.h
+printf '#include <n.h>\n' > c.c
+echo "old header recorded:";   pp c.c; cache
+echo "touched only:";          touch -t 202101010000 inc/n.h; pp c.c; cache
+echo "same size and time trusted:"
+sed 's/7/8/' inc/n.h > n.h && mv n.h inc/n.h && touch -t 202001010000 inc/n.h
+pp c.c; cache
+echo "size changed:"
+sed 's/8/10/' inc/n.h > n.h && mv n.h inc/n.h && touch -t 202001010000 inc/n.h
+pp c.c; cache
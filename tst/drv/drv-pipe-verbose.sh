@@ -0,0 +1,9 @@
+# -v: both commands of a pipe echoed before the compiler writes to stderr
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+
+echo 'int a;' > a.c
+
+$BCC -B$BELUGA -v -c a.c >out 2>&1
+echo "exit status $?"
+grep -v '^ ' out | sed 's/ .*//; s|.*/||'
@@ -0,0 +1,22 @@
+# -fcompile-server: include guards and #pragma once kept per file; diagnostics and status
+
+T=$(mktemp -d) && trap 'rm -rf $T' 0 && cd $T || exit 1
+
+printf '#ifndef H_H\n#define H_H\ntypedef int ht;\n#endif\n' > h.h
+printf '#pragma once\ntypedef int ot;\n' > o.h
+
+printf '#include "h.h"\n#include "h.h"\nht p;\n' > p.c
+printf '#define H_H\n#include "h.h"\nht q;\n' > q.c    # error; h.h skipped
+printf '#include "h.h"\nht r;\n' > r.c
+printf '#include "o.h"\n#include "o.h"\not s;\n' > s.c
+printf '#include "o.h"\not t;\n' > t.c
+printf 'int w(void) { return; }\n' > w.c
+
+for j in 1 3; do
+    echo "-j$j:"
+    $BCC -B$BELUGA -Wc,--no-warning-code -fcompile-server -j$j -c p.c q.c r.c s.c t.c w.c >out 2>&1
+    echo "exit status $?"
+    cat out
+    ls *.o
+    rm -f *.o
+done
@@ -0,0 +1,20 @@
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
+#include "perf-pp-lex-c.h"
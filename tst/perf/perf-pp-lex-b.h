@@ -0,0 +1,35 @@
+/*
+ *  a block comment long enough that the lexer spends most of its time skipping its body
+ *  rather than recognizing tokens; lines like this one are typical of license headers,
+ *  interface descriptions and commented-out code that make up much of real headers
+ *      and indented lines with runs of spaces before and inside them    too
+ */
+extern int a_rather_long_identifier_naming_some_object_in_a_header_0;    /* trailing comment */
+extern int another_long_identifier_for_the_identifier_scanner_1;    // line comment to the end
+        extern   unsigned   long   spaced_out_declaration_with_runs_of_blanks_2;
+	extern	int	tab_separated_declaration_3;	/* with tabs */
+typedef struct long_structure_tag_name_for_scanning {
+    int first_member_with_a_descriptive_name;     /* explains the first member */
+    long second_member_with_a_descriptive_name;    /* explains the second member */
+    char *third_member_with_a_descriptive_name;    /* explains the third member */
+} long_structure_type_name_for_scanning_t;
+/* short */ int /* comments */ between /* tokens */ ;
+// a line comment that runs on for a while without anything the lexer needs to look at
+// another one, followed by a blank line
+
+extern int function_with_a_long_name_and_parameters(int first_parameter_name,
+                                                      long second_parameter_name,
+                                                      const char *third_parameter_name);
+/*
+ *  ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz 0123456789 _ ABCDEFGHIJKLMNOPQRSTUVWXYZ
+ *  abcdefghijklmnopqrstuvwxyz 0123456789 _ ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz
+ *  * stars * inside * the * comment * that * are * not * followed * by * a * slash *
+ */
+static const char *const messages_for_the_string_scanner[] = {
+    "a string literal long enough that the scanner copies it in runs of plain characters",
+    "escapes like \"quotes\", \\backslashes\\ and \t tabs break the runs only briefly",
+    "a question mark? is checked for trigraphs but usually begins none", L"and a wide one"
+};
+static const char characters_for_the_scanner[] = { 'a', '\n', '\'', '\\', 'z', '0' };
+static const double numbers_for_the_ppnum_scanner[] = { 3.14159265358979e+00, 1.0e-10, .5,
+                                                        0x7fffffffUL, 1234567890, 42 };
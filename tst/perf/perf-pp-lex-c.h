@@ -0,0 +1,30 @@
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
+#include "perf-pp-lex-b.h"
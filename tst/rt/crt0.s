@@ -0,0 +1,21 @@
+# startup code for executable tests on x86-linux;
+# no C library assumed: main's return value becomes the exit status
+.text
+.globl _start
+_start:
+call main
+movl %eax,%ebx
+movl $1,%eax
+int $0x80
+
+# int write(int fd, const void *buf, unsigned n)
+.globl write
+write:
+pushl %ebx
+movl 8(%esp),%ebx
+movl 12(%esp),%ecx
+movl 16(%esp),%edx
+movl $4,%eax
+int $0x80
+popl %ebx
+ret
@@ -0,0 +1,159 @@
+/*
+ *  minimal library for executable tests
+ */
+
+int write(int, const void *, unsigned);
+
+
+static char buf[512];    /* output buffer */
+static int nbuf;         /* # of chars in buffer */
+
+
+/*
+ *  flushes the output buffer
+ */
+static void flush(void)
+{
+    if (nbuf > 0)
+        write(1, buf, nbuf);
+    nbuf = 0;
+}
+
+
+/*
+ *  puts a character into the output buffer
+ */
+static void put(int c)
+{
+    if (nbuf == sizeof(buf))
+        flush();
+    buf[nbuf++] = c;
+}
+
+
+/*
+ *  writes a character
+ */
+int putchar(int c)
+{
+    put(c);
+    flush();
+
+    return (unsigned char)c;
+}
+
+
+/*
+ *  puts a field padded to a width
+ */
+static int field(const char *s, int n, int width, int left, int zero)
+{
+    int i, r = 0;
+
+    if (zero && n > 0 && *s == '-')
+        put(*s++), n--, width--, r++;
+    if (!left)
+        for (; width > n; width--, r++)
+            put((zero)? '0': ' ');
+    for (i = 0; i < n; i++, r++)
+        put(s[i]);
+    for (; width > n; width--, r++)
+        put(' ');
+
+    return r;
+}
+
+
+/*
+ *  prints formatted output;
+ *  supports d, i, u, x, X, o, c, s, p and % with flags '-' and '0' and a width;
+ *  length modifiers are accepted and ignored;
+ *  ASSUMPTION: arguments are passed on the stack in 4-byte slots
+ */
+int printf(const char *fmt, ...)
+{
+    char *ap = (char *)&fmt + sizeof(fmt);
+    int r = 0;
+
+    for (; *fmt; fmt++) {
+        char s[16], *p;
+        int left = 0, zero = 0, width = 0;
+        unsigned u, base = 10;
+        const char *digit = "0123456789abcdef";
+
+        if (*fmt != '%') {
+            put(*fmt);
+            r++;
+            continue;
+        }
+        for (fmt++; *fmt == '-' || *fmt == '0'; fmt++)
+            if (*fmt == '-')
+                left = 1;
+            else
+                zero = 1;
+        for (; *fmt >= '0' && *fmt <= '9'; fmt++)
+            width = width*10 + (*fmt - '0');
+        while (*fmt == 'l' || *fmt == 'h')
+            fmt++;
+        p = s + sizeof(s);
+        switch(*fmt) {
+            case 'd':
+            case 'i':
+                {
+                    int n = *(int *)ap;
+                    u = (n < 0)? -(unsigned)n: n;
+                    do
+                        *--p = '0' + u % 10;
+                    while ((u /= 10) != 0);
+                    if (n < 0)
+                        *--p = '-';
+                }
+                ap += 4;
+                break;
+            case 'X':
+                digit = "0123456789ABCDEF";
+                /* no break */
+            case 'x':
+            case 'p':
+                base = 16;
+                goto conv;
+            case 'o':
+                base = 8;
+                /* no break */
+            case 'u':
+            conv:
+                u = *(unsigned *)ap;
+                ap += 4;
+                do
+                    *--p = digit[u % base];
+                while ((u /= base) != 0);
+                break;
+            case 'c':
+                *--p = *(int *)ap;
+                ap += 4;
+                break;
+            case 's':
+                p = *(char **)ap;
+                ap += 4;
+                {
+                    int n = 0;
+                    while (p[n])
+                        n++;
+                    r += field(p, n, width, left, 0);
+                }
+                continue;
+            case '\0':
+                fmt--;
+                continue;
+            default:
+                *--p = *fmt;
+                break;
+        }
+        r += field(p, s + sizeof(s) - p, width, left, zero && !left);
+    }
+    flush();
+
+    return r;
+}
+
+/* end of libc.c */
@@ -6,14 +6,18 @@ var assert = require('assert')
 var EventEmitter = require('events').EventEmitter,
     ee = new EventEmitter()
 var fs = require('fs')
+var os = require('os')
 var path = require('path')
-var spawn = require('child_process').spawn
+var spawn = require('child_process').spawn,
+    spawnSync = require('child_process').spawnSync
 
 
 var prgname = 'run.js'
 var id, dir
 var excludes = {}
 var fails = []
+var rt    // runtime for executable tests
+var tmp   // directory for temporary files
 var copts = [ '--error-stop=0', '--no-warning-code', '--unwind-typedef',
               '--warning-on=5',   '--warning-on=20',  '--warning-on=25',  '--warning-on=53',
               '--warning-on=55',  '--warning-on=78',
@@ -42,8 +46,24 @@ var run = {
         touts: [ null, true, true ]
     },
     'assembly output': {
-        proc: evalasm,
-        exec: '../../build/beluga'
+        proc:  evalasm,
+        exec:  '../../build/beluga',
+        copts: []
+    },
+    'assembly output at -O1': {
+        proc:  evalasm,
+        exec:  '../../build/beluga',
+        copts: [ '--olevel=1' ]
+    },
+    'assembly output at -O2': {
+        proc:  evalasm,
+        exec:  '../../build/beluga',
+        copts: [ '--olevel=2' ]
+    },
+    'driver': {
+        proc:  drvout,
+        exec:  '../../build/bcc',
+        files: /[a-z0-9\-]\.sh$/i
     }
 }
 
@@ -114,6 +134,32 @@ function exclude() {
 }
 
 
+function preprt() {
+    var r
+    var src = path.join(__dirname, 'rt')
+
+    var err = function (msg) {
+        console.log('\n- executables will not be run: '+msg)
+        rt = undefined
+    }
+
+    rt = {
+        dir:  tmp,
+        objs: [ path.join(tmp, 'crt0.o'), path.join(tmp, 'libc.o') ]
+    }
+
+    r = spawnSync(path.join(dir, run[id].exec), [ '--target=x86-linux', path.join(src, 'libc.c'),
+                                                  '-o', path.join(tmp, 'libc.s') ])
+    if (r.status !== 0) return err('cannot compile runtime')
+    r = spawnSync('as', [ '--32', '-o', rt.objs[1], path.join(tmp, 'libc.s') ])
+    if (r.status !== 0) return err('cannot assemble runtime')
+    r = spawnSync('as', [ '--32', '-o', rt.objs[0], path.join(src, 'crt0.s') ])
+    if (r.status !== 0) return err('cannot assemble runtime')
+    r = spawnSync('ld', [ '-V' ])
+    if (r.status !== 0 || r.stdout.toString().indexOf('elf_i386') < 0) return err('no linker for elf_i386')
+}
+
+
 function next(name, fail, msg) {
     if (fail) {
         process.stdout.write('[FAILED]'+((msg)? ': '+msg: '')+'\n')
@@ -159,19 +205,11 @@ function bufeq(b1, b2) {
 }
 
 
-function diagout(name) {
+function getopts(name) {
     var opts
     var codes
 
-    process.stdout.write('  checking for '+name+'... ')
-
-    try {
-        codes = fs.readFileSync(path.join(dir, name), 'binary')
-    } catch(e) {
-        next(name, true, 'cannot read test code')
-        return
-    }
-
+    codes = fs.readFileSync(path.join(dir, name), 'binary')
     codes = codes.split('\n')
     if (codes[0].substring(0, 2) === '/*' &&
         (opts=/\/\*(.*) \*\//.exec(codes[0]), opts && opts[1])) {
@@ -185,12 +223,26 @@ function diagout(name) {
             }
             i++
         }
-    } else {
-        opts = run[id].eopts
+        return opts
+    }
+
+    return null
+}
+
+
+function diagout(name) {
+    var opts
+
+    process.stdout.write('  checking for '+name+'... ')
+
+    try {
+        opts = getopts(name) || run[id].eopts
+    } catch(e) {
+        next(name, true, 'cannot read test code')
+        return
     }
     opts = opts.concat(run[id].copts)
     opts.push('./'+name)
-    codes = null
 
     !function () {
         var child
@@ -233,17 +285,90 @@ function diagout(name) {
 }
 
 
+function evalexe(name, asm) {
+    var r
+    var origin
+    var base = path.join(rt.dir, name)
+
+    try {
+        origin = fs.readFileSync(path.join(dir, name+'.out'))
+    } catch(e) {
+        return true    // not to run
+    }
+
+    fs.writeFileSync(base+'.s', asm)
+    r = spawnSync('as', [ '--32', '-o', base+'.o', base+'.s' ])
+    if (r.status === 0)
+        r = spawnSync('ld', [ '-m', 'elf_i386', '-o', base ].concat(rt.objs, base+'.o'))
+    if (r.status === 0)
+        r = spawnSync(base, [], { cwd: dir, timeout: 10000 })
+    if (r.status !== 0 || !r.stdout.equals(origin)) {
+        try {
+            fs.writeFileSync(path.join(dir, name+'.out.new'), r.stdout)
+        } catch(e) {}
+        return false
+    }
+
+    return true
+}
+
+
+function evalobj(name, asm, opts) {
+    var r
+    var dump = []
+    var base = path.join(tmp, name)
+
+    r = spawnSync(run[id].exec, opts.concat('--object', '-o', base+'.o', './'+name), { cwd: dir })
+    if (r.status !== 0)    // no object from erroneous code
+        return (!fs.existsSync(base+'.o') || fs.statSync(base+'.o').size === 0)
+    fs.writeFileSync(base+'.s', asm)
+    r = spawnSync('as', [ '--32', '-o', base+'.as.o', base+'.s' ])
+    if (r.status !== 0) return true    // not to check
+
+    ;[ base+'.as.o', base+'.o' ].forEach(function (o) {
+        var d = spawnSync('objdump', [ '-d', o ]),
+            e = spawnSync('readelf', [ '-rW', o ])
+        if (d.status !== 0 || e.status !== 0) return
+        dump.push(d.stdout.toString().split(o).join('')
+                   // as pads with multi-byte nops
+                   .replace(/^.*\t(nop|xchg +%ax,%ax|mov +%esi,%esi|lea +0x0\(%e[sd]i(,%eiz,1)?\),%e[sd]i) *\n/gm,
+                            '') +
+                  e.stdout.toString()
+                   // layout and symbol indices may differ
+                   .replace(/ at offset 0x[0-9a-f]+/g, '')
+                   .replace(/^([0-9a-f]+ +)[0-9a-f]+ /gm, '$1'))
+    })
+
+    return (dump.length < 2 || dump[0] === dump[1])
+}
+
+
 function evalasm(name) {
     var count = 0
     var targets = [ 'x86-test', 'x86-linux' ]
     var fail = false, msg = []
+    var fopts
 
     process.stdout.write('  checking for '+name+'... ')
 
+    try {
+        fopts = getopts(name) || []
+    } catch(e) {
+        next(name, true, 'cannot read test code')
+        return
+    }
+    for (var i = 0; i < fopts.length; i++) {    // target-specific test
+        if (fopts[i].indexOf('--target=') === 0) {
+            targets = [ fopts[i].substring(9) ]
+            fopts.splice(i, 1)
+            break
+        }
+    }
+
     for (var i = 0; i < targets.length; i++) {
         !function (target) {
             var child
-            var opts = []
+            var opts = fopts.concat(run[id].copts)
             var stdout = new Buffer(0)
 
             opts.push('--target='+target, './'+name)
@@ -258,7 +383,9 @@ function evalasm(name) {
                 try {
                     origin = fs.readFileSync(path.join(dir, name+'.'+target))
                 } catch(e) {
-                    origin = undefined
+                    // x86-linux cases with only an expected run output are checked by running
+                    origin = (target === 'x86-linux' && fs.existsSync(path.join(dir, name+'.out')))?
+                                 stdout: undefined
                 }
                 if (!origin || !stdout.equals(origin)) {
                     fail = fail || true
@@ -269,6 +396,14 @@ function evalasm(name) {
                         msg.push('cannot write output file')
                     }
                 }
+                if (target === 'x86-linux' && !evalobj(name, stdout, opts.slice(0, -1))) {
+                    fail = true
+                    msg.push('object')
+                }
+                if (target === 'x86-linux' && rt && !evalexe(name, stdout)) {
+                    fail = true
+                    msg.push('execution')
+                }
 
                 ;(++count === targets.length) && next(name, fail, msg.join(', '))
             })
@@ -277,6 +412,41 @@ function evalasm(name) {
 }
 
 
+function drvout(name) {
+    var child
+    var env = {}
+    var stdout = new Buffer(0)
+
+    process.stdout.write('  checking for '+name+'... ')
+
+    for (var k in process.env) env[k] = process.env[k]
+    env.BCC = path.resolve(dir, run[id].exec)
+    env.BELUGA = path.dirname(env.BCC)    // directory for -B
+    child = spawn('sh', [ './'+name ], { cwd: dir, env: env })
+    child.stdout.on('data', function (data) {
+        stdout = Buffer.concat([ stdout, data ])
+    })
+
+    child.on('close', function () {
+        var origin
+
+        try {
+            origin = fs.readFileSync(path.join(dir, name+'.out'))
+        } catch(e) {
+            origin = undefined
+        }
+        if (!origin || !stdout.equals(origin)) {
+            try {
+                fs.writeFileSync(path.join(dir, name+'.out.new'), stdout)
+            } catch(e) {}
+            next(name, true)
+            return
+        }
+        next(name, false)
+    })
+}
+
+
 // starts here
 !function () {
     var buf
@@ -287,9 +457,16 @@ function evalasm(name) {
     console.log('Running tests for '+id+':')
 
     exclude()
+    if (run[id].proc === evalasm) {
+        tmp = fs.mkdtempSync(path.join(os.tmpdir(), 'run.js-'))
+        process.on('exit', function () {
+            fs.rmSync(tmp, { recursive: true, force: true })
+        })
+        preprt()
+    }
     buf = fs.readdirSync(dir)
     for (var i = 0; i < buf.length; i++) {
-        ;(/[a-z0-9\-].c$/i.test(buf[i]) && !excludes[buf[i]]) && list.push(buf[i])
+        ;((run[id].files || /[a-z0-9\-].c$/i).test(buf[i]) && !excludes[buf[i]]) && list.push(buf[i])
     }
 
     console.log('')